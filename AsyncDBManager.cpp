@@ -0,0 +1,157 @@
+/**
+ * @file AsyncDBManager.cpp
+ * @brief Этот файл содержит реализацию класса AsyncDBManager.
+ */
+
+#include "AsyncDBManager.h"
+#include "Logger.h"
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+
+/**
+ * @brief Конструктор асинхронного соединения.
+ * @param reactor Реактор, в котором ожидаются запросы.
+ * @param host Хост базы данных.
+ * @param user Пользователь базы данных.
+ * @param password Пароль базы данных.
+ * @param database Имя базы данных.
+ * @param port Порт базы данных.
+ */
+AsyncDBManager::AsyncDBManager(Reactor& reactor, const std::string& host, const std::string& user,
+                               const std::string& password, const std::string& database, int port)
+    : host(host), user(user), password(password), database(database), port(port),
+      reactor(reactor), connection(nullptr), inFlight(false) {}
+
+/**
+ * @brief Деструктор. Закрывает соединение.
+ */
+AsyncDBManager::~AsyncDBManager() {
+    disconnect();
+}
+
+/**
+ * @brief Устанавливает соединение и переводит его в неблокирующий режим.
+ * @return True, если соединение успешно, иначе false.
+ */
+bool AsyncDBManager::connect() {
+    std::stringstream conninfo;
+    conninfo << "host=" << host
+             << " port=" << port
+             << " dbname=" << database
+             << " user=" << user
+             << " password=" << password;
+
+    connection = PQconnectdb(conninfo.str().c_str());
+    if (PQstatus(connection) != CONNECTION_OK) {
+        Logger::severe("Connection to database failed: {}", PQerrorMessage(connection));
+        PQfinish(connection);
+        connection = nullptr;
+        return false;
+    }
+    if (PQsetnonblocking(connection, 1) != 0) {
+        Logger::severe("Failed to switch connection to non-blocking mode: {}", PQerrorMessage(connection));
+        PQfinish(connection);
+        connection = nullptr;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Закрывает соединение и удаляет его сокет из реактора.
+ */
+void AsyncDBManager::disconnect() {
+    if (connection) {
+        reactor.forget(PQsocket(connection));
+        PQfinish(connection);
+        connection = nullptr;
+    }
+}
+
+/**
+ * @brief Проверяет, активно ли соединение.
+ */
+bool AsyncDBManager::isConnected() const {
+    return connection != nullptr && PQstatus(connection) == CONNECTION_OK;
+}
+
+/**
+ * @brief Выполняет запрос, возвращающий строки (SELECT, ... RETURNING).
+ * Запрос отправляется через PQsendQueryParams. Затем сопрограмма дописывает буфер отправки (PQflush)
+ * и читает ответ (PQconsumeInput), приостанавливаясь на сокете соединения, пока libpq
+ * не соберет все результаты.
+ * @param sql Текст запроса с параметрами $1, $2, ...
+ * @param params Значения параметров.
+ * @return Задача с результатом последней команды запроса.
+ * @throw std::runtime_error Если соединение не установлено или запрос завершился с ошибкой.
+ */
+Task<PGResultWrapper> AsyncDBManager::query(std::string sql, std::vector<std::string> params) {
+    if (!isConnected()) {
+        throw std::runtime_error("Database not connected");
+    }
+    if (inFlight) {
+        throw std::runtime_error("Connection already has a query in flight");
+    }
+
+    std::vector<const char*> values;
+    values.reserve(params.size());
+    for (const auto& param : params) {
+        values.push_back(param.c_str());
+    }
+    if (!PQsendQueryParams(connection, sql.c_str(), static_cast<int>(values.size()), nullptr,
+                           values.empty() ? nullptr : values.data(), nullptr, nullptr, 0)) {
+        throw std::runtime_error(std::string("Failed to send query: ") + PQerrorMessage(connection));
+    }
+    inFlight = true;
+    int socket = PQsocket(connection);
+
+    try {
+        int flushed;
+        while ((flushed = PQflush(connection)) == 1) {
+            co_await reactor.writable(socket);
+        }
+        if (flushed < 0) {
+            throw std::runtime_error(std::string("Failed to flush query: ") + PQerrorMessage(connection));
+        }
+
+        PGResultWrapper last(nullptr);
+        while (true) {
+            while (PQisBusy(connection)) {
+                co_await reactor.readable(socket);
+                if (!PQconsumeInput(connection)) {
+                    throw std::runtime_error(std::string("Failed to read query result: ") + PQerrorMessage(connection));
+                }
+            }
+            PGresult* next = PQgetResult(connection);
+            if (!next) {
+                break;
+            }
+            last = PGResultWrapper(next);
+        }
+        inFlight = false;
+
+        if (!last.isValid()) {
+            throw std::runtime_error("Query returned no result");
+        }
+        ExecStatusType status = PQresultStatus(last.get());
+        if (status != PGRES_TUPLES_OK && status != PGRES_COMMAND_OK) {
+            throw std::runtime_error(std::string("Query execution failed: ") + PQresultErrorMessage(last.get()));
+        }
+        co_return last;
+    } catch (...) {
+        inFlight = false;
+        throw;
+    }
+}
+
+/**
+ * @brief Выполняет запрос на изменение (INSERT, UPDATE, DELETE).
+ * @param sql Текст запроса с параметрами $1, $2, ...
+ * @param params Значения параметров.
+ * @return Задача с количеством затронутых строк.
+ */
+Task<int> AsyncDBManager::update(std::string sql, std::vector<std::string> params) {
+    PGResultWrapper result = co_await query(std::move(sql), std::move(params));
+    co_return std::atoi(PQcmdTuples(result.get()));
+}
@@ -0,0 +1,94 @@
+/**
+ * @file AsyncDBManager.h
+ * @brief Этот файл содержит объявление класса AsyncDBManager - асинхронного соединения с PostgreSQL
+ *        на неблокирующем интерфейсе libpq, запросы которого ожидаются через co_await.
+ */
+
+#pragma once
+
+#include <libpq-fe.h>
+#include <string>
+#include <vector>
+#include "DBManager.h"
+#include "Reactor.h"
+#include "Task.h"
+
+/**
+ * @brief Асинхронное соединение с базой данных.
+ * Запрос отправляется через PQsendQueryParams, а ожидание ответа приостанавливает сопрограмму
+ * до готовности сокета (PQsocket) в реакторе, поэтому один поток может вести запросы
+ * на многих соединениях одновременно. На одном соединении в каждый момент выполняется
+ * не больше одного запроса. Параметры передаются отдельно от текста запроса ($1, $2, ...).
+ */
+class AsyncDBManager {
+private:
+    std::string host;
+    std::string user;
+    std::string password;
+    std::string database;
+    int port;
+
+    Reactor& reactor;
+    PGconn* connection;
+    bool inFlight;
+
+public:
+    /**
+     * @brief Конструирует асинхронное соединение.
+     * @param reactor Реактор, в котором ожидаются запросы.
+     * @param host Хост базы данных.
+     * @param user Пользователь базы данных.
+     * @param password Пароль базы данных.
+     * @param database Имя базы данных.
+     * @param port Порт базы данных (по умолчанию 5432).
+     */
+    AsyncDBManager(Reactor& reactor, const std::string& host, const std::string& user,
+                   const std::string& password, const std::string& database, int port = 5432);
+
+    /**
+     * @brief Уничтожает объект и закрывает соединение.
+     */
+    ~AsyncDBManager();
+
+    AsyncDBManager(const AsyncDBManager&) = delete;
+    AsyncDBManager& operator=(const AsyncDBManager&) = delete;
+
+    /**
+     * @brief Устанавливает соединение и переводит его в неблокирующий режим.
+     * @return True, если соединение успешно, иначе false.
+     */
+    bool connect();
+
+    /**
+     * @brief Закрывает соединение.
+     */
+    void disconnect();
+
+    /**
+     * @brief Проверяет, активно ли соединение.
+     */
+    bool isConnected() const;
+
+    /**
+     * @brief Проверяет, выполняется ли сейчас запрос на соединении.
+     */
+    bool isBusy() const { return inFlight; }
+
+    /**
+     * @brief Выполняет запрос, возвращающий строки (SELECT, ... RETURNING).
+     * @param sql Текст запроса с параметрами $1, $2, ...
+     * @param params Значения параметров.
+     * @return Задача с результатом запроса.
+     * @throw std::runtime_error Если соединение не установлено или запрос завершился с ошибкой.
+     */
+    Task<PGResultWrapper> query(std::string sql, std::vector<std::string> params = {});
+
+    /**
+     * @brief Выполняет запрос на изменение (INSERT, UPDATE, DELETE).
+     * @param sql Текст запроса с параметрами $1, $2, ...
+     * @param params Значения параметров.
+     * @return Задача с количеством затронутых строк.
+     * @throw std::runtime_error Если соединение не установлено или запрос завершился с ошибкой.
+     */
+    Task<int> update(std::string sql, std::vector<std::string> params = {});
+};
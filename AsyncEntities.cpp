@@ -0,0 +1,113 @@
+/**
+ * @file AsyncEntities.cpp
+ * @brief Этот файл содержит асинхронные варианты часто вызываемых методов сущностей
+ *        (поиск свободных номеров, проверка доступности, создание бронирования) поверх AsyncDBManager.
+ *        Вынесены в отдельный файл, так как асинхронный слой собирается только под Linux.
+ */
+
+#include "AsyncDBManager.h"
+#include "Booking.h"
+#include "Room.h"
+#include <exception>
+
+/**
+ * @brief Преобразует строковое представление статуса в BookingStatus (определена в Booking.cpp).
+ */
+BookingStatus toBookingStatus(const std::string& statusStr);
+
+/**
+ * @brief Асинхронно находит номера, свободные на указанные даты.
+ * @param dbManager Асинхронное соединение с базой данных.
+ * @param dateFrom Дата заезда.
+ * @param dateTo Дата выезда.
+ * @return Задача с вектором свободных номеров.
+ */
+Task<std::vector<Room>> Room::findAvailableRoomsAsync(AsyncDBManager& dbManager, std::string dateFrom, std::string dateTo) {
+    std::vector<std::string> params{std::move(dateFrom), std::move(dateTo)};
+    PGResultWrapper result = co_await dbManager.query(
+        "SELECT r.id, r.number, r.type, r.price_per_day, r.description FROM rooms r "
+        "WHERE NOT EXISTS (SELECT 1 FROM bookings b WHERE b.room_id = r.id AND b.status <> 'cancelled' "
+        "AND b.date_from <= $2::date AND (b.date_from, b.date_to) OVERLAPS ($1::date, $2::date)) ORDER BY r.id",
+        std::move(params));
+
+    std::vector<Room> rooms;
+    rooms.reserve(PQntuples(result.get()));
+    for (int i = 0; i < PQntuples(result.get()); i++) {
+        rooms.emplace_back(std::stoi(PQgetvalue(result.get(), i, 0)),
+                           PQgetvalue(result.get(), i, 1),
+                           PQgetvalue(result.get(), i, 2),
+                           std::stod(PQgetvalue(result.get(), i, 3)),
+                           PQgetvalue(result.get(), i, 4));
+    }
+    co_return rooms;
+}
+
+/**
+ * @brief Асинхронно проверяет доступность номера на указанные даты.
+ * @param dbManager Асинхронное соединение с базой данных.
+ * @param roomId Идентификатор номера.
+ * @param dateFrom Дата начала.
+ * @param dateTo Дата окончания.
+ * @return Задача с результатом проверки.
+ */
+Task<bool> Booking::isRoomAvailableAsync(AsyncDBManager& dbManager, int roomId, std::string dateFrom, std::string dateTo) {
+    std::vector<std::string> params{std::to_string(roomId), std::move(dateFrom), std::move(dateTo)};
+    PGResultWrapper result = co_await dbManager.query(
+        "SELECT NOT EXISTS (SELECT 1 FROM bookings WHERE room_id = $1 AND status <> 'cancelled' "
+        "AND date_from <= $3::date AND (date_from, date_to) OVERLAPS ($2::date, $3::date))",
+        std::move(params));
+    co_return PQgetvalue(result.get(), 0, 0)[0] == 't';
+}
+
+/**
+ * @brief Асинхронно создает бронирование.
+ * Проверка доступности и вставка выполняются одним запросом в транзакции под блокировкой
+ * pg_advisory_xact_lock(room_id), поэтому параллельные бронирования номера не пересекаются.
+ * @param dbManager Асинхронное соединение с базой данных.
+ * @param userId Идентификатор пользователя.
+ * @param roomId Идентификатор номера.
+ * @param dateFrom Дата начала бронирования.
+ * @param dateTo Дата окончания бронирования.
+ * @return Задача с созданным бронированием или nullptr, если номер занят.
+ */
+Task<std::unique_ptr<Booking>> Booking::createBookingAsync(AsyncDBManager& dbManager, int userId, int roomId,
+                                                           std::string dateFrom, std::string dateTo) {
+    std::vector<std::string> params{std::to_string(userId), std::to_string(roomId), std::move(dateFrom), std::move(dateTo)};
+    std::vector<std::string> lockParams(1, params[1]);
+    // Как в createBookingIfFree: вставка под блокировкой номера, снимок берется после ее получения.
+    co_await dbManager.update("BEGIN");
+    PGResultWrapper result(nullptr);
+    std::exception_ptr failure;
+    try {
+        co_await dbManager.query("SELECT pg_advisory_xact_lock($1::int)", std::move(lockParams));
+        result = co_await dbManager.query(
+            "INSERT INTO bookings (user_id, room_id, property_id, date_from, date_to, status) "
+            "SELECT $1, $2, (SELECT property_id FROM rooms WHERE id = $2), $3::date, $4::date, 'pending' WHERE NOT EXISTS ("
+            "SELECT 1 FROM bookings WHERE room_id = $2 AND status <> 'cancelled' "
+            "AND date_from <= $4::date AND (date_from, date_to) OVERLAPS ($3::date, $4::date)) "
+            "RETURNING id, user_id, room_id, date_from, date_to, status, version",
+            std::move(params));
+        co_await dbManager.update("COMMIT");
+    } catch (...) {
+        failure = std::current_exception();
+    }
+    if (failure) {
+        try {
+            co_await dbManager.update("ROLLBACK");
+        } catch (...) {
+        }
+        std::rethrow_exception(failure);
+    }
+
+    if (PQntuples(result.get()) != 1) {
+        co_return nullptr;
+    }
+    co_return std::make_unique<Booking>(
+        std::stoi(PQgetvalue(result.get(), 0, 0)),
+        std::stoi(PQgetvalue(result.get(), 0, 1)),
+        std::stoi(PQgetvalue(result.get(), 0, 2)),
+        PQgetvalue(result.get(), 0, 3),
+        PQgetvalue(result.get(), 0, 4),
+        toBookingStatus(PQgetvalue(result.get(), 0, 5)),
+        std::stoi(PQgetvalue(result.get(), 0, 6)));
+}
@@ -0,0 +1,805 @@
+/**
+ * @file AuditJournal.cpp
+ * @brief Этот файл содержит реализацию журнала аудита.
+ */
+
+#include "AuditJournal.h"
+#include "DBManager.h"
+#include "Logger.h"
+#include "Metrics.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char SEGMENT_MAGIC[8] = {'H', 'O', 'T', 'E', 'L', 'A', 'U', 'D'};
+constexpr std::uint32_t FORMAT_VERSION = 1;
+constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+constexpr std::size_t MIN_SEGMENT_BYTES = 4096;
+
+/**
+ * @brief Заголовок файла сегмента.
+ */
+struct SegmentHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint64_t capacity;
+    std::uint64_t firstSequence;    ///< Номер первой записи сегмента.
+    std::uint64_t reserved[4];
+};
+static_assert(sizeof(SegmentHeader) == 64, "SegmentHeader layout");
+
+/**
+ * @brief Заголовок записи; за ним следуют detailLength байт подробностей и выравнивание до 8 байт.
+ * Нулевой size означает конец записей сегмента.
+ */
+struct RecordHeader {
+    std::uint32_t size;             ///< Полный размер записи с выравниванием.
+    std::uint32_t checksum;         ///< FNV-1a всех байт после checksum до конца подробностей.
+    std::uint64_t sequence;
+    std::int64_t wallNs;
+    std::int32_t actorId;
+    std::int32_t targetId;
+    std::uint16_t action;
+    std::uint16_t detailLength;
+    std::uint32_t reserved;
+};
+static_assert(sizeof(RecordHeader) == 40, "RecordHeader layout");
+
+thread_local int currentActor = 0;
+
+/**
+ * @brief Метрики журнала аудита.
+ */
+struct AuditMetrics {
+    MetricCounter& records;
+    MetricCounter& syncs;
+    MetricCounter& syncFailures;
+    MetricCounter& shipped;
+    MetricCounter& shipFailures;
+};
+
+/**
+ * @brief Возвращает метрики журнала аудита (регистрирует их при первом обращении).
+ */
+AuditMetrics& auditMetrics() {
+    MetricsRegistry& registry = MetricsRegistry::global();
+    static AuditMetrics metrics{
+        registry.counter("hotel_audit_records_total", "Records appended to the audit journal."),
+        registry.counter("hotel_audit_syncs_total", "Audit journal flushes to disk (one per commit group)."),
+        registry.counter("hotel_audit_sync_failures_total", "Audit journal flushes to disk that failed."),
+        registry.counter("hotel_audit_shipped_total", "Audit records shipped to the audit_log table."),
+        registry.counter("hotel_audit_ship_failures_total", "Failed attempts to ship audit records."),
+    };
+    return metrics;
+}
+
+/**
+ * @brief Контрольная сумма FNV-1a (32 бита).
+ */
+std::uint32_t checksum(const unsigned char* data, std::size_t size) {
+    std::uint32_t hash = 2166136261u;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Выравнивает размер записи до 8 байт.
+ */
+std::size_t recordSize(std::size_t detailLength) {
+    return (sizeof(RecordHeader) + detailLength + 7) & ~static_cast<std::size_t>(7);
+}
+
+/**
+ * @brief Разбирает запись по смещению.
+ * @param base Начало сегмента.
+ * @param offset Смещение записи.
+ * @param limit Конец доступных байт.
+ * @param record Запись (если не nullptr).
+ * @return Размер записи или 0, если записей больше нет (конец, неполная или поврежденная запись).
+ */
+std::size_t parseRecord(const unsigned char* base, std::size_t offset, std::size_t limit, AuditRecord* record) {
+    if (offset + sizeof(RecordHeader) > limit) {
+        return 0;
+    }
+    RecordHeader header;
+    std::memcpy(&header, base + offset, sizeof(header));
+    if (header.size == 0 || header.detailLength > AuditJournal::MAX_DETAIL ||
+        header.size != recordSize(header.detailLength) || offset + header.size > limit) {
+        return 0;
+    }
+    const std::size_t covered = sizeof(RecordHeader) - offsetof(RecordHeader, sequence) + header.detailLength;
+    if (checksum(base + offset + offsetof(RecordHeader, sequence), covered) != header.checksum) {
+        return 0;
+    }
+    if (record) {
+        record->sequence = header.sequence;
+        record->wallNs = header.wallNs;
+        record->actorId = header.actorId;
+        record->targetId = header.targetId;
+        record->action = static_cast<AuditAction>(header.action);
+        record->detail.assign(reinterpret_cast<const char*>(base + offset + sizeof(RecordHeader)), header.detailLength);
+    }
+    return header.size;
+}
+
+/**
+ * @brief Проверяет заголовок сегмента.
+ * @return Описание проблемы или пустая строка.
+ */
+std::string checkHeader(const unsigned char* base, std::size_t length) {
+    if (length < sizeof(SegmentHeader)) {
+        return "file is truncated";
+    }
+    const SegmentHeader& header = *reinterpret_cast<const SegmentHeader*>(base);
+    if (std::memcmp(header.magic, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC)) != 0) {
+        return "not an audit segment";
+    }
+    if (header.byteOrder != BYTE_ORDER_MARK) {
+        return "byte order mismatch";
+    }
+    if (header.version != FORMAT_VERSION) {
+        return "unsupported format version " + std::to_string(header.version);
+    }
+    if (header.capacity != length) {
+        return "file size mismatch";
+    }
+    return "";
+}
+
+/**
+ * @brief Возвращает пути сегментов каталога по возрастанию номера первой записи.
+ */
+std::vector<std::string> segmentPaths(const std::string& directory) {
+    std::vector<std::string> paths;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        std::string name = entry.path().filename().string();
+        if (name.rfind("audit-", 0) == 0 && entry.path().extension() == ".seg") {
+            paths.push_back(entry.path().string());
+        }
+    }
+    std::sort(paths.begin(), paths.end()); // номер в имени дополнен нулями
+    return paths;
+}
+
+/**
+ * @brief Заключает строку в кавычки SQL (standard_conforming_strings = on).
+ */
+std::string quoteLiteral(std::string_view text) {
+    std::string quoted = "'";
+    for (char c : text) {
+        if (c == '\0') {
+            continue;
+        }
+        quoted += c;
+        if (c == '\'') {
+            quoted += '\'';
+        }
+    }
+    return quoted + "'";
+}
+
+} // namespace
+
+/**
+ * @brief Файл сегмента, отображенный в память для чтения и записи.
+ * Поля end и lastSequence меняются под мьютексом журнала, shipOffset - только потоком отправки.
+ */
+class AuditSegment {
+public:
+    std::string path;
+    unsigned char* base = nullptr;
+    std::size_t capacity = 0;
+    std::uint64_t firstSequence = 0;
+    std::uint64_t lastSequence = 0;                   ///< 0 - записей нет.
+    std::size_t end = sizeof(SegmentHeader);          ///< Конец записей.
+    std::size_t syncedEnd = sizeof(SegmentHeader);    ///< Конец записей, сброшенных на диск.
+    std::size_t shipOffset = sizeof(SegmentHeader);   ///< Первая неотправленная запись.
+
+private:
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+
+    /**
+     * @brief Открывает (или создает) файл и отображает его в память.
+     * @param size Размер файла при создании (0 - открыть существующий).
+     */
+    void map(std::size_t size) {
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                           size ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Cannot open audit segment " + path);
+        }
+        LARGE_INTEGER length;
+        if (size) {
+            length.QuadPart = static_cast<LONGLONG>(size);
+            if (!SetFilePointerEx(file, length, nullptr, FILE_BEGIN) || !SetEndOfFile(file)) {
+                throw std::runtime_error("Cannot size audit segment " + path);
+            }
+        } else if (!GetFileSizeEx(file, &length)) {
+            throw std::runtime_error("Cannot read audit segment size " + path);
+        }
+        capacity = static_cast<std::size_t>(length.QuadPart);
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, 0, 0, nullptr);
+        if (mapping) {
+            base = static_cast<unsigned char*>(MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, 0));
+        }
+#else
+        int fd = ::open(path.c_str(), size ? (O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC) : (O_RDWR | O_CLOEXEC), 0644);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open audit segment " + path);
+        }
+        struct stat info;
+        if ((size && ::ftruncate(fd, static_cast<off_t>(size)) != 0) || ::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot size audit segment " + path);
+        }
+        capacity = static_cast<std::size_t>(info.st_size);
+        void* mapped = capacity ? ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+        ::close(fd);
+        if (mapped != MAP_FAILED) {
+            base = static_cast<unsigned char*>(mapped);
+        }
+#endif
+        if (!base) {
+            throw std::runtime_error("Cannot map audit segment " + path);
+        }
+    }
+
+public:
+    /**
+     * @brief Создает пустой сегмент.
+     * @param path Путь к файлу.
+     * @param capacity Размер файла.
+     * @param firstSequence Номер первой записи.
+     */
+    AuditSegment(std::string path, std::size_t capacity, std::uint64_t firstSequence)
+        : path(std::move(path)), firstSequence(firstSequence) {
+        map(capacity);
+        SegmentHeader header{};
+        std::memcpy(header.magic, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC));
+        header.version = FORMAT_VERSION;
+        header.byteOrder = BYTE_ORDER_MARK;
+        header.capacity = this->capacity;
+        header.firstSequence = firstSequence;
+        std::memcpy(base, &header, sizeof(header));
+        sync(0, sizeof(header));
+    }
+
+    /**
+     * @brief Открывает существующий сегмент и находит конец его записей.
+     * Байты после последней целой записи обнуляются: это неполная запись прерванного процесса.
+     * @param path Путь к файлу.
+     * @throw std::runtime_error Если заголовок поврежден.
+     */
+    explicit AuditSegment(std::string path) : path(std::move(path)) {
+        map(0);
+        std::string problem = checkHeader(base, capacity);
+        if (!problem.empty()) {
+            unmap();
+            throw std::runtime_error("Invalid audit segment " + this->path + ": " + problem);
+        }
+        firstSequence = reinterpret_cast<const SegmentHeader*>(base)->firstSequence;
+        AuditRecord record;
+        while (std::size_t size = parseRecord(base, end, capacity, &record)) {
+            lastSequence = record.sequence;
+            end += size;
+        }
+        // Обнуляются только байты до последнего ненулевого, чтобы не загрязнять пустые страницы.
+        std::size_t garbageEnd = capacity;
+        while (garbageEnd > end && base[garbageEnd - 1] == 0) {
+            --garbageEnd;
+        }
+        if (garbageEnd > end) {
+            std::memset(base + end, 0, garbageEnd - end);
+            sync(end, garbageEnd);
+        }
+        syncedEnd = end;
+    }
+
+    ~AuditSegment() {
+        unmap();
+    }
+
+    AuditSegment(const AuditSegment&) = delete;
+    AuditSegment& operator=(const AuditSegment&) = delete;
+
+    /**
+     * @brief Сбрасывает диапазон байт на диск.
+     * @throw std::runtime_error Если сброс не удался.
+     */
+    void sync(std::size_t from, std::size_t to) {
+#ifdef _WIN32
+        if (!FlushViewOfFile(base + from, to - from) || !FlushFileBuffers(file)) {
+            throw std::runtime_error("Failed to flush audit segment " + path);
+        }
+#else
+        static const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        std::size_t start = from / page * page;
+        if (::msync(base + start, to - start, MS_SYNC) != 0) {
+            throw std::runtime_error("Failed to flush audit segment " + path);
+        }
+#endif
+    }
+
+    /**
+     * @brief Снимает отображение и закрывает файл.
+     */
+    void unmap() {
+#ifdef _WIN32
+        if (base) UnmapViewOfFile(base);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (base) ::munmap(base, capacity);
+#endif
+        base = nullptr;
+    }
+};
+
+/**
+ * @brief Устанавливает пользователя текущего потока.
+ * @param actorId Идентификатор пользователя (0 - система).
+ */
+AuditActor::AuditActor(int actorId) : previous(currentActor) {
+    currentActor = actorId;
+}
+
+/**
+ * @brief Восстанавливает предыдущего пользователя.
+ */
+AuditActor::~AuditActor() {
+    currentActor = previous;
+}
+
+/**
+ * @brief Возвращает пользователя текущего потока (0, если не установлен).
+ */
+int AuditActor::current() {
+    return currentActor;
+}
+
+/**
+ * @brief Открывает журнал: восстанавливает сегменты каталога или создает первый.
+ * @param shipConnection Фабрика соединения отправки.
+ * @param config Параметры.
+ */
+AuditJournal::AuditJournal(Factory shipConnection, AuditJournalConfig config)
+    : connect(std::move(shipConnection)), config(std::move(config)) {
+    this->config.segmentBytes = std::max(this->config.segmentBytes, MIN_SEGMENT_BYTES);
+    std::filesystem::create_directories(this->config.directory);
+    for (const std::string& path : segmentPaths(this->config.directory)) {
+        auto segment = std::make_unique<AuditSegment>(path);
+        if (segment->lastSequence != 0) {
+            nextSequence = std::max(nextSequence, segment->lastSequence + 1);
+        } else {
+            nextSequence = std::max(nextSequence, segment->firstSequence);
+        }
+        segments.push_back(std::move(segment));
+    }
+    appended = durable = nextSequence - 1;
+    if (segments.empty()) {
+        rotate();
+    }
+    syncer = std::thread(&AuditJournal::syncLoop, this);
+    shipper = std::thread(&AuditJournal::shipLoop, this);
+}
+
+/**
+ * @brief Сбрасывает записи на диск, пытается отправить их и останавливает фоновые потоки.
+ */
+AuditJournal::~AuditJournal() {
+    AuditJournal* self = this;
+    installed.compare_exchange_strong(self, nullptr);
+    stop();
+}
+
+/**
+ * @brief Делает журнал журналом процесса для note (nullptr - отключить).
+ */
+void AuditJournal::install(AuditJournal* journal) {
+    installed.store(journal, std::memory_order_release);
+}
+
+/**
+ * @brief Записывает действие пользователя текущего потока в журнал процесса, если он установлен.
+ * @param action Действие.
+ * @param targetId Пользователь или бронирование.
+ * @param detail Подробности.
+ */
+void AuditJournal::note(AuditAction action, int targetId, std::string_view detail) {
+    AuditJournal* journal = installed.load(std::memory_order_acquire);
+    if (!journal) {
+        return;
+    }
+    try {
+        journal->append(action, targetId, detail, AuditActor::current());
+    } catch (const std::exception& e) {
+        Logger::severe("Audit record for {} {} lost: {}", actionName(action), targetId, e.what());
+    }
+}
+
+/**
+ * @brief Возвращает имя действия.
+ */
+const char* AuditJournal::actionName(AuditAction action) {
+    switch (action) {
+        case AuditAction::ROLE_CHANGE: return "role_change";
+        case AuditAction::STATUS_CHANGE: return "status_change";
+        case AuditAction::BILL_CALCULATED: return "bill_calculated";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Разбирает имя действия.
+ * @throw std::invalid_argument Если имя неизвестно.
+ */
+AuditAction AuditJournal::parseAction(const std::string& name) {
+    for (AuditAction action : {AuditAction::ROLE_CHANGE, AuditAction::STATUS_CHANGE, AuditAction::BILL_CALCULATED}) {
+        if (name == actionName(action)) {
+            return action;
+        }
+    }
+    throw std::invalid_argument("Unknown audit action: " + name);
+}
+
+/**
+ * @brief Читает записи всех сегментов каталога по возрастанию номера.
+ * Сегменты читаются обычным чтением файла, поэтому журнал может быть открыт другим процессом.
+ * @param directory Каталог сегментов.
+ * @throw std::runtime_error Если сегмент поврежден в заголовке.
+ */
+std::vector<AuditRecord> AuditJournal::readDirectory(const std::string& directory) {
+    std::vector<AuditRecord> records;
+    for (const std::string& path : segmentPaths(directory)) {
+        std::vector<unsigned char> bytes(static_cast<std::size_t>(std::filesystem::file_size(path)));
+        std::ifstream in(path, std::ios::binary);
+        if (!in.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()))) {
+            throw std::runtime_error("Cannot read audit segment " + path);
+        }
+        std::string problem = checkHeader(bytes.data(), bytes.size());
+        if (!problem.empty()) {
+            throw std::runtime_error("Invalid audit segment " + path + ": " + problem);
+        }
+        std::size_t offset = sizeof(SegmentHeader);
+        AuditRecord record;
+        while (std::size_t size = parseRecord(bytes.data(), offset, bytes.size(), &record)) {
+            records.push_back(record);
+            offset += size;
+        }
+    }
+    return records;
+}
+
+/**
+ * @brief Создает новый активный сегмент; его первая запись получит номер nextSequence.
+ */
+void AuditJournal::rotate() {
+    char name[40];
+    std::snprintf(name, sizeof(name), "audit-%020llu.seg", static_cast<unsigned long long>(nextSequence));
+    std::string path = (std::filesystem::path(config.directory) / name).string();
+    segments.push_back(std::make_unique<AuditSegment>(path, config.segmentBytes, nextSequence));
+}
+
+/**
+ * @brief Дописывает запись в активный сегмент и (если waitForSync) ждет ее сброса на диск.
+ * @param action Действие.
+ * @param targetId Пользователь или бронирование.
+ * @param detail Подробности (обрезаются до MAX_DETAIL байт).
+ * @param actorId Пользователь, выполнивший действие.
+ * @return Номер записи.
+ * @throw std::runtime_error Если журнал остановлен, сброс на диск не удался или новый сегмент не
+ *        удалось создать.
+ */
+std::uint64_t AuditJournal::append(AuditAction action, int targetId, std::string_view detail, int actorId) {
+    detail = detail.substr(0, MAX_DETAIL);
+    const std::size_t size = recordSize(detail.size());
+    std::uint64_t sequence;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping) {
+            throw std::runtime_error("Audit journal is stopped");
+        }
+        if (!syncFailure.empty()) {
+            throw std::runtime_error("Audit journal failed: " + syncFailure);
+        }
+        if (segments.back()->end + size > segments.back()->capacity) {
+            rotate();
+        }
+        AuditSegment& segment = *segments.back();
+        sequence = nextSequence;
+
+        RecordHeader header{};
+        header.size = static_cast<std::uint32_t>(size);
+        header.sequence = sequence;
+        header.wallNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        header.actorId = actorId;
+        header.targetId = targetId;
+        header.action = static_cast<std::uint16_t>(action);
+        header.detailLength = static_cast<std::uint16_t>(detail.size());
+        unsigned char* at = segment.base + segment.end;
+        std::memcpy(at, &header, sizeof(header));
+        std::memcpy(at + sizeof(header), detail.data(), detail.size());
+        std::memset(at + sizeof(header) + detail.size(), 0, size - sizeof(header) - detail.size());
+        header.checksum = checksum(at + offsetof(RecordHeader, sequence),
+                                   sizeof(RecordHeader) - offsetof(RecordHeader, sequence) + detail.size());
+        std::memcpy(at + offsetof(RecordHeader, checksum), &header.checksum, sizeof(header.checksum));
+
+        segment.end += size;
+        segment.lastSequence = sequence;
+        appended = sequence;
+        ++nextSequence;
+    }
+    syncWake.notify_one();
+    auditMetrics().records.increment();
+    if (config.waitForSync) {
+        waitDurable(sequence);
+    }
+    return sequence;
+}
+
+/**
+ * @brief Ждет, пока запись с номером sequence не окажется на диске.
+ * @throw std::runtime_error Если сброс на диск не удался раньше, чем запись стала сохраненной.
+ */
+void AuditJournal::waitDurable(std::uint64_t sequence) {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (durable < sequence) {
+        if (!syncFailure.empty()) {
+            throw std::runtime_error("Audit record " + std::to_string(sequence) + " is not durable: " + syncFailure);
+        }
+        durableChanged.wait_for(lock, std::chrono::milliseconds(100));
+    }
+}
+
+/**
+ * @brief Цикл потока сброса на диск.
+ * Сбрасывает все записанное с прошлого сброса одним вызовом на сегмент и будит ждущих; записи,
+ * добавленные во время сброса, уходят следующей группой. При ошибке сброса durable и syncedEnd
+ * не продвигаются: ошибка запоминается в syncFailure, ждущие получают исключение, поток завершается.
+ */
+void AuditJournal::syncLoop() {
+    struct Range {
+        AuditSegment* segment;
+        std::size_t from;
+        std::size_t to;
+    };
+    std::vector<Range> ranges;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        syncWake.wait_for(lock, std::chrono::milliseconds(100), [this] { return stopping || appended > durable; });
+        if (appended == durable) {
+            if (stopping) {
+                return;
+            }
+            continue;
+        }
+        std::uint64_t target = appended;
+        ranges.clear();
+        for (const auto& segment : segments) {
+            if (segment->syncedEnd < segment->end) {
+                ranges.push_back({segment.get(), segment->syncedEnd, segment->end});
+            }
+        }
+        lock.unlock();
+        std::string failure;
+        for (const Range& range : ranges) {
+            try {
+                range.segment->sync(range.from, range.to);
+            } catch (const std::exception& e) {
+                failure = e.what();
+                break;
+            }
+        }
+        auditMetrics().syncs.increment();
+        lock.lock();
+        if (!failure.empty()) {
+            Logger::severe("Audit journal stops accepting records: {}", failure);
+            auditMetrics().syncFailures.increment();
+            syncFailure = failure;
+            durableChanged.notify_all();
+            return;
+        }
+        for (const Range& range : ranges) {
+            range.segment->syncedEnd = range.to;
+        }
+        durable = target;
+        durableChanged.notify_all();
+    }
+}
+
+/**
+ * @brief Цикл потока отправки: раз в shipInterval отправляет сброшенные записи.
+ */
+void AuditJournal::shipLoop() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (durableChanged.wait_for(lock, config.shipInterval, [this] { return stopping; })) {
+                return;
+            }
+        }
+        ship();
+    }
+}
+
+/**
+ * @brief Отправляет в audit_log одну пачку сброшенных записей.
+ * При новом соединении номер последней отправленной записи уточняется по audit_log.
+ * @return Количество отправленных записей (0 - отправлять нечего).
+ * @throw std::runtime_error Если база данных недоступна или запрос не выполнен.
+ */
+std::size_t AuditJournal::shipBatch() {
+    if (!db || !db->isConnected()) {
+        db = connect ? connect() : nullptr;
+        if (!db) {
+            throw std::runtime_error("audit database unavailable");
+        }
+        PGResultWrapper last = db->executeQuery("SELECT COALESCE(MAX(sequence), 0) FROM audit_log WHERE node = " +
+                                                quoteLiteral(config.node) + ";");
+        std::uint64_t stored = std::stoull(PQgetvalue(last.get(), 0, 0));
+        std::lock_guard<std::mutex> lock(mutex);
+        shipped = std::max(shipped, stored);
+    }
+
+    struct Source {
+        AuditSegment* segment;
+        std::size_t limit;
+    };
+    std::vector<Source> sources;
+    std::uint64_t after;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& segment : segments) {
+            sources.push_back({segment.get(), segment->syncedEnd});
+        }
+        after = shipped;
+    }
+
+    std::vector<AuditRecord> batch;
+    std::vector<std::pair<AuditSegment*, std::size_t>> positions;
+    for (const Source& source : sources) {
+        std::size_t offset = source.segment->shipOffset;
+        AuditRecord record;
+        while (batch.size() < config.shipBatch) {
+            std::size_t size = parseRecord(source.segment->base, offset, source.limit, &record);
+            if (size == 0) {
+                break;
+            }
+            offset += size;
+            if (record.sequence <= after) {
+                source.segment->shipOffset = offset; // уже в audit_log
+                continue;
+            }
+            batch.push_back(record);
+            positions.emplace_back(source.segment, offset);
+        }
+    }
+    if (batch.empty()) {
+        return 0;
+    }
+
+    std::string values;
+    values.reserve(batch.size() * 128);
+    for (const AuditRecord& record : batch) {
+        char time[48];
+        std::snprintf(time, sizeof(time), "to_timestamp(%lld.%06lld)", static_cast<long long>(record.wallNs / 1000000000),
+                      static_cast<long long>(record.wallNs % 1000000000 / 1000));
+        values += values.empty() ? "(" : ", (";
+        values += quoteLiteral(config.node) + ", " + std::to_string(record.sequence) + ", " + time + ", " +
+                  (record.actorId ? std::to_string(record.actorId) : std::string("NULL")) + ", '" +
+                  actionName(record.action) + "', " + std::to_string(record.targetId) + ", " +
+                  quoteLiteral(record.detail) + ")";
+    }
+    db->executeUpdate("INSERT INTO audit_log (node, sequence, recorded_at, actor_id, action, target_id, detail) VALUES " +
+                      values + " ON CONFLICT (node, sequence) DO NOTHING;");
+    auditMetrics().shipped.increment(batch.size());
+
+    std::lock_guard<std::mutex> lock(mutex);
+    shipped = std::max(shipped, batch.back().sequence);
+    for (const auto& [segment, offset] : positions) {
+        segment->shipOffset = offset;
+    }
+    // Полностью отправленные закрытые сегменты больше не нужны.
+    while (segments.size() > 1 && segments.front()->lastSequence <= shipped &&
+           segments.front()->shipOffset >= segments.front()->end) {
+        std::string path = segments.front()->path;
+        segments.pop_front();
+        std::remove(path.c_str());
+    }
+    return batch.size();
+}
+
+/**
+ * @brief Отправляет в audit_log все сброшенные записи сейчас.
+ * @return True, если отправлено все, что было сброшено до вызова.
+ */
+bool AuditJournal::ship() {
+    std::lock_guard<std::mutex> shipping(shipMutex);
+    std::uint64_t target;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        target = durable;
+    }
+    try {
+        while (shippedSequence() < target && shipBatch() > 0) {
+        }
+    } catch (const std::exception& e) {
+        auditMetrics().shipFailures.increment();
+        Logger::warning("Audit records not shipped: {}", e.what());
+        return false;
+    }
+    return shippedSequence() >= target;
+}
+
+/**
+ * @brief Возвращает номер последней записи.
+ */
+std::uint64_t AuditJournal::lastSequence() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return appended;
+}
+
+/**
+ * @brief Возвращает номер последней отправленной в audit_log записи.
+ */
+std::uint64_t AuditJournal::shippedSequence() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return shipped;
+}
+
+/**
+ * @brief Возвращает количество файлов сегментов.
+ */
+std::size_t AuditJournal::segmentCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return segments.size();
+}
+
+/**
+ * @brief Сбрасывает записи на диск, пытается отправить их и останавливает фоновые потоки.
+ */
+void AuditJournal::stop() {
+    if (!syncer.joinable() && !shipper.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    syncWake.notify_all();
+    durableChanged.notify_all();
+    if (syncer.joinable()) {
+        syncer.join();
+    }
+    if (shipper.joinable()) {
+        shipper.join();
+    }
+    ship();
+}
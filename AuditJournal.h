@@ -0,0 +1,248 @@
+/**
+ * @file AuditJournal.h
+ * @brief Этот файл содержит журнал аудита (AuditJournal): компактные двоичные записи о смене ролей,
+ *        смене статусов бронирований и расчете счетов дописываются в отображенный в память файл
+ *        сегмента с групповым сбросом на диск и в фоне отправляются в таблицу audit_log.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+class DBManager;
+class AuditSegment;
+
+/**
+ * @brief Действие, записываемое в журнал аудита.
+ */
+enum class AuditAction : std::uint16_t {
+    ROLE_CHANGE = 1,        ///< User::updateRole; цель - пользователь.
+    STATUS_CHANGE = 2,      ///< Booking::updateStatus; цель - бронирование.
+    BILL_CALCULATED = 3     ///< Bill::forBooking; цель - бронирование.
+};
+
+/**
+ * @brief Запись журнала аудита.
+ */
+struct AuditRecord {
+    std::uint64_t sequence = 0;   ///< Номер записи (растет без пропусков в пределах узла).
+    std::int64_t wallNs = 0;      ///< Время записи (system_clock), нс от эпохи Unix.
+    int actorId = 0;              ///< Пользователь, выполнивший действие (0 - система).
+    int targetId = 0;             ///< Пользователь или бронирование, к которому относится действие.
+    AuditAction action = AuditAction::ROLE_CHANGE;
+    std::string detail;           ///< Подробности, например "user->manager".
+};
+
+/**
+ * @brief Параметры журнала аудита.
+ */
+struct AuditJournalConfig {
+    std::string directory = "audit";                  ///< Каталог файлов сегментов.
+    std::string node = "local";                       ///< Имя узла в audit_log (номера записей уникальны в узле).
+    std::size_t segmentBytes = 4 << 20;               ///< Размер файла сегмента.
+    bool waitForSync = true;                          ///< append ждет сброса записи на диск.
+    std::size_t shipBatch = 500;                      ///< Записей в одном INSERT.
+    std::chrono::milliseconds shipInterval{1000};     ///< Период отправки в audit_log.
+};
+
+/**
+ * @brief Устанавливает пользователя, от имени которого текущий поток выполняет действия, на время
+ *        своей жизни (вложенные области восстанавливают предыдущего пользователя).
+ */
+class AuditActor {
+private:
+    int previous;
+
+public:
+    /**
+     * @brief Устанавливает пользователя текущего потока.
+     * @param actorId Идентификатор пользователя (0 - система).
+     */
+    explicit AuditActor(int actorId);
+
+    /**
+     * @brief Восстанавливает предыдущего пользователя.
+     */
+    ~AuditActor();
+
+    AuditActor(const AuditActor&) = delete;
+    AuditActor& operator=(const AuditActor&) = delete;
+
+    /**
+     * @brief Возвращает пользователя текущего потока (0, если не установлен).
+     */
+    static int current();
+};
+
+/**
+ * @brief Журнал аудита.
+ *
+ * append пишет запись прямо в отображенную в память страницу активного сегмента
+ * (<directory>/audit-<номер первой записи>.seg) под коротким мьютексом и ждет, пока поток сброса
+ * не выполнит msync (FlushViewOfFile под Windows) диапазона, включающего запись. Пока идет один
+ * сброс, новые записи накапливаются и сбрасываются следующим одним вызовом (групповой сброс), поэтому
+ * стоимость сброса делится между всеми одновременными действиями. Заполненный сегмент закрывается,
+ * и создается следующий. Неудачный сброс не повторяется (после ошибки msync неясно, какие страницы
+ * дошли до диска): журнал переходит в состояние ошибки, записи после последнего удачного сброса
+ * не считаются сохраненными, а append и waitDurable бросают исключение до перезапуска.
+ *
+ * Поток отправки пачками по shipBatch записей переносит сброшенные записи в таблицу audit_log
+ * (sql/006_audit_log.sql) многострочным INSERT ... ON CONFLICT DO NOTHING и удаляет полностью
+ * отправленные сегменты. После перезапуска записи восстанавливаются из сегментов (неполная последняя
+ * запись отбрасывается по контрольной сумме), а отправка продолжается с последнего номера узла в
+ * audit_log. Пока база данных недоступна, записи остаются в сегментах.
+ *
+ * Сущности пишут в журнал процесса (install) через AuditJournal::note; пользователь берется из
+ * AuditActor текущего потока. Без установленного журнала note ничего не делает.
+ */
+class AuditJournal {
+public:
+    using Factory = std::function<std::unique_ptr<DBManager>()>;
+
+    static constexpr std::size_t MAX_DETAIL = 1024;   ///< Более длинные подробности обрезаются.
+
+private:
+    Factory connect;
+    AuditJournalConfig config;
+
+    mutable std::mutex mutex;
+    std::condition_variable syncWake;
+    std::condition_variable durableChanged;
+    std::deque<std::unique_ptr<AuditSegment>> segments;   ///< От старых к активному (последний).
+    std::uint64_t nextSequence = 1;
+    std::uint64_t appended = 0;      ///< Последний записанный номер.
+    std::uint64_t durable = 0;       ///< Последний сброшенный на диск номер.
+    std::uint64_t shipped = 0;       ///< Последний отправленный в audit_log номер.
+    std::string syncFailure;         ///< Ошибка сброса на диск (пусто - ошибок не было).
+    bool stopping = false;
+    std::thread syncer;
+    std::thread shipper;
+
+    std::mutex shipMutex;            ///< Одна отправка за раз.
+    std::unique_ptr<DBManager> db;   ///< Соединение отправки (под shipMutex).
+
+    inline static std::atomic<AuditJournal*> installed{nullptr};
+
+    /**
+     * @brief Создает новый активный сегмент (под mutex).
+     */
+    void rotate();
+
+    /**
+     * @brief Цикл потока сброса на диск.
+     */
+    void syncLoop();
+
+    /**
+     * @brief Цикл потока отправки в audit_log.
+     */
+    void shipLoop();
+
+    /**
+     * @brief Отправляет записи одной пачкой.
+     * @return Количество отправленных записей.
+     */
+    std::size_t shipBatch();
+
+public:
+    /**
+     * @brief Открывает журнал: восстанавливает сегменты каталога или создает первый.
+     * @param shipConnection Фабрика соединения отправки (nullptr от фабрики - база данных недоступна).
+     * @param config Параметры.
+     * @throw std::runtime_error Если каталог или сегмент не удалось создать или отобразить.
+     */
+    explicit AuditJournal(Factory shipConnection, AuditJournalConfig config = {});
+
+    /**
+     * @brief Сбрасывает записи на диск, пытается отправить их и останавливает фоновые потоки.
+     */
+    ~AuditJournal();
+
+    AuditJournal(const AuditJournal&) = delete;
+    AuditJournal& operator=(const AuditJournal&) = delete;
+
+    /**
+     * @brief Делает журнал журналом процесса для note (nullptr - отключить).
+     * Журнал должен жить, пока установлен.
+     */
+    static void install(AuditJournal* journal);
+
+    /**
+     * @brief Записывает действие пользователя текущего потока в журнал процесса, если он установлен.
+     * Ошибки журнала записываются в Logger и не прерывают действие.
+     */
+    static void note(AuditAction action, int targetId, std::string_view detail);
+
+    /**
+     * @brief Возвращает имя действия (role_change, status_change, bill_calculated).
+     */
+    static const char* actionName(AuditAction action);
+
+    /**
+     * @brief Разбирает имя действия.
+     * @throw std::invalid_argument Если имя неизвестно.
+     */
+    static AuditAction parseAction(const std::string& name);
+
+    /**
+     * @brief Читает записи всех сегментов каталога по возрастанию номера.
+     * @param directory Каталог сегментов.
+     * @throw std::runtime_error Если сегмент поврежден в заголовке.
+     */
+    static std::vector<AuditRecord> readDirectory(const std::string& directory);
+
+    /**
+     * @brief Дописывает запись.
+     * @param action Действие.
+     * @param targetId Пользователь или бронирование.
+     * @param detail Подробности (обрезаются до MAX_DETAIL байт).
+     * @param actorId Пользователь, выполнивший действие.
+     * @return Номер записи; если waitForSync, запись уже на диске.
+     * @throw std::runtime_error Если журнал остановлен, сброс на диск не удался или сегмент не создан.
+     */
+    std::uint64_t append(AuditAction action, int targetId, std::string_view detail, int actorId);
+
+    /**
+     * @brief Ждет, пока запись с номером sequence не окажется на диске.
+     * @throw std::runtime_error Если сброс на диск не удался раньше, чем запись стала сохраненной.
+     */
+    void waitDurable(std::uint64_t sequence);
+
+    /**
+     * @brief Отправляет в audit_log все сброшенные записи сейчас.
+     * @return True, если отправлено все, что было сброшено до вызова.
+     */
+    bool ship();
+
+    /**
+     * @brief Возвращает номер последней записи.
+     */
+    std::uint64_t lastSequence() const;
+
+    /**
+     * @brief Возвращает номер последней отправленной в audit_log записи.
+     */
+    std::uint64_t shippedSequence() const;
+
+    /**
+     * @brief Возвращает количество файлов сегментов.
+     */
+    std::size_t segmentCount() const;
+
+    /**
+     * @brief Сбрасывает записи на диск, пытается отправить их и останавливает фоновые потоки.
+     */
+    void stop();
+};
@@ -0,0 +1,108 @@
+/**
+ * @file Bill.cpp
+ * @brief Этот файл содержит реализацию класса Bill.
+ */
+
+#include "Bill.h"
+#include "AuditJournal.h"
+#include "Booking.h"
+#include "Metrics.h"
+#include "Tracing.h"
+#include "Room.h"
+#include "Service.h"
+#include "ServiceWriteBehind.h"
+#include <map>
+
+/**
+ * @brief Конструктор класса Bill.
+ * @param bookingId Идентификатор бронирования.
+ * @param userId Идентификатор пользователя, которому принадлежит бронирование.
+ * @param roomNumber Номер комнаты.
+ * @param roomType Тип комнаты.
+ * @param days Количество оплачиваемых дней.
+ * @param roomCost Стоимость номера.
+ * @param lines Строки счета за услуги.
+ */
+Bill::Bill(int bookingId, int userId, const std::string& roomNumber, const std::string& roomType,
+           long days, double roomCost, std::vector<BillLine> lines)
+    : bookingId(bookingId), userId(userId), roomNumber(roomNumber), roomType(roomType),
+      days(days), roomCost(roomCost), lines(std::move(lines)) {}
+
+/**
+ * @brief Возвращает стоимость всех услуг.
+ * @return Сумма по строкам услуг.
+ */
+double Bill::getServicesCost() const {
+    double total = 0;
+    for (const auto& line : lines) {
+        total += line.cost;
+    }
+    return total;
+}
+
+/**
+ * @brief Возвращает итоговую стоимость.
+ * @return Стоимость номера и услуг.
+ */
+double Bill::getTotal() const {
+    return roomCost + getServicesCost();
+}
+
+/**
+ * @brief Рассчитывает счет для бронирования.
+ * Номер оплачивается за один день; услуги, удаленные из справочника, в счет не попадают.
+ * @param dbManager Менеджер базы данных для взаимодействия с БД.
+ * @param bookingId Идентификатор бронирования.
+ * @param deadline Крайний срок всего расчета (общий для всех его запросов).
+ * @param pendingServices Отложенная запись услуг, чьи незаписанные изменения учитываются в счете.
+ * @return Уникальный указатель на счет или nullptr, если бронирование или его номер не найдены.
+ * @throw QueryTimeoutError Если расчет не уложился в срок.
+ */
+std::unique_ptr<Bill> Bill::forBooking(DBManager& dbManager, int bookingId, const Deadline& deadline,
+                                       const ServiceWriteBehind* pendingServices) {
+    TraceSpan span("Bill::forBooking", "entity");
+    static MetricHistogram& duration = MetricsRegistry::global().histogram(
+        "hotel_bill_duration_seconds", "Time to load and compose a bill.");
+    MetricTimer timer(duration);
+    DBManager::DeadlineScope scope(dbManager, deadline);
+    auto booking = Booking::findBookingById(dbManager, bookingId);
+    if (!booking) {
+        return nullptr;
+    }
+    auto room = Room::findRoomById(dbManager, booking->getRoomId());
+    if (!room) {
+        return nullptr;
+    }
+
+    std::vector<std::pair<Service, int>> services;
+    std::map<int, int> bookingServices = pendingServices ? pendingServices->getServices(dbManager, *booking)
+                                                         : booking->getServices(dbManager);
+    for (auto const& [serviceId, quantity] : bookingServices) {
+        auto service = Service::findServiceById(dbManager, serviceId);
+        if (service) {
+            services.emplace_back(*service, quantity);
+        }
+    }
+    auto bill = std::make_unique<Bill>(compose(*booking, *room, services));
+    AuditJournal::note(AuditAction::BILL_CALCULATED, bookingId, "total=" + std::to_string(bill->getTotal()));
+    return bill;
+}
+
+/**
+ * @brief Составляет счет по уже загруженным данным (без обращений к базе данных).
+ * Номер оплачивается за один день.
+ * @param booking Бронирование.
+ * @param room Номер бронирования.
+ * @param services Услуги бронирования и их количество.
+ * @return Счет.
+ */
+Bill Bill::compose(const Booking& booking, const Room& room, const std::vector<std::pair<Service, int>>& services) {
+    long days = 1;
+    std::vector<BillLine> lines;
+    lines.reserve(services.size());
+    for (const auto& [service, quantity] : services) {
+        lines.push_back(BillLine{service.getId(), service.getName(), quantity, service.getPrice() * quantity});
+    }
+    return Bill(booking.getId(), booking.getUserId(), room.getNumber(), room.getType(),
+                days, room.getPricePerDay() * days, std::move(lines));
+}
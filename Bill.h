@@ -0,0 +1,96 @@
+/**
+ * @file Bill.h
+ * @brief Этот файл содержит объявление класса Bill, представляющего счет за бронирование.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "DBManager.h"
+
+class Booking;
+class Room;
+class Service;
+class ServiceWriteBehind;
+
+/**
+ * @brief Строка счета за услугу.
+ */
+struct BillLine {
+    int serviceId;
+    std::string name;
+    int quantity;
+    double cost;
+};
+
+/**
+ * @brief Класс Bill представляет счет за бронирование: стоимость номера и добавленных услуг.
+ */
+class Bill {
+private:
+    int bookingId;
+    int userId;
+    std::string roomNumber;
+    std::string roomType;
+    long days;
+    double roomCost;
+    std::vector<BillLine> lines;
+
+public:
+    /**
+     * @brief Конструктор для создания нового объекта Bill.
+     * @param bookingId Идентификатор бронирования.
+     * @param userId Идентификатор пользователя, которому принадлежит бронирование.
+     * @param roomNumber Номер комнаты.
+     * @param roomType Тип комнаты.
+     * @param days Количество оплачиваемых дней.
+     * @param roomCost Стоимость номера.
+     * @param lines Строки счета за услуги.
+     */
+    Bill(int bookingId, int userId, const std::string& roomNumber, const std::string& roomType,
+         long days, double roomCost, std::vector<BillLine> lines);
+
+    int getBookingId() const { return bookingId; }
+    int getUserId() const { return userId; }
+    const std::string& getRoomNumber() const { return roomNumber; }
+    const std::string& getRoomType() const { return roomType; }
+    long getDays() const { return days; }
+    double getRoomCost() const { return roomCost; }
+    const std::vector<BillLine>& getLines() const { return lines; }
+
+    /**
+     * @brief Возвращает стоимость всех услуг.
+     * @return Сумма по строкам услуг.
+     */
+    double getServicesCost() const;
+
+    /**
+     * @brief Возвращает итоговую стоимость.
+     * @return Стоимость номера и услуг.
+     */
+    double getTotal() const;
+
+    /**
+     * @brief Составляет счет по уже загруженным данным (без обращений к базе данных).
+     * @param booking Бронирование.
+     * @param room Номер бронирования.
+     * @param services Услуги бронирования и их количество.
+     * @return Счет.
+     */
+    static Bill compose(const Booking& booking, const Room& room, const std::vector<std::pair<Service, int>>& services);
+
+    /**
+     * @brief Рассчитывает счет для бронирования.
+     * @param dbManager Менеджер базы данных для взаимодействия с БД.
+     * @param bookingId Идентификатор бронирования.
+     * @param deadline Крайний срок всего расчета (общий для всех его запросов).
+     * @param pendingServices Отложенная запись услуг, чьи незаписанные изменения учитываются в счете
+     *        (nullptr - только строки из базы данных).
+     * @return Уникальный указатель на счет или nullptr, если бронирование или его номер не найдены.
+     * @throw QueryTimeoutError Если расчет не уложился в срок.
+     */
+    static std::unique_ptr<Bill> forBooking(DBManager& dbManager, int bookingId, const Deadline& deadline = Deadline(),
+                                            const ServiceWriteBehind* pendingServices = nullptr);
+};
@@ -4,8 +4,13 @@
  */
 #include "Booking.h"
 #include "DBManager.h"
+#include "AuditJournal.h"
+#include "Metrics.h"
+#include "Tracing.h"
+#include "SnapshotScan.h"
 #include <iostream>
 #include <memory>
+#include <cstdlib>
 
 /**
  * @brief Вспомогательная функция для преобразования строкового представления статуса бронирования в перечисление BookingStatus.
@@ -28,10 +33,11 @@ BookingStatus toBookingStatus(const std::string& statusStr) {
  * @param dateFrom Дата начала бронирования в формате YYYY-MM-DD.
  * @param dateTo Дата окончания бронирования в формате YYYY-MM-DD.
  * @param status Текущий статус бронирования.
+ * @param version Версия строки в базе данных.
  */
 Booking::Booking(int id, int userId, int roomId, const std::string& dateFrom, 
-                 const std::string& dateTo, BookingStatus status)
-    : id(id), userId(userId), roomId(roomId), dateFrom(dateFrom), dateTo(dateTo), status(status) {}
+                 const std::string& dateTo, BookingStatus status, int version)
+    : id(id), userId(userId), roomId(roomId), dateFrom(dateFrom), dateTo(dateTo), status(status), version(version) {}
 
 /**
  * @brief Возвращает идентификатор бронирования.
@@ -55,13 +61,13 @@ int Booking::getRoomId() const { return roomId; }
  * @brief Возвращает дату начала бронирования.
  * @return Строка с датой начала бронирования.
  */
-std::string Booking::getDateFrom() const { return dateFrom; }
+const std::string& Booking::getDateFrom() const { return dateFrom; }
 
 /**
  * @brief Возвращает дату окончания бронирования.
  * @return Строка с датой окончания бронирования.
  */
-std::string Booking::getDateTo() const { return dateTo; }
+const std::string& Booking::getDateTo() const { return dateTo; }
 
 /**
  * @brief Возвращает текущий статус бронирования.
@@ -69,11 +75,26 @@ std::string Booking::getDateTo() const { return dateTo; }
  */
 BookingStatus Booking::getStatus() const { return status; }
 
+/**
+ * @brief Возвращает версию бронирования, с которой был загружен объект.
+ * @return Версия строки.
+ */
+int Booking::getVersion() const { return version; }
+
 /**
  * @brief Возвращает строковое представление текущего статуса бронирования.
  * @return Строка, представляющая статус бронирования.
  */
 std::string Booking::getStatusString() const {
+    return statusToString(status);
+}
+
+/**
+ * @brief Возвращает строковое представление статуса бронирования.
+ * @param status Статус бронирования.
+ * @return Строка, представляющая статус бронирования.
+ */
+std::string Booking::statusToString(BookingStatus status) {
     switch (status) {
         case BookingStatus::PENDING: return "pending";
         case BookingStatus::CONFIRMED: return "confirmed";
@@ -89,8 +110,10 @@ std::string Booking::getStatusString() const {
  * @return Карта, где ключ - ID услуги, значение - количество.
  */
 std::map<int, int> Booking::getServices(DBManager& dbManager) {
+    TraceSpan span("Booking::getServices", "entity");
     std::map<int, int> servicesMap;
-    std::string query = "SELECT service_id, quantity FROM booking_services WHERE booking_id = " + std::to_string(id) + ";";
+    std::string query = "SELECT service_id, quantity FROM booking_services WHERE booking_id = " + std::to_string(id) +
+                        " AND booking_date_from = '" + dateFrom + "';";
     PGResultWrapper result = dbManager.executeQuery(query);
     for (int i = 0; i < PQntuples(result.get()); ++i) {
         servicesMap[std::stoi(PQgetvalue(result.get(), i, 0))] = std::stoi(PQgetvalue(result.get(), i, 1));
@@ -99,39 +122,154 @@ std::map<int, int> Booking::getServices(DBManager& dbManager) {
 }
 
 /**
- * @brief Добавляет услугу к данному бронированию в базе данных.
- * Если услуга уже существует, обновляет количество.
+ * @brief Добавляет услугу к данному бронированию в базе данных, если бронирование не изменилось с момента загрузки.
+ * Если услуга уже существует, количество увеличивается на quantity.
  * @param dbManager Менеджер базы данных для взаимодействия с БД.
  * @param serviceId Идентификатор услуги для добавления.
  * @param quantity Количество добавляемой услуги.
+ * @return Результат изменения.
  */
-void Booking::addService(DBManager& dbManager, int serviceId, int quantity) {
-    std::string query = "INSERT INTO booking_services (booking_id, service_id, quantity) VALUES (" +
-                        std::to_string(id) + ", " + std::to_string(serviceId) + ", " + std::to_string(quantity) +
-                        ") ON CONFLICT (booking_id, service_id) DO UPDATE SET quantity = " + std::to_string(quantity) + ";";
-    dbManager.executeUpdate(query);
+UpdateResult Booking::addService(DBManager& dbManager, int serviceId, int quantity) {
+    TraceSpan span("Booking::addService", "entity");
+    std::string query = "INSERT INTO booking_services (booking_id, service_id, quantity, booking_date_from) VALUES (" +
+                        std::to_string(id) + ", " + std::to_string(serviceId) + ", " + std::to_string(quantity) + ", '" + dateFrom +
+                        "') ON CONFLICT (booking_id, service_id, booking_date_from) DO UPDATE SET quantity = booking_services.quantity + EXCLUDED.quantity;";
+    return mutateServices(dbManager, query);
 }
 
 /**
- * @brief Удаляет услугу из данного бронирования в базе данных.
+ * @brief Удаляет услугу из данного бронирования в базе данных, если бронирование не изменилось с момента загрузки.
  * @param dbManager Менеджер базы данных для взаимодействия с БД.
  * @param serviceId Идентификатор услуги для удаления.
+ * @return Результат изменения.
  */
-void Booking::removeService(DBManager& dbManager, int serviceId) {
+UpdateResult Booking::removeService(DBManager& dbManager, int serviceId) {
+    TraceSpan span("Booking::removeService", "entity");
     std::string query = "DELETE FROM booking_services WHERE booking_id = " + std::to_string(id) + 
-                        " AND service_id = " + std::to_string(serviceId) + ";";
-    dbManager.executeUpdate(query);
+                        " AND service_id = " + std::to_string(serviceId) + " AND booking_date_from = '" + dateFrom + "';";
+    return mutateServices(dbManager, query);
 }
 
 /**
- * @brief Обновляет статус данного бронирования в базе данных.
+ * @brief Обновляет статус данного бронирования в базе данных, если бронирование не изменилось с момента загрузки.
+ * Статус и версия объекта меняются только при успешном изменении.
  * @param dbManager Менеджер базы данных для взаимодействия с БД.
  * @param newStatus Новый статус для установки.
+ * @return Результат изменения.
  */
-void Booking::updateStatus(DBManager& dbManager, BookingStatus newStatus) {
+UpdateResult Booking::updateStatus(DBManager& dbManager, BookingStatus newStatus) {
+    TraceSpan span("Booking::updateStatus", "entity");
+    std::string query = "UPDATE bookings SET status = '" + statusToString(newStatus) + "', version = version + 1 WHERE id = " +
+                        std::to_string(id) + " AND date_from = '" + dateFrom + "' AND version = " + std::to_string(version) + ";";
+    if (dbManager.executeUpdate(query) == 0) {
+        return classifyMiss(dbManager);
+    }
+    AuditJournal::note(AuditAction::STATUS_CHANGE, id, statusToString(status) + "->" + statusToString(newStatus));
     this->status = newStatus;
-    std::string query = "UPDATE bookings SET status = '" + getStatusString() + "' WHERE id = " + std::to_string(id) + ";";
-    dbManager.executeUpdate(query);
+    ++version;
+    return UpdateResult::OK;
+}
+
+/**
+ * @brief Определяет причину неудачного изменения с проверкой версии.
+ * @param dbManager Менеджер базы данных для взаимодействия с БД.
+ * @return UpdateResult::NOT_FOUND, если бронирование удалено, иначе UpdateResult::CONFLICT.
+ */
+UpdateResult Booking::classifyMiss(DBManager& dbManager) const {
+    TraceSpan span("Booking::classifyMiss", "entity");
+    static MetricCounter& conflicts = MetricsRegistry::global().counter(
+        "hotel_booking_version_conflicts_total", "Booking updates rejected by the optimistic version check.");
+    PGResultWrapper result = dbManager.executeQuery("SELECT 1 FROM bookings WHERE id = " + std::to_string(id) + ";");
+    if (PQntuples(result.get()) == 0) {
+        return UpdateResult::NOT_FOUND;
+    }
+    conflicts.increment();
+    return UpdateResult::CONFLICT;
+}
+
+/**
+ * @brief Выполняет изменение услуг бронирования в транзакции вместе с проверкой и увеличением версии.
+ * Если версия бронирования изменилась, транзакция откатывается и изменение не применяется.
+ * @param dbManager Менеджер базы данных для взаимодействия с БД.
+ * @param statement SQL-запрос изменения booking_services.
+ * @return Результат изменения.
+ */
+UpdateResult Booking::mutateServices(DBManager& dbManager, const std::string& statement) {
+    TraceSpan span("Booking::mutateServices", "entity");
+    dbManager.beginTransaction();
+    try {
+        int bumped = dbManager.executeUpdate("UPDATE bookings SET version = version + 1 WHERE id = " + std::to_string(id) +
+                                             " AND date_from = '" + dateFrom + "' AND version = " + std::to_string(version) + ";");
+        if (bumped == 0) {
+            dbManager.rollback();
+            return classifyMiss(dbManager);
+        }
+        dbManager.executeUpdate(statement);
+        dbManager.commit();
+    } catch (const std::exception&) {
+        dbManager.rollback();
+        throw;
+    }
+    ++version;
+    return UpdateResult::OK;
+}
+
+/**
+ * @brief Обновляет статус группы бронирований одним запросом.
+ * Прежний статус каждой строки читается под FOR UPDATE в том же запросе, и каждая смена записывается
+ * в журнал аудита, как в updateStatus.
+ * @param dbManager Менеджер базы данных для взаимодействия с БД.
+ * @param ids Идентификаторы бронирований.
+ * @param newStatus Новый статус для установки.
+ * @return Количество обновленных бронирований.
+ */
+int Booking::updateStatuses(DBManager& dbManager, const std::vector<int>& ids, BookingStatus newStatus) {
+    TraceSpan span("Booking::updateStatuses", "entity");
+    if (ids.empty()) {
+        return 0;
+    }
+    std::string idList;
+    for (int id : ids) {
+        if (!idList.empty()) idList += ',';
+        idList += std::to_string(id);
+    }
+    std::string status = statusToString(newStatus);
+    std::string query = "UPDATE bookings b SET status = '" + status + "', version = b.version + 1 "
+                        "FROM (SELECT id, date_from, status FROM bookings WHERE id = ANY('{" + idList + "}'::int[]) FOR UPDATE) old "
+                        "WHERE b.id = old.id AND b.date_from = old.date_from RETURNING b.id, old.status;";
+    PGResultWrapper result = dbManager.executeQuery(query);
+    int updated = PQntuples(result.get());
+    for (int i = 0; i < updated; ++i) {
+        AuditJournal::note(AuditAction::STATUS_CHANGE, std::atoi(PQgetvalue(result.get(), i, 0)),
+                           std::string(PQgetvalue(result.get(), i, 1)) + "->" + status);
+    }
+    return updated;
+}
+
+/**
+ * @brief Применяет правило массовой смены статуса одним запросом.
+ * Строки, заблокированные другими транзакциями, пропускаются (FOR UPDATE SKIP LOCKED),
+ * чтобы пакетная обработка не ждала интерактивных изменений. Каждая смена записывается в журнал аудита.
+ * @param dbManager Менеджер базы данных для взаимодействия с БД.
+ * @param transition Правило смены статуса.
+ * @param limit Максимальное количество обновляемых строк (0 - без ограничения).
+ * @return Количество обновленных бронирований.
+ */
+int Booking::applyTransition(DBManager& dbManager, const StatusTransition& transition, int limit) {
+    TraceSpan span("Booking::applyTransition", "entity");
+    std::string column = transition.dateField == BookingDateField::DATE_FROM ? "date_from" : "date_to";
+    std::string query = "UPDATE bookings SET status = '" + statusToString(transition.to) +
+                        "', version = version + 1 WHERE id IN (SELECT id FROM bookings WHERE status = '" + statusToString(transition.from) +
+                        "' AND " + column + " < '" + transition.before + "' ORDER BY id" +
+                        (limit > 0 ? " LIMIT " + std::to_string(limit) : std::string()) +
+                        " FOR UPDATE SKIP LOCKED) RETURNING id;";
+    PGResultWrapper result = dbManager.executeQuery(query);
+    int updated = PQntuples(result.get());
+    std::string change = statusToString(transition.from) + "->" + statusToString(transition.to);
+    for (int i = 0; i < updated; ++i) {
+        AuditJournal::note(AuditAction::STATUS_CHANGE, std::atoi(PQgetvalue(result.get(), i, 0)), change);
+    }
+    return updated;
 }
 
 /**
@@ -141,8 +279,9 @@ void Booking::updateStatus(DBManager& dbManager, BookingStatus newStatus) {
  * @return Уникальный указатель на объект Booking, если бронирование найдено, иначе nullptr.
  */
 std::unique_ptr<Booking> Booking::findBookingById(DBManager& dbManager, int id) {
-    std::string query = "SELECT user_id, room_id, date_from, date_to, status FROM bookings WHERE id = " + std::to_string(id) + ";";
-    PGResultWrapper result = dbManager.executeQuery(query);
+    TraceSpan span("Booking::findBookingById", "entity");
+    std::string query = "SELECT user_id, room_id, date_from, date_to, status, version FROM bookings WHERE id = " + std::to_string(id) + ";";
+    PGResultWrapper result = dbManager.executeRead(query);
     if (PQntuples(result.get()) == 1) {
         auto booking = std::make_unique<Booking>(
             id,
@@ -150,7 +289,8 @@ std::unique_ptr<Booking> Booking::findBookingById(DBManager& dbManager, int id)
             std::stoi(PQgetvalue(result.get(), 0, 1)),
             PQgetvalue(result.get(), 0, 2),
             PQgetvalue(result.get(), 0, 3),
-            toBookingStatus(PQgetvalue(result.get(), 0, 4))
+            toBookingStatus(PQgetvalue(result.get(), 0, 4)),
+            std::stoi(PQgetvalue(result.get(), 0, 5))
         );
         return booking;
     }
@@ -163,19 +303,83 @@ std::unique_ptr<Booking> Booking::findBookingById(DBManager& dbManager, int id)
  * @return Вектор объектов Booking, представляющих все бронирования.
  */
 std::vector<Booking> Booking::getAllBookings(DBManager& dbManager) {
+    TraceSpan span("Booking::getAllBookings", "entity");
     std::vector<Booking> bookings;
-    std::string query = "SELECT id, user_id, room_id, date_from, date_to, status FROM bookings;";
-    PGResultWrapper result = dbManager.executeQuery(query);
-    for (int i = 0; i < PQntuples(result.get()); i++) {
+    std::string query = "SELECT id, user_id, room_id, date_from, date_to, status, version FROM bookings;";
+    PGResultWrapper result = dbManager.executeRead(query);
+    appendRows(result.get(), bookings);
+    return bookings;
+}
+
+/**
+ * @brief Добавляет бронирования из результата запроса со столбцами
+ *        id, user_id, room_id, date_from, date_to, status, version.
+ * @param result Результат запроса.
+ * @param bookings Вектор, в конец которого добавляются бронирования.
+ */
+void Booking::appendRows(const PGresult* result, std::vector<Booking>& bookings) {
+    int rows = PQntuples(result);
+    bookings.reserve(bookings.size() + static_cast<std::size_t>(rows));
+    for (int i = 0; i < rows; i++) {
         bookings.emplace_back(
-            std::stoi(PQgetvalue(result.get(), i, 0)),
-            std::stoi(PQgetvalue(result.get(), i, 1)),
-            std::stoi(PQgetvalue(result.get(), i, 2)),
-            PQgetvalue(result.get(), i, 3),
-            PQgetvalue(result.get(), i, 4),
-            toBookingStatus(PQgetvalue(result.get(), i, 5))
+            std::stoi(PQgetvalue(result, i, 0)),
+            std::stoi(PQgetvalue(result, i, 1)),
+            std::stoi(PQgetvalue(result, i, 2)),
+            PQgetvalue(result, i, 3),
+            PQgetvalue(result, i, 4),
+            toBookingStatus(PQgetvalue(result, i, 5)),
+            std::stoi(PQgetvalue(result, i, 6))
         );
     }
+}
+
+/**
+ * @brief Получает список всех бронирований параллельным чтением в одном снимке данных.
+ * Диапазоны идентификаторов читаются разными соединениями; результаты склеиваются по порядку.
+ * @param scan Параллельное чтение.
+ * @return Вектор бронирований по возрастанию идентификатора.
+ */
+std::vector<Booking> Booking::getAllBookings(SnapshotScan& scan) {
+    TraceSpan span("Booking::getAllBookings", "entity");
+    std::vector<PGResultWrapper> parts = scan.run("SELECT min(id), max(id) FROM bookings;", [](const ScanRange& range) {
+        return "SELECT id, user_id, room_id, date_from, date_to, status, version FROM bookings WHERE id >= " +
+               std::to_string(range.lower) + " AND id < " + std::to_string(range.upper) + " ORDER BY id;";
+    });
+    std::size_t total = 0;
+    for (const auto& part : parts) {
+        total += static_cast<std::size_t>(PQntuples(part.get()));
+    }
+    std::vector<Booking> bookings;
+    bookings.reserve(total);
+    for (const auto& part : parts) {
+        appendRows(part.get(), bookings);
+    }
+    return bookings;
+}
+
+/**
+ * @brief Получает список всех бронирований, размещая вектор и строковые поля в арене.
+ * @param dbManager Менеджер базы данных для взаимодействия с БД.
+ * @param arena Арена, в которой размещаются вектор и строки результата.
+ * @return Вектор строк бронирований в памяти арены.
+ */
+std::pmr::vector<BookingRow> Booking::getAllBookings(DBManager& dbManager, QueryArena& arena) {
+    TraceSpan span("Booking::getAllBookings", "entity");
+    std::pmr::vector<BookingRow> bookings(arena.resource());
+    std::string query = "SELECT id, user_id, room_id, date_from, date_to, status FROM bookings;";
+    PGResultWrapper result = dbManager.executeRead(query);
+    int numRows = PQntuples(result.get());
+    bookings.reserve(numRows);
+    for (int i = 0; i < numRows; i++) {
+        bookings.push_back(BookingRow{
+            std::atoi(PQgetvalue(result.get(), i, 0)),
+            std::atoi(PQgetvalue(result.get(), i, 1)),
+            std::atoi(PQgetvalue(result.get(), i, 2)),
+            arena.copy(std::string_view(PQgetvalue(result.get(), i, 3), PQgetlength(result.get(), i, 3))),
+            arena.copy(std::string_view(PQgetvalue(result.get(), i, 4), PQgetlength(result.get(), i, 4))),
+            toBookingStatus(PQgetvalue(result.get(), i, 5))
+        });
+    }
     return bookings;
 }
 
@@ -186,9 +390,10 @@ std::vector<Booking> Booking::getAllBookings(DBManager& dbManager) {
  * @return Вектор объектов Booking, связанных с указанным пользователем.
  */
 std::vector<Booking> Booking::findBookingsByUserId(DBManager& dbManager, int userId) {
+    TraceSpan span("Booking::findBookingsByUserId", "entity");
     std::vector<Booking> bookings;
-    std::string query = "SELECT id, room_id, date_from, date_to, status FROM bookings WHERE user_id = " + std::to_string(userId) + ";";
-    PGResultWrapper result = dbManager.executeQuery(query);
+    std::string query = "SELECT id, room_id, date_from, date_to, status, version FROM bookings WHERE user_id = " + std::to_string(userId) + ";";
+    PGResultWrapper result = dbManager.executeRead(query);
     for (int i = 0; i < PQntuples(result.get()); i++) {
         bookings.emplace_back(
             std::stoi(PQgetvalue(result.get(), i, 0)),
@@ -196,7 +401,8 @@ std::vector<Booking> Booking::findBookingsByUserId(DBManager& dbManager, int use
             std::stoi(PQgetvalue(result.get(), i, 1)),
             PQgetvalue(result.get(), i, 2),
             PQgetvalue(result.get(), i, 3),
-            toBookingStatus(PQgetvalue(result.get(), i, 4))
+            toBookingStatus(PQgetvalue(result.get(), i, 4)),
+            std::stoi(PQgetvalue(result.get(), i, 5))
         );
     }
     return bookings;
@@ -205,6 +411,7 @@ std::vector<Booking> Booking::findBookingsByUserId(DBManager& dbManager, int use
 /**
  * @brief Проверяет доступность номера на указанные даты.
  * Номер считается недоступным, если существует бронирование (не отмененное), которое пересекается с желаемым диапазоном дат.
+ * Условие date_from <= dateTo следует из OVERLAPS, но позволяет планировщику не читать секции более поздних месяцев.
  * @param dbManager Менеджер базы данных для взаимодействия с БД.
  * @param roomId Идентификатор номера для проверки.
  * @param dateFrom Дата начала проверки доступности.
@@ -212,9 +419,11 @@ std::vector<Booking> Booking::findBookingsByUserId(DBManager& dbManager, int use
  * @return True, если номер доступен, иначе false.
  */
 bool Booking::isRoomAvailable(DBManager& dbManager, int roomId, const std::string& dateFrom, const std::string& dateTo) {
+    TraceSpan span("Booking::isRoomAvailable", "entity");
     std::string query = "SELECT COUNT(*) FROM bookings WHERE room_id = " + std::to_string(roomId) +
-                        " AND status <> 'cancelled' AND (date_from, date_to) OVERLAPS ('" + dateFrom + "', '" + dateTo + "');";
-    PGResultWrapper result = dbManager.executeQuery(query);
+                        " AND status <> 'cancelled' AND date_from <= '" + dateTo + "'" +
+                        " AND (date_from, date_to) OVERLAPS ('" + dateFrom + "', '" + dateTo + "');";
+    PGResultWrapper result = dbManager.executeRead(query);
     bool isAvailable = (std::stoi(PQgetvalue(result.get(), 0, 0)) == 0);
     return isAvailable; 
 }
@@ -229,15 +438,78 @@ bool Booking::isRoomAvailable(DBManager& dbManager, int roomId, const std::strin
  * @return Уникальный указатель на созданный объект Booking, если бронирование успешно создано, иначе nullptr.
  */
 std::unique_ptr<Booking> Booking::createBooking(DBManager& dbManager, int userId, int roomId, const std::string& dateFrom, const std::string& dateTo) {
-    if (!isRoomAvailable(dbManager, roomId, dateFrom, dateTo)) {
-        return nullptr; 
+    TraceSpan span("Booking::createBooking", "entity");
+    return createBookingIfFree(dbManager, userId, roomId, dateFrom, dateTo);
+}
+
+/**
+ * @brief Создает бронирование, если номер свободен, сериализуя создание бронирований одного номера.
+ * Транзакция сначала берет блокировку pg_advisory_xact_lock(room_id), затем выполняет
+ * INSERT ... WHERE NOT EXISTS с условием занятости как в isRoomAvailable. Снимок вставки берется уже
+ * под блокировкой, поэтому он видит бронирования, зафиксированные предыдущим владельцем блокировки,
+ * и два соединения (любых процессов) не могут одновременно забронировать пересекающиеся даты.
+ * Ограничение исключения здесь невозможно: bookings секционирована по date_from.
+ * @param dbManager Менеджер базы данных для взаимодействия с БД.
+ * @param userId Идентификатор пользователя.
+ * @param roomId Идентификатор номера.
+ * @param dateFrom Дата начала бронирования.
+ * @param dateTo Дата окончания бронирования.
+ * @return Созданное бронирование или nullptr, если номер занят или не существует.
+ */
+std::unique_ptr<Booking> Booking::createBookingIfFree(DBManager& dbManager, int userId, int roomId, const std::string& dateFrom,
+                                                      const std::string& dateTo) {
+    TraceSpan span("Booking::createBookingIfFree", "entity");
+    static MetricCounter& created = MetricsRegistry::global().counter(
+        "hotel_bookings_created_total", "Bookings created.");
+    static MetricCounter& rejected = MetricsRegistry::global().counter(
+        "hotel_booking_rejections_total", "Booking requests rejected because the room was not available.");
+    std::string room = std::to_string(roomId);
+    std::string insert = "INSERT INTO bookings (user_id, room_id, property_id, date_from, date_to, status) SELECT " +
+                        std::to_string(userId) + ", r.id, r.property_id, '" + dateFrom + "', '" + dateTo + "', 'pending' "
+                        "FROM rooms r WHERE r.id = " + room + " AND NOT EXISTS (SELECT 1 FROM bookings WHERE room_id = " + room +
+                        " AND status <> 'cancelled' AND date_from <= '" + dateTo + "'" +
+                        " AND (date_from, date_to) OVERLAPS ('" + dateFrom + "', '" + dateTo + "')) RETURNING id, version;";
+    PGResultWrapper result(nullptr);
+    dbManager.beginTransaction();
+    try {
+        dbManager.executeQuery("SELECT pg_advisory_xact_lock(" + room + ");");
+        result = dbManager.executeQuery(insert);
+        dbManager.commit();
+    } catch (const std::exception&) {
+        dbManager.rollback();
+        throw;
     }
-    std::string query = "INSERT INTO bookings (user_id, room_id, date_from, date_to, status) VALUES (" +
-                        std::to_string(userId) + ", " + std::to_string(roomId) + ", '" + dateFrom + "', '" + dateTo + "', 'pending') RETURNING id;";
-    PGResultWrapper result = dbManager.executeQuery(query);
-    if (PQntuples(result.get()) == 1) {
-        int newId = std::stoi(PQgetvalue(result.get(), 0, 0));
-        return findBookingById(dbManager, newId); 
+    if (PQntuples(result.get()) != 1) {
+        rejected.increment();
+        return nullptr;
     }
-    return nullptr; 
-} 
\ No newline at end of file
+    created.increment();
+    return std::make_unique<Booking>(std::stoi(PQgetvalue(result.get(), 0, 0)), userId, roomId, dateFrom, dateTo,
+                                     BookingStatus::PENDING, std::stoi(PQgetvalue(result.get(), 0, 1)));
+}
+
+/**
+ * @brief Возвращает сводку бронирований по отелям базы данных за период.
+ * Ночи и стоимость считаются по цене номера; отмененные бронирования не учитываются.
+ * @param dbManager Менеджер базы данных для взаимодействия с БД.
+ * @param dateFrom Начало периода (дата заезда, включительно).
+ * @param dateTo Конец периода (не включительно).
+ * @return Строки по возрастанию идентификатора отеля.
+ */
+std::vector<PropertyStats> Booking::propertyStats(DBManager& dbManager, const std::string& dateFrom, const std::string& dateTo) {
+    TraceSpan span("Booking::propertyStats", "entity");
+    std::string query = "SELECT b.property_id, COUNT(*), COALESCE(SUM(b.date_to - b.date_from), 0), "
+                        "COALESCE(SUM((b.date_to - b.date_from) * r.price_per_day), 0) "
+                        "FROM bookings b JOIN rooms r ON r.id = b.room_id WHERE b.status <> 'cancelled' "
+                        "AND b.date_from >= '" + dateFrom + "' AND b.date_from < '" + dateTo + "' "
+                        "GROUP BY b.property_id ORDER BY b.property_id;";
+    PGResultWrapper result = dbManager.executeRead(query);
+    std::vector<PropertyStats> stats(PQntuples(result.get()));
+    for (int i = 0; i < PQntuples(result.get()); ++i) {
+        stats[i].propertyId = std::stoi(PQgetvalue(result.get(), i, 0));
+        stats[i].bookings = std::stoi(PQgetvalue(result.get(), i, 1));
+        stats[i].nights = std::stoll(PQgetvalue(result.get(), i, 2));
+        stats[i].revenue = std::stod(PQgetvalue(result.get(), i, 3));
+    }
+    return stats;
+}
@@ -10,10 +10,18 @@
 #include <vector>
 #include <map>
 #include <memory>
+#include <memory_resource>
+#include <string_view>
 #include "DBManager.h"
+#include "QueryArena.h"
+#include "OptimisticLock.h"
 #include "User.h"
 #include "Room.h"
 #include "Service.h"
+#include "Task.h"
+
+class AsyncDBManager;
+class SnapshotScan;
 
 /**
  * @brief Перечисление, определяющее возможные статусы бронирования.
@@ -25,6 +33,48 @@ enum class BookingStatus {
     COMPLETED
 };
 
+/**
+ * @brief Поле даты бронирования, по которому отбираются бронирования при массовой смене статуса.
+ */
+enum class BookingDateField {
+    DATE_FROM,
+    DATE_TO
+};
+
+/**
+ * @brief Правило массовой смены статуса: бронирования со статусом from,
+ * у которых поле dateField строго меньше before, переводятся в статус to.
+ */
+struct StatusTransition {
+    BookingStatus from;
+    BookingStatus to;
+    BookingDateField dateField;
+    std::string before;
+};
+
+/**
+ * @brief Строка результата запроса бронирований, размещенная в QueryArena.
+ * Строковые поля ссылаются на память арены и действительны до ее уничтожения.
+ */
+struct BookingRow {
+    int id;
+    int userId;
+    int roomId;
+    std::string_view dateFrom;
+    std::string_view dateTo;
+    BookingStatus status;
+};
+
+/**
+ * @brief Сводка бронирований одного отеля за период (отчет по сети, см. ShardRouter).
+ */
+struct PropertyStats {
+    int propertyId = 0;
+    int bookings = 0;           ///< Неотмененных бронирований с заездом в периоде.
+    long long nights = 0;       ///< Суммарное количество ночей.
+    double revenue = 0.0;       ///< Стоимость проживания (без услуг).
+};
+
 /**
  * @brief Класс Booking представляет собой запись о бронировании номера в отеле.
  * Он содержит информацию о бронировании, такую как пользователь, номер, даты,
@@ -38,6 +88,22 @@ private:
     std::string dateFrom;
     std::string dateTo;
     BookingStatus status;
+    int version;    ///< Версия строки для оптимистичной блокировки.
+
+    /**
+     * @brief Определяет причину неудачного изменения с проверкой версии.
+     * @param dbManager Менеджер базы данных для взаимодействия с БД.
+     * @return UpdateResult::NOT_FOUND, если бронирование удалено, иначе UpdateResult::CONFLICT.
+     */
+    UpdateResult classifyMiss(DBManager& dbManager) const;
+
+    /**
+     * @brief Выполняет изменение услуг бронирования в транзакции вместе с проверкой и увеличением версии.
+     * @param dbManager Менеджер базы данных для взаимодействия с БД.
+     * @param statement SQL-запрос изменения booking_services.
+     * @return Результат изменения.
+     */
+    UpdateResult mutateServices(DBManager& dbManager, const std::string& statement);
 
 public:
     /**
@@ -48,9 +114,10 @@ public:
      * @param dateFrom Дата начала бронирования.
      * @param dateTo Дата окончания бронирования.
      * @param status Статус бронирования.
+     * @param version Версия строки в базе данных.
      */
     Booking(int id, int userId, int roomId, const std::string& dateFrom, 
-            const std::string& dateTo, BookingStatus status);
+            const std::string& dateTo, BookingStatus status, int version = 0);
     
     /**
      * @brief Возвращает идентификатор бронирования.
@@ -74,13 +141,13 @@ public:
      * @brief Возвращает дату начала бронирования.
      * @return Строка с датой начала бронирования.
      */
-    std::string getDateFrom() const;
+    const std::string& getDateFrom() const;
 
     /**
      * @brief Возвращает дату окончания бронирования.
      * @return Строка с датой окончания бронирования.
      */
-    std::string getDateTo() const;
+    const std::string& getDateTo() const;
 
     /**
      * @brief Возвращает текущий статус бронирования.
@@ -88,11 +155,24 @@ public:
      */
     BookingStatus getStatus() const;
 
+    /**
+     * @brief Возвращает версию бронирования, с которой был загружен объект.
+     * @return Версия строки.
+     */
+    int getVersion() const;
+
     /**
      * @brief Возвращает строковое представление текущего статуса бронирования.
      * @return Строка, представляющая статус бронирования.
      */
     std::string getStatusString() const;
+
+    /**
+     * @brief Возвращает строковое представление статуса бронирования.
+     * @param status Статус бронирования.
+     * @return Строка, представляющая статус бронирования.
+     */
+    static std::string statusToString(BookingStatus status);
     
     /**
      * @brief Получает все услуги, связанные с данным бронированием, из базы данных.
@@ -102,26 +182,50 @@ public:
     std::map<int, int> getServices(DBManager& dbManager);
 
     /**
-     * @brief Добавляет услугу к данному бронированию в базе данных.
+     * @brief Добавляет услугу к данному бронированию в базе данных, если бронирование не изменилось с момента загрузки.
+     * Если услуга уже есть в бронировании, количество увеличивается.
      * @param dbManager Менеджер базы данных для взаимодействия с БД.
      * @param serviceId Идентификатор услуги для добавления.
      * @param quantity Количество добавляемой услуги.
+     * @return Результат изменения.
      */
-    void addService(DBManager& dbManager, int serviceId, int quantity);
+    UpdateResult addService(DBManager& dbManager, int serviceId, int quantity);
 
     /**
-     * @brief Удаляет услугу из данного бронирования в базе данных.
+     * @brief Удаляет услугу из данного бронирования в базе данных, если бронирование не изменилось с момента загрузки.
      * @param dbManager Менеджер базы данных для взаимодействия с БД.
      * @param serviceId Идентификатор услуги для удаления.
+     * @return Результат изменения.
      */
-    void removeService(DBManager& dbManager, int serviceId);
+    UpdateResult removeService(DBManager& dbManager, int serviceId);
     
     /**
-     * @brief Обновляет статус данного бронирования в базе данных.
+     * @brief Обновляет статус данного бронирования в базе данных, если бронирование не изменилось с момента загрузки.
      * @param dbManager Менеджер базы данных для взаимодействия с БД.
      * @param newStatus Новый статус для установки.
+     * @return Результат изменения.
      */
-    void updateStatus(DBManager& dbManager, BookingStatus newStatus);
+    UpdateResult updateStatus(DBManager& dbManager, BookingStatus newStatus);
+
+    /**
+     * @brief Обновляет статус группы бронирований одним запросом; каждая смена пишется в журнал аудита.
+     * @param dbManager Менеджер базы данных для взаимодействия с БД.
+     * @param ids Идентификаторы бронирований.
+     * @param newStatus Новый статус для установки.
+     * @return Количество обновленных бронирований.
+     */
+    static int updateStatuses(DBManager& dbManager, const std::vector<int>& ids, BookingStatus newStatus);
+
+    /**
+     * @brief Применяет правило массовой смены статуса одним запросом.
+     * Строки, заблокированные другими транзакциями, пропускаются (FOR UPDATE SKIP LOCKED); каждая смена
+     * пишется в журнал аудита.
+     * @param dbManager Менеджер базы данных для взаимодействия с БД.
+     * @param transition Правило смены статуса.
+     * @param limit Максимальное количество обновляемых строк (0 - без ограничения).
+     * @return Количество обновленных бронирований.
+     */
+    static int applyTransition(DBManager& dbManager, const StatusTransition& transition, int limit = 0);
     
     /**
      * @brief Находит бронирование по его идентификатору в базе данных.
@@ -131,6 +235,14 @@ public:
      */
     static std::unique_ptr<Booking> findBookingById(DBManager& dbManager, int id);
 
+    /**
+     * @brief Добавляет бронирования из результата запроса со столбцами
+     *        id, user_id, room_id, date_from, date_to, status, version.
+     * @param result Результат запроса.
+     * @param bookings Вектор, в конец которого добавляются бронирования.
+     */
+    static void appendRows(const PGresult* result, std::vector<Booking>& bookings);
+
     /**
      * @brief Получает список всех бронирований из базы данных.
      * @param dbManager Менеджер базы данных для взаимодействия с БД.
@@ -138,6 +250,21 @@ public:
      */
     static std::vector<Booking> getAllBookings(DBManager& dbManager);
 
+    /**
+     * @brief Получает список всех бронирований, размещая результат в арене.
+     * @param dbManager Менеджер базы данных для взаимодействия с БД.
+     * @param arena Арена, в которой размещаются вектор и строки результата.
+     * @return Вектор строк бронирований в памяти арены.
+     */
+    static std::pmr::vector<BookingRow> getAllBookings(DBManager& dbManager, QueryArena& arena);
+
+    /**
+     * @brief Получает список всех бронирований параллельным чтением в одном снимке данных.
+     * @param scan Параллельное чтение.
+     * @return Вектор бронирований по возрастанию идентификатора.
+     */
+    static std::vector<Booking> getAllBookings(SnapshotScan& scan);
+
     /**
      * @brief Находит бронирования по идентификатору пользователя в базе данных.
      * @param dbManager Менеджер базы данных для взаимодействия с БД.
@@ -166,4 +293,50 @@ public:
      * @return Уникальный указатель на созданный объект Booking, если бронирование успешно создано, иначе nullptr.
      */
     static std::unique_ptr<Booking> createBooking(DBManager& dbManager, int userId, int roomId, const std::string& dateFrom, const std::string& dateTo);
+
+    /**
+     * @brief Создает бронирование, если номер свободен: INSERT ... WHERE NOT EXISTS в транзакции под
+     *        блокировкой pg_advisory_xact_lock(room_id), сериализующей создание бронирований номера.
+     * @param dbManager Менеджер базы данных для взаимодействия с БД.
+     * @param userId Идентификатор пользователя.
+     * @param roomId Идентификатор номера.
+     * @param dateFrom Дата начала бронирования.
+     * @param dateTo Дата окончания бронирования.
+     * @return Созданное бронирование или nullptr, если номер занят или не существует.
+     * @throw std::runtime_error Если запрос не выполнен.
+     */
+    static std::unique_ptr<Booking> createBookingIfFree(DBManager& dbManager, int userId, int roomId, const std::string& dateFrom,
+                                                        const std::string& dateTo);
+
+    /**
+     * @brief Возвращает сводку бронирований по отелям базы данных за период.
+     * @param dbManager Менеджер базы данных для взаимодействия с БД.
+     * @param dateFrom Начало периода (дата заезда, включительно).
+     * @param dateTo Конец периода (не включительно).
+     * @return Строки по возрастанию идентификатора отеля.
+     */
+    static std::vector<PropertyStats> propertyStats(DBManager& dbManager, const std::string& dateFrom, const std::string& dateTo);
+
+    /**
+     * @brief Асинхронно проверяет доступность номера на указанные даты.
+     * @param dbManager Асинхронное соединение с базой данных.
+     * @param roomId Идентификатор номера.
+     * @param dateFrom Дата начала.
+     * @param dateTo Дата окончания.
+     * @return Задача с результатом проверки.
+     */
+    static Task<bool> isRoomAvailableAsync(AsyncDBManager& dbManager, int roomId, std::string dateFrom, std::string dateTo);
+
+    /**
+     * @brief Асинхронно создает бронирование.
+     * Проверка доступности и вставка выполняются одним запросом INSERT ... WHERE NOT EXISTS.
+     * @param dbManager Асинхронное соединение с базой данных.
+     * @param userId Идентификатор пользователя.
+     * @param roomId Идентификатор номера.
+     * @param dateFrom Дата начала бронирования.
+     * @param dateTo Дата окончания бронирования.
+     * @return Задача с созданным бронированием или nullptr, если номер занят.
+     */
+    static Task<std::unique_ptr<Booking>> createBookingAsync(AsyncDBManager& dbManager, int userId, int roomId,
+                                                             std::string dateFrom, std::string dateTo);
 }; 
\ No newline at end of file
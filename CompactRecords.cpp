@@ -0,0 +1,176 @@
+/**
+ * @file CompactRecords.cpp
+ * @brief Этот файл содержит реализацию компактных таблиц номеров, услуг и пользователей.
+ */
+
+#include "CompactRecords.h"
+#include <cstdlib>
+#include <stdexcept>
+
+/**
+ * @brief Возвращает значение поля результата как std::string_view без копирования.
+ */
+static std::string_view fieldView(PGresult* result, int row, int column) {
+    return std::string_view(PQgetvalue(result, row, column), PQgetlength(result, row, column));
+}
+
+/**
+ * @brief Конструктор арены строк.
+ * @param blockSize Размер одного блока в байтах.
+ */
+StringArena::StringArena(std::size_t blockSize)
+    : blockSize(blockSize), used(blockSize), total(0) {}
+
+/**
+ * @brief Копирует строку в арену. Длинные строки получают отдельный блок.
+ * @param value Строка для сохранения.
+ * @return Представление сохраненной копии.
+ */
+std::string_view StringArena::store(std::string_view value) {
+    if (value.empty()) {
+        return std::string_view();
+    }
+    if (value.size() > blockSize / 4) {
+        // Длинная строка получает собственный блок, который вставляется перед текущим,
+        // чтобы не терять свободное место в текущем блоке.
+        auto block = std::make_unique<char[]>(value.size());
+        std::memcpy(block.get(), value.data(), value.size());
+        const char* dest = block.get();
+        blocks.insert(blocks.empty() ? blocks.end() : blocks.end() - 1, std::move(block));
+        total += value.size();
+        return std::string_view(dest, value.size());
+    }
+    if (used + value.size() > blockSize) {
+        blocks.push_back(std::make_unique<char[]>(blockSize));
+        used = 0;
+    }
+    char* dest = blocks.back().get() + used;
+    std::memcpy(dest, value.data(), value.size());
+    used += value.size();
+    total += value.size();
+    return std::string_view(dest, value.size());
+}
+
+/**
+ * @brief Возвращает идентификатор строки, добавляя ее в словарь при необходимости.
+ * @param name Строка.
+ * @return Идентификатор строки.
+ * @throw std::length_error Если словарь переполнен.
+ */
+std::uint16_t TypeDictionary::intern(std::string_view name) {
+    if (const std::uint16_t* id = ids.find(name)) {
+        return *id;
+    }
+    if (names.size() > UINT16_MAX) {
+        throw std::length_error("Type dictionary overflow");
+    }
+    std::uint16_t id = static_cast<std::uint16_t>(names.size());
+    names.emplace_back(name);
+    ids.insert(name, id);
+    return id;
+}
+
+/**
+ * @brief Добавляет номер в таблицу.
+ * @param id Идентификатор номера.
+ * @param number Номер комнаты.
+ * @param type Тип комнаты.
+ * @param pricePerDay Цена за номер в день.
+ * @param description Описание номера.
+ */
+void RoomTable::add(int id, std::string_view number, std::string_view type, double pricePerDay, std::string_view description) {
+    rooms.push_back(CompactRoom{id, types.intern(type), InlineString<13>(number), pricePerDay, arena.store(description)});
+}
+
+/**
+ * @brief Загружает все номера из базы данных напрямую из буфера результата, без промежуточных std::string.
+ * @param dbManager Менеджер базы данных для взаимодействия с БД.
+ * @return Таблица номеров.
+ * @throw std::runtime_error Если запрос не удался или номер комнаты длиннее InlineString<13>: таблица
+ *        загружается целиком или не загружается.
+ */
+RoomTable RoomTable::load(DBManager& dbManager) {
+    RoomTable table;
+    PGResultWrapper result = dbManager.executeQuery("SELECT id, number, type, price_per_day, description FROM rooms;");
+    int numRows = PQntuples(result.get());
+    table.reserve(numRows);
+    for (int i = 0; i < numRows; ++i) {
+        std::string_view number = fieldView(result.get(), i, 1);
+        if (number.size() > InlineString<13>::capacity()) {
+            throw std::runtime_error("Room " + std::string(PQgetvalue(result.get(), i, 0)) + " number '" +
+                                     std::string(number) + "' does not fit the compact room table");
+        }
+        table.add(std::atoi(PQgetvalue(result.get(), i, 0)),
+                  number,
+                  fieldView(result.get(), i, 2),
+                  std::atof(PQgetvalue(result.get(), i, 3)),
+                  fieldView(result.get(), i, 4));
+    }
+    return table;
+}
+
+/**
+ * @brief Добавляет услугу в таблицу.
+ * @param id Идентификатор услуги.
+ * @param name Название услуги.
+ * @param price Цена услуги.
+ */
+void ServiceTable::add(int id, std::string_view name, double price) {
+    services.push_back(CompactService{id, price, arena.store(name)});
+}
+
+/**
+ * @brief Загружает все услуги из базы данных.
+ * @param dbManager Менеджер базы данных для взаимодействия с БД.
+ * @return Таблица услуг.
+ * @throw std::runtime_error Если запрос не удался.
+ */
+ServiceTable ServiceTable::load(DBManager& dbManager) {
+    ServiceTable table;
+    PGResultWrapper result = dbManager.executeQuery("SELECT id, name, price FROM services;");
+    int numRows = PQntuples(result.get());
+    table.services.reserve(numRows);
+    for (int i = 0; i < numRows; ++i) {
+        table.add(std::atoi(PQgetvalue(result.get(), i, 0)),
+                  fieldView(result.get(), i, 1),
+                  std::atof(PQgetvalue(result.get(), i, 2)));
+    }
+    return table;
+}
+
+/**
+ * @brief Добавляет пользователя в таблицу.
+ * @param id Идентификатор пользователя.
+ * @param login Логин пользователя.
+ * @param role Роль пользователя.
+ */
+void UserTable::add(int id, std::string_view login, UserRole role) {
+    users.push_back(CompactUser{id, role, InlineString<31>(login)});
+}
+
+/**
+ * @brief Загружает всех пользователей из базы данных (без хэшей паролей).
+ * @param dbManager Менеджер базы данных для взаимодействия с БД.
+ * @return Таблица пользователей.
+ * @throw std::runtime_error Если запрос не удался или логин длиннее InlineString<31>.
+ */
+UserTable UserTable::load(DBManager& dbManager) {
+    UserTable table;
+    PGResultWrapper result = dbManager.executeQuery("SELECT id, login, role FROM users;");
+    int numRows = PQntuples(result.get());
+    table.users.reserve(numRows);
+    for (int i = 0; i < numRows; ++i) {
+        std::string_view login = fieldView(result.get(), i, 1);
+        if (login.size() > InlineString<31>::capacity()) {
+            throw std::runtime_error("User " + std::string(PQgetvalue(result.get(), i, 0)) + " login '" +
+                                     std::string(login) + "' does not fit the compact user table");
+        }
+        std::string_view roleStr = fieldView(result.get(), i, 2);
+        UserRole role;
+        if (roleStr == "admin") role = UserRole::ADMIN;
+        else if (roleStr == "manager") role = UserRole::MANAGER;
+        else role = UserRole::USER;
+        table.add(std::atoi(PQgetvalue(result.get(), i, 0)), login, role);
+    }
+    return table;
+}
@@ -0,0 +1,293 @@
+/**
+ * @file CompactRecords.h
+ * @brief Этот файл содержит компактные представления номеров, услуг и пользователей
+ *        для массовой загрузки и обхода (десятки и сотни тысяч записей) без выделения памяти
+ *        под каждое строковое поле.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "DBManager.h"
+#include "FlatHashIndex.h"
+#include "User.h"
+
+/**
+ * @brief Строка фиксированной емкости, хранящаяся непосредственно внутри записи.
+ * @tparam N Максимальная длина строки в байтах (не более 255).
+ */
+template <std::size_t N>
+class InlineString {
+    static_assert(N < 256, "InlineString length is stored in one byte");
+
+private:
+    char data[N];
+    std::uint8_t length;
+
+public:
+    /**
+     * @brief Конструирует пустую строку.
+     */
+    InlineString() : data{}, length(0) {}
+
+    /**
+     * @brief Конструирует строку из значения.
+     * @param value Значение.
+     * @throw std::length_error Если значение длиннее N байт.
+     */
+    explicit InlineString(std::string_view value) : data{}, length(0) { assign(value); }
+
+    /**
+     * @brief Присваивает новое значение.
+     * @param value Значение.
+     * @throw std::length_error Если значение длиннее N байт.
+     */
+    void assign(std::string_view value) {
+        if (value.size() > N) {
+            throw std::length_error("Value '" + std::string(value) + "' exceeds inline capacity of " + std::to_string(N));
+        }
+        std::memcpy(data, value.data(), value.size());
+        length = static_cast<std::uint8_t>(value.size());
+    }
+
+    /**
+     * @brief Возвращает представление строки.
+     * @return Представление строки, действительное, пока жива запись.
+     */
+    std::string_view view() const { return std::string_view(data, length); }
+
+    /**
+     * @brief Возвращает максимальную емкость строки.
+     */
+    static constexpr std::size_t capacity() { return N; }
+};
+
+/**
+ * @brief Общая арена для длинных строк (описания, названия услуг).
+ * Строки копируются в крупные блоки; возвращаемые представления остаются действительными
+ * все время жизни арены, так как блоки никогда не перемещаются.
+ */
+class StringArena {
+private:
+    std::vector<std::unique_ptr<char[]>> blocks;
+    std::size_t blockSize;
+    std::size_t used;       ///< Занято байт в последнем блоке.
+    std::size_t total;      ///< Всего сохранено байт.
+
+public:
+    /**
+     * @brief Конструирует пустую арену.
+     * @param blockSize Размер одного блока в байтах.
+     */
+    explicit StringArena(std::size_t blockSize = 64 * 1024);
+
+    StringArena(const StringArena&) = delete;
+    StringArena& operator=(const StringArena&) = delete;
+    StringArena(StringArena&&) = default;
+    StringArena& operator=(StringArena&&) = default;
+
+    /**
+     * @brief Копирует строку в арену.
+     * @param value Строка для сохранения.
+     * @return Представление сохраненной копии.
+     */
+    std::string_view store(std::string_view value);
+
+    /**
+     * @brief Возвращает количество сохраненных байт.
+     */
+    std::size_t bytesStored() const { return total; }
+
+    /**
+     * @brief Возвращает количество выделенных блоков.
+     */
+    std::size_t blockCount() const { return blocks.size(); }
+};
+
+/**
+ * @brief Словарь для кодирования повторяющихся строк (типов номеров) небольшими целыми числами.
+ */
+class TypeDictionary {
+private:
+    std::deque<std::string> names;   ///< deque не перемещает строки при росте, поэтому name() не устаревает.
+    FlatHashIndex<std::uint16_t> ids;
+
+public:
+    /**
+     * @brief Возвращает идентификатор строки, добавляя ее в словарь при необходимости.
+     * @param name Строка.
+     * @return Идентификатор строки.
+     * @throw std::length_error Если словарь переполнен.
+     */
+    std::uint16_t intern(std::string_view name);
+
+    /**
+     * @brief Возвращает строку по идентификатору.
+     * @param id Идентификатор.
+     * @return Представление строки, действительное все время жизни словаря.
+     */
+    std::string_view name(std::uint16_t id) const { return names[id]; }
+
+    /**
+     * @brief Возвращает количество различных строк в словаре.
+     */
+    std::size_t size() const { return names.size(); }
+};
+
+/**
+ * @brief Компактная запись номера.
+ */
+struct CompactRoom {
+    std::int32_t id;
+    std::uint16_t typeId;           ///< Идентификатор типа в TypeDictionary таблицы.
+    InlineString<13> number;
+    double pricePerDay;
+    std::string_view description;   ///< Текст описания в арене таблицы.
+};
+
+/**
+ * @brief Компактная запись услуги.
+ */
+struct CompactService {
+    std::int32_t id;
+    double price;
+    std::string_view name;          ///< Название в арене таблицы.
+};
+
+/**
+ * @brief Компактная запись пользователя. Хэш пароля намеренно не хранится.
+ */
+struct CompactUser {
+    std::int32_t id;
+    UserRole role;
+    InlineString<31> login;
+};
+
+/**
+ * @brief Таблица номеров в компактном представлении.
+ */
+class RoomTable {
+private:
+    std::vector<CompactRoom> rooms;
+    TypeDictionary types;
+    StringArena arena;
+
+public:
+    /**
+     * @brief Добавляет номер в таблицу.
+     * @param id Идентификатор номера.
+     * @param number Номер комнаты.
+     * @param type Тип комнаты.
+     * @param pricePerDay Цена за номер в день.
+     * @param description Описание номера.
+     */
+    void add(int id, std::string_view number, std::string_view type, double pricePerDay, std::string_view description);
+
+    /**
+     * @brief Загружает все номера из базы данных.
+     * @param dbManager Менеджер базы данных для взаимодействия с БД.
+     * @return Таблица номеров.
+     * @throw std::runtime_error Если запрос не удался или номер комнаты длиннее InlineString<13>: таблица
+     *        загружается целиком или не загружается.
+     */
+    static RoomTable load(DBManager& dbManager);
+
+    /**
+     * @brief Резервирует место под указанное количество номеров.
+     */
+    void reserve(std::size_t count) { rooms.reserve(count); }
+
+    /**
+     * @brief Возвращает номер комнаты записи.
+     */
+    std::string_view number(const CompactRoom& room) const { return room.number.view(); }
+
+    /**
+     * @brief Возвращает тип комнаты записи.
+     */
+    std::string_view type(const CompactRoom& room) const { return types.name(room.typeId); }
+
+    /**
+     * @brief Возвращает описание записи.
+     */
+    std::string_view description(const CompactRoom& room) const { return room.description; }
+
+    /**
+     * @brief Возвращает словарь типов номеров.
+     */
+    const TypeDictionary& typeDictionary() const { return types; }
+
+    const CompactRoom& operator[](std::size_t i) const { return rooms[i]; }
+    std::size_t size() const { return rooms.size(); }
+    std::vector<CompactRoom>::const_iterator begin() const { return rooms.begin(); }
+    std::vector<CompactRoom>::const_iterator end() const { return rooms.end(); }
+};
+
+/**
+ * @brief Таблица услуг в компактном представлении.
+ */
+class ServiceTable {
+private:
+    std::vector<CompactService> services;
+    StringArena arena;
+
+public:
+    /**
+     * @brief Добавляет услугу в таблицу.
+     * @param id Идентификатор услуги.
+     * @param name Название услуги.
+     * @param price Цена услуги.
+     */
+    void add(int id, std::string_view name, double price);
+
+    /**
+     * @brief Загружает все услуги из базы данных.
+     * @param dbManager Менеджер базы данных для взаимодействия с БД.
+     * @return Таблица услуг.
+     * @throw std::runtime_error Если запрос не удался.
+     */
+    static ServiceTable load(DBManager& dbManager);
+
+    const CompactService& operator[](std::size_t i) const { return services[i]; }
+    std::size_t size() const { return services.size(); }
+    std::vector<CompactService>::const_iterator begin() const { return services.begin(); }
+    std::vector<CompactService>::const_iterator end() const { return services.end(); }
+};
+
+/**
+ * @brief Таблица пользователей в компактном представлении.
+ */
+class UserTable {
+private:
+    std::vector<CompactUser> users;
+
+public:
+    /**
+     * @brief Добавляет пользователя в таблицу.
+     * @param id Идентификатор пользователя.
+     * @param login Логин пользователя.
+     * @param role Роль пользователя.
+     */
+    void add(int id, std::string_view login, UserRole role);
+
+    /**
+     * @brief Загружает всех пользователей из базы данных (без хэшей паролей).
+     * @param dbManager Менеджер базы данных для взаимодействия с БД.
+     * @return Таблица пользователей.
+     * @throw std::runtime_error Если запрос не удался или логин длиннее InlineString<31>.
+     */
+    static UserTable load(DBManager& dbManager);
+
+    const CompactUser& operator[](std::size_t i) const { return users[i]; }
+    std::size_t size() const { return users.size(); }
+    std::vector<CompactUser>::const_iterator begin() const { return users.begin(); }
+    std::vector<CompactUser>::const_iterator end() const { return users.end(); }
+};
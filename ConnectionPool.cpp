@@ -0,0 +1,133 @@
+/**
+ * @file ConnectionPool.cpp
+ * @brief Этот файл содержит реализацию класса ConnectionPool.
+ */
+
+#include "ConnectionPool.h"
+#include "Metrics.h"
+#include <stdexcept>
+
+/**
+ * @brief Оператор присваивания перемещением. Текущее соединение возвращается в пул.
+ * @param other Перемещаемая аренда.
+ * @return Ссылка на эту аренду.
+ */
+ConnectionPool::Lease& ConnectionPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        if (pool && connection) {
+            pool->release(std::move(connection));
+        }
+        pool = other.pool;
+        connection = std::move(other.connection);
+    }
+    return *this;
+}
+
+/**
+ * @brief Деструктор аренды. Возвращает соединение в пул.
+ */
+ConnectionPool::Lease::~Lease() {
+    if (pool && connection) {
+        pool->release(std::move(connection));
+    }
+}
+
+/**
+ * @brief Конструктор пула. Открывает все соединения заранее.
+ * @param factory Функция, создающая соединение.
+ * @param size Количество соединений.
+ * @throws std::runtime_error Если фабрика не смогла создать соединение.
+ */
+ConnectionPool::ConnectionPool(const Factory& factory, std::size_t size) : capacity(size) {
+    idle.reserve(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        std::unique_ptr<DBManager> connection = factory();
+        if (!connection) {
+            throw std::runtime_error("Failed to open pooled database connection " + std::to_string(i + 1) +
+                                     " of " + std::to_string(size));
+        }
+        idle.push_back(std::move(connection));
+    }
+}
+
+/**
+ * @brief Возвращает соединение в пул и будит один ожидающий поток.
+ * @param connection Возвращаемое соединение.
+ */
+void ConnectionPool::release(std::unique_ptr<DBManager> connection) {
+    connection->setDeadline(Deadline::never());
+    connection->clearLastWrite();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        idle.push_back(std::move(connection));
+    }
+    returned.notify_one();
+}
+
+/**
+ * @brief Берет соединение из пула, ожидая освобождения при необходимости.
+ * @return Аренда соединения.
+ */
+ConnectionPool::Lease ConnectionPool::acquire() {
+    static MetricHistogram& wait = MetricsRegistry::global().histogram(
+        "hotel_pool_acquire_wait_seconds", "Time spent waiting for a pooled connection.");
+    MetricTimer timer(wait);
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!returned.wait_for(lock, std::chrono::seconds(1), [this] { return !idle.empty(); })) {
+    }
+    std::unique_ptr<DBManager> connection = std::move(idle.back());
+    idle.pop_back();
+    return Lease(this, std::move(connection));
+}
+
+/**
+ * @brief Берет соединение из пула, ожидая не дольше указанного времени.
+ * @param timeout Максимальное время ожидания.
+ * @return Аренда соединения или пустая аренда по истечении времени.
+ */
+ConnectionPool::Lease ConnectionPool::tryAcquire(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!returned.wait_for(lock, timeout, [this] { return !idle.empty(); })) {
+        static MetricCounter& timeouts = MetricsRegistry::global().counter(
+            "hotel_pool_acquire_timeouts_total", "Connection pool acquisitions that timed out.");
+        timeouts.increment();
+        return Lease();
+    }
+    std::unique_ptr<DBManager> connection = std::move(idle.back());
+    idle.pop_back();
+    return Lease(this, std::move(connection));
+}
+
+/**
+ * @brief Возвращает количество свободных соединений.
+ */
+std::size_t ConnectionPool::available() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return idle.size();
+}
+
+/**
+ * @brief Создает фабрику, которая подключается к PostgreSQL с указанными параметрами.
+ * @param host Хост базы данных.
+ * @param user Пользователь базы данных.
+ * @param password Пароль базы данных.
+ * @param database Имя базы данных.
+ * @param port Порт базы данных.
+ * @param replicas Общий маршрутизатор реплик для запросов на чтение (nullptr - без реплик).
+ * @param slowQueries Общий сборщик планов медленных запросов (nullptr - не собирать).
+ * @return Фабрика соединений; при неудачном подключении фабрика возвращает nullptr.
+ */
+ConnectionPool::Factory ConnectionPool::postgres(const std::string& host, const std::string& user,
+                                                 const std::string& password, const std::string& database, int port,
+                                                 std::shared_ptr<ReplicaRouter> replicas,
+                                                 std::shared_ptr<SlowQueryLog> slowQueries) {
+    return [=]() -> std::unique_ptr<DBManager> {
+        auto connection = std::make_unique<DBManager>(host, user, password, database, port);
+        if (!connection->connect()) {
+            return nullptr;
+        }
+        connection->useReplicas(replicas);
+        connection->useSlowQueryLog(slowQueries);
+        return connection;
+    };
+}
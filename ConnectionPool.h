@@ -0,0 +1,118 @@
+/**
+ * @file ConnectionPool.h
+ * @brief Этот файл содержит объявление класса ConnectionPool - пула соединений с базой данных,
+ *        разделяемого рабочими потоками сервера.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "DBManager.h"
+
+/**
+ * @brief Пул соединений фиксированного размера.
+ * Соединение выдается в монопольное пользование через Lease и возвращается в пул
+ * при уничтожении Lease. Если свободных соединений нет, acquire ждет.
+ */
+class ConnectionPool {
+public:
+    using Factory = std::function<std::unique_ptr<DBManager>()>;
+
+    /**
+     * @brief Аренда соединения. Возвращает соединение в пул при уничтожении.
+     */
+    class Lease {
+    private:
+        ConnectionPool* pool;
+        std::unique_ptr<DBManager> connection;
+
+    public:
+        Lease() : pool(nullptr) {}
+        Lease(ConnectionPool* pool, std::unique_ptr<DBManager> connection)
+            : pool(pool), connection(std::move(connection)) {}
+        Lease(Lease&& other) noexcept = default;
+        Lease& operator=(Lease&& other) noexcept;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease();
+
+        /**
+         * @brief Проверяет, содержит ли аренда соединение.
+         */
+        explicit operator bool() const { return connection != nullptr; }
+
+        DBManager& operator*() const { return *connection; }
+        DBManager* operator->() const { return connection.get(); }
+        DBManager* get() const { return connection.get(); }
+    };
+
+private:
+    mutable std::mutex mutex;
+    std::condition_variable returned;
+    std::vector<std::unique_ptr<DBManager>> idle;
+    std::size_t capacity;
+
+    /**
+     * @brief Возвращает соединение в пул.
+     * @param connection Возвращаемое соединение.
+     */
+    void release(std::unique_ptr<DBManager> connection);
+
+public:
+    /**
+     * @brief Создает пул и открывает все соединения.
+     * @param factory Функция, создающая соединение.
+     * @param size Количество соединений.
+     * @throws std::runtime_error Если фабрика не смогла создать соединение.
+     */
+    ConnectionPool(const Factory& factory, std::size_t size);
+
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+    /**
+     * @brief Берет соединение из пула, ожидая освобождения при необходимости.
+     * @return Аренда соединения.
+     */
+    Lease acquire();
+
+    /**
+     * @brief Берет соединение из пула, ожидая не дольше указанного времени.
+     * @param timeout Максимальное время ожидания.
+     * @return Аренда соединения или пустая аренда по истечении времени.
+     */
+    Lease tryAcquire(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Возвращает общее количество соединений пула.
+     */
+    std::size_t size() const { return capacity; }
+
+    /**
+     * @brief Возвращает количество свободных соединений.
+     */
+    std::size_t available() const;
+
+    /**
+     * @brief Создает фабрику, которая подключается к PostgreSQL с указанными параметрами.
+     * @param host Хост базы данных.
+     * @param user Пользователь базы данных.
+     * @param password Пароль базы данных.
+     * @param database Имя базы данных.
+     * @param port Порт базы данных.
+     * @param replicas Общий маршрутизатор реплик для запросов на чтение (nullptr - без реплик).
+     * @param slowQueries Общий сборщик планов медленных запросов (nullptr - не собирать).
+     * @return Фабрика соединений; созданное ею соединение уже подключено.
+     */
+    static Factory postgres(const std::string& host, const std::string& user, const std::string& password,
+                            const std::string& database, int port = 5432,
+                            std::shared_ptr<ReplicaRouter> replicas = nullptr,
+                            std::shared_ptr<SlowQueryLog> slowQueries = nullptr);
+};
@@ -4,8 +4,119 @@
  */
 
 #include "DBManager.h"
-#include <iostream>
+#include "Metrics.h"
+#include "Tracing.h"
+#include "Logger.h"
+#include "SlowQueryLog.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
 #include <sstream>
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <poll.h>
+#endif
+
+namespace {
+
+/**
+ * @brief Сколько ждать ответа сервера на отмену запроса, прежде чем переустановить соединение.
+ */
+constexpr std::chrono::milliseconds CANCEL_GRACE{1000};
+
+/**
+ * @brief SQLSTATE запроса, прерванного по statement_timeout или отмене (query_canceled).
+ */
+constexpr const char* QUERY_CANCELED = "57014";
+
+/**
+ * @brief Ждет, пока сокет станет доступен для чтения.
+ * @param socket Сокет соединения.
+ * @param timeoutMs Время ожидания в миллисекундах (-1 - без ограничения).
+ * @return Результат poll: больше нуля - готов, 0 - время истекло, меньше нуля - ошибка.
+ */
+int waitReadable(int socket, int timeoutMs) {
+#ifdef _WIN32
+    WSAPOLLFD descriptor{};
+    descriptor.fd = static_cast<SOCKET>(socket);
+    descriptor.events = POLLRDNORM;
+    return WSAPoll(&descriptor, 1, timeoutMs);
+#else
+    pollfd descriptor{};
+    descriptor.fd = socket;
+    descriptor.events = POLLIN;
+    return ::poll(&descriptor, 1, timeoutMs);
+#endif
+}
+
+/**
+ * @brief Метрики уровня базы данных (общие для всех соединений процесса).
+ */
+struct DBMetrics {
+    MetricCounter& primaryQueries;
+    MetricCounter& replicaQueries;
+    MetricCounter& errors;
+    MetricCounter& timeouts;
+    MetricHistogram& duration;
+    MetricGauge& connections;
+    MetricCounter& connectFailures;
+    MetricCounter& commits;
+    MetricCounter& rollbacks;
+    MetricCounter& copyRows;
+};
+
+/**
+ * @brief Возвращает метрики базы данных (регистрирует их при первом обращении).
+ */
+DBMetrics& dbMetrics() {
+    MetricsRegistry& registry = MetricsRegistry::global();
+    static DBMetrics metrics{
+        registry.counter("hotel_db_queries_total", "Queries sent to the database.", "target=\"primary\""),
+        registry.counter("hotel_db_queries_total", "Queries sent to the database.", "target=\"replica\""),
+        registry.counter("hotel_db_query_errors_total", "Queries that returned an error."),
+        registry.counter("hotel_db_query_timeouts_total", "Queries cancelled by their deadline."),
+        registry.histogram("hotel_db_query_duration_seconds", "Query round-trip time."),
+        registry.gauge("hotel_db_connections", "Open primary database connections."),
+        registry.counter("hotel_db_connect_failures_total", "Failed connection attempts."),
+        registry.counter("hotel_db_transactions_total", "Finished transactions.", "outcome=\"commit\""),
+        registry.counter("hotel_db_transactions_total", "Finished transactions.", "outcome=\"rollback\""),
+        registry.counter("hotel_db_copy_rows_total", "Rows loaded with COPY."),
+    };
+    return metrics;
+}
+
+/**
+ * @brief Сообщает сборщику планов длительность запроса при выходе из области (в том числе по исключению).
+ */
+class SlowQueryWatch {
+private:
+    SlowQueryLog* log;
+    const std::string& query;
+    std::chrono::steady_clock::time_point started;
+
+public:
+    SlowQueryWatch(SlowQueryLog* log, const std::string& query)
+        : log(log), query(query), started(log ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point()) {}
+
+    ~SlowQueryWatch() {
+        if (!log) {
+            return;
+        }
+        try {
+            log->report(query, std::chrono::steady_clock::now() - started);
+        } catch (const std::exception& e) {
+            Logger::warning("Slow query report failed: {}", e.what());
+        }
+    }
+
+    SlowQueryWatch(const SlowQueryWatch&) = delete;
+    SlowQueryWatch& operator=(const SlowQueryWatch&) = delete;
+};
+
+} // namespace
 
 /**
  * @brief Конструктор класса DBManager.
@@ -20,7 +131,7 @@ DBManager::DBManager(const std::string& host, const std::string& user,
                      const std::string& password, const std::string& database,
                      int port)
     : host(host), user(user), password(password), database(database), port(port),
-      connection(nullptr) {
+      connection(nullptr), appliedTimeoutMs(0), primaryPins(0), inTransaction(false) {
 }
 
 /**
@@ -47,16 +158,19 @@ bool DBManager::connect() {
         connection = PQconnectdb(conninfo.str().c_str());
 
         if (PQstatus(connection) != CONNECTION_OK) {
-            std::cerr << "Connection to database failed: " << PQerrorMessage(connection) << std::endl;
+            Logger::severe("Connection to database failed: {}", PQerrorMessage(connection));
             PQfinish(connection);
             connection = nullptr;
+            dbMetrics().connectFailures.increment();
             return false;
         }
 
+        appliedTimeoutMs = 0;
+        dbMetrics().connections.add(1);
         return true;
     }
     catch (const std::exception& e) {
-        std::cerr << "Exception: " << e.what() << std::endl;
+        Logger::severe("Exception: {}", e.what());
         return false;
     }
 }
@@ -68,7 +182,12 @@ void DBManager::disconnect() {
     if (connection) {
         PQfinish(connection);
         connection = nullptr;
+        dbMetrics().connections.add(-1);
     }
+    for (std::size_t i = 0; i < replicas.size(); ++i) {
+        closeReplica(static_cast<int>(i));
+    }
+    inTransaction = false;
 }
 
 /**
@@ -86,20 +205,178 @@ bool DBManager::isConnected() const {
  * @throw std::runtime_error Если база данных не подключена или выполнение запроса завершилось с ошибкой.
  */
 PGResultWrapper DBManager::executeQuery(const std::string& query) {
+    return executeQuery(query, Deadline::never());
+}
+
+/**
+ * @brief Выполняет SQL-запрос, который возвращает результат, с крайним сроком.
+ * @param query Строка SQL-запроса.
+ * @param deadline Крайний срок вызова.
+ * @return Объект PGResultWrapper, содержащий результат запроса.
+ * @throw QueryTimeoutError Если запрос не уложился в срок.
+ * @throw std::runtime_error Если база данных не подключена или выполнение запроса завершилось с ошибкой.
+ */
+PGResultWrapper DBManager::executeQuery(const std::string& query, const Deadline& deadline) {
     if (!isConnected()) {
         throw std::runtime_error("Database not connected");
     }
     
-    PGresult* result = PQexec(connection, query.c_str());
-    
-    if (PQresultStatus(result) != PGRES_TUPLES_OK && 
-        PQresultStatus(result) != PGRES_COMMAND_OK) {
-        std::string error = PQerrorMessage(connection);
-        PQclear(result); 
+    PGResultWrapper result = execute(connection, appliedTimeoutMs, query, deadline);
+    checkQueryResult(connection, result);
+    // INSERT ... RETURNING и подобные запросы тоже проходят здесь: закрепляем чтения сеанса.
+    if (std::strncmp(PQcmdStatus(result.get()), "SELECT", 6) != 0) {
+        lastWrite = ReplicaRouter::Clock::now();
+    }
+    return result; 
+}
+
+/**
+ * @brief Проверяет статус результата запроса на чтение.
+ * @param conn Соединение, выполнившее запрос.
+ * @param result Результат запроса.
+ * @throw std::runtime_error Если запрос завершился с ошибкой.
+ */
+void DBManager::checkQueryResult(PGconn* conn, const PGResultWrapper& result) {
+    if (PQresultStatus(result.get()) != PGRES_TUPLES_OK && 
+        PQresultStatus(result.get()) != PGRES_COMMAND_OK) {
+        std::string error = PQerrorMessage(conn);
         throw std::runtime_error("Query execution failed: " + error);
     }
-    
-    return PGResultWrapper(result); 
+}
+
+/**
+ * @brief Выполняет запрос только на чтение.
+ * @param query Строка SQL-запроса (только SELECT без блокировок).
+ * @return Объект PGResultWrapper, содержащий результат запроса.
+ * @throw std::runtime_error Если выполнение запроса завершилось с ошибкой.
+ */
+PGResultWrapper DBManager::executeRead(const std::string& query) {
+    return executeRead(query, Deadline::never());
+}
+
+/**
+ * @brief Выполняет запрос только на чтение с крайним сроком.
+ * Реплика выбирается маршрутизатором по наименьшему числу выполняющихся запросов. Если реплика
+ * недоступна или соединение с ней оборвалось, она исключается из выбора, а запрос выполняется
+ * на основном сервере.
+ * @param query Строка SQL-запроса (только SELECT без блокировок).
+ * @param deadline Крайний срок вызова.
+ * @return Объект PGResultWrapper, содержащий результат запроса.
+ * @throw QueryTimeoutError Если запрос не уложился в срок.
+ * @throw std::runtime_error Если выполнение запроса завершилось с ошибкой.
+ */
+PGResultWrapper DBManager::executeRead(const std::string& query, const Deadline& deadline) {
+    if (!readsOnPrimary()) {
+        int index = replicaRouter->acquire();
+        if (index >= 0) {
+            struct Release {
+                ReplicaRouter& router;
+                int index;
+                ~Release() { router.release(index); }
+            } release{*replicaRouter, index};
+
+            PGconn* replica = replicaConnection(index);
+            if (replica) {
+                try {
+                    PGResultWrapper result = execute(replica, replicas[index].appliedTimeoutMs, query, deadline);
+                    if (PQstatus(replica) == CONNECTION_OK) {
+                        checkQueryResult(replica, result);
+                        return result;
+                    }
+                } catch (const QueryTimeoutError&) {
+                    throw;
+                } catch (const std::exception&) {
+                    if (PQstatus(replica) == CONNECTION_OK) {
+                        throw;
+                    }
+                }
+                Logger::warning("Replica {}:{} failed, reading from primary", replicaRouter->endpoint(index).host,
+                                replicaRouter->endpoint(index).port);
+                closeReplica(index);
+            }
+            replicaRouter->markDown(index);
+        }
+    }
+
+    if (!isConnected()) {
+        throw std::runtime_error("Database not connected");
+    }
+    PGResultWrapper result = execute(connection, appliedTimeoutMs, query, deadline);
+    checkQueryResult(connection, result);
+    return result;
+}
+
+/**
+ * @brief Подключает реплики для запросов на чтение.
+ * Соединения с репликами открываются при первом чтении.
+ * @param router Общий маршрутизатор реплик (nullptr - отключить реплики).
+ */
+void DBManager::useReplicas(std::shared_ptr<ReplicaRouter> router) {
+    for (std::size_t i = 0; i < replicas.size(); ++i) {
+        closeReplica(static_cast<int>(i));
+    }
+    replicaRouter = std::move(router);
+    replicas.assign(replicaRouter ? replicaRouter->size() : 0, ReplicaConnection());
+}
+
+/**
+ * @brief Подключает сбор планов медленных запросов.
+ * @param log Общий сборщик планов (nullptr - отключить).
+ */
+void DBManager::useSlowQueryLog(std::shared_ptr<SlowQueryLog> log) {
+    slowQueryLog = std::move(log);
+}
+
+/**
+ * @brief Проверяет, выполняются ли сейчас чтения на основном сервере.
+ * @param now Текущее время.
+ * @return True, если реплик нет, открыта транзакция, действует PrimaryReads или не истекло окно после записи.
+ */
+bool DBManager::readsOnPrimary(ReplicaRouter::Clock::time_point now) const {
+    if (!replicaRouter || replicaRouter->size() == 0 || inTransaction || primaryPins > 0) {
+        return true;
+    }
+    return lastWrite != ReplicaRouter::Clock::time_point() && now - lastWrite < replicaRouter->getPinWindow();
+}
+
+/**
+ * @brief Возвращает открытое соединение с репликой, подключаясь при необходимости.
+ * @param index Индекс реплики.
+ * @return Соединение или nullptr, если подключиться не удалось.
+ */
+PGconn* DBManager::replicaConnection(int index) {
+    ReplicaConnection& replica = replicas[index];
+    if (replica.connection && PQstatus(replica.connection) == CONNECTION_OK) {
+        return replica.connection;
+    }
+    closeReplica(index);
+    const ReplicaEndpoint& endpoint = replicaRouter->endpoint(index);
+    std::stringstream conninfo;
+    conninfo << "host=" << endpoint.host
+             << " port=" << endpoint.port
+             << " dbname=" << endpoint.database
+             << " user=" << endpoint.user
+             << " password=" << endpoint.password
+             << " connect_timeout=2";
+    replica.connection = PQconnectdb(conninfo.str().c_str());
+    if (PQstatus(replica.connection) != CONNECTION_OK) {
+        Logger::severe("Connection to replica failed: {}", PQerrorMessage(replica.connection));
+        closeReplica(index);
+        return nullptr;
+    }
+    replica.appliedTimeoutMs = 0;
+    return replica.connection;
+}
+
+/**
+ * @brief Закрывает соединение с репликой.
+ * @param index Индекс реплики.
+ */
+void DBManager::closeReplica(int index) {
+    if (replicas[index].connection) {
+        PQfinish(replicas[index].connection);
+        replicas[index].connection = nullptr;
+    }
 }
 
 /**
@@ -109,11 +386,25 @@ PGResultWrapper DBManager::executeQuery(const std::string& query) {
  * @throw std::runtime_error Если база данных не подключена или выполнение запроса завершилось с ошибкой.
  */
 int DBManager::executeUpdate(const std::string& query) {
+    return executeUpdate(query, Deadline::never());
+}
+
+/**
+ * @brief Выполняет SQL-запрос на обновление данных с крайним сроком.
+ * @param query Строка SQL-запроса.
+ * @param deadline Крайний срок вызова.
+ * @return Количество затронутых строк.
+ * @throw QueryTimeoutError Если запрос не уложился в срок.
+ * @throw std::runtime_error Если база данных не подключена или выполнение запроса завершилось с ошибкой.
+ */
+int DBManager::executeUpdate(const std::string& query, const Deadline& deadline) {
     if (!isConnected()) {
         throw std::runtime_error("Database not connected");
     }
     
-    PGResultWrapper result(PQexec(connection, query.c_str()));
+    PGResultWrapper result = execute(connection, appliedTimeoutMs, query, deadline);
+    // Даже неудачная проверка версии считается записью: повторное чтение должно видеть основной сервер.
+    lastWrite = ReplicaRouter::Clock::now();
     
     if (PQresultStatus(result.get()) != PGRES_COMMAND_OK) {
         std::string error = PQerrorMessage(connection);
@@ -124,20 +415,93 @@ int DBManager::executeUpdate(const std::string& query) {
     return affected; 
 }
 
+/**
+ * @brief Загружает строки командой COPY ... FROM STDIN.
+ * Данные отправляются серверу по мере их получения от write, поэтому объем загрузки не ограничен памятью.
+ * Если write выбрасывает исключение, COPY прерывается (сервер отменяет строки этой команды),
+ * и исключение передается дальше.
+ * @param copyStatement Команда COPY ... FROM STDIN.
+ * @param write Получает функцию отправки и передает через нее данные в формате COPY порциями.
+ * @return Количество загруженных строк.
+ * @throw std::runtime_error Если база данных не подключена или COPY завершилась с ошибкой.
+ */
+long long DBManager::copyIn(const std::string& copyStatement,
+                            const std::function<void(const std::function<void(const std::string&)>&)>& write) {
+    if (!isConnected()) {
+        throw std::runtime_error("Database not connected");
+    }
+
+    PGResultWrapper started(PQexec(connection, copyStatement.c_str()));
+    lastWrite = ReplicaRouter::Clock::now();
+    if (PQresultStatus(started.get()) != PGRES_COPY_IN) {
+        std::string error = PQerrorMessage(connection);
+        throw std::runtime_error("COPY failed to start: " + error);
+    }
+
+    try {
+        write([this](const std::string& chunk) {
+            if (!chunk.empty() && PQputCopyData(connection, chunk.data(), static_cast<int>(chunk.size())) != 1) {
+                throw std::runtime_error(std::string("COPY data transfer failed: ") + PQerrorMessage(connection));
+            }
+        });
+    } catch (...) {
+        PQputCopyEnd(connection, "aborted by client");
+        while (PGresult* next = PQgetResult(connection)) {
+            PQclear(next);
+        }
+        throw;
+    }
+
+    if (PQputCopyEnd(connection, nullptr) != 1) {
+        throw std::runtime_error(std::string("COPY completion failed: ") + PQerrorMessage(connection));
+    }
+    PGResultWrapper last(nullptr);
+    while (PGresult* next = PQgetResult(connection)) {
+        last = PGResultWrapper(next);
+    }
+    if (PQresultStatus(last.get()) != PGRES_COMMAND_OK) {
+        std::string error = PQerrorMessage(connection);
+        throw std::runtime_error("COPY failed: " + error);
+    }
+    long long rows = std::atoll(PQcmdTuples(last.get()));
+    dbMetrics().copyRows.increment(static_cast<std::uint64_t>(rows));
+    return rows;
+}
+
 /**
  * @brief Начинает новую транзакцию базы данных.
  * @throw std::runtime_error Если база данных не подключена или начало транзакции завершилось с ошибкой.
  */
 void DBManager::beginTransaction() {
+    beginTransaction(IsolationLevel::READ_COMMITTED);
+}
+
+/**
+ * @brief Начинает новую транзакцию с указанным уровнем изоляции.
+ * @param level Уровень изоляции.
+ * @param readOnly Транзакция только на чтение.
+ * @throw std::runtime_error Если база данных не подключена или начало транзакции завершилось с ошибкой.
+ */
+void DBManager::beginTransaction(IsolationLevel level, bool readOnly) {
     if (!isConnected()) {
         throw std::runtime_error("Database not connected");
     }
     
-    PGResultWrapper result(PQexec(connection, "BEGIN"));
+    std::string statement = "BEGIN";
+    if (level == IsolationLevel::REPEATABLE_READ) {
+        statement += " ISOLATION LEVEL REPEATABLE READ";
+    } else if (level == IsolationLevel::SERIALIZABLE) {
+        statement += " ISOLATION LEVEL SERIALIZABLE";
+    }
+    if (readOnly) {
+        statement += " READ ONLY";
+    }
+    PGResultWrapper result(PQexec(connection, statement.c_str()));
     if (PQresultStatus(result.get()) != PGRES_COMMAND_OK) {
         std::string error = PQerrorMessage(connection);
         throw std::runtime_error("Failed to begin transaction: " + error);
     }
+    inTransaction = true;
 }
 
 /**
@@ -149,6 +513,9 @@ void DBManager::commit() {
         throw std::runtime_error("Database not connected");
     }
     
+    inTransaction = false;
+    lastWrite = ReplicaRouter::Clock::now();
+    dbMetrics().commits.increment();
     PGResultWrapper result(PQexec(connection, "COMMIT"));
     if (PQresultStatus(result.get()) != PGRES_COMMAND_OK) {
         std::string error = PQerrorMessage(connection);
@@ -165,9 +532,132 @@ void DBManager::rollback() {
         throw std::runtime_error("Database not connected");
     }
     
+    inTransaction = false;
+    appliedTimeoutMs = -1; // statement_timeout, установленный внутри транзакции, откатывается вместе с ней
+    dbMetrics().rollbacks.increment();
     PGResultWrapper result(PQexec(connection, "ROLLBACK"));
     if (PQresultStatus(result.get()) != PGRES_COMMAND_OK) {
         std::string error = PQerrorMessage(connection);
         throw std::runtime_error("Failed to rollback transaction: " + error);
     }
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Выполняет запрос с учетом крайнего срока.
+ * Действующий срок - самый ранний из срока вызова, срока DeadlineScope и ограничения по умолчанию.
+ * Без срока запрос выполняется через PQexec, как раньше. Со сроком перед запросом в том же
+ * обращении к серверу устанавливается statement_timeout на оставшееся время, а клиент ждет
+ * ответа не дольше срока и затем отменяет запрос через PQcancel.
+ * Количество, длительность, ошибки и таймауты запросов учитываются в метриках hotel_db_*,
+ * а при включенной трассировке запрос записывается областью "DBManager::execute" с началом текста.
+ * @param conn Соединение.
+ * @param applied statement_timeout сеанса этого соединения.
+ * @param query Строка SQL-запроса.
+ * @param deadline Крайний срок вызова.
+ * @return Последний результат запроса.
+ * @throw QueryTimeoutError Если срок истек до отправки, сервер прервал запрос или клиент отменил его.
+ */
+PGResultWrapper DBManager::execute(PGconn* conn, long long& applied, const std::string& query, const Deadline& deadline) {
+    TraceSpan span("DBManager::execute", "db", query);
+    DBMetrics& metrics = dbMetrics();
+    (conn == connection ? metrics.primaryQueries : metrics.replicaQueries).increment();
+    MetricTimer timer(metrics.duration);
+    SlowQueryWatch watch(slowQueryLog.get(), query);
+
+    Deadline effective = deadline.earliest(scopeDeadline);
+    if (defaultTimeout.count() > 0) {
+        effective = effective.earliest(Deadline::after(defaultTimeout));
+    }
+    if (!effective.isBounded() && applied == 0) {
+        PGResultWrapper result(PQexec(conn, query.c_str()));
+        ExecStatusType status = PQresultStatus(result.get());
+        if (status != PGRES_TUPLES_OK && status != PGRES_COMMAND_OK) {
+            metrics.errors.increment();
+        }
+        return result;
+    }
+    if (effective.expired()) {
+        metrics.timeouts.increment();
+        throw QueryTimeoutError("Query deadline expired before execution");
+    }
+
+    long long timeoutMs = effective.isBounded() ? std::max<long long>(1, effective.remaining().count()) : 0;
+    std::string text = "SET statement_timeout = " + std::to_string(timeoutMs) + "; " + query;
+    if (!PQsendQuery(conn, text.c_str())) {
+        throw std::runtime_error(std::string("Query execution failed: ") + PQerrorMessage(conn));
+    }
+
+    bool timedOut = !waitForResult(conn, effective);
+    if (timedOut) {
+        cancelRunningQuery(conn);
+    }
+
+    PGResultWrapper last(nullptr);
+    while (PGresult* next = PQgetResult(conn)) {
+        last = PGResultWrapper(next);
+    }
+
+    ExecStatusType status = PQresultStatus(last.get());
+    bool failed = status != PGRES_TUPLES_OK && status != PGRES_COMMAND_OK;
+    const char* sqlState = last.isValid() ? PQresultErrorField(last.get(), PG_DIAG_SQLSTATE) : nullptr;
+    if (timedOut || (sqlState && std::string(sqlState) == QUERY_CANCELED)) {
+        applied = -1;
+        metrics.timeouts.increment();
+        throw QueryTimeoutError("Query timed out after " + std::to_string(timeoutMs) + " ms");
+    }
+    // Ошибка откатывает неявную транзакцию вместе с SET, поэтому значение сеанса неизвестно.
+    applied = failed ? -1 : timeoutMs;
+    if (failed) {
+        metrics.errors.increment();
+    }
+    return last;
+}
+
+/**
+ * @brief Ждет готовности результата отправленного запроса до крайнего срока.
+ * @param conn Соединение.
+ * @param deadline Крайний срок ожидания.
+ * @return True, если результат готов (или соединение сообщило об ошибке), false - если срок истек.
+ */
+bool DBManager::waitForResult(PGconn* conn, const Deadline& deadline) {
+    while (true) {
+        if (!PQconsumeInput(conn) || !PQisBusy(conn)) {
+            return true;
+        }
+        if (deadline.expired()) {
+            return false;
+        }
+        int timeoutMs = -1;
+        if (deadline.isBounded()) {
+            timeoutMs = static_cast<int>(std::min<long long>(deadline.remaining().count() + 1, INT_MAX));
+        }
+        if (waitReadable(PQsocket(conn), timeoutMs) < 0 && errno != EINTR) {
+            return true;
+        }
+    }
+}
+
+/**
+ * @brief Отменяет выполняющийся запрос и дожидается ответа сервера на отмену.
+ * Если отмену не удалось отправить или сервер не ответил за CANCEL_GRACE,
+ * соединение переустанавливается, чтобы не оставить его занятым; открытая транзакция при этом
+ * теряется, и inTransaction сбрасывается.
+ * @param conn Соединение.
+ */
+void DBManager::cancelRunningQuery(PGconn* conn) {
+    char error[256];
+    PGcancel* cancel = PQgetCancel(conn);
+    bool sent = cancel && PQcancel(cancel, error, sizeof(error));
+    if (cancel) {
+        PQfreeCancel(cancel);
+    }
+    if (sent && waitForResult(conn, Deadline::after(CANCEL_GRACE))) {
+        return;
+    }
+    Logger::warning("Query cancel did not complete, resetting connection");
+    PQreset(conn);
+    if (conn == connection) {
+        // Новый сеанс начинается вне транзакции: иначе executeRead навсегда остался бы на основном сервере.
+        inTransaction = false;
+    }
+}
@@ -6,9 +6,16 @@
 #pragma once
 
 #include <libpq-fe.h>
+#include <chrono>
+#include <functional>
 #include <string>
 #include <memory>
 #include <stdexcept>
+#include <vector>
+#include "Deadline.h"
+#include "ReplicaRouter.h"
+
+class SlowQueryLog;
 
 /**
  * @brief RAII-обертка для PGresult* для устранения ручного управления памятью.
@@ -86,10 +93,34 @@ public:
     }
 };
 
+/**
+ * @brief Ошибка истечения времени запроса.
+ * Выбрасывается, если запрос не уложился в крайний срок: сервер прервал его по
+ * statement_timeout или клиент отменил его через PQcancel.
+ */
+class QueryTimeoutError : public std::runtime_error {
+public:
+    /**
+     * @brief Конструирует ошибку.
+     * @param message Описание ошибки.
+     */
+    explicit QueryTimeoutError(const std::string& message) : std::runtime_error(message) {}
+};
+
+/**
+ * @brief Уровень изоляции транзакции.
+ */
+enum class IsolationLevel {
+    READ_COMMITTED,   ///< Каждый запрос видит данные на момент своего начала (по умолчанию).
+    REPEATABLE_READ,  ///< Все запросы транзакции видят один снимок данных.
+    SERIALIZABLE      ///< Как REPEATABLE_READ, плюс проверка сериализуемости.
+};
+
 /**
  * @brief Управляет подключениями и операциями с базой данных PostgreSQL.
  * Этот класс предоставляет методы для подключения, отключения, выполнения запросов
- * и управления транзакциями.
+ * и управления транзакциями. Если подключены реплики, запросы executeRead выполняются
+ * на реплике; все остальные запросы и чтения вскоре после записи - на основном сервере.
  */
 class DBManager {
 private:
@@ -100,8 +131,118 @@ private:
     int port;
 
     PGconn* connection; ///< Указатель на объект соединения PostgreSQL.
-    
+
+    Deadline scopeDeadline;                       ///< Крайний срок текущей составной операции.
+    std::chrono::milliseconds defaultTimeout{0};  ///< Ограничение одного запроса (0 - без ограничения).
+    long long appliedTimeoutMs;                   ///< statement_timeout сеанса (-1 - неизвестен).
+
+    /**
+     * @brief Соединение с репликой.
+     */
+    struct ReplicaConnection {
+        PGconn* connection = nullptr;
+        long long appliedTimeoutMs = 0;
+    };
+
+    std::shared_ptr<ReplicaRouter> replicaRouter;     ///< Выбор реплики (nullptr - реплик нет).
+    std::vector<ReplicaConnection> replicas;          ///< Соединения с репликами, открываются при первом чтении.
+    ReplicaRouter::Clock::time_point lastWrite;       ///< Последняя запись через это соединение.
+    int primaryPins;                                  ///< Активные области PrimaryReads.
+    bool inTransaction;                               ///< Открыта транзакция на основном сервере.
+    std::shared_ptr<SlowQueryLog> slowQueryLog;       ///< Сбор планов медленных запросов (nullptr - отключен).
+
+    /**
+     * @brief Выполняет запрос с учетом крайнего срока и возвращает последний результат.
+     * @param conn Соединение.
+     * @param applied statement_timeout сеанса этого соединения.
+     * @param query Строка SQL-запроса.
+     * @param deadline Крайний срок вызова.
+     * @return Результат запроса (статус не проверяется, кроме истечения времени).
+     * @throw QueryTimeoutError Если срок истек.
+     */
+    PGResultWrapper execute(PGconn* conn, long long& applied, const std::string& query, const Deadline& deadline);
+
+    /**
+     * @brief Ждет готовности результата до крайнего срока.
+     * @return False, если срок истек раньше.
+     */
+    bool waitForResult(PGconn* conn, const Deadline& deadline);
+
+    /**
+     * @brief Отменяет выполняющийся запрос и дожидается ответа сервера на отмену.
+     * Если сервер не ответил, соединение переустанавливается.
+     */
+    void cancelRunningQuery(PGconn* conn);
+
+    /**
+     * @brief Проверяет статус результата запроса на чтение и выбрасывает ошибку.
+     */
+    static void checkQueryResult(PGconn* conn, const PGResultWrapper& result);
+
+    /**
+     * @brief Возвращает открытое соединение с репликой, подключаясь при необходимости.
+     * @return Соединение или nullptr, если подключиться не удалось.
+     */
+    PGconn* replicaConnection(int index);
+
+    /**
+     * @brief Закрывает соединение с репликой.
+     */
+    void closeReplica(int index);
+
 public:
+    /**
+     * @brief Устанавливает крайний срок для всех запросов соединения на время своей жизни.
+     * Вложенные области сужают срок; деструктор восстанавливает предыдущий.
+     */
+    class DeadlineScope {
+    private:
+        DBManager& db;
+        Deadline previous;
+
+    public:
+        /**
+         * @brief Устанавливает крайний срок.
+         * @param db Менеджер базы данных.
+         * @param deadline Крайний срок составной операции.
+         */
+        DeadlineScope(DBManager& db, const Deadline& deadline) : db(db), previous(db.scopeDeadline) {
+            db.scopeDeadline = previous.earliest(deadline);
+        }
+
+        /**
+         * @brief Восстанавливает предыдущий крайний срок.
+         */
+        ~DeadlineScope() { db.scopeDeadline = previous; }
+
+        DeadlineScope(const DeadlineScope&) = delete;
+        DeadlineScope& operator=(const DeadlineScope&) = delete;
+    };
+
+    /**
+     * @brief Направляет чтения executeRead на основной сервер на время своей жизни
+     *        (проверки, результат которых используется для последующей записи).
+     */
+    class PrimaryReads {
+    private:
+        DBManager& db;
+
+    public:
+        /**
+         * @brief Закрепляет чтения за основным сервером.
+         * @param db Менеджер базы данных.
+         */
+        explicit PrimaryReads(DBManager& db) : db(db) { ++db.primaryPins; }
+
+        /**
+         * @brief Снимает закрепление.
+         */
+        ~PrimaryReads() { --db.primaryPins; }
+
+        PrimaryReads(const PrimaryReads&) = delete;
+        PrimaryReads& operator=(const PrimaryReads&) = delete;
+    };
+
     /**
      * @brief Конструирует новый объект DBManager.
      * @param host Хост базы данных.
@@ -142,18 +283,129 @@ public:
      */
     PGResultWrapper executeQuery(const std::string& query);
 
+    /**
+     * @brief Выполняет запрос, возвращающий результаты, с крайним сроком.
+     * @param query Строка SQL-запроса для выполнения.
+     * @param deadline Крайний срок вызова (сужается сроком DeadlineScope и ограничением по умолчанию).
+     * @return PGResultWrapper, содержащая результаты запроса.
+     * @throw QueryTimeoutError Если запрос не уложился в срок.
+     */
+    PGResultWrapper executeQuery(const std::string& query, const Deadline& deadline);
+
+    /**
+     * @brief Выполняет запрос только на чтение: на реплике, если она есть и чтение не закреплено
+     *        за основным сервером, иначе на основном сервере.
+     * @param query Строка SQL-запроса (только SELECT без блокировок).
+     * @return PGResultWrapper, содержащая результаты запроса.
+     */
+    PGResultWrapper executeRead(const std::string& query);
+
+    /**
+     * @brief Выполняет запрос только на чтение с крайним сроком.
+     * @param query Строка SQL-запроса (только SELECT без блокировок).
+     * @param deadline Крайний срок вызова.
+     * @return PGResultWrapper, содержащая результаты запроса.
+     * @throw QueryTimeoutError Если запрос не уложился в срок.
+     */
+    PGResultWrapper executeRead(const std::string& query, const Deadline& deadline);
+
+    /**
+     * @brief Подключает реплики для запросов на чтение.
+     * @param router Общий маршрутизатор реплик (nullptr - отключить реплики).
+     */
+    void useReplicas(std::shared_ptr<ReplicaRouter> router);
+
+    /**
+     * @brief Подключает сбор планов медленных запросов.
+     * @param log Общий сборщик планов (nullptr - отключить).
+     */
+    void useSlowQueryLog(std::shared_ptr<SlowQueryLog> log);
+
+    /**
+     * @brief Проверяет, выполняются ли сейчас чтения на основном сервере.
+     * Чтения закреплены за основным сервером, если реплик нет, открыта транзакция, действует
+     * область PrimaryReads или с последней записи прошло меньше окна маршрутизатора.
+     * @param now Текущее время.
+     */
+    bool readsOnPrimary(ReplicaRouter::Clock::time_point now = ReplicaRouter::Clock::now()) const;
+
+    /**
+     * @brief Возвращает момент последней записи через это соединение.
+     */
+    ReplicaRouter::Clock::time_point getLastWrite() const { return lastWrite; }
+
+    /**
+     * @brief Переносит момент последней записи сеанса на это соединение (не назад).
+     * Используется пулом соединений: запись сеанса через другое соединение тоже закрепляет его чтения.
+     * @param time Момент записи.
+     */
+    void setLastWrite(ReplicaRouter::Clock::time_point time) { if (time > lastWrite) lastWrite = time; }
+
+    /**
+     * @brief Сбрасывает момент последней записи (соединение возвращено в пул).
+     */
+    void clearLastWrite() { lastWrite = ReplicaRouter::Clock::time_point(); }
+
     /**
      * @brief Выполняет запрос на обновление базы данных (например, INSERT, UPDATE, DELETE).
      * @param query Строка SQL-запроса для выполнения.
      * @return Количество затронутых строк.
      */
     int executeUpdate(const std::string& query);
+
+    /**
+     * @brief Выполняет запрос на обновление с крайним сроком.
+     * @param query Строка SQL-запроса для выполнения.
+     * @param deadline Крайний срок вызова.
+     * @return Количество затронутых строк.
+     * @throw QueryTimeoutError Если запрос не уложился в срок.
+     */
+    int executeUpdate(const std::string& query, const Deadline& deadline);
+
+    /**
+     * @brief Загружает строки командой COPY ... FROM STDIN.
+     * @param copyStatement Команда COPY ... FROM STDIN.
+     * @param write Получает функцию отправки и передает через нее данные в формате COPY порциями.
+     * @return Количество загруженных строк.
+     */
+    long long copyIn(const std::string& copyStatement,
+                     const std::function<void(const std::function<void(const std::string&)>&)>& write);
+
+    /**
+     * @brief Устанавливает ограничение времени для каждого запроса этого соединения.
+     * @param timeout Ограничение (0 - без ограничения).
+     */
+    void setDefaultTimeout(std::chrono::milliseconds timeout) { defaultTimeout = timeout; }
+
+    /**
+     * @brief Возвращает ограничение времени одного запроса.
+     */
+    std::chrono::milliseconds getDefaultTimeout() const { return defaultTimeout; }
+
+    /**
+     * @brief Возвращает крайний срок текущей составной операции.
+     */
+    const Deadline& getDeadline() const { return scopeDeadline; }
+
+    /**
+     * @brief Устанавливает крайний срок для всех последующих запросов (без восстановления предыдущего).
+     * Используется, когда срок привязан к аренде соединения, а не к области видимости.
+     * @param deadline Крайний срок.
+     */
+    void setDeadline(const Deadline& deadline) { scopeDeadline = deadline; }
     
     /**
      * @brief Начинает новую транзакцию базы данных.
      */
     void beginTransaction();
 
+    /**
+     * @brief Начинает новую транзакцию с указанным уровнем изоляции.
+     * @param level Уровень изоляции.
+     * @param readOnly Транзакция только на чтение.
+     */
+    void beginTransaction(IsolationLevel level, bool readOnly = false);
+
     /**
      * @brief Подтверждает текущую транзакцию базы данных.
      */
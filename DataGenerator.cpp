@@ -0,0 +1,434 @@
+/**
+ * @file DataGenerator.cpp
+ * @brief Этот файл содержит реализацию класса DataGenerator.
+ */
+
+#include "DataGenerator.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace {
+
+/**
+ * @brief Услуга каталога генератора.
+ */
+struct CatalogService {
+    const char* name;
+    double price;
+};
+
+const CatalogService kCatalog[] = {
+    {"Breakfast", 15.0}, {"Parking", 10.0}, {"Spa", 60.0}, {"Laundry", 12.0},
+    {"Airport transfer", 40.0}, {"Late checkout", 25.0}, {"Minibar", 20.0}, {"Room service", 30.0},
+};
+constexpr int kCatalogSize = static_cast<int>(sizeof(kCatalog) / sizeof(kCatalog[0]));
+
+/**
+ * @brief Тип номера: доля номеров определяется количеством вхождений в kRoomLayout.
+ */
+struct RoomKind {
+    const char* type;
+    double price;
+};
+
+const RoomKind kRoomLayout[] = {
+    {"Single", 60.0}, {"Single", 60.0}, {"Single", 60.0}, {"Double", 90.0}, {"Double", 90.0},
+    {"Double", 90.0}, {"Double", 90.0}, {"Family", 130.0}, {"Family", 130.0}, {"Suite", 180.0},
+};
+constexpr int kRoomsPerFloor = 20;
+
+constexpr double kStayScale = 2.5;          ///< Средняя добавка к одной ночи (экспоненциальная).
+constexpr int kMaxStay = 14;
+constexpr double kPeakDayOfYear = 196.0;    ///< 15 июля.
+constexpr std::uint64_t kServiceStream = 0x5e41ce5ull;
+
+/**
+ * @brief Генератор псевдослучайных чисел splitmix64: быстрый и с независимыми потоками по зерну.
+ */
+class Random {
+private:
+    std::uint64_t state;
+
+public:
+    explicit Random(std::uint64_t seed) : state(seed) {}
+
+    std::uint64_t next() {
+        std::uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    /** @brief Равномерное число из [0, 1). */
+    double uniform() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+
+    /** @brief Равномерное целое из [0, bound). */
+    int below(int bound) { return static_cast<int>(uniform() * bound); }
+};
+
+/**
+ * @brief Смешивает зерно и идентификатор в зерно отдельного потока.
+ */
+std::uint64_t streamSeed(std::uint64_t seed, std::uint64_t id) {
+    Random mixer(seed ^ (id * 0xd1b54a32d192ed03ull));
+    return mixer.next();
+}
+
+/**
+ * @brief Дописывает целое число.
+ */
+void appendInt(std::string& out, long long value) {
+    char buffer[24];
+    auto [end, error] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, end);
+}
+
+/**
+ * @brief Дописывает цену с двумя знаками после точки.
+ */
+void appendPrice(std::string& out, double value) {
+    char buffer[32];
+    auto [end, error] = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::fixed, 2);
+    out.append(buffer, end);
+}
+
+/**
+ * @brief Разбирает дату YYYY-MM-DD.
+ * @throws std::invalid_argument Если дата имеет неверный формат.
+ */
+std::chrono::year_month_day parseDate(const std::string& date) {
+    int year = 0;
+    unsigned month = 0;
+    unsigned day = 0;
+    char tail = 0;
+    if (date.size() != 10 || std::sscanf(date.c_str(), "%4d-%2u-%2u%c", &year, &month, &day, &tail) != 3) {
+        throw std::invalid_argument("Invalid date: '" + date + "'");
+    }
+    std::chrono::year_month_day result{std::chrono::year(year), std::chrono::month(month), std::chrono::day(day)};
+    if (!result.ok()) {
+        throw std::invalid_argument("Invalid date: '" + date + "'");
+    }
+    return result;
+}
+
+/**
+ * @brief Приводит несуществующий день (например, 29 февраля после сдвига года) к последнему дню месяца.
+ */
+std::chrono::sys_days clampToMonth(const std::chrono::year_month_day& date) {
+    if (date.ok()) {
+        return std::chrono::sys_days(date);
+    }
+    return std::chrono::sys_days(std::chrono::year_month_day_last(date.year(), std::chrono::month_day_last(date.month())));
+}
+
+/**
+ * @brief Форматирует дату в YYYY-MM-DD.
+ */
+std::string formatDate(const std::chrono::year_month_day& date) {
+    char buffer[11];
+    std::snprintf(buffer, sizeof(buffer), "%04d-%02u-%02u", static_cast<int>(date.year()),
+                  static_cast<unsigned>(date.month()), static_cast<unsigned>(date.day()));
+    return buffer;
+}
+
+/**
+ * @brief Заканчивает поле и строку COPY.
+ */
+void endRow(std::string& out) { out.push_back('\n'); }
+void endField(std::string& out) { out.push_back('\t'); }
+
+} // namespace
+
+/**
+ * @brief Конструирует генератор.
+ * Заранее вычисляет даты всех дней истории и вероятность заезда по дням. Средняя длительность
+ * проживания L и вероятность заезда q связаны с загрузкой o так: свободный промежуток между
+ * бронированиями в среднем (1 - q) / q дней, откуда q = o / (o + L (1 - o)). Сезонность умножает q
+ * на 1 + A cos(2π (день года - 196) / 365.25).
+ * @param config Параметры генерации.
+ * @throws std::invalid_argument Если параметры вне допустимых границ или дата имеет неверный формат.
+ */
+DataGenerator::DataGenerator(DataGenConfig config) : config(std::move(config)) {
+    const DataGenConfig& c = this->config;
+    if (c.rooms < 1 || c.guests < 1 || c.properties < 1 || c.properties > c.rooms) {
+        throw std::invalid_argument("Data generator requires at least one room, guest and property, and no more properties than rooms");
+    }
+    if (c.years < 0 || c.monthsAhead < 0 || (c.years == 0 && c.monthsAhead == 0)) {
+        throw std::invalid_argument("Data generator requires a non-empty date range");
+    }
+    if (!(c.occupancy > 0 && c.occupancy < 1) || c.seasonality < 0 || c.seasonality > 1 ||
+        c.cancellationRate < 0 || c.cancellationRate > 1 || c.servicesPerBooking < 0) {
+        throw std::invalid_argument("Data generator rates are out of range");
+    }
+
+    using namespace std::chrono;
+    year_month_day today = parseDate(c.today);
+    sys_days first = clampToMonth(year_month_day(today.year() - years(c.years), today.month(), today.day()));
+    sys_days last = clampToMonth(today + months(c.monthsAhead));
+    historyDays = static_cast<int>((last - first).count());
+    todayIndex = static_cast<int>((sys_days(today) - first).count());
+
+    double meanStay = 1.0 + 1.0 / (std::exp(1.0 / kStayScale) - 1.0);
+    double baseChance = c.occupancy / (c.occupancy + meanStay * (1.0 - c.occupancy));
+    dates.reserve(historyDays + 1);
+    arrivalChance.reserve(historyDays + 1);
+    for (int day = 0; day <= historyDays; ++day) {
+        sys_days current = first + days(day);
+        year_month_day date(current);
+        dates.push_back(formatDate(date));
+        double dayOfYear = static_cast<double>((current - sys_days(date.year() / January / 1)).count());
+        double season = 1.0 + c.seasonality * std::cos(2.0 * 3.14159265358979323846 * (dayOfYear - kPeakDayOfYear) / 365.25);
+        arrivalChance.push_back(std::min(1.0, baseChance * season));
+    }
+}
+
+/**
+ * @brief Возвращает таблицы в порядке загрузки (сначала таблицы, на которые ссылаются другие).
+ */
+const std::vector<DataTable>& DataGenerator::loadOrder() {
+    static const std::vector<DataTable> order = {DataTable::PROPERTIES, DataTable::USERS, DataTable::ROOMS,
+                                                 DataTable::SERVICES, DataTable::BOOKINGS, DataTable::BOOKING_SERVICES};
+    return order;
+}
+
+/**
+ * @brief Возвращает имя таблицы в базе данных.
+ */
+const char* DataGenerator::tableName(DataTable table) {
+    switch (table) {
+        case DataTable::PROPERTIES: return "properties";
+        case DataTable::USERS: return "users";
+        case DataTable::ROOMS: return "rooms";
+        case DataTable::SERVICES: return "services";
+        case DataTable::BOOKINGS: return "bookings";
+        case DataTable::BOOKING_SERVICES: return "booking_services";
+    }
+    return "";
+}
+
+/**
+ * @brief Возвращает список столбцов таблицы в порядке полей генерируемых строк.
+ */
+const char* DataGenerator::columns(DataTable table) {
+    switch (table) {
+        case DataTable::PROPERTIES: return "id, name";
+        case DataTable::USERS: return "id, login, password_hash, role";
+        case DataTable::ROOMS: return "id, number, type, price_per_day, description, property_id";
+        case DataTable::SERVICES: return "id, name, price";
+        case DataTable::BOOKINGS: return "id, user_id, room_id, property_id, date_from, date_to, status, version";
+        case DataTable::BOOKING_SERVICES: return "booking_id, service_id, quantity, booking_date_from";
+    }
+    return "";
+}
+
+/**
+ * @brief Возвращает количество месяцев от месяца первого дня до месяца последнего дня.
+ */
+int DataGenerator::monthsSpanned() const {
+    std::chrono::year_month_day first = parseDate(dates.front());
+    std::chrono::year_month_day last = parseDate(dates.back());
+    return (static_cast<int>(last.year()) - static_cast<int>(first.year())) * 12 +
+           static_cast<int>(static_cast<unsigned>(last.month())) - static_cast<int>(static_cast<unsigned>(first.month()));
+}
+
+/**
+ * @brief Возвращает отель номера: номера делятся между отелями непрерывными блоками.
+ */
+int DataGenerator::propertyOfRoom(int roomId) const {
+    return static_cast<int>(static_cast<long long>(roomId - 1) * config.properties / config.rooms) + 1;
+}
+
+/**
+ * @brief Проходит все бронирования в порядке идентификаторов (без форматирования строк).
+ * Номера обходятся по возрастанию, бронирования номера - по дате заезда; выезд совпадает
+ * с днем, начиная с которого номер снова свободен.
+ * @param visit Вызывается для каждого бронирования.
+ */
+void DataGenerator::forEachBooking(const std::function<void(const GeneratedBooking&)>& visit) const {
+    int nextId = 1;
+    for (int roomId = 1; roomId <= config.rooms; ++roomId) {
+        Random random(streamSeed(config.seed, static_cast<std::uint64_t>(roomId)));
+        int propertyId = propertyOfRoom(roomId);
+        int day = 0;
+        while (day < historyDays) {
+            if (random.uniform() >= arrivalChance[day]) {
+                ++day;
+                continue;
+            }
+            int stay = 1 + std::min(kMaxStay - 1, static_cast<int>(-std::log1p(-random.uniform()) * kStayScale));
+            if (day + stay > historyDays) {
+                break;
+            }
+            double skew = random.uniform();
+            GeneratedBooking booking{nextId++, 3 + std::min(config.guests - 1, static_cast<int>(config.guests * skew * skew)),
+                                     roomId, propertyId, day, day + stay, nullptr};
+            if (random.uniform() < config.cancellationRate) {
+                booking.status = "cancelled";
+            } else if (booking.dateTo <= todayIndex) {
+                booking.status = "completed";
+            } else if (booking.dateFrom <= todayIndex) {
+                booking.status = "confirmed";
+            } else {
+                booking.status = random.uniform() < 0.6 ? "confirmed" : "pending";
+            }
+            visit(booking);
+            day += stay;
+        }
+    }
+}
+
+/**
+ * @brief Генерирует строки таблицы.
+ * Пользователь 1 - администратор admin, пользователь 2 - менеджер manager, остальные - гости
+ * guestNNNNNNN с паролем guest; гости выбираются неравномерно, поэтому у части из них много
+ * бронирований. Услуги получают только неотмененные бронирования; количество услуги не превышает
+ * числа ночей.
+ * @param table Таблица.
+ * @param flush Получает накопленную порцию строк; после вызова буфер очищается.
+ * @param chunkBytes Размер порции, после которого вызывается flush.
+ * @return Количество сгенерированных строк.
+ */
+long long DataGenerator::generate(DataTable table, const std::function<void(const std::string&)>& flush,
+                                  std::size_t chunkBytes) const {
+    std::string out;
+    out.reserve(chunkBytes + 256);
+    long long rows = 0;
+    auto rowDone = [&] {
+        endRow(out);
+        ++rows;
+        if (out.size() >= chunkBytes) {
+            flush(out);
+            out.clear();
+        }
+    };
+
+    switch (table) {
+        case DataTable::PROPERTIES:
+            for (int id = 1; id <= config.properties; ++id) {
+                appendInt(out, id);
+                endField(out);
+                out += id == 1 ? std::string("Main") : "Property " + std::to_string(id);
+                rowDone();
+            }
+            break;
+
+        case DataTable::USERS: {
+            out += "1\tadmin\tadmin\tadmin";
+            rowDone();
+            out += "2\tmanager\tmanager\tmanager";
+            rowDone();
+            char login[24];
+            for (int guest = 1; guest <= config.guests; ++guest) {
+                appendInt(out, guest + 2);
+                std::snprintf(login, sizeof(login), "\tguest%07d", guest);
+                out += login;
+                out += "\tguest\tuser";
+                rowDone();
+            }
+            break;
+        }
+
+        case DataTable::ROOMS:
+            for (int roomId = 1, first = 1; roomId <= config.rooms; ++roomId) {
+                int propertyId = propertyOfRoom(roomId);
+                if (roomId > 1 && propertyId != propertyOfRoom(roomId - 1)) {
+                    first = roomId;
+                }
+                int index = roomId - first;
+                int floor = index / kRoomsPerFloor + 1;
+                const RoomKind& kind = kRoomLayout[index % (sizeof(kRoomLayout) / sizeof(kRoomLayout[0]))];
+                appendInt(out, roomId);
+                endField(out);
+                if (config.properties > 1) {
+                    appendInt(out, propertyId);
+                    out.push_back('-');
+                }
+                appendInt(out, floor * 100 + index % kRoomsPerFloor + 1);
+                endField(out);
+                out += kind.type;
+                endField(out);
+                appendPrice(out, kind.price + 2.0 * std::min(floor, 10));
+                endField(out);
+                out += kind.type;
+                out += " room, floor ";
+                appendInt(out, floor);
+                endField(out);
+                appendInt(out, propertyId);
+                rowDone();
+            }
+            break;
+
+        case DataTable::SERVICES:
+            for (int i = 0; i < kCatalogSize; ++i) {
+                appendInt(out, i + 1);
+                endField(out);
+                out += kCatalog[i].name;
+                endField(out);
+                appendPrice(out, kCatalog[i].price);
+                rowDone();
+            }
+            break;
+
+        case DataTable::BOOKINGS:
+            forEachBooking([&](const GeneratedBooking& booking) {
+                appendInt(out, booking.id);
+                endField(out);
+                appendInt(out, booking.userId);
+                endField(out);
+                appendInt(out, booking.roomId);
+                endField(out);
+                appendInt(out, booking.propertyId);
+                endField(out);
+                out += dates[booking.dateFrom];
+                endField(out);
+                out += dates[booking.dateTo];
+                endField(out);
+                out += booking.status;
+                out += "\t0";
+                rowDone();
+            });
+            break;
+
+        case DataTable::BOOKING_SERVICES:
+            forEachBooking([&](const GeneratedBooking& booking) {
+                if (std::string_view(booking.status) == "cancelled") {
+                    return;
+                }
+                Random random(streamSeed(config.seed ^ kServiceStream, static_cast<std::uint64_t>(booking.id)));
+                // Число услуг - пуассоновское со средним servicesPerBooking (метод Кнута).
+                int count = 0;
+                double limit = std::exp(-config.servicesPerBooking);
+                for (double product = random.uniform(); product > limit && count < kCatalogSize; product *= random.uniform()) {
+                    ++count;
+                }
+                int order[kCatalogSize];
+                for (int i = 0; i < kCatalogSize; ++i) {
+                    order[i] = i;
+                }
+                int nights = booking.dateTo - booking.dateFrom;
+                for (int i = 0; i < count; ++i) {
+                    std::swap(order[i], order[i + random.below(kCatalogSize - i)]);
+                    appendInt(out, booking.id);
+                    endField(out);
+                    appendInt(out, order[i] + 1);
+                    endField(out);
+                    appendInt(out, 1 + random.below(nights));
+                    endField(out);
+                    out += dates[booking.dateFrom];
+                    rowDone();
+                }
+            });
+            break;
+    }
+
+    if (!out.empty()) {
+        flush(out);
+    }
+    return rows;
+}
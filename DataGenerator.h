@@ -0,0 +1,140 @@
+/**
+ * @file DataGenerator.h
+ * @brief Этот файл содержит объявление класса DataGenerator - детерминированного генератора
+ *        синтетических данных гостиницы (отели, пользователи, номера, услуги, бронирования и услуги
+ *        бронирований) в текстовом формате COPY для нагрузочных испытаний.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Параметры генерации.
+ */
+struct DataGenConfig {
+    std::uint64_t seed = 1;             ///< Зерно: одинаковые параметры дают одинаковые данные.
+    int properties = 1;                 ///< Количество отелей сети.
+    int rooms = 100;                    ///< Количество номеров (всего по сети).
+    int guests = 5000;                  ///< Количество гостей (кроме администратора и менеджера).
+    int years = 2;                      ///< Глубина истории в годах до today.
+    int monthsAhead = 3;                ///< Горизонт будущих бронирований в месяцах после today.
+    std::string today = "2025-01-01";   ///< Текущая дата в формате YYYY-MM-DD.
+    double occupancy = 0.7;             ///< Средняя загрузка номеров (0..1).
+    double seasonality = 0.3;           ///< Амплитуда сезонности (0..1), пик в середине июля.
+    double cancellationRate = 0.08;     ///< Доля отмененных бронирований.
+    double servicesPerBooking = 1.2;    ///< Среднее количество услуг на неотмененное бронирование.
+};
+
+/**
+ * @brief Генерируемая таблица.
+ */
+enum class DataTable {
+    PROPERTIES,
+    USERS,
+    ROOMS,
+    SERVICES,
+    BOOKINGS,
+    BOOKING_SERVICES
+};
+
+/**
+ * @brief Генератор синтетических данных.
+ * Бронирования строятся по номерам: для каждого номера случайная последовательность заездов
+ * проходит по календарю от начала истории до горизонта, и следующий заезд возможен не раньше
+ * выезда предыдущего, поэтому бронирования одного номера не пересекаются. Вероятность заезда
+ * подобрана под заданную загрузку и меняется по сезону. Случайные числа номера и услуг бронирования
+ * выводятся из зерна и идентификатора, поэтому каждую таблицу можно сгенерировать отдельно
+ * (booking_services повторно проходит те же бронирования) и результат не зависит от порядка вызовов.
+ * Строки выдаются порциями в текстовом формате COPY (поля через табуляцию, строки через \n).
+ */
+class DataGenerator {
+public:
+    /**
+     * @brief Бронирование, выданное генератором.
+     */
+    struct GeneratedBooking {
+        int id;
+        int userId;
+        int roomId;
+        int propertyId;
+        int dateFrom;           ///< Номер дня от начала истории.
+        int dateTo;             ///< Номер дня выезда от начала истории.
+        const char* status;
+    };
+
+private:
+    DataGenConfig config;
+    int historyDays;                    ///< Дней от начала истории до горизонта.
+    std::vector<std::string> dates;     ///< Даты YYYY-MM-DD по номеру дня.
+    std::vector<double> arrivalChance;  ///< Вероятность заезда в свободный номер по номеру дня.
+    int todayIndex;
+
+    /**
+     * @brief Возвращает отель номера.
+     */
+    int propertyOfRoom(int roomId) const;
+
+public:
+    /**
+     * @brief Конструирует генератор.
+     * @param config Параметры генерации.
+     * @throws std::invalid_argument Если параметры вне допустимых границ или дата имеет неверный формат.
+     */
+    explicit DataGenerator(DataGenConfig config);
+
+    /**
+     * @brief Возвращает таблицы в порядке загрузки (сначала таблицы, на которые ссылаются другие).
+     */
+    static const std::vector<DataTable>& loadOrder();
+
+    /**
+     * @brief Возвращает имя таблицы в базе данных.
+     */
+    static const char* tableName(DataTable table);
+
+    /**
+     * @brief Возвращает список столбцов таблицы в порядке полей генерируемых строк.
+     */
+    static const char* columns(DataTable table);
+
+    /**
+     * @brief Возвращает первый день истории в формате YYYY-MM-DD.
+     */
+    const std::string& firstDay() const { return dates.front(); }
+
+    /**
+     * @brief Возвращает последний день горизонта в формате YYYY-MM-DD.
+     */
+    const std::string& lastDay() const { return dates.back(); }
+
+    /**
+     * @brief Возвращает количество месяцев от месяца первого дня до месяца последнего дня.
+     */
+    int monthsSpanned() const;
+
+    /**
+     * @brief Генерирует строки таблицы.
+     * @param table Таблица.
+     * @param flush Получает накопленную порцию строк; после вызова буфер очищается.
+     * @param chunkBytes Размер порции, после которого вызывается flush.
+     * @return Количество сгенерированных строк.
+     */
+    long long generate(DataTable table, const std::function<void(const std::string&)>& flush,
+                       std::size_t chunkBytes = 1 << 20) const;
+
+    /**
+     * @brief Проходит все бронирования в порядке идентификаторов (без форматирования строк).
+     * @param visit Вызывается для каждого бронирования.
+     */
+    void forEachBooking(const std::function<void(const GeneratedBooking&)>& visit) const;
+
+    /**
+     * @brief Возвращает дату по номеру дня от начала истории.
+     */
+    const std::string& date(int day) const { return dates[day]; }
+};
@@ -0,0 +1,85 @@
+/**
+ * @file Deadline.h
+ * @brief Этот файл содержит класс Deadline - момент времени, к которому операция должна завершиться.
+ *        Используется для ограничения времени запросов к базе данных.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+
+/**
+ * @brief Крайний срок операции по монотонным часам.
+ * Объект по умолчанию не ограничивает время. Крайние сроки вложенных операций
+ * объединяются методом earliest(): действует более ранний.
+ */
+class Deadline {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    Clock::time_point when;
+    bool bounded;
+
+    Deadline(Clock::time_point when, bool bounded) : when(when), bounded(bounded) {}
+
+public:
+    /**
+     * @brief Конструирует неограниченный крайний срок.
+     */
+    Deadline() : when(), bounded(false) {}
+
+    /**
+     * @brief Возвращает неограниченный крайний срок.
+     */
+    static Deadline never() { return Deadline(); }
+
+    /**
+     * @brief Возвращает крайний срок через указанное время от текущего момента.
+     * @param timeout Допустимая длительность; нулевая или отрицательная - срок уже истек.
+     */
+    static Deadline after(std::chrono::milliseconds timeout) { return Deadline(Clock::now() + timeout, true); }
+
+    /**
+     * @brief Возвращает крайний срок в указанный момент.
+     * @param time Момент по монотонным часам.
+     */
+    static Deadline at(Clock::time_point time) { return Deadline(time, true); }
+
+    /**
+     * @brief Проверяет, ограничен ли срок.
+     */
+    bool isBounded() const { return bounded; }
+
+    /**
+     * @brief Проверяет, истек ли срок. Неограниченный срок не истекает.
+     */
+    bool expired() const { return bounded && Clock::now() >= when; }
+
+    /**
+     * @brief Возвращает оставшееся время (не меньше нуля); для неограниченного срока - максимум.
+     */
+    std::chrono::milliseconds remaining() const {
+        if (!bounded) {
+            return std::chrono::milliseconds::max();
+        }
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(when - Clock::now());
+        return std::max(left, std::chrono::milliseconds(0));
+    }
+
+    /**
+     * @brief Возвращает момент истечения (для ограниченного срока).
+     */
+    Clock::time_point time() const { return when; }
+
+    /**
+     * @brief Возвращает более ранний из двух сроков.
+     * @param other Другой крайний срок.
+     */
+    Deadline earliest(const Deadline& other) const {
+        if (!bounded) return other;
+        if (!other.bounded) return *this;
+        return when <= other.when ? *this : other;
+    }
+};
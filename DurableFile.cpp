@@ -0,0 +1,62 @@
+/**
+ * @file DurableFile.cpp
+ * @brief Этот файл содержит реализацию функций надежной записи файлов.
+ */
+
+#include "DurableFile.h"
+#include <cstdio>
+#include <filesystem>
+#include <stdexcept>
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Записывает файл и сбрасывает его на диск.
+ * @throws std::runtime_error При ошибке записи.
+ */
+void writeDurably(const std::string& path, const std::string& data) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        throw std::runtime_error("Failed to open " + path);
+    }
+    bool written = std::fwrite(data.data(), 1, data.size(), file) == data.size() && std::fflush(file) == 0;
+#ifdef _WIN32
+    written = written && _commit(_fileno(file)) == 0;
+#else
+    written = written && fsync(fileno(file)) == 0;
+#endif
+    if (std::fclose(file) != 0 || !written) {
+        throw std::runtime_error("Failed to write " + path);
+    }
+}
+
+/**
+ * @brief Атомарно заменяет файл target файлом source и сбрасывает на диск запись каталога.
+ * @throws std::runtime_error При ошибке переименования или сброса.
+ */
+void replaceDurably(const std::string& source, const std::string& target) {
+#ifdef _WIN32
+    if (!MoveFileExA(source.c_str(), target.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+        throw std::runtime_error("Failed to rename " + source + " to " + target);
+    }
+#else
+    if (std::rename(source.c_str(), target.c_str()) != 0) {
+        throw std::runtime_error("Failed to rename " + source + " to " + target);
+    }
+    std::string directory = std::filesystem::path(target).parent_path().string();
+    int fd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY);
+    bool synced = fd >= 0 && fsync(fd) == 0;
+    if (fd >= 0) {
+        ::close(fd);
+    }
+    if (!synced) {
+        throw std::runtime_error("Failed to sync directory of " + target);
+    }
+#endif
+}
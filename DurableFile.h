@@ -0,0 +1,26 @@
+/**
+ * @file DurableFile.h
+ * @brief Этот файл содержит функции надежной записи файлов: данные сбрасываются на диск,
+ *        а замена файла атомарна и переживает сбой питания.
+ */
+
+#pragma once
+
+#include <string>
+
+/**
+ * @brief Записывает файл и сбрасывает его на диск (fsync, под Windows _commit).
+ * @param path Путь к файлу (перезаписывается).
+ * @param data Содержимое файла.
+ * @throws std::runtime_error При ошибке записи.
+ */
+void writeDurably(const std::string& path, const std::string& data);
+
+/**
+ * @brief Атомарно заменяет файл target файлом source и сбрасывает на диск запись каталога.
+ * Под Windows используется MoveFileEx с MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH.
+ * @param source Записанный временный файл.
+ * @param target Заменяемый файл.
+ * @throws std::runtime_error При ошибке переименования или сброса.
+ */
+void replaceDurably(const std::string& source, const std::string& target);
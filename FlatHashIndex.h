@@ -0,0 +1,182 @@
+/**
+ * @file FlatHashIndex.h
+ * @brief Этот файл содержит шаблон FlatHashIndex - плоского хэш-индекса с открытой адресацией
+ *        для быстрого поиска по строковым ключам (номер комнаты, логин пользователя).
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Плоский хэш-индекс с открытой адресацией (линейное пробирование).
+ * Ключи хранятся подряд в одном буфере символов, слоты - в одном массиве,
+ * поэтому вставка не выделяет память под отдельные узлы, а поиск принимает std::string_view
+ * без создания временных строк.
+ * @tparam V Тип значения (должен быть тривиально копируемым, например int или size_t).
+ */
+template <typename V>
+class FlatHashIndex {
+private:
+    /**
+     * @brief Слот таблицы. Пустой слот имеет hash == 0.
+     */
+    struct Slot {
+        std::uint64_t hash;
+        std::uint32_t keyOffset;
+        std::uint32_t keyLength;
+        V value;
+    };
+
+    std::vector<Slot> slots;   ///< Массив слотов, размер - степень двойки.
+    std::vector<char> keys;    ///< Буфер, в котором подряд лежат все ключи.
+    std::size_t count;         ///< Количество занятых слотов.
+
+public:
+    /**
+     * @brief Конструирует пустой индекс.
+     * @param expected Ожидаемое количество ключей (для предварительного выделения).
+     */
+    explicit FlatHashIndex(std::size_t expected = 16) : count(0) {
+        reserve(expected);
+    }
+
+    /**
+     * @brief Вставляет ключ или обновляет значение существующего ключа.
+     * @param key Ключ.
+     * @param value Значение.
+     * @return True, если ключ был добавлен, false, если значение существующего ключа обновлено.
+     */
+    bool insert(std::string_view key, V value) {
+        if ((count + 1) * 4 > slots.size() * 3) {
+            rehash(slots.size() * 2);
+        }
+        std::uint64_t h = hashKey(key);
+        std::size_t mask = slots.size() - 1;
+        for (std::size_t i = h & mask;; i = (i + 1) & mask) {
+            Slot& slot = slots[i];
+            if (slot.hash == 0) {
+                slot.hash = h;
+                slot.keyOffset = static_cast<std::uint32_t>(keys.size());
+                slot.keyLength = static_cast<std::uint32_t>(key.size());
+                slot.value = value;
+                keys.insert(keys.end(), key.begin(), key.end());
+                ++count;
+                return true;
+            }
+            if (slot.hash == h && keyAt(slot) == key) {
+                slot.value = value;
+                return false;
+            }
+        }
+    }
+
+    /**
+     * @brief Ищет значение по ключу.
+     * @param key Ключ.
+     * @return Указатель на значение или nullptr, если ключ не найден.
+     *         Указатель действителен до следующей вставки.
+     */
+    const V* find(std::string_view key) const {
+        std::uint64_t h = hashKey(key);
+        std::size_t mask = slots.size() - 1;
+        for (std::size_t i = h & mask;; i = (i + 1) & mask) {
+            const Slot& slot = slots[i];
+            if (slot.hash == 0) {
+                return nullptr;
+            }
+            if (slot.hash == h && keyAt(slot) == key) {
+                return &slot.value;
+            }
+        }
+    }
+
+    /**
+     * @brief Проверяет наличие ключа в индексе.
+     * @param key Ключ.
+     * @return True, если ключ присутствует.
+     */
+    bool contains(std::string_view key) const { return find(key) != nullptr; }
+
+    /**
+     * @brief Возвращает количество ключей в индексе.
+     * @return Количество ключей.
+     */
+    std::size_t size() const { return count; }
+
+    /**
+     * @brief Проверяет, пуст ли индекс.
+     * @return True, если ключей нет.
+     */
+    bool empty() const { return count == 0; }
+
+    /**
+     * @brief Удаляет все ключи, сохраняя выделенную память.
+     */
+    void clear() {
+        for (Slot& slot : slots) {
+            slot.hash = 0;
+        }
+        keys.clear();
+        count = 0;
+    }
+
+    /**
+     * @brief Резервирует место под указанное количество ключей без перехэширования при вставке.
+     * @param expected Ожидаемое количество ключей.
+     */
+    void reserve(std::size_t expected) {
+        std::size_t capacity = 16;
+        while (capacity * 3 < expected * 4) {
+            capacity *= 2;
+        }
+        if (capacity > slots.size()) {
+            rehash(capacity);
+        }
+    }
+
+private:
+    /**
+     * @brief Возвращает ключ, хранящийся в слоте.
+     */
+    std::string_view keyAt(const Slot& slot) const {
+        return std::string_view(keys.data() + slot.keyOffset, slot.keyLength);
+    }
+
+    /**
+     * @brief Вычисляет хэш ключа (FNV-1a с финальным перемешиванием). Никогда не возвращает 0.
+     */
+    static std::uint64_t hashKey(std::string_view key) {
+        std::uint64_t h = 1469598103934665603ULL;
+        for (unsigned char c : key) {
+            h ^= c;
+            h *= 1099511628211ULL;
+        }
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return h == 0 ? 1 : h;
+    }
+
+    /**
+     * @brief Перестраивает таблицу слотов под новую емкость. Буфер ключей не копируется.
+     */
+    void rehash(std::size_t newCapacity) {
+        std::vector<Slot> old(newCapacity, Slot{0, 0, 0, V{}});
+        old.swap(slots);
+        std::size_t mask = slots.size() - 1;
+        for (const Slot& slot : old) {
+            if (slot.hash == 0) {
+                continue;
+            }
+            std::size_t i = slot.hash & mask;
+            while (slots[i].hash != 0) {
+                i = (i + 1) & mask;
+            }
+            slots[i] = slot;
+        }
+    }
+};
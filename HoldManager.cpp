@@ -0,0 +1,279 @@
+/**
+ * @file HoldManager.cpp
+ * @brief Этот файл содержит реализацию класса HoldManager.
+ */
+
+#include "HoldManager.h"
+#include "Booking.h"
+#include "Metrics.h"
+#include "Tracing.h"
+#include <algorithm>
+#include <mutex>
+
+/**
+ * @brief Конструирует менеджер удержаний.
+ * @param ttl Время жизни удержания.
+ * @param wheelSlots Количество слотов колеса таймеров каждой полосы.
+ */
+HoldManager::HoldManager(std::chrono::seconds ttl, std::size_t wheelSlots) : ttl(ttl) {
+    std::uint64_t now = static_cast<std::uint64_t>(toSeconds(Clock::now()));
+    for (Stripe& stripe : stripes) {
+        stripe.expiry = TimingWheel<std::uint64_t>(wheelSlots, now);
+    }
+}
+
+/**
+ * @brief Переводит момент времени в секунды (тики колеса).
+ */
+std::int64_t HoldManager::toSeconds(Clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+}
+
+/**
+ * @brief Возвращает полосу номера.
+ */
+HoldManager::Stripe& HoldManager::stripeForRoom(int roomId) {
+    return stripes[static_cast<unsigned>(roomId) % STRIPES];
+}
+
+/**
+ * @brief Возвращает полосу удержания (номер полосы хранится в младших битах идентификатора).
+ */
+HoldManager::Stripe& HoldManager::stripeForHold(std::uint64_t holdId) {
+    return stripes[holdId % STRIPES];
+}
+
+/**
+ * @brief Проверяет, мешает ли действующее удержание другого пользователя диапазону дат.
+ * Подтверждаемое удержание мешает, даже если истекло: его бронирование может быть уже записано.
+ * Даты сравниваются как строки YYYY-MM-DD; диапазоны полуоткрытые, как в OVERLAPS.
+ */
+bool HoldManager::blocks(const Stripe& stripe, int roomId, const std::string& dateFrom, const std::string& dateTo,
+                         int exceptUserId, std::int64_t seconds) {
+    auto room = stripe.byRoom.find(roomId);
+    if (room == stripe.byRoom.end()) {
+        return false;
+    }
+    for (std::uint64_t id : room->second) {
+        const Hold& hold = stripe.holds.at(id);
+        if (hold.userId != exceptUserId && (hold.converting || hold.expiresAt > seconds) &&
+            hold.dateFrom < dateTo && dateFrom < hold.dateTo) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Удаляет удержание из полосы. Запись в колесе таймеров удаляется лениво.
+ */
+void HoldManager::erase(Stripe& stripe, std::uint64_t holdId) {
+    auto it = stripe.holds.find(holdId);
+    if (it == stripe.holds.end()) {
+        return;
+    }
+    auto room = stripe.byRoom.find(it->second.roomId);
+    std::vector<std::uint64_t>& ids = room->second;
+    *std::find(ids.begin(), ids.end(), holdId) = ids.back();
+    ids.pop_back();
+    if (ids.empty()) {
+        stripe.byRoom.erase(room);
+    }
+    stripe.holds.erase(it);
+}
+
+/**
+ * @brief Удерживает номер на диапазон дат.
+ * @param roomId Идентификатор номера.
+ * @param userId Пользователь.
+ * @param dateFrom Дата начала.
+ * @param dateTo Дата окончания.
+ * @param now Текущее время.
+ * @return Удержание или std::nullopt, если номер удерживает другой пользователь.
+ */
+std::optional<Hold> HoldManager::place(int roomId, int userId, const std::string& dateFrom, const std::string& dateTo,
+                                       Clock::time_point now) {
+    static MetricCounter& placed = MetricsRegistry::global().counter(
+        "hotel_holds_placed_total", "Tentative room holds placed.");
+    static MetricCounter& rejected = MetricsRegistry::global().counter(
+        "hotel_holds_rejected_total", "Hold requests rejected because another user holds the room.");
+    std::int64_t seconds = toSeconds(now);
+    Stripe& stripe = stripeForRoom(roomId);
+    Hold hold;
+    hold.id = nextSequence.fetch_add(1, std::memory_order_relaxed) * STRIPES + static_cast<unsigned>(roomId) % STRIPES;
+    hold.roomId = roomId;
+    hold.userId = userId;
+    hold.dateFrom = dateFrom;
+    hold.dateTo = dateTo;
+    hold.expiresAt = seconds + ttl.count();
+
+    std::unique_lock<std::shared_mutex> lock(stripe.mutex);
+    if (blocks(stripe, roomId, dateFrom, dateTo, userId, seconds)) {
+        rejected.increment();
+        return std::nullopt;
+    }
+    stripe.holds.emplace(hold.id, hold);
+    stripe.byRoom[roomId].push_back(hold.id);
+    stripe.expiry.schedule(hold.id, static_cast<std::uint64_t>(hold.expiresAt));
+    placed.increment();
+    return hold;
+}
+
+/**
+ * @brief Находит действующее удержание.
+ * @param holdId Идентификатор удержания.
+ * @param now Текущее время.
+ * @return Удержание или std::nullopt, если оно неизвестно или истекло.
+ */
+std::optional<Hold> HoldManager::find(std::uint64_t holdId, Clock::time_point now) const {
+    std::int64_t seconds = toSeconds(now);
+    const Stripe& stripe = stripes[holdId % STRIPES];
+    std::shared_lock<std::shared_mutex> lock(stripe.mutex);
+    auto it = stripe.holds.find(holdId);
+    if (it == stripe.holds.end() || (!it->second.converting && it->second.expiresAt <= seconds)) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+/**
+ * @brief Продлевает действующее удержание пользователя на ttl от текущего момента.
+ * Колесо не трогается: при срабатывании старого таймера удержание ставится на новый срок.
+ * @return True, если удержание продлено.
+ */
+bool HoldManager::extend(std::uint64_t holdId, int userId, Clock::time_point now) {
+    std::int64_t seconds = toSeconds(now);
+    Stripe& stripe = stripeForHold(holdId);
+    std::unique_lock<std::shared_mutex> lock(stripe.mutex);
+    auto it = stripe.holds.find(holdId);
+    if (it == stripe.holds.end() || it->second.userId != userId || it->second.converting ||
+        it->second.expiresAt <= seconds) {
+        return false;
+    }
+    it->second.expiresAt = seconds + ttl.count();
+    return true;
+}
+
+/**
+ * @brief Снимает удержание пользователя. Подтверждаемое удержание не снимается.
+ * @return True, если удержание существовало.
+ */
+bool HoldManager::release(std::uint64_t holdId, int userId) {
+    Stripe& stripe = stripeForHold(holdId);
+    std::unique_lock<std::shared_mutex> lock(stripe.mutex);
+    auto it = stripe.holds.find(holdId);
+    if (it == stripe.holds.end() || it->second.userId != userId || it->second.converting) {
+        return false;
+    }
+    erase(stripe, holdId);
+    return true;
+}
+
+/**
+ * @brief Проверяет, удерживает ли номер на пересекающиеся даты другой пользователь.
+ * @param roomId Идентификатор номера.
+ * @param dateFrom Дата начала.
+ * @param dateTo Дата окончания.
+ * @param exceptUserId Пользователь, чьи удержания не учитываются (0 - учитываются все).
+ * @param now Текущее время.
+ */
+bool HoldManager::isHeld(int roomId, const std::string& dateFrom, const std::string& dateTo, int exceptUserId,
+                         Clock::time_point now) const {
+    const Stripe& stripe = stripes[static_cast<unsigned>(roomId) % STRIPES];
+    std::shared_lock<std::shared_mutex> lock(stripe.mutex);
+    return blocks(stripe, roomId, dateFrom, dateTo, exceptUserId, toSeconds(now));
+}
+
+/**
+ * @brief Превращает удержание в бронирование (Booking::createBookingIfFree, сериализовано по номеру).
+ * На время записи удержание помечается как подтверждаемое: повторное подтверждение, снятие и
+ * истечение его не трогают, а пересекающиеся удержания по-прежнему отклоняются.
+ * @param dbManager Менеджер базы данных.
+ * @param holdId Идентификатор удержания.
+ * @param userId Пользователь (должен владеть удержанием).
+ * @param now Текущее время.
+ * @return Бронирование или nullptr, если удержание не найдено, истекло, уже подтверждается или номер занят.
+ */
+std::unique_ptr<Booking> HoldManager::confirm(DBManager& dbManager, std::uint64_t holdId, int userId,
+                                              Clock::time_point now) {
+    TraceSpan span("HoldManager::confirm", "entity");
+    static MetricCounter& converted = MetricsRegistry::global().counter(
+        "hotel_holds_converted_total", "Holds converted into bookings.");
+    std::int64_t seconds = toSeconds(now);
+    Stripe& stripe = stripeForHold(holdId);
+    Hold hold;
+    {
+        std::unique_lock<std::shared_mutex> lock(stripe.mutex);
+        auto it = stripe.holds.find(holdId);
+        if (it == stripe.holds.end() || it->second.userId != userId || it->second.converting ||
+            it->second.expiresAt <= seconds) {
+            return nullptr;
+        }
+        it->second.converting = true;
+        hold = it->second;
+    }
+
+    std::unique_ptr<Booking> booking;
+    try {
+        booking = Booking::createBookingIfFree(dbManager, userId, hold.roomId, hold.dateFrom, hold.dateTo);
+    } catch (...) {
+        std::unique_lock<std::shared_mutex> lock(stripe.mutex);
+        auto it = stripe.holds.find(holdId);
+        if (it != stripe.holds.end()) {
+            it->second.converting = false;
+        }
+        throw;
+    }
+    {
+        std::unique_lock<std::shared_mutex> lock(stripe.mutex);
+        erase(stripe, holdId);
+    }
+    if (booking) {
+        converted.increment();
+    }
+    return booking;
+}
+
+/**
+ * @brief Освобождает истекшие удержания.
+ * Продленные удержания ставятся на новый срок, подтверждаемые проверяются на следующем тике.
+ * @param now Текущее время.
+ * @return Количество освобожденных удержаний.
+ */
+std::size_t HoldManager::expire(Clock::time_point now) {
+    static MetricCounter& expired = MetricsRegistry::global().counter(
+        "hotel_holds_expired_total", "Holds released after their TTL without a booking.");
+    std::int64_t seconds = toSeconds(now);
+    std::size_t removed = 0;
+    for (Stripe& stripe : stripes) {
+        std::unique_lock<std::shared_mutex> lock(stripe.mutex);
+        stripe.expiry.advance(static_cast<std::uint64_t>(seconds), [&](std::uint64_t id) {
+            auto it = stripe.holds.find(id);
+            if (it == stripe.holds.end()) {
+                return;
+            }
+            if (it->second.converting) {
+                stripe.expiry.schedule(id, static_cast<std::uint64_t>(seconds + 1));
+            } else if (it->second.expiresAt <= seconds) {
+                erase(stripe, id);
+                ++removed;
+            } else {
+                stripe.expiry.schedule(id, static_cast<std::uint64_t>(it->second.expiresAt));
+            }
+        });
+    }
+    expired.increment(removed);
+    return removed;
+}
+
+/**
+ * @brief Возвращает количество удержаний (включая истекшие, но еще не освобожденные).
+ */
+std::size_t HoldManager::size() const {
+    std::size_t total = 0;
+    for (const Stripe& stripe : stripes) {
+        std::shared_lock<std::shared_mutex> lock(stripe.mutex);
+        total += stripe.holds.size();
+    }
+    return total;
+}
@@ -0,0 +1,177 @@
+/**
+ * @file HoldManager.h
+ * @brief Этот файл содержит объявление класса HoldManager - временных удержаний номеров в памяти
+ *        процесса на время оформления бронирования.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "TimingWheel.h"
+
+class Booking;
+class DBManager;
+
+/**
+ * @brief Временное удержание номера на диапазон дат.
+ */
+struct Hold {
+    std::uint64_t id = 0;        ///< Идентификатор удержания.
+    int roomId = 0;
+    int userId = 0;              ///< Пользователь, оформляющий бронирование.
+    std::string dateFrom;        ///< Дата начала (включительно).
+    std::string dateTo;          ///< Дата окончания (не включительно, как в OVERLAPS).
+    std::int64_t expiresAt = 0;  ///< Момент истечения (секунды steady_clock).
+    bool converting = false;     ///< Идет запись бронирования по удержанию.
+};
+
+/**
+ * @brief Потокобезопасный менеджер временных удержаний номеров.
+ *
+ * Пока гость выбирает номер и подтверждает бронирование, номер удерживается за ним на ttl: другие
+ * пользователи не могут удержать или забронировать пересекающийся диапазон дат, а в списке свободных
+ * номеров он не показывается. Удержания живут только в памяти и не обращаются к базе данных; в базу
+ * данных пишется лишь подтвержденное бронирование (confirm) - через Booking::createBookingIfFree.
+ *
+ * Удержания разделены на STRIPES полос по номеру комнаты, у каждой полосы свои блокировка, индекс по
+ * номеру и колесо таймеров с шагом в одну секунду, поэтому удержания разных номеров не конкурируют.
+ * Истекшее удержание перестает действовать сразу (проверяется время), а память освобождает expire.
+ */
+class HoldManager {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::size_t STRIPES = 64;
+
+private:
+    /**
+     * @brief Полоса удержаний.
+     */
+    struct Stripe {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::uint64_t, Hold> holds;
+        std::unordered_map<int, std::vector<std::uint64_t>> byRoom;   ///< Удержания по номерам.
+        TimingWheel<std::uint64_t> expiry;
+    };
+
+    std::array<Stripe, STRIPES> stripes;
+    std::chrono::seconds ttl;
+    std::atomic<std::uint64_t> nextSequence{1};
+
+    /**
+     * @brief Возвращает полосу номера.
+     */
+    Stripe& stripeForRoom(int roomId);
+
+    /**
+     * @brief Возвращает полосу удержания (номер полосы хранится в младших битах идентификатора).
+     */
+    Stripe& stripeForHold(std::uint64_t holdId);
+
+    /**
+     * @brief Проверяет, мешает ли действующее удержание другого пользователя диапазону дат (под mutex полосы).
+     */
+    static bool blocks(const Stripe& stripe, int roomId, const std::string& dateFrom, const std::string& dateTo,
+                       int exceptUserId, std::int64_t seconds);
+
+    /**
+     * @brief Удаляет удержание из полосы (под mutex полосы).
+     */
+    static void erase(Stripe& stripe, std::uint64_t holdId);
+
+    /**
+     * @brief Переводит момент времени в секунды (тики колеса).
+     */
+    static std::int64_t toSeconds(Clock::time_point time);
+
+public:
+    /**
+     * @brief Конструирует менеджер удержаний.
+     * @param ttl Время жизни удержания.
+     * @param wheelSlots Количество слотов колеса таймеров каждой полосы.
+     */
+    explicit HoldManager(std::chrono::seconds ttl = std::chrono::minutes(10), std::size_t wheelSlots = 1024);
+
+    /**
+     * @brief Удерживает номер на диапазон дат.
+     * Собственные удержания пользователя не мешают новому.
+     * @param roomId Идентификатор номера.
+     * @param userId Пользователь.
+     * @param dateFrom Дата начала.
+     * @param dateTo Дата окончания.
+     * @param now Текущее время.
+     * @return Удержание или std::nullopt, если номер удерживает другой пользователь.
+     */
+    std::optional<Hold> place(int roomId, int userId, const std::string& dateFrom, const std::string& dateTo,
+                              Clock::time_point now = Clock::now());
+
+    /**
+     * @brief Находит действующее удержание.
+     * @param holdId Идентификатор удержания.
+     * @param now Текущее время.
+     * @return Удержание или std::nullopt, если оно неизвестно или истекло.
+     */
+    std::optional<Hold> find(std::uint64_t holdId, Clock::time_point now = Clock::now()) const;
+
+    /**
+     * @brief Продлевает действующее удержание пользователя на ttl от текущего момента.
+     * @return True, если удержание продлено.
+     */
+    bool extend(std::uint64_t holdId, int userId, Clock::time_point now = Clock::now());
+
+    /**
+     * @brief Снимает удержание пользователя.
+     * @return True, если удержание существовало.
+     */
+    bool release(std::uint64_t holdId, int userId);
+
+    /**
+     * @brief Проверяет, удерживает ли номер на пересекающиеся даты другой пользователь.
+     * @param roomId Идентификатор номера.
+     * @param dateFrom Дата начала.
+     * @param dateTo Дата окончания.
+     * @param exceptUserId Пользователь, чьи удержания не учитываются (0 - учитываются все).
+     * @param now Текущее время.
+     */
+    bool isHeld(int roomId, const std::string& dateFrom, const std::string& dateTo, int exceptUserId = 0,
+                Clock::time_point now = Clock::now()) const;
+
+    /**
+     * @brief Превращает удержание в бронирование (Booking::createBookingIfFree, сериализовано по номеру).
+     * Удержание снимается, если бронирование создано или номер уже занят в базе данных; при ошибке
+     * базы данных оно остается, и подтверждение можно повторить.
+     * @param dbManager Менеджер базы данных.
+     * @param holdId Идентификатор удержания.
+     * @param userId Пользователь (должен владеть удержанием).
+     * @param now Текущее время.
+     * @return Бронирование или nullptr, если удержание не найдено, истекло, уже подтверждается или номер занят.
+     */
+    std::unique_ptr<Booking> confirm(DBManager& dbManager, std::uint64_t holdId, int userId,
+                                     Clock::time_point now = Clock::now());
+
+    /**
+     * @brief Освобождает истекшие удержания.
+     * @param now Текущее время.
+     * @return Количество освобожденных удержаний.
+     */
+    std::size_t expire(Clock::time_point now = Clock::now());
+
+    /**
+     * @brief Возвращает количество удержаний (включая истекшие, но еще не освобожденные).
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Возвращает время жизни удержания.
+     */
+    std::chrono::seconds getTtl() const { return ttl; }
+};
@@ -0,0 +1,257 @@
+/**
+ * @file HttpMessage.cpp
+ * @brief Этот файл содержит реализацию разбора HTTP-запросов и сериализации HTTP-ответов.
+ */
+
+#include "HttpMessage.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+
+namespace {
+
+/**
+ * @brief Приводит строку к нижнему регистру.
+ */
+std::string toLower(std::string_view text) {
+    std::string result(text);
+    std::transform(result.begin(), result.end(), result.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return result;
+}
+
+/**
+ * @brief Удаляет пробелы и табуляции по краям строки.
+ */
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) text.remove_suffix(1);
+    return text;
+}
+
+/**
+ * @brief Возвращает текстовое описание кода состояния.
+ */
+const char* reasonPhrase(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 201: return "Created";
+        case 400: return "Bad Request";
+        case 401: return "Unauthorized";
+        case 403: return "Forbidden";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 409: return "Conflict";
+        case 413: return "Payload Too Large";
+        case 503: return "Service Unavailable";
+        case 504: return "Gateway Timeout";
+        default: return status >= 500 ? "Internal Server Error" : "Unknown";
+    }
+}
+
+/**
+ * @brief Возвращает значение шестнадцатеричной цифры или -1.
+ */
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+} // namespace
+
+/**
+ * @brief Возвращает значение заголовка.
+ * @param name Имя заголовка в нижнем регистре.
+ * @return Значение заголовка или пустая строка.
+ */
+std::string HttpRequest::header(const std::string& name) const {
+    auto it = headers.find(name);
+    return it == headers.end() ? std::string() : it->second;
+}
+
+/**
+ * @brief Сериализует ответ в формат HTTP/1.1.
+ * @param keepAlive Сохранять ли соединение после ответа.
+ * @return Готовые к отправке байты.
+ */
+std::string HttpResponse::serialize(bool keepAlive) const {
+    std::string out;
+    out.reserve(128 + body.size());
+    out += "HTTP/1.1 " + std::to_string(status) + " " + reasonPhrase(status) + "\r\n";
+    out += "Content-Type: " + contentType + "\r\n";
+    out += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+    out += keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+    out += body;
+    return out;
+}
+
+/**
+ * @brief Создает JSON-ответ с ошибкой вида {"error": "..."}.
+ * @param status Код состояния.
+ * @param message Текст ошибки.
+ */
+HttpResponse HttpResponse::error(int status, const std::string& message) {
+    HttpResponse response;
+    response.status = status;
+    response.body = "{\"error\":\"" + jsonEscape(message) + "\"}";
+    return response;
+}
+
+/**
+ * @brief Разбирает один HTTP/1.x запрос из начала буфера.
+ * @param buffer Накопленные байты соединения.
+ * @param request Заполняется при статусе COMPLETE.
+ * @param consumed Количество байт, занятых запросом (при статусе COMPLETE).
+ * @param maxSize Максимальный размер запроса вместе с телом.
+ * @return Статус разбора.
+ */
+ParseStatus parseHttpRequest(std::string_view buffer, HttpRequest& request, std::size_t& consumed, std::size_t maxSize) {
+    std::size_t headerEnd = buffer.find("\r\n\r\n");
+    if (headerEnd == std::string_view::npos) {
+        return buffer.size() > maxSize ? ParseStatus::BAD : ParseStatus::INCOMPLETE;
+    }
+
+    std::string_view head = buffer.substr(0, headerEnd);
+    std::size_t lineEnd = head.find("\r\n");
+    std::string_view requestLine = head.substr(0, lineEnd);
+
+    std::size_t firstSpace = requestLine.find(' ');
+    std::size_t secondSpace = requestLine.rfind(' ');
+    if (firstSpace == std::string_view::npos || secondSpace == firstSpace) {
+        return ParseStatus::BAD;
+    }
+    std::string_view version = requestLine.substr(secondSpace + 1);
+    if (version != "HTTP/1.1" && version != "HTTP/1.0") {
+        return ParseStatus::BAD;
+    }
+    std::string_view target = requestLine.substr(firstSpace + 1, secondSpace - firstSpace - 1);
+    if (target.empty() || target.front() != '/') {
+        return ParseStatus::BAD;
+    }
+
+    HttpRequest parsed;
+    parsed.method = std::string(requestLine.substr(0, firstSpace));
+    std::size_t question = target.find('?');
+    parsed.path = std::string(target.substr(0, question));
+    if (question != std::string_view::npos) {
+        parsed.query = std::string(target.substr(question + 1));
+    }
+
+    std::size_t position = lineEnd == std::string_view::npos ? head.size() : lineEnd + 2;
+    while (position < head.size()) {
+        std::size_t next = head.find("\r\n", position);
+        if (next == std::string_view::npos) next = head.size();
+        std::string_view line = head.substr(position, next - position);
+        std::size_t colon = line.find(':');
+        if (colon == std::string_view::npos || colon == 0) {
+            return ParseStatus::BAD;
+        }
+        parsed.headers[toLower(trim(line.substr(0, colon)))] = std::string(trim(line.substr(colon + 1)));
+        position = next + 2;
+    }
+
+    if (!parsed.header("transfer-encoding").empty()) {
+        return ParseStatus::BAD;
+    }
+    std::size_t contentLength = 0;
+    std::string lengthHeader = parsed.header("content-length");
+    if (!lengthHeader.empty()) {
+        if (lengthHeader.size() > 9 || !std::all_of(lengthHeader.begin(), lengthHeader.end(),
+                                                     [](unsigned char c) { return std::isdigit(c); })) {
+            return ParseStatus::BAD;
+        }
+        contentLength = std::stoul(lengthHeader);
+    }
+    std::size_t total = headerEnd + 4 + contentLength;
+    if (total > maxSize) {
+        return ParseStatus::BAD;
+    }
+    if (buffer.size() < total) {
+        return ParseStatus::INCOMPLETE;
+    }
+    parsed.body = std::string(buffer.substr(headerEnd + 4, contentLength));
+
+    std::string connection = toLower(parsed.header("connection"));
+    parsed.keepAlive = version == "HTTP/1.1" ? connection != "close" : connection == "keep-alive";
+
+    request = std::move(parsed);
+    consumed = total;
+    return ParseStatus::COMPLETE;
+}
+
+/**
+ * @brief Декодирует строку из URL-кодировки (%XX и '+' как пробел).
+ * Некорректные последовательности %XX оставляются как есть.
+ * @param text Закодированная строка.
+ * @return Декодированная строка.
+ */
+std::string urlDecode(std::string_view text) {
+    std::string result;
+    result.reserve(text.size());
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        char c = text[i];
+        if (c == '+') {
+            result.push_back(' ');
+        } else if (c == '%' && i + 2 < text.size() && hexValue(text[i + 1]) >= 0 && hexValue(text[i + 2]) >= 0) {
+            result.push_back(static_cast<char>(hexValue(text[i + 1]) * 16 + hexValue(text[i + 2])));
+            i += 2;
+        } else {
+            result.push_back(c);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Разбирает параметры формы или строки запроса вида a=1&b=2.
+ * @param text Закодированные параметры.
+ * @return Словарь параметров.
+ */
+std::map<std::string, std::string> parseForm(std::string_view text) {
+    std::map<std::string, std::string> fields;
+    while (!text.empty()) {
+        std::size_t amp = text.find('&');
+        std::string_view pair = text.substr(0, amp);
+        if (!pair.empty()) {
+            std::size_t eq = pair.find('=');
+            if (eq == std::string_view::npos) {
+                fields[urlDecode(pair)] = "";
+            } else {
+                fields[urlDecode(pair.substr(0, eq))] = urlDecode(pair.substr(eq + 1));
+            }
+        }
+        if (amp == std::string_view::npos) break;
+        text.remove_prefix(amp + 1);
+    }
+    return fields;
+}
+
+/**
+ * @brief Экранирует строку для вставки в JSON (без окружающих кавычек).
+ * @param text Исходная строка.
+ * @return Экранированная строка.
+ */
+std::string jsonEscape(std::string_view text) {
+    std::string result;
+    result.reserve(text.size());
+    for (char c : text) {
+        switch (c) {
+            case '"': result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\n': result += "\\n"; break;
+            case '\r': result += "\\r"; break;
+            case '\t': result += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[7];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+                    result += escaped;
+                } else {
+                    result.push_back(c);
+                }
+        }
+    }
+    return result;
+}
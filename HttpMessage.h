@@ -0,0 +1,96 @@
+/**
+ * @file HttpMessage.h
+ * @brief Этот файл содержит структуры HTTP-запроса и ответа, инкрементальный разбор запросов
+ *        и вспомогательные функции для форм и JSON, используемые сетевым сервером.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief HTTP-запрос.
+ */
+struct HttpRequest {
+    std::string method;                           ///< Метод (GET, POST, ...).
+    std::string path;                             ///< Путь без строки запроса.
+    std::string query;                            ///< Строка запроса (после '?'), не декодированная.
+    std::map<std::string, std::string> headers;   ///< Заголовки; имена приведены к нижнему регистру.
+    std::string body;                             ///< Тело запроса.
+    bool keepAlive = true;                        ///< Сохранять ли соединение после ответа.
+
+    /**
+     * @brief Возвращает значение заголовка.
+     * @param name Имя заголовка в нижнем регистре.
+     * @return Значение заголовка или пустая строка.
+     */
+    std::string header(const std::string& name) const;
+};
+
+/**
+ * @brief HTTP-ответ.
+ */
+struct HttpResponse {
+    int status = 200;                                 ///< Код состояния.
+    std::string contentType = "application/json";     ///< Тип содержимого.
+    std::string body;                                 ///< Тело ответа.
+
+    /**
+     * @brief Сериализует ответ в формат HTTP/1.1.
+     * @param keepAlive Сохранять ли соединение после ответа.
+     * @return Готовые к отправке байты.
+     */
+    std::string serialize(bool keepAlive) const;
+
+    /**
+     * @brief Создает JSON-ответ с ошибкой вида {"error": "..."}.
+     * @param status Код состояния.
+     * @param message Текст ошибки.
+     */
+    static HttpResponse error(int status, const std::string& message);
+};
+
+/**
+ * @brief Результат разбора HTTP-запроса.
+ */
+enum class ParseStatus {
+    COMPLETE,    ///< Запрос разобран полностью.
+    INCOMPLETE,  ///< Нужно больше данных.
+    BAD          ///< Запрос некорректен или слишком велик.
+};
+
+/**
+ * @brief Разбирает один HTTP/1.x запрос из начала буфера.
+ * Поддерживается тело с Content-Length; chunked-кодирование отклоняется.
+ * @param buffer Накопленные байты соединения.
+ * @param request Заполняется при статусе COMPLETE.
+ * @param consumed Количество байт, занятых запросом (при статусе COMPLETE).
+ * @param maxSize Максимальный размер запроса вместе с телом.
+ * @return Статус разбора.
+ */
+ParseStatus parseHttpRequest(std::string_view buffer, HttpRequest& request, std::size_t& consumed,
+                             std::size_t maxSize = 1 << 20);
+
+/**
+ * @brief Декодирует строку из URL-кодировки (%XX и '+' как пробел).
+ * @param text Закодированная строка.
+ * @return Декодированная строка.
+ */
+std::string urlDecode(std::string_view text);
+
+/**
+ * @brief Разбирает параметры формы или строки запроса вида a=1&b=2.
+ * @param text Закодированные параметры.
+ * @return Словарь параметров.
+ */
+std::map<std::string, std::string> parseForm(std::string_view text);
+
+/**
+ * @brief Экранирует строку для вставки в JSON (без окружающих кавычек).
+ * @param text Исходная строка.
+ * @return Экранированная строка.
+ */
+std::string jsonEscape(std::string_view text);
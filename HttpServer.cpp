@@ -0,0 +1,363 @@
+/**
+ * @file HttpServer.cpp
+ * @brief Этот файл содержит реализацию класса HttpServer (Linux: epoll, eventfd).
+ */
+
+#include "HttpServer.h"
+#include "Logger.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::size_t MAX_REQUEST_SIZE = 1 << 20;
+constexpr int MAX_EVENTS = 256;
+
+/**
+ * @brief Формирует текст системной ошибки.
+ */
+std::string systemError(const std::string& what) {
+    return what + ": " + std::strerror(errno);
+}
+
+} // namespace
+
+/**
+ * @brief Конструктор сервера.
+ * @param handler Обработчик запросов; вызывается из потоков планировщика конкурентно.
+ * @param scheduler Планировщик, выполняющий обработчики.
+ */
+HttpServer::HttpServer(Handler handler, TaskScheduler& scheduler)
+    : handler(std::move(handler)), scheduler(scheduler), listenFd(-1), epollFd(-1),
+      wakeFd(-1), boundPort(0), stopping(false), nextGeneration(1), inFlight(0) {}
+
+/**
+ * @brief Деструктор. Закрывает дескрипторы.
+ */
+HttpServer::~HttpServer() {
+    for (auto& entry : connections) {
+        ::close(entry.first);
+    }
+    if (listenFd >= 0) ::close(listenFd);
+    if (wakeFd >= 0) ::close(wakeFd);
+    if (epollFd >= 0) ::close(epollFd);
+}
+
+/**
+ * @brief Открывает слушающий сокет.
+ * @param address IPv4-адрес для прослушивания.
+ * @param port Порт (0 - выбрать свободный).
+ * @throws std::runtime_error При ошибке создания сокета или epoll.
+ */
+void HttpServer::listen(const std::string& address, int port) {
+    listenFd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) {
+        throw std::runtime_error(systemError("socket failed"));
+    }
+    int enable = 1;
+    ::setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    if (::inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1) {
+        throw std::runtime_error("Invalid listen address: " + address);
+    }
+    if (::bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        throw std::runtime_error(systemError("bind failed"));
+    }
+    if (::listen(listenFd, SOMAXCONN) < 0) {
+        throw std::runtime_error(systemError("listen failed"));
+    }
+    socklen_t length = sizeof(addr);
+    ::getsockname(listenFd, reinterpret_cast<sockaddr*>(&addr), &length);
+    boundPort = ntohs(addr.sin_port);
+
+    epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd < 0 || wakeFd < 0) {
+        throw std::runtime_error(systemError("epoll/eventfd setup failed"));
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = listenFd;
+    ::epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+    event.data.fd = wakeFd;
+    ::epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+}
+
+/**
+ * @brief Запускает цикл событий. Возвращает управление после stop(), когда завершатся
+ *        все переданные планировщику обработчики.
+ */
+void HttpServer::run() {
+    if (epollFd < 0) {
+        throw std::runtime_error("HttpServer::run called before listen");
+    }
+    epoll_event events[MAX_EVENTS];
+    while (!stopping) {
+        int ready = ::epoll_wait(epollFd, events, MAX_EVENTS, -1);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            Logger::severe("{}", systemError("epoll_wait failed"));
+            break;
+        }
+        for (int i = 0; i < ready; ++i) {
+            int fd = events[i].data.fd;
+            std::uint32_t flags = events[i].events;
+            if (fd == listenFd) {
+                acceptConnections();
+            } else if (fd == wakeFd) {
+                std::uint64_t counter;
+                while (::read(wakeFd, &counter, sizeof(counter)) > 0) {}
+                drainCompletions();
+            } else {
+                if (flags & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                    readConnection(fd);
+                }
+                if ((flags & EPOLLOUT) && connections.count(fd)) {
+                    writeConnection(fd);
+                }
+            }
+        }
+    }
+
+    stopping = true;
+    while (inFlight.load() > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+/**
+ * @brief Останавливает цикл событий. Может вызываться из любого потока и из обработчика сигнала.
+ */
+void HttpServer::stop() {
+    stopping = true;
+    if (wakeFd >= 0) {
+        std::uint64_t one = 1;
+        ssize_t ignored = ::write(wakeFd, &one, sizeof(one));
+        (void)ignored;
+    }
+}
+
+/**
+ * @brief Принимает все ожидающие соединения.
+ */
+void HttpServer::acceptConnections() {
+    while (true) {
+        int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                Logger::severe("{}", systemError("accept failed"));
+            }
+            return;
+        }
+        int enable = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+
+        Connection& connection = connections[fd];
+        connection = Connection();
+        connection.generation = nextGeneration++;
+
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.fd = fd;
+        ::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+    }
+}
+
+/**
+ * @brief Читает данные соединения и запускает обработку запроса.
+ * @param fd Дескриптор соединения.
+ */
+void HttpServer::readConnection(int fd) {
+    auto it = connections.find(fd);
+    if (it == connections.end()) {
+        return;
+    }
+    Connection& connection = it->second;
+    char buffer[16384];
+    while (true) {
+        ssize_t received = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (received > 0) {
+            connection.input.append(buffer, static_cast<std::size_t>(received));
+            if (connection.input.size() > 2 * MAX_REQUEST_SIZE) {
+                closeConnection(fd);
+                return;
+            }
+            continue;
+        }
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        closeConnection(fd);
+        return;
+    }
+    dispatch(fd, connection);
+}
+
+/**
+ * @brief Разбирает следующий запрос соединения и передает его планировщику.
+ * @param fd Дескриптор соединения.
+ * @param connection Состояние соединения.
+ */
+void HttpServer::dispatch(int fd, Connection& connection) {
+    if (connection.busy || connection.input.empty()) {
+        return;
+    }
+    HttpRequest request;
+    std::size_t consumed = 0;
+    ParseStatus status = parseHttpRequest(connection.input, request, consumed, MAX_REQUEST_SIZE);
+    if (status == ParseStatus::INCOMPLETE) {
+        return;
+    }
+    if (status == ParseStatus::BAD) {
+        respondDirect(fd, connection, HttpResponse::error(400, "Malformed request"));
+        return;
+    }
+    connection.input.erase(0, consumed);
+    connection.busy = true;
+    std::uint64_t generation = connection.generation;
+    inFlight.fetch_add(1);
+    auto shared = std::make_shared<HttpRequest>(std::move(request));
+    if (!scheduler.trySubmit([this, fd, generation, shared] { process(fd, generation, *shared); })) {
+        inFlight.fetch_sub(1);
+        respondDirect(fd, connection, HttpResponse::error(503, "Server is overloaded"));
+    }
+}
+
+/**
+ * @brief Отправляет накопленный ответ соединения.
+ * После полной отправки соединение готово к следующему запросу (или закрывается).
+ * @param fd Дескриптор соединения.
+ */
+void HttpServer::writeConnection(int fd) {
+    auto it = connections.find(fd);
+    if (it == connections.end()) {
+        return;
+    }
+    Connection& connection = it->second;
+    while (connection.written < connection.output.size()) {
+        ssize_t sent = ::send(fd, connection.output.data() + connection.written,
+                              connection.output.size() - connection.written, MSG_NOSIGNAL);
+        if (sent > 0) {
+            connection.written += static_cast<std::size_t>(sent);
+            continue;
+        }
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            watch(fd, connection, true);
+            return;
+        }
+        closeConnection(fd);
+        return;
+    }
+
+    connection.output.clear();
+    connection.written = 0;
+    connection.busy = false;
+    if (connection.closeAfterWrite) {
+        closeConnection(fd);
+        return;
+    }
+    watch(fd, connection, false);
+    dispatch(fd, connection);
+}
+
+/**
+ * @brief Переносит готовые ответы рабочих потоков в соединения.
+ * Ответы для уже закрытых соединений отбрасываются.
+ */
+void HttpServer::drainCompletions() {
+    std::vector<Completion> ready;
+    {
+        std::lock_guard<std::mutex> lock(completionMutex);
+        ready.swap(completions);
+    }
+    for (auto& completion : ready) {
+        auto it = connections.find(completion.fd);
+        if (it == connections.end() || it->second.generation != completion.generation) {
+            continue;
+        }
+        it->second.output = std::move(completion.bytes);
+        it->second.written = 0;
+        it->second.closeAfterWrite = !completion.keepAlive;
+        writeConnection(completion.fd);
+    }
+}
+
+/**
+ * @brief Ставит ответ на отправку, минуя рабочие потоки (ошибки разбора).
+ * Соединение закрывается после отправки.
+ */
+void HttpServer::respondDirect(int fd, Connection& connection, const HttpResponse& response) {
+    connection.busy = true;
+    connection.closeAfterWrite = true;
+    connection.input.clear();
+    connection.output = response.serialize(false);
+    connection.written = 0;
+    writeConnection(fd);
+}
+
+/**
+ * @brief Обновляет набор ожидаемых событий соединения.
+ */
+void HttpServer::watch(int fd, Connection& connection, bool wantWrite) {
+    if (connection.writing == wantWrite) {
+        return;
+    }
+    connection.writing = wantWrite;
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLRDHUP | (wantWrite ? EPOLLOUT : 0u);
+    event.data.fd = fd;
+    ::epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event);
+}
+
+/**
+ * @brief Закрывает соединение.
+ */
+void HttpServer::closeConnection(int fd) {
+    ::epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    connections.erase(fd);
+}
+
+/**
+ * @brief Выполняет обработчик в потоке планировщика и возвращает ответ в цикл событий.
+ * Исключение обработчика превращается в ответ 500.
+ * @param fd Дескриптор соединения.
+ * @param generation Поколение соединения.
+ * @param request HTTP-запрос.
+ */
+void HttpServer::process(int fd, std::uint64_t generation, const HttpRequest& request) {
+    HttpResponse response;
+    try {
+        response = handler(request);
+    } catch (const std::exception& e) {
+        Logger::severe("Request handler failed: {}", e.what());
+        response = HttpResponse::error(500, "Internal server error");
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(completionMutex);
+        completions.push_back(Completion{fd, generation, response.serialize(request.keepAlive), request.keepAlive});
+    }
+    std::uint64_t one = 1;
+    ssize_t ignored = ::write(wakeFd, &one, sizeof(one));
+    (void)ignored;
+    inFlight.fetch_sub(1);
+}
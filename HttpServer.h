@@ -0,0 +1,153 @@
+/**
+ * @file HttpServer.h
+ * @brief Этот файл содержит объявление класса HttpServer - HTTP-сервера на цикле событий epoll
+ *        и общим планировщиком задач для выполнения обработчиков запросов.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "HttpMessage.h"
+#include "TaskScheduler.h"
+
+/**
+ * @brief HTTP/1.1 сервер.
+ * Один поток цикла событий принимает соединения, читает и разбирает запросы и пишет ответы
+ * (неблокирующие сокеты, epoll). Обработчики выполняются общим планировщиком задач, поэтому
+ * долгие запросы к базе данных не задерживают ввод-вывод других соединений. Готовые ответы
+ * возвращаются в цикл событий через очередь и eventfd. Если очередь планировщика заполнена,
+ * запрос сразу получает ответ 503. На соединении одновременно
+ * обрабатывается не больше одного запроса, так что конвейерные запросы получают ответы по порядку.
+ */
+class HttpServer {
+public:
+    using Handler = std::function<HttpResponse(const HttpRequest&)>;
+
+private:
+    struct Connection {
+        std::string input;            ///< Прочитанные, но еще не разобранные байты.
+        std::string output;           ///< Ответ, ожидающий отправки.
+        std::size_t written = 0;      ///< Сколько байт output уже отправлено.
+        bool busy = false;            ///< Запрос передан рабочему потоку.
+        bool closeAfterWrite = false; ///< Закрыть соединение после отправки ответа.
+        bool writing = false;         ///< Ожидается готовность сокета к записи (EPOLLOUT).
+        std::uint64_t generation = 0; ///< Отличает соединения с переиспользованным дескриптором.
+    };
+
+    struct Completion {
+        int fd;
+        std::uint64_t generation;
+        std::string bytes;
+        bool keepAlive;
+    };
+
+    Handler handler;
+    TaskScheduler& scheduler;
+    int listenFd;
+    int epollFd;
+    int wakeFd;
+    int boundPort;
+    std::atomic<bool> stopping;
+    std::uint64_t nextGeneration;
+    std::unordered_map<int, Connection> connections;
+    std::atomic<int> inFlight;
+
+    std::mutex completionMutex;
+    std::vector<Completion> completions;
+
+    /**
+     * @brief Принимает все ожидающие соединения.
+     */
+    void acceptConnections();
+
+    /**
+     * @brief Читает данные соединения и запускает обработку запроса.
+     * @param fd Дескриптор соединения.
+     */
+    void readConnection(int fd);
+
+    /**
+     * @brief Разбирает следующий запрос соединения и передает его планировщику.
+     * @param fd Дескриптор соединения.
+     * @param connection Состояние соединения.
+     */
+    void dispatch(int fd, Connection& connection);
+
+    /**
+     * @brief Отправляет накопленный ответ соединения.
+     * @param fd Дескриптор соединения.
+     */
+    void writeConnection(int fd);
+
+    /**
+     * @brief Переносит готовые ответы рабочих потоков в соединения.
+     */
+    void drainCompletions();
+
+    /**
+     * @brief Ставит ответ на отправку, минуя рабочие потоки (ошибки разбора).
+     */
+    void respondDirect(int fd, Connection& connection, const HttpResponse& response);
+
+    /**
+     * @brief Обновляет набор ожидаемых событий соединения.
+     */
+    void watch(int fd, Connection& connection, bool wantWrite);
+
+    /**
+     * @brief Закрывает соединение.
+     */
+    void closeConnection(int fd);
+
+    /**
+     * @brief Выполняет обработчик в потоке планировщика и возвращает ответ в цикл событий.
+     */
+    void process(int fd, std::uint64_t generation, const HttpRequest& request);
+
+public:
+    /**
+     * @brief Конструирует сервер.
+     * @param handler Обработчик запросов; вызывается из потоков планировщика конкурентно.
+     * @param scheduler Планировщик, выполняющий обработчики.
+     */
+    HttpServer(Handler handler, TaskScheduler& scheduler);
+
+    /**
+     * @brief Деструктор. Закрывает дескрипторы.
+     */
+    ~HttpServer();
+
+    HttpServer(const HttpServer&) = delete;
+    HttpServer& operator=(const HttpServer&) = delete;
+
+    /**
+     * @brief Открывает слушающий сокет.
+     * @param address IPv4-адрес для прослушивания.
+     * @param port Порт (0 - выбрать свободный).
+     * @throws std::runtime_error При ошибке создания сокета или epoll.
+     */
+    void listen(const std::string& address, int port);
+
+    /**
+     * @brief Возвращает фактический порт слушающего сокета.
+     */
+    int port() const { return boundPort; }
+
+    /**
+     * @brief Запускает цикл событий. Возвращает управление после stop(), когда завершатся
+     *        все переданные планировщику обработчики.
+     */
+    void run();
+
+    /**
+     * @brief Останавливает цикл событий. Может вызываться из любого потока и из обработчика сигнала.
+     */
+    void stop();
+};
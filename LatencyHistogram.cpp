@@ -0,0 +1,106 @@
+/**
+ * @file LatencyHistogram.cpp
+ * @brief Этот файл содержит реализацию класса LatencyHistogram.
+ */
+
+#include "LatencyHistogram.h"
+#include <algorithm>
+#include <limits>
+
+/**
+ * @brief Конструктор пустой гистограммы.
+ */
+LatencyHistogram::LatencyHistogram()
+    : counts(BUCKET_COUNT, 0), total(0), sum(0), minValue(std::numeric_limits<std::uint64_t>::max()), maxValue(0) {}
+
+/**
+ * @brief Возвращает индекс корзины для значения.
+ * Значения меньше 2 * SUB_BUCKETS хранятся точно; дальше корзина определяется
+ * старшим битом и следующими SUB_BUCKET_BITS битами.
+ */
+std::size_t LatencyHistogram::bucketIndex(std::uint64_t value) {
+    if (value < SUB_BUCKETS) {
+        return static_cast<std::size_t>(value);
+    }
+    int msb = 63 - __builtin_clzll(value);
+    int shift = msb - SUB_BUCKET_BITS;
+    return static_cast<std::size_t>(shift + 1) * SUB_BUCKETS + static_cast<std::size_t>((value >> shift) - SUB_BUCKETS);
+}
+
+/**
+ * @brief Возвращает наибольшее значение, попадающее в корзину.
+ */
+std::uint64_t LatencyHistogram::bucketUpperBound(std::size_t index) {
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+    int shift = static_cast<int>(index / SUB_BUCKETS) - 1;
+    std::uint64_t lower = (SUB_BUCKETS + index % SUB_BUCKETS) << shift;
+    return lower + ((std::uint64_t(1) << shift) - 1);
+}
+
+/**
+ * @brief Записывает одно значение.
+ * @param value Значение (например, задержка в наносекундах).
+ */
+void LatencyHistogram::record(std::uint64_t value) {
+    ++counts[bucketIndex(value)];
+    ++total;
+    sum += value;
+    minValue = std::min(minValue, value);
+    maxValue = std::max(maxValue, value);
+}
+
+/**
+ * @brief Добавляет значения другой гистограммы.
+ * @param other Другая гистограмма.
+ */
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+        counts[i] += other.counts[i];
+    }
+    total += other.total;
+    sum += other.sum;
+    minValue = std::min(minValue, other.minValue);
+    maxValue = std::max(maxValue, other.maxValue);
+}
+
+/**
+ * @brief Очищает гистограмму.
+ */
+void LatencyHistogram::reset() {
+    std::fill(counts.begin(), counts.end(), 0);
+    total = 0;
+    sum = 0;
+    minValue = std::numeric_limits<std::uint64_t>::max();
+    maxValue = 0;
+}
+
+/**
+ * @brief Возвращает значение перцентиля (верхнюю границу корзины, но не больше максимума).
+ * @param percentile Перцентиль от 0 до 100.
+ * @return Значение перцентиля или 0 для пустой гистограммы.
+ */
+std::uint64_t LatencyHistogram::percentile(double percentile) const {
+    if (total == 0) {
+        return 0;
+    }
+    percentile = std::clamp(percentile, 0.0, 100.0);
+    std::uint64_t rank = static_cast<std::uint64_t>(percentile / 100.0 * static_cast<double>(total) + 0.5);
+    rank = std::clamp<std::uint64_t>(rank, 1, total);
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return std::min(bucketUpperBound(i), maxValue);
+        }
+    }
+    return maxValue;
+}
+
+/**
+ * @brief Возвращает среднее значение.
+ */
+double LatencyHistogram::mean() const {
+    return total ? static_cast<double>(sum) / static_cast<double>(total) : 0.0;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file LatencyHistogram.h
+ * @brief Этот файл содержит объявление класса LatencyHistogram - гистограммы задержек
+ *        с логарифмически-линейными корзинами для расчета перцентилей.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Гистограмма задержек с ограниченной относительной погрешностью.
+ * Каждый интервал [2^k, 2^(k+1)) делится на 32 равные корзины, поэтому погрешность
+ * перцентиля не превышает ~3% при фиксированном объеме памяти (1920 счетчиков).
+ * Запись - O(1) без выделений памяти. Класс не потокобезопасен: каждый поток
+ * ведет свою гистограмму, а итог собирается через merge.
+ */
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 5;
+    static constexpr std::size_t SUB_BUCKETS = std::size_t(1) << SUB_BUCKET_BITS;
+    static constexpr std::size_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+private:
+    std::vector<std::uint64_t> counts;
+    std::uint64_t total;
+    std::uint64_t sum;
+    std::uint64_t minValue;
+    std::uint64_t maxValue;
+
+public:
+    /**
+     * @brief Конструирует пустую гистограмму.
+     */
+    LatencyHistogram();
+
+    /**
+     * @brief Записывает одно значение.
+     * @param value Значение (например, задержка в наносекундах).
+     */
+    void record(std::uint64_t value);
+
+    /**
+     * @brief Добавляет значения другой гистограммы.
+     * @param other Другая гистограмма.
+     */
+    void merge(const LatencyHistogram& other);
+
+    /**
+     * @brief Очищает гистограмму.
+     */
+    void reset();
+
+    /**
+     * @brief Возвращает значение перцентиля (верхнюю границу корзины, но не больше максимума).
+     * @param percentile Перцентиль от 0 до 100.
+     * @return Значение перцентиля или 0 для пустой гистограммы.
+     */
+    std::uint64_t percentile(double percentile) const;
+
+    /**
+     * @brief Возвращает количество записанных значений.
+     */
+    std::uint64_t count() const { return total; }
+
+    /**
+     * @brief Возвращает среднее значение.
+     */
+    double mean() const;
+
+    /**
+     * @brief Возвращает минимальное значение (0 для пустой гистограммы).
+     */
+    std::uint64_t min() const { return total ? minValue : 0; }
+
+    /**
+     * @brief Возвращает максимальное значение.
+     */
+    std::uint64_t max() const { return maxValue; }
+
+    /**
+     * @brief Возвращает индекс корзины для значения.
+     */
+    static std::size_t bucketIndex(std::uint64_t value);
+
+    /**
+     * @brief Возвращает наибольшее значение, попадающее в корзину.
+     */
+    static std::uint64_t bucketUpperBound(std::size_t index);
+};
@@ -0,0 +1,119 @@
+/**
+ * @file LoadProfile.cpp
+ * @brief Этот файл содержит реализацию OperationMix и ArrivalSchedule.
+ */
+
+#include "LoadProfile.h"
+#include <sstream>
+#include <stdexcept>
+
+/**
+ * @brief Возвращает имя операции (search, book, service, bill, cancel).
+ */
+const char* operationName(LoadOperation operation) {
+    switch (operation) {
+        case LoadOperation::SEARCH: return "search";
+        case LoadOperation::BOOK: return "book";
+        case LoadOperation::ADD_SERVICE: return "service";
+        case LoadOperation::BILL: return "bill";
+        case LoadOperation::CANCEL: return "cancel";
+    }
+    return "";
+}
+
+/**
+ * @brief Конструирует смесь по весам операций (в порядке LoadOperation).
+ * @param weights Неотрицательные веса; нормируются к сумме.
+ * @throws std::invalid_argument Если вес отрицателен или сумма весов равна нулю.
+ */
+OperationMix::OperationMix(const std::array<double, LOAD_OPERATION_COUNT>& weights) {
+    double total = 0;
+    for (double weight : weights) {
+        if (weight < 0) {
+            throw std::invalid_argument("Operation weight must not be negative");
+        }
+        total += weight;
+    }
+    if (total <= 0) {
+        throw std::invalid_argument("Operation mix must contain at least one operation");
+    }
+    double running = 0;
+    for (std::size_t i = 0; i < LOAD_OPERATION_COUNT; ++i) {
+        running += weights[i];
+        cumulative[i] = running / total;
+    }
+    cumulative.back() = 1.0;
+}
+
+/**
+ * @brief Разбирает смесь вида "search=50,book=20,service=15,bill=10,cancel=5".
+ * Не указанные операции получают вес 0.
+ * @throws std::invalid_argument Если имя операции неизвестно или вес задан неверно.
+ */
+OperationMix OperationMix::parse(const std::string& text) {
+    std::array<double, LOAD_OPERATION_COUNT> weights{};
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (item.empty()) {
+            continue;
+        }
+        std::size_t equals = item.find('=');
+        std::string name = item.substr(0, equals);
+        std::size_t index = 0;
+        while (index < LOAD_OPERATION_COUNT && name != operationName(static_cast<LoadOperation>(index))) {
+            ++index;
+        }
+        if (equals == std::string::npos || index == LOAD_OPERATION_COUNT) {
+            throw std::invalid_argument("Invalid operation mix item: '" + item + "'");
+        }
+        try {
+            weights[index] = std::stod(item.substr(equals + 1));
+        } catch (const std::exception&) {
+            throw std::invalid_argument("Invalid operation weight: '" + item + "'");
+        }
+    }
+    return OperationMix(weights);
+}
+
+/**
+ * @brief Выбирает операцию по равномерному случайному числу из [0, 1).
+ */
+LoadOperation OperationMix::pick(double uniform) const {
+    std::size_t index = 0;
+    while (index + 1 < LOAD_OPERATION_COUNT && uniform >= cumulative[index]) {
+        ++index;
+    }
+    return static_cast<LoadOperation>(index);
+}
+
+/**
+ * @brief Возвращает долю операции (0..1).
+ */
+double OperationMix::share(LoadOperation operation) const {
+    std::size_t index = static_cast<std::size_t>(operation);
+    return cumulative[index] - (index == 0 ? 0.0 : cumulative[index - 1]);
+}
+
+/**
+ * @brief Конструирует расписание.
+ * @param ratePerSecond Интенсивность (операций в секунду).
+ * @param seed Зерно генератора интервалов.
+ * @param start Момент начала.
+ * @throws std::invalid_argument Если интенсивность не положительна.
+ */
+ArrivalSchedule::ArrivalSchedule(double ratePerSecond, std::uint64_t seed, Clock::time_point start)
+    : random(seed), gap(ratePerSecond > 0 ? ratePerSecond : 1.0), nextArrival(start) {
+    if (ratePerSecond <= 0) {
+        throw std::invalid_argument("Arrival rate must be positive");
+    }
+}
+
+/**
+ * @brief Возвращает запланированный момент следующей операции и продвигает расписание.
+ * Интервалы между операциями распределены экспоненциально со средним 1 / интенсивность.
+ */
+ArrivalSchedule::Clock::time_point ArrivalSchedule::next() {
+    nextArrival += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(gap(random)));
+    return nextArrival;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file LoadProfile.h
+ * @brief Этот файл содержит описание профиля нагрузки для нагрузочного теста hotel_loadgen:
+ *        операции сеанса, их доли (OperationMix) и расписание поступления операций
+ *        в открытой модели нагрузки (ArrivalSchedule).
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+
+/**
+ * @brief Операция сеанса гостя или администратора.
+ */
+enum class LoadOperation {
+    SEARCH,         ///< Поиск свободных номеров.
+    BOOK,           ///< Поиск и бронирование найденного номера.
+    ADD_SERVICE,    ///< Добавление услуги к бронированию.
+    BILL,           ///< Расчет счета.
+    CANCEL          ///< Отмена бронирования.
+};
+
+/// Количество видов операций.
+constexpr std::size_t LOAD_OPERATION_COUNT = 5;
+
+/**
+ * @brief Возвращает имя операции (search, book, service, bill, cancel).
+ */
+const char* operationName(LoadOperation operation);
+
+/**
+ * @brief Доли операций сеанса.
+ */
+class OperationMix {
+private:
+    std::array<double, LOAD_OPERATION_COUNT> cumulative;
+
+public:
+    /**
+     * @brief Конструирует смесь по весам операций (в порядке LoadOperation).
+     * @param weights Неотрицательные веса; нормируются к сумме.
+     * @throws std::invalid_argument Если вес отрицателен или сумма весов равна нулю.
+     */
+    explicit OperationMix(const std::array<double, LOAD_OPERATION_COUNT>& weights);
+
+    /**
+     * @brief Разбирает смесь вида "search=50,book=20,service=15,bill=10,cancel=5".
+     * Не указанные операции получают вес 0.
+     * @throws std::invalid_argument Если имя операции неизвестно или вес задан неверно.
+     */
+    static OperationMix parse(const std::string& text);
+
+    /**
+     * @brief Выбирает операцию по равномерному случайному числу из [0, 1).
+     */
+    LoadOperation pick(double uniform) const;
+
+    /**
+     * @brief Возвращает долю операции (0..1).
+     */
+    double share(LoadOperation operation) const;
+};
+
+/**
+ * @brief Расписание поступления операций открытой модели нагрузки.
+ * Операции поступают пуассоновским потоком с заданной интенсивностью независимо от того,
+ * успевает ли система их обрабатывать. Задержка измеряется от запланированного момента,
+ * а не от фактического начала, поэтому очередь, накопившаяся из-за медленного ответа,
+ * попадает в задержку (поправка на координированное упущение).
+ */
+class ArrivalSchedule {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    std::mt19937_64 random;
+    std::exponential_distribution<double> gap;
+    Clock::time_point nextArrival;
+
+public:
+    /**
+     * @brief Конструирует расписание.
+     * @param ratePerSecond Интенсивность (операций в секунду).
+     * @param seed Зерно генератора интервалов.
+     * @param start Момент начала.
+     * @throws std::invalid_argument Если интенсивность не положительна.
+     */
+    ArrivalSchedule(double ratePerSecond, std::uint64_t seed, Clock::time_point start);
+
+    /**
+     * @brief Возвращает запланированный момент следующей операции и продвигает расписание.
+     */
+    Clock::time_point next();
+};
@@ -0,0 +1,448 @@
+/**
+ * @file Logger.cpp
+ * @brief Этот файл содержит реализацию асинхронного журнала: буферы потоков, фоновый поток вывода,
+ *        отложенное форматирование и ограничение частоты сообщений.
+ */
+
+#include "Logger.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+constexpr std::chrono::milliseconds FLUSH_INTERVAL{50};
+
+/**
+ * @brief Кольцевой буфер записей одного потока (один производитель - поток-владелец,
+ *        один потребитель - вывод под drainMutex).
+ */
+struct LogRing {
+    std::vector<LogRecord> records = std::vector<LogRecord>(Logger::RING_RECORDS);
+    alignas(64) std::atomic<std::uint64_t> head{0}; ///< Пишет только производитель.
+    alignas(64) std::atomic<std::uint64_t> tail{0}; ///< Пишет только потребитель.
+    int threadId = 0;
+    std::atomic<bool> exited{false};
+};
+
+/**
+ * @brief Разделяемое состояние журнала.
+ */
+struct LoggerState {
+    std::mutex ringsMutex;
+    std::vector<std::shared_ptr<LogRing>> rings;
+    int nextThreadId = 1;
+
+    std::mutex drainMutex; ///< Вывод: приемник, ограничение частоты.
+    std::function<void(std::string_view)> sink;
+    std::FILE* file = nullptr;
+    std::size_t rateLimit = Logger::DEFAULT_RATE_LIMIT;
+    struct RateWindow {
+        std::int64_t second = 0;
+        std::size_t written = 0;
+        std::size_t suppressed = 0;
+    };
+    std::unordered_map<const char*, RateWindow> windows;
+    std::uint64_t reportedDrops = 0;
+
+    std::atomic<std::uint64_t> dropped{0};
+
+    std::mutex wakeMutex;
+    std::condition_variable wakeUp;
+    bool stopping = false;
+    std::thread writer;
+
+    ~LoggerState();
+};
+
+LoggerState& state() {
+    static LoggerState instance;
+    return instance;
+}
+
+/**
+ * @brief Владеет буфером потока и отмечает его при завершении потока; буфер удаляется после вывода.
+ */
+struct RingSlot {
+    std::shared_ptr<LogRing> ring;
+
+    ~RingSlot() {
+        if (ring) {
+            ring->exited.store(true, std::memory_order_release);
+        }
+    }
+};
+
+thread_local RingSlot slot;
+
+const char* levelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::VERBOSE: return "VERBOSE";
+        case LogLevel::INFO: return "INFO";
+        case LogLevel::WARNING: return "WARNING";
+        case LogLevel::SEVERE: return "SEVERE";
+    }
+    return "UNKNOWN";
+}
+
+/**
+ * @brief Добавляет к строке время записи в виде "YYYY-MM-DD HH:MM:SS.mmm" (UTC).
+ */
+void appendTime(std::string& out, std::int64_t wallNs) {
+    std::time_t seconds = static_cast<std::time_t>(wallNs / 1'000'000'000);
+    std::tm utc = *std::gmtime(&seconds); // вызывается только под drainMutex
+    char text[32];
+    std::size_t length = std::strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &utc);
+    std::snprintf(text + length, sizeof(text) - length, ".%03d", static_cast<int>(wallNs / 1'000'000 % 1000));
+    out += text;
+}
+
+/**
+ * @brief Подставляет аргументы записи вместо {} в строке формата.
+ */
+void appendMessage(std::string& out, const LogRecord& record) {
+    std::size_t next = 0;
+    for (const char* p = record.format; *p; ++p) {
+        if (p[0] == '{' && p[1] == '}' && next < record.argumentCount) {
+            const LogArgument& argument = record.arguments[next++];
+            char number[32];
+            switch (argument.type) {
+                case LogArgument::Type::SIGNED:
+                    std::snprintf(number, sizeof(number), "%lld", static_cast<long long>(argument.signedValue));
+                    out += number;
+                    break;
+                case LogArgument::Type::UNSIGNED:
+                    std::snprintf(number, sizeof(number), "%llu", static_cast<unsigned long long>(argument.unsignedValue));
+                    out += number;
+                    break;
+                case LogArgument::Type::REAL:
+                    std::snprintf(number, sizeof(number), "%g", argument.realValue);
+                    out += number;
+                    break;
+                case LogArgument::Type::TEXT:
+                    out.append(record.text + argument.textOffset, argument.textLength);
+                    break;
+            }
+            ++p;
+        } else {
+            out += *p;
+        }
+    }
+    // Сообщения libpq оканчиваются переводом строки; одна запись - одна строка.
+    while (!out.empty() && (out.back() == '\n' || out.back() == '\r' || out.back() == ' ')) {
+        out.pop_back();
+    }
+}
+
+/**
+ * @brief Передает пачку строк приемнику (под drainMutex).
+ */
+void emit(LoggerState& shared, const std::string& batch) {
+    if (batch.empty()) {
+        return;
+    }
+    if (shared.sink) {
+        shared.sink(batch);
+    } else if (shared.file) {
+        std::fwrite(batch.data(), 1, batch.size(), shared.file);
+        std::fflush(shared.file);
+    } else {
+        std::cerr.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+        std::cerr.flush();
+    }
+}
+
+/**
+ * @brief Добавляет строку о подавленных сообщениях одной строки формата.
+ */
+void appendSuppressed(std::string& batch, const char* format, std::size_t count, std::int64_t wallNs) {
+    appendTime(batch, wallNs);
+    batch += " WARNING [logger] suppressed " + std::to_string(count) + " messages: ";
+    batch += format;
+    batch += '\n';
+}
+
+/**
+ * @brief Забирает записи из всех буферов, форматирует их и выводит одной пачкой.
+ * @param final True - вывести и сводки подавленных сообщений, окно которых еще не закончилось.
+ */
+void drain(LoggerState& shared, bool final) {
+    std::vector<std::shared_ptr<LogRing>> rings;
+    {
+        std::lock_guard<std::mutex> lock(shared.ringsMutex);
+        rings = shared.rings;
+    }
+
+    std::lock_guard<std::mutex> lock(shared.drainMutex);
+    struct Line {
+        std::int64_t wallNs;
+        std::string text;
+    };
+    std::vector<Line> lines;
+    std::int64_t latest = 0;
+    for (const auto& ring : rings) {
+        bool exited = ring->exited.load(std::memory_order_acquire);
+        std::uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        std::uint64_t head = ring->head.load(std::memory_order_acquire);
+        for (; tail < head; ++tail) {
+            const LogRecord& record = ring->records[tail % Logger::RING_RECORDS];
+            latest = std::max(latest, record.wallNs);
+            auto& window = shared.windows[record.format];
+            std::int64_t second = record.wallNs / 1'000'000'000;
+            if (window.second != second) {
+                window.second = second;
+                window.written = 0;
+            }
+            if (shared.rateLimit > 0 && window.written >= shared.rateLimit) {
+                ++window.suppressed;
+                continue;
+            }
+            ++window.written;
+            Line line{record.wallNs, {}};
+            appendTime(line.text, record.wallNs);
+            line.text += ' ';
+            line.text += levelName(record.level);
+            line.text += " [" + std::to_string(ring->threadId) + "] ";
+            appendMessage(line.text, record);
+            line.text += '\n';
+            lines.push_back(std::move(line));
+        }
+        ring->tail.store(tail, std::memory_order_release);
+        if (exited && tail == ring->head.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> ringsLock(shared.ringsMutex);
+            shared.rings.erase(std::remove(shared.rings.begin(), shared.rings.end(), ring), shared.rings.end());
+        }
+    }
+    // Буферы потоков выводятся по очереди; порядок по времени восстанавливается внутри пачки.
+    std::stable_sort(lines.begin(), lines.end(), [](const Line& a, const Line& b) { return a.wallNs < b.wallNs; });
+
+    std::string batch;
+    for (const auto& line : lines) {
+        batch += line.text;
+    }
+    std::int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    latest = std::max(latest, now);
+    for (auto it = shared.windows.begin(); it != shared.windows.end();) {
+        auto& window = it->second;
+        bool closed = window.second != latest / 1'000'000'000;
+        if (window.suppressed > 0 && (final || closed)) {
+            appendSuppressed(batch, it->first, window.suppressed, latest);
+            window.suppressed = 0;
+        }
+        it = closed && window.suppressed == 0 ? shared.windows.erase(it) : std::next(it);
+    }
+    std::uint64_t dropped = shared.dropped.load(std::memory_order_relaxed);
+    if (dropped != shared.reportedDrops) {
+        appendTime(batch, latest);
+        batch += " WARNING [logger] dropped " + std::to_string(dropped - shared.reportedDrops) +
+                 " records: thread buffer full\n";
+        shared.reportedDrops = dropped;
+    }
+    emit(shared, batch);
+}
+
+/**
+ * @brief Цикл фонового потока вывода.
+ */
+void writerLoop(LoggerState& shared) {
+    std::unique_lock<std::mutex> lock(shared.wakeMutex);
+    while (!shared.stopping) {
+        lock.unlock();
+        drain(shared, false);
+        lock.lock();
+        shared.wakeUp.wait_for(lock, FLUSH_INTERVAL, [&shared] { return shared.stopping; });
+    }
+}
+
+/**
+ * @brief Останавливает фоновый поток и выводит оставшиеся записи.
+ */
+LoggerState::~LoggerState() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    if (writer.joinable()) {
+        writer.join();
+    }
+    drain(*this, true);
+    if (file) {
+        std::fclose(file);
+    }
+}
+
+/**
+ * @brief Возвращает буфер текущего потока; при первом обращении регистрирует его и запускает
+ *        фоновый поток вывода.
+ */
+LogRing& currentRing() {
+    if (!slot.ring) {
+        auto ring = std::make_shared<LogRing>();
+        LoggerState& shared = state();
+        std::lock_guard<std::mutex> lock(shared.ringsMutex);
+        ring->threadId = shared.nextThreadId++;
+        shared.rings.push_back(ring);
+        if (!shared.writer.joinable()) {
+            shared.writer = std::thread(writerLoop, std::ref(shared));
+        }
+        slot.ring = std::move(ring);
+    }
+    return *slot.ring;
+}
+
+} // namespace
+
+/**
+ * @brief Занимает ячейку в буфере текущего потока и отмечает время записи.
+ * @return Ячейка или nullptr, если буфер заполнен.
+ */
+LogRecord* Logger::reserve() {
+    LogRing& ring = currentRing();
+    std::uint64_t head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.tail.load(std::memory_order_acquire) >= RING_RECORDS) {
+        state().dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    LogRecord& record = ring.records[head % RING_RECORDS];
+    record.wallNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    return &record;
+}
+
+/**
+ * @brief Публикует запись, заполненную в ячейке из reserve().
+ */
+void Logger::commit() {
+    LogRing& ring = *slot.ring;
+    ring.head.store(ring.head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Копирует строковый аргумент в запись (с обрезкой по границе символа UTF-8).
+ */
+void Logger::capture(LogRecord& record, std::string_view value) {
+    LogArgument& argument = record.arguments[record.argumentCount++];
+    std::size_t length = std::min(value.size(), LogRecord::TEXT_BYTES - record.textUsed);
+    while (length < value.size() && length > 0 && (static_cast<unsigned char>(value[length]) & 0xC0) == 0x80) {
+        --length;
+    }
+    argument.type = LogArgument::Type::TEXT;
+    argument.textOffset = record.textUsed;
+    argument.textLength = static_cast<std::uint16_t>(length);
+    std::memcpy(record.text + record.textUsed, value.data(), length);
+    record.textUsed = static_cast<std::uint16_t>(record.textUsed + length);
+}
+
+/**
+ * @brief Устанавливает минимальный записываемый уровень.
+ */
+void Logger::setLevel(LogLevel level) {
+    minimumLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+/**
+ * @brief Разбирает имя уровня (verbose, info, warning, severe; без учета регистра).
+ * @throws std::invalid_argument Если имя неизвестно.
+ */
+LogLevel Logger::parseLevel(const std::string& name) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+    if (lower == "verbose") return LogLevel::VERBOSE;
+    if (lower == "info") return LogLevel::INFO;
+    if (lower == "warning") return LogLevel::WARNING;
+    if (lower == "severe") return LogLevel::SEVERE;
+    throw std::invalid_argument("Unknown log level: " + name);
+}
+
+/**
+ * @brief Ограничивает число сообщений одной строки формата в секунду (0 - без ограничения).
+ * Счет текущей секунды начинается заново.
+ */
+void Logger::setRateLimit(std::size_t perSecond) {
+    LoggerState& shared = state();
+    std::lock_guard<std::mutex> lock(shared.drainMutex);
+    shared.rateLimit = perSecond;
+    for (auto& [format, window] : shared.windows) {
+        window.written = 0;
+    }
+}
+
+/**
+ * @brief Направляет вывод в файл (дописывается в конец).
+ * @return False, если файл не удалось открыть; тогда вывод остается прежним.
+ */
+bool Logger::openFile(const std::string& path) {
+    std::FILE* opened = std::fopen(path.c_str(), "a");
+    if (!opened) {
+        return false;
+    }
+    LoggerState& shared = state();
+    std::lock_guard<std::mutex> lock(shared.drainMutex);
+    if (shared.file) {
+        std::fclose(shared.file);
+    }
+    shared.file = opened;
+    return true;
+}
+
+/**
+ * @brief Направляет вывод в функцию (пустая функция - обратно в файл или std::cerr).
+ */
+void Logger::setSink(std::function<void(std::string_view)> sink) {
+    LoggerState& shared = state();
+    std::lock_guard<std::mutex> lock(shared.drainMutex);
+    shared.sink = std::move(sink);
+}
+
+/**
+ * @brief Настраивает журнал по переменным окружения HOTEL_LOG_LEVEL, HOTEL_LOG_FILE и HOTEL_LOG_RATE_LIMIT.
+ */
+void Logger::configureFromEnvironment() {
+    if (const char* level = std::getenv("HOTEL_LOG_LEVEL"); level && *level) {
+        try {
+            setLevel(parseLevel(level));
+        } catch (const std::invalid_argument& e) {
+            warning("{}", e.what());
+        }
+    }
+    if (const char* path = std::getenv("HOTEL_LOG_FILE"); path && *path && !openFile(path)) {
+        warning("Cannot open log file {}, logging to stderr", path);
+    }
+    if (const char* limit = std::getenv("HOTEL_LOG_RATE_LIMIT"); limit && *limit) {
+        char* end = nullptr;
+        unsigned long long perSecond = std::strtoull(limit, &end, 10);
+        if (*end == '\0') {
+            setRateLimit(static_cast<std::size_t>(perSecond));
+        } else {
+            warning("Invalid HOTEL_LOG_RATE_LIMIT value: {}", limit);
+        }
+    }
+}
+
+/**
+ * @brief Выводит все записи, опубликованные до вызова, включая сводки подавленных сообщений.
+ */
+void Logger::flush() {
+    drain(state(), true);
+}
+
+/**
+ * @brief Возвращает количество записей, отброшенных из-за заполненного буфера потока.
+ */
+std::uint64_t Logger::dropped() {
+    return state().dropped.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,213 @@
+/**
+ * @file Logger.h
+ * @brief Этот файл содержит асинхронный журнал диагностики (Logger): записи попадают в кольцевые
+ *        буферы потоков без блокировок, а форматирование и вывод выполняет фоновый поток пачками.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * @brief Уровень записи журнала.
+ * Имена DEBUG и ERROR не используются: это распространенные макросы (ERROR объявлен в windows.h).
+ */
+enum class LogLevel {
+    VERBOSE,
+    INFO,
+    WARNING,
+    SEVERE
+};
+
+/**
+ * @brief Аргумент записи, сохраненный до форматирования.
+ */
+struct LogArgument {
+    enum class Type : std::uint8_t {
+        SIGNED,
+        UNSIGNED,
+        REAL,
+        TEXT
+    };
+
+    Type type;
+    std::uint16_t textOffset;  ///< TEXT: смещение в LogRecord::text.
+    std::uint16_t textLength;  ///< TEXT: длина (строка обрезается, если не помещается).
+    union {
+        std::int64_t signedValue;
+        std::uint64_t unsignedValue;
+        double realValue;
+    };
+};
+
+/**
+ * @brief Неотформатированная запись: строка формата, аргументы и копии строковых аргументов.
+ */
+struct LogRecord {
+    static constexpr std::size_t MAX_ARGUMENTS = 4;
+    static constexpr std::size_t TEXT_BYTES = 200;
+
+    std::int64_t wallNs;        ///< Время записи (system_clock), нс от эпохи Unix.
+    const char* format;         ///< Строка формата с {} вместо аргументов (строковый литерал).
+    LogLevel level;
+    std::uint8_t argumentCount;
+    std::uint16_t textUsed;
+    LogArgument arguments[MAX_ARGUMENTS];
+    char text[TEXT_BYTES];
+};
+
+/**
+ * @brief Асинхронный журнал процесса.
+ *
+ * Logger::severe("Failed to add user: {}", e.what()) проверяет уровень, занимает ячейку в кольцевом
+ * буфере текущего потока (один производитель, один потребитель, без блокировок), копирует аргументы
+ * и публикует запись. Форматирование, ограничение частоты и вывод выполняет фоновый поток
+ * каждые 50 мс одной записью в приемник. Если буфер потока заполнен, запись отбрасывается
+ * и учитывается в dropped(): журнал никогда не блокирует вызывающий поток.
+ *
+ * Строка формата должна жить все время работы программы (строковый литерал): она читается позже,
+ * в фоновом потоке. Строковые аргументы копируются и могут быть временными.
+ */
+class Logger {
+public:
+    static constexpr std::size_t RING_RECORDS = 512;
+    static constexpr std::size_t DEFAULT_RATE_LIMIT = 100;
+
+private:
+    inline static std::atomic<int> minimumLevel{static_cast<int>(LogLevel::INFO)};
+
+    /**
+     * @brief Занимает ячейку в буфере текущего потока.
+     * @return Ячейка или nullptr, если буфер заполнен.
+     */
+    static LogRecord* reserve();
+
+    /**
+     * @brief Публикует запись, заполненную в ячейке из reserve().
+     */
+    static void commit();
+
+    /**
+     * @brief Копирует строковый аргумент в запись.
+     */
+    static void capture(LogRecord& record, std::string_view value);
+
+    static void capture(LogRecord& record, const char* value) { capture(record, std::string_view(value ? value : "(null)")); }
+    static void capture(LogRecord& record, const std::string& value) { capture(record, std::string_view(value)); }
+
+    template <std::integral T>
+    static void capture(LogRecord& record, T value) {
+        LogArgument& argument = record.arguments[record.argumentCount++];
+        if constexpr (std::is_signed_v<T>) {
+            argument.type = LogArgument::Type::SIGNED;
+            argument.signedValue = value;
+        } else {
+            argument.type = LogArgument::Type::UNSIGNED;
+            argument.unsignedValue = value;
+        }
+    }
+
+    template <std::floating_point T>
+    static void capture(LogRecord& record, T value) {
+        LogArgument& argument = record.arguments[record.argumentCount++];
+        argument.type = LogArgument::Type::REAL;
+        argument.realValue = static_cast<double>(value);
+    }
+
+public:
+    /**
+     * @brief Проверяет, записываются ли сообщения уровня level.
+     */
+    static bool enabled(LogLevel level) {
+        return static_cast<int>(level) >= minimumLevel.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Записывает сообщение (аргументы подставляются вместо {} в фоновом потоке).
+     * @param level Уровень.
+     * @param format Строка формата (строковый литерал).
+     * @param args Не более LogRecord::MAX_ARGUMENTS чисел или строк.
+     */
+    template <typename... Args>
+    static void log(LogLevel level, const char* format, const Args&... args) {
+        static_assert(sizeof...(Args) <= LogRecord::MAX_ARGUMENTS, "Too many log arguments");
+        if (!enabled(level)) {
+            return;
+        }
+        LogRecord* record = reserve();
+        if (!record) {
+            return;
+        }
+        record->level = level;
+        record->format = format;
+        record->argumentCount = 0;
+        record->textUsed = 0;
+        (capture(*record, args), ...);
+        commit();
+    }
+
+    template <typename... Args>
+    static void verbose(const char* format, const Args&... args) { log(LogLevel::VERBOSE, format, args...); }
+
+    template <typename... Args>
+    static void info(const char* format, const Args&... args) { log(LogLevel::INFO, format, args...); }
+
+    template <typename... Args>
+    static void warning(const char* format, const Args&... args) { log(LogLevel::WARNING, format, args...); }
+
+    template <typename... Args>
+    static void severe(const char* format, const Args&... args) { log(LogLevel::SEVERE, format, args...); }
+
+    /**
+     * @brief Устанавливает минимальный записываемый уровень (по умолчанию INFO).
+     */
+    static void setLevel(LogLevel level);
+
+    /**
+     * @brief Разбирает имя уровня (verbose, info, warning, severe; без учета регистра).
+     * @throws std::invalid_argument Если имя неизвестно.
+     */
+    static LogLevel parseLevel(const std::string& name);
+
+    /**
+     * @brief Ограничивает число сообщений одной строки формата в секунду (0 - без ограничения).
+     * Подавленные сообщения сводятся в одну строку "suppressed N messages".
+     */
+    static void setRateLimit(std::size_t perSecond);
+
+    /**
+     * @brief Направляет вывод в файл (дописывается в конец).
+     * @return False, если файл не удалось открыть; тогда вывод остается прежним.
+     */
+    static bool openFile(const std::string& path);
+
+    /**
+     * @brief Направляет вывод в функцию (пустая функция - обратно в std::cerr).
+     * Функция вызывается из фонового потока с пачкой готовых строк.
+     */
+    static void setSink(std::function<void(std::string_view)> sink);
+
+    /**
+     * @brief Настраивает журнал по переменным окружения HOTEL_LOG_LEVEL (verbose, info, warning,
+     *        severe), HOTEL_LOG_FILE (файл вместо std::cerr) и HOTEL_LOG_RATE_LIMIT (сообщений одной
+     *        строки формата в секунду, 0 - без ограничения). Неверные значения записываются в журнал.
+     */
+    static void configureFromEnvironment();
+
+    /**
+     * @brief Выводит все записи, опубликованные до вызова, включая сводки подавленных сообщений.
+     */
+    static void flush();
+
+    /**
+     * @brief Возвращает количество записей, отброшенных из-за заполненного буфера потока.
+     */
+    static std::uint64_t dropped();
+};
@@ -0,0 +1,296 @@
+/**
+ * @file Metrics.cpp
+ * @brief Этот файл содержит реализацию реестра метрик и записи выгрузки в файл.
+ */
+
+#include "Metrics.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+/**
+ * @brief Возвращает имя вида метрики для строки # TYPE.
+ */
+const char* kindName(MetricKind kind) {
+    switch (kind) {
+        case MetricKind::COUNTER: return "counter";
+        case MetricKind::GAUGE: return "gauge";
+        case MetricKind::HISTOGRAM: return "histogram";
+    }
+    return "untyped";
+}
+
+/**
+ * @brief Собирает метки в фигурных скобках с дополнительной меткой (пустая строка - без меток).
+ */
+std::string labelSet(const std::string& labels, const std::string& extra = "") {
+    if (labels.empty() && extra.empty()) {
+        return "";
+    }
+    return "{" + labels + (!labels.empty() && !extra.empty() ? "," : "") + extra + "}";
+}
+
+} // namespace
+
+/**
+ * @brief Записывает длительность.
+ * @param nanoseconds Длительность в наносекундах.
+ */
+void MetricHistogram::observe(std::uint64_t nanoseconds) {
+    std::size_t index = static_cast<std::size_t>(
+        std::lower_bound(BOUNDS_NS.begin(), BOUNDS_NS.end(), nanoseconds) - BOUNDS_NS.begin());
+    buckets[index].fetch_add(1, std::memory_order_relaxed);
+    sumNs.fetch_add(nanoseconds, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Записывает длительность.
+ */
+void MetricHistogram::observe(std::chrono::steady_clock::duration duration) {
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+    observe(static_cast<std::uint64_t>(ns > 0 ? ns : 0));
+}
+
+/**
+ * @brief Оценивает перцентиль по границам корзин (верхняя граница корзины, в которую он попал).
+ * @param percentile Перцентиль от 0 до 100.
+ * @return Оценка в наносекундах; 0 для пустой гистограммы, BOUNDS_NS.back() для корзины +Inf.
+ */
+std::uint64_t MetricHistogram::percentile(double percentile) const {
+    std::array<std::uint64_t, BOUND_COUNT + 1> counts;
+    std::uint64_t observed = 0;
+    for (std::size_t i = 0; i <= BOUND_COUNT; ++i) {
+        counts[i] = bucket(i);
+        observed += counts[i];
+    }
+    if (observed == 0) {
+        return 0;
+    }
+    double rank = std::clamp(percentile, 0.0, 100.0) / 100.0 * static_cast<double>(observed);
+    std::uint64_t running = 0;
+    for (std::size_t i = 0; i < BOUND_COUNT; ++i) {
+        running += counts[i];
+        if (running > 0 && static_cast<double>(running) >= rank) {
+            return BOUNDS_NS[i];
+        }
+    }
+    return BOUNDS_NS.back();
+}
+
+/**
+ * @brief Возвращает общий реестр процесса.
+ */
+MetricsRegistry& MetricsRegistry::global() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+/**
+ * @brief Находит или регистрирует метрику.
+ * @throws std::invalid_argument Если метрика с этим именем уже зарегистрирована другого вида.
+ */
+MetricsRegistry::Entry& MetricsRegistry::entry(const std::string& name, const std::string& help,
+                                               const std::string& labels, MetricKind kind) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& existing : entries) {
+        if (existing.name != name) {
+            continue;
+        }
+        if (existing.kind != kind) {
+            throw std::invalid_argument("Metric " + name + " is already registered as a " + kindName(existing.kind));
+        }
+        if (existing.labels == labels) {
+            return existing;
+        }
+    }
+    Entry& created = entries.emplace_back();
+    created.name = name;
+    created.help = help;
+    created.labels = labels;
+    created.kind = kind;
+    return created;
+}
+
+/**
+ * @brief Возвращает счетчик (регистрирует при первом обращении).
+ * @param name Имя метрики, например hotel_bookings_created_total.
+ * @param help Описание для строки # HELP.
+ * @param labels Метки без фигурных скобок, например result="success".
+ */
+MetricCounter& MetricsRegistry::counter(const std::string& name, const std::string& help, const std::string& labels) {
+    return entry(name, help, labels, MetricKind::COUNTER).counter;
+}
+
+/**
+ * @brief Возвращает измеритель (регистрирует при первом обращении).
+ */
+MetricGauge& MetricsRegistry::gauge(const std::string& name, const std::string& help, const std::string& labels) {
+    return entry(name, help, labels, MetricKind::GAUGE).gauge;
+}
+
+/**
+ * @brief Возвращает гистограмму длительностей (регистрирует при первом обращении).
+ */
+MetricHistogram& MetricsRegistry::histogram(const std::string& name, const std::string& help, const std::string& labels) {
+    return entry(name, help, labels, MetricKind::HISTOGRAM).histogram;
+}
+
+/**
+ * @brief Возвращает выгрузку в текстовом формате Prometheus (версия 0.0.4).
+ * Метрики одного имени выводятся вместе под одной парой строк # HELP / # TYPE. Для гистограммы
+ * корзины накопительные, а _count равен корзине +Inf, даже если запись шла во время выгрузки.
+ */
+std::string MetricsRegistry::prometheusText() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::map<std::string, std::vector<const Entry*>> byName;
+    for (const auto& entry : entries) {
+        byName[entry.name].push_back(&entry);
+    }
+
+    std::ostringstream out;
+    for (const auto& [name, group] : byName) {
+        out << "# HELP " << name << ' ' << group.front()->help << '\n';
+        out << "# TYPE " << name << ' ' << kindName(group.front()->kind) << '\n';
+        for (const Entry* entry : group) {
+            switch (entry->kind) {
+                case MetricKind::COUNTER:
+                    out << name << labelSet(entry->labels) << ' ' << entry->counter.get() << '\n';
+                    break;
+                case MetricKind::GAUGE:
+                    out << name << labelSet(entry->labels) << ' ' << entry->gauge.get() << '\n';
+                    break;
+                case MetricKind::HISTOGRAM: {
+                    std::uint64_t cumulative = 0;
+                    for (std::size_t i = 0; i < MetricHistogram::BOUND_COUNT; ++i) {
+                        cumulative += entry->histogram.bucket(i);
+                        std::ostringstream bound;
+                        bound << static_cast<double>(MetricHistogram::BOUNDS_NS[i]) / 1e9;
+                        out << name << "_bucket" << labelSet(entry->labels, "le=\"" + bound.str() + "\"") << ' '
+                            << cumulative << '\n';
+                    }
+                    cumulative += entry->histogram.bucket(MetricHistogram::BOUND_COUNT);
+                    out << name << "_bucket" << labelSet(entry->labels, "le=\"+Inf\"") << ' ' << cumulative << '\n';
+                    out << name << "_sum" << labelSet(entry->labels) << ' '
+                        << static_cast<double>(entry->histogram.sum()) / 1e9 << '\n';
+                    out << name << "_count" << labelSet(entry->labels) << ' ' << cumulative << '\n';
+                    break;
+                }
+            }
+        }
+    }
+    return out.str();
+}
+
+/**
+ * @brief Возвращает значения всех метрик в порядке имен.
+ */
+std::vector<MetricSample> MetricsRegistry::samples() const {
+    std::vector<MetricSample> result;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& entry : entries) {
+            MetricSample sample{entry.name, entry.labels, entry.kind};
+            switch (entry.kind) {
+                case MetricKind::COUNTER: sample.value = static_cast<double>(entry.counter.get()); break;
+                case MetricKind::GAUGE: sample.value = static_cast<double>(entry.gauge.get()); break;
+                case MetricKind::HISTOGRAM: {
+                    std::uint64_t count = entry.histogram.count();
+                    sample.value = static_cast<double>(count);
+                    sample.meanMs = count ? static_cast<double>(entry.histogram.sum()) / static_cast<double>(count) / 1e6 : 0;
+                    sample.p50Ms = static_cast<double>(entry.histogram.percentile(50)) / 1e6;
+                    sample.p99Ms = static_cast<double>(entry.histogram.percentile(99)) / 1e6;
+                    break;
+                }
+            }
+            result.push_back(std::move(sample));
+        }
+    }
+    std::stable_sort(result.begin(), result.end(), [](const MetricSample& a, const MetricSample& b) {
+        return a.name < b.name;
+    });
+    return result;
+}
+
+/**
+ * @brief Конструирует экспортер.
+ * @param registry Реестр метрик.
+ * @param path Путь к файлу выгрузки.
+ * @param interval Период записи.
+ */
+MetricsFileExporter::MetricsFileExporter(MetricsRegistry& registry, std::string path, std::chrono::milliseconds interval)
+    : registry(registry), path(std::move(path)), interval(interval) {}
+
+/**
+ * @brief Останавливает запись (с последней записью файла).
+ */
+MetricsFileExporter::~MetricsFileExporter() {
+    stop();
+}
+
+/**
+ * @brief Записывает выгрузку в файл немедленно.
+ * Выгрузка пишется во временный файл рядом с целевым и переименовывается, поэтому
+ * сборщик никогда не читает наполовину записанный файл.
+ * @return False, если файл не удалось записать.
+ */
+bool MetricsFileExporter::writeNow() {
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::trunc);
+        out << registry.prometheusText();
+        if (!out) {
+            return false;
+        }
+    }
+    std::remove(path.c_str()); // rename на Windows не заменяет существующий файл
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+/**
+ * @brief Запускает фоновую запись.
+ */
+void MetricsFileExporter::start() {
+    if (worker.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = false;
+    }
+    worker = std::thread(&MetricsFileExporter::loop, this);
+}
+
+/**
+ * @brief Останавливает фоновую запись и дожидается завершения потока.
+ */
+void MetricsFileExporter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Цикл фонового потока: записывает файл каждые interval и один раз при остановке.
+ */
+void MetricsFileExporter::loop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        lock.unlock();
+        writeNow();
+        lock.lock();
+        wakeUp.wait_for(lock, interval, [this] { return stopping; });
+    }
+    lock.unlock();
+    writeNow();
+}
@@ -0,0 +1,273 @@
+/**
+ * @file Metrics.h
+ * @brief Этот файл содержит реестр метрик (MetricsRegistry) со счетчиками, измерителями и гистограммами
+ *        без блокировок на пути записи, их выгрузку в текстовом формате Prometheus и периодическую
+ *        запись выгрузки в файл (MetricsFileExporter).
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Монотонно растущий счетчик.
+ */
+class MetricCounter {
+private:
+    std::atomic<std::uint64_t> value{0};
+
+public:
+    /**
+     * @brief Увеличивает счетчик.
+     */
+    void increment(std::uint64_t amount = 1) { value.fetch_add(amount, std::memory_order_relaxed); }
+
+    /**
+     * @brief Возвращает значение счетчика.
+     */
+    std::uint64_t get() const { return value.load(std::memory_order_relaxed); }
+};
+
+/**
+ * @brief Измеритель: значение, которое может расти и уменьшаться (например, число открытых соединений).
+ */
+class MetricGauge {
+private:
+    std::atomic<std::int64_t> value{0};
+
+public:
+    /**
+     * @brief Устанавливает значение.
+     */
+    void set(std::int64_t newValue) { value.store(newValue, std::memory_order_relaxed); }
+
+    /**
+     * @brief Изменяет значение на delta.
+     */
+    void add(std::int64_t delta) { value.fetch_add(delta, std::memory_order_relaxed); }
+
+    /**
+     * @brief Возвращает значение.
+     */
+    std::int64_t get() const { return value.load(std::memory_order_relaxed); }
+};
+
+/**
+ * @brief Гистограмма длительностей с фиксированными границами корзин (от 100 мкс до 10 с).
+ * Каждая корзина - отдельный атомарный счетчик, поэтому запись не блокирует и не выделяет память.
+ * Снимок, прочитанный во время записи, может не учитывать последние наблюдения, но не бывает испорчен.
+ */
+class MetricHistogram {
+public:
+    static constexpr std::size_t BOUND_COUNT = 16;
+    /// Верхние границы корзин в наносекундах; последняя корзина (+Inf) - все, что больше.
+    static constexpr std::array<std::uint64_t, BOUND_COUNT> BOUNDS_NS = {
+        100'000, 250'000, 500'000, 1'000'000, 2'500'000, 5'000'000, 10'000'000, 25'000'000,
+        50'000'000, 100'000'000, 250'000'000, 500'000'000, 1'000'000'000, 2'500'000'000, 5'000'000'000, 10'000'000'000};
+
+private:
+    std::array<std::atomic<std::uint64_t>, BOUND_COUNT + 1> buckets{};
+    std::atomic<std::uint64_t> sumNs{0};
+    std::atomic<std::uint64_t> total{0};
+
+public:
+    /**
+     * @brief Записывает длительность.
+     * @param nanoseconds Длительность в наносекундах.
+     */
+    void observe(std::uint64_t nanoseconds);
+
+    /**
+     * @brief Записывает длительность.
+     */
+    void observe(std::chrono::steady_clock::duration duration);
+
+    /**
+     * @brief Возвращает количество наблюдений в корзине (не накопительное).
+     * @param index Индекс корзины от 0 до BOUND_COUNT (последняя - больше всех границ).
+     */
+    std::uint64_t bucket(std::size_t index) const { return buckets[index].load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Возвращает количество наблюдений.
+     */
+    std::uint64_t count() const { return total.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Возвращает сумму наблюдений в наносекундах.
+     */
+    std::uint64_t sum() const { return sumNs.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Оценивает перцентиль по границам корзин (верхняя граница корзины, в которую он попал).
+     * @param percentile Перцентиль от 0 до 100.
+     * @return Оценка в наносекундах; 0 для пустой гистограммы, BOUNDS_NS.back() для корзины +Inf.
+     */
+    std::uint64_t percentile(double percentile) const;
+};
+
+/**
+ * @brief Замер длительности области видимости в гистограмму.
+ */
+class MetricTimer {
+private:
+    MetricHistogram& histogram;
+    std::chrono::steady_clock::time_point started;
+
+public:
+    explicit MetricTimer(MetricHistogram& histogram) : histogram(histogram), started(std::chrono::steady_clock::now()) {}
+    ~MetricTimer() { histogram.observe(std::chrono::steady_clock::now() - started); }
+
+    MetricTimer(const MetricTimer&) = delete;
+    MetricTimer& operator=(const MetricTimer&) = delete;
+};
+
+/**
+ * @brief Вид метрики.
+ */
+enum class MetricKind {
+    COUNTER,
+    GAUGE,
+    HISTOGRAM
+};
+
+/**
+ * @brief Значение метрики на момент снимка (для экрана статистики).
+ */
+struct MetricSample {
+    std::string name;
+    std::string labels;         ///< Метки в формате Prometheus без фигурных скобок, например kind="read".
+    MetricKind kind;
+    double value = 0;           ///< Значение счетчика или измерителя; для гистограммы - количество наблюдений.
+    double meanMs = 0;          ///< Гистограмма: среднее, мс.
+    double p50Ms = 0;           ///< Гистограмма: оценка медианы, мс.
+    double p99Ms = 0;           ///< Гистограмма: оценка 99-го перцентиля, мс.
+};
+
+/**
+ * @brief Реестр метрик процесса.
+ * Метрика определяется именем и метками; повторная регистрация возвращает тот же объект.
+ * Регистрация берет мьютекс, поэтому места вызова сохраняют ссылку (обычно в статической
+ * локальной переменной), и дальше запись идет только атомарными операциями. Объекты метрик
+ * живут столько же, сколько реестр, и не перемещаются.
+ */
+class MetricsRegistry {
+private:
+    struct Entry {
+        std::string name;
+        std::string help;
+        std::string labels;
+        MetricKind kind;
+        MetricCounter counter;
+        MetricGauge gauge;
+        MetricHistogram histogram;
+    };
+
+    mutable std::mutex mutex;
+    std::deque<Entry> entries;
+
+    /**
+     * @brief Находит или регистрирует метрику.
+     * @throws std::invalid_argument Если метрика с этим именем уже зарегистрирована другого вида.
+     */
+    Entry& entry(const std::string& name, const std::string& help, const std::string& labels, MetricKind kind);
+
+public:
+    /**
+     * @brief Возвращает общий реестр процесса.
+     */
+    static MetricsRegistry& global();
+
+    /**
+     * @brief Возвращает счетчик (регистрирует при первом обращении).
+     * @param name Имя метрики, например hotel_bookings_created_total.
+     * @param help Описание для строки # HELP.
+     * @param labels Метки без фигурных скобок, например result="success".
+     */
+    MetricCounter& counter(const std::string& name, const std::string& help, const std::string& labels = "");
+
+    /**
+     * @brief Возвращает измеритель (регистрирует при первом обращении).
+     */
+    MetricGauge& gauge(const std::string& name, const std::string& help, const std::string& labels = "");
+
+    /**
+     * @brief Возвращает гистограмму длительностей (регистрирует при первом обращении).
+     * Выгружается в секундах, поэтому имя должно оканчиваться на _seconds.
+     */
+    MetricHistogram& histogram(const std::string& name, const std::string& help, const std::string& labels = "");
+
+    /**
+     * @brief Возвращает выгрузку в текстовом формате Prometheus (версия 0.0.4).
+     */
+    std::string prometheusText() const;
+
+    /**
+     * @brief Возвращает значения всех метрик в порядке имен.
+     */
+    std::vector<MetricSample> samples() const;
+};
+
+/**
+ * @brief Периодическая запись выгрузки реестра в файл (для node_exporter textfile collector
+ *        или чтения любым сборщиком). Файл заменяется атомарно через временный файл.
+ */
+class MetricsFileExporter {
+private:
+    MetricsRegistry& registry;
+    std::string path;
+    std::chrono::milliseconds interval;
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    bool stopping = false;
+    std::thread worker;
+
+    /**
+     * @brief Цикл фонового потока.
+     */
+    void loop();
+
+public:
+    /**
+     * @brief Конструирует экспортер.
+     * @param registry Реестр метрик.
+     * @param path Путь к файлу выгрузки.
+     * @param interval Период записи.
+     */
+    MetricsFileExporter(MetricsRegistry& registry, std::string path, std::chrono::milliseconds interval);
+
+    /**
+     * @brief Останавливает запись (с последней записью файла).
+     */
+    ~MetricsFileExporter();
+
+    MetricsFileExporter(const MetricsFileExporter&) = delete;
+    MetricsFileExporter& operator=(const MetricsFileExporter&) = delete;
+
+    /**
+     * @brief Записывает выгрузку в файл немедленно.
+     * @return False, если файл не удалось записать.
+     */
+    bool writeNow();
+
+    /**
+     * @brief Запускает фоновую запись.
+     */
+    void start();
+
+    /**
+     * @brief Останавливает фоновую запись и дожидается завершения потока.
+     */
+    void stop();
+};
@@ -0,0 +1,103 @@
+/**
+ * @file OptimisticLock.h
+ * @brief Этот файл содержит типы для оптимистичной блокировки: результат изменения с проверкой версии
+ *        (compare-and-set), политику повторов и вспомогательную функцию retryOnConflict.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <random>
+#include <thread>
+#include <type_traits>
+
+/**
+ * @brief Результат изменения записи с проверкой версии.
+ */
+enum class UpdateResult {
+    OK,         ///< Изменение применено, версия увеличена.
+    CONFLICT,   ///< Запись была изменена другим пользователем (версия не совпала).
+    NOT_FOUND   ///< Запись не найдена.
+};
+
+/**
+ * @brief Политика повторов при конфликте версий.
+ */
+struct RetryPolicy {
+    int maxAttempts = 5;                                      ///< Максимальное число попыток.
+    std::chrono::milliseconds initialBackoff{5};             ///< Задержка перед второй попыткой.
+    std::chrono::milliseconds maxBackoff{200};               ///< Верхняя граница задержки.
+};
+
+/**
+ * @brief Вычисляет задержку перед повтором: экспоненциальный рост с полным случайным разбросом.
+ * @param attempt Номер завершившейся неудачной попытки (начиная с 1).
+ * @param policy Политика повторов.
+ * @param random Генератор случайных чисел.
+ * @return Задержка перед следующей попыткой.
+ */
+template <typename Random>
+std::chrono::milliseconds computeBackoff(int attempt, const RetryPolicy& policy, Random& random) {
+    long long ceiling = policy.initialBackoff.count();
+    for (int i = 1; i < attempt && ceiling < policy.maxBackoff.count(); ++i) {
+        ceiling *= 2;
+    }
+    if (ceiling > policy.maxBackoff.count()) {
+        ceiling = policy.maxBackoff.count();
+    }
+    std::uniform_int_distribution<long long> jitter(0, ceiling);
+    return std::chrono::milliseconds(jitter(random));
+}
+
+/**
+ * @brief Управление повторами изнутри попытки.
+ * Попытка вызывает stop(), если конфликт окончательный (например, запись изменилась так, что
+ * повтор потерял смысл): retryOnConflict сразу возвращает ее результат.
+ */
+class RetryControl {
+    bool stopped = false;
+
+public:
+    /**
+     * @brief Запрещает дальнейшие повторы.
+     */
+    void stop() { stopped = true; }
+
+    /**
+     * @brief Проверяет, запрещены ли повторы.
+     * @return true, если попытка вызвала stop().
+     */
+    bool isStopped() const { return stopped; }
+};
+
+/**
+ * @brief Выполняет попытку изменения, повторяя ее при конфликте версий.
+ * Попытка должна сама перечитывать актуальную версию записи перед изменением.
+ * @param attempt Функция без аргументов или с аргументом RetryControl&, возвращающая UpdateResult.
+ * @param policy Политика повторов.
+ * @param attemptsMade Если не nullptr, получает количество выполненных попыток.
+ * @return Результат последней попытки.
+ */
+template <typename Attempt>
+UpdateResult retryOnConflict(Attempt&& attempt, const RetryPolicy& policy = RetryPolicy(), int* attemptsMade = nullptr) {
+    thread_local std::minstd_rand random(std::random_device{}());
+    UpdateResult result = UpdateResult::CONFLICT;
+    RetryControl control;
+    int made = 0;
+    while (made < policy.maxAttempts) {
+        if constexpr (std::is_invocable_v<Attempt&, RetryControl&>) {
+            result = attempt(control);
+        } else {
+            result = attempt();
+        }
+        ++made;
+        if (result != UpdateResult::CONFLICT || control.isStopped() || made == policy.maxAttempts) {
+            break;
+        }
+        std::this_thread::sleep_for(computeBackoff(made, policy, random));
+    }
+    if (attemptsMade) {
+        *attemptsMade = made;
+    }
+    return result;
+}
@@ -0,0 +1,436 @@
+/**
+ * @file PartitionManager.cpp
+ * @brief Этот файл содержит реализацию класса PartitionManager и формата архива секции.
+ */
+
+#include "PartitionManager.h"
+#include "DurableFile.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace {
+
+constexpr char ARCHIVE_MAGIC[4] = {'H', 'B', 'P', 'A'};
+constexpr std::uint16_t ARCHIVE_VERSION = 1;
+constexpr std::size_t HEADER_SIZE = 4 + 2 + 4 + 4 + 4;
+constexpr std::size_t BOOKING_RECORD_SIZE = 6 * 4 + 1;
+constexpr std::size_t SERVICE_RECORD_SIZE = 3 * 4;
+
+const char* const STATUSES[] = {"pending", "confirmed", "cancelled", "completed"};
+
+/**
+ * @brief Разбирает дату YYYY-MM-DD (день может отсутствовать) на год и месяц.
+ * @throws std::invalid_argument При неверном формате.
+ */
+void parseMonth(const std::string& date, int& year, int& month) {
+    bool valid = date.size() >= 7 && date[4] == '-';
+    for (std::size_t i : {0, 1, 2, 3, 5, 6}) {
+        valid = valid && i < date.size() && std::isdigit(static_cast<unsigned char>(date[i]));
+    }
+    if (!valid) {
+        throw std::invalid_argument("Invalid date: '" + date + "'");
+    }
+    year = std::stoi(date.substr(0, 4));
+    month = std::stoi(date.substr(5, 2));
+    if (month < 1 || month > 12) {
+        throw std::invalid_argument("Invalid month in date: '" + date + "'");
+    }
+}
+
+/**
+ * @brief Форматирует первый день месяца как YYYY-MM-01.
+ */
+std::string formatMonth(int year, int month) {
+    char buffer[16];
+    std::snprintf(buffer, sizeof(buffer), "%04d-%02d-01", year, month);
+    return buffer;
+}
+
+/**
+ * @brief Переводит дату YYYY-MM-DD в число YYYYMMDD.
+ */
+std::int32_t packDate(const std::string& date) {
+    if (date.size() != 10 || date[4] != '-' || date[7] != '-') {
+        throw std::runtime_error("Cannot archive date '" + date + "'");
+    }
+    return std::stoi(date.substr(0, 4)) * 10000 + std::stoi(date.substr(5, 2)) * 100 + std::stoi(date.substr(8, 2));
+}
+
+/**
+ * @brief Переводит число YYYYMMDD в дату YYYY-MM-DD.
+ */
+std::string unpackDate(std::int32_t packed) {
+    char buffer[16];
+    std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d", packed / 10000, packed / 100 % 100, packed % 100);
+    return buffer;
+}
+
+/**
+ * @brief Возвращает код статуса для архива.
+ */
+std::uint8_t packStatus(const std::string& status) {
+    for (std::uint8_t code = 0; code < std::size(STATUSES); ++code) {
+        if (status == STATUSES[code]) return code;
+    }
+    throw std::runtime_error("Cannot archive booking status '" + status + "'");
+}
+
+/**
+ * @brief Дописывает целое число в порядке little-endian.
+ */
+template <typename T>
+void put(std::string& out, T value) {
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        out.push_back(static_cast<char>((static_cast<std::uint64_t>(value) >> (8 * i)) & 0xFF));
+    }
+}
+
+/**
+ * @brief Читает целое число в порядке little-endian и сдвигает позицию.
+ */
+template <typename T>
+T take(const std::string& in, std::size_t& pos) {
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        value |= static_cast<std::uint64_t>(static_cast<unsigned char>(in[pos + i])) << (8 * i);
+    }
+    pos += sizeof(T);
+    return static_cast<T>(value);
+}
+
+/**
+ * @brief Возвращает целое значение ячейки результата.
+ */
+std::int32_t intValue(const PGResultWrapper& result, int row, int column) {
+    return std::stoi(PQgetvalue(result.get(), row, column));
+}
+
+} // namespace
+
+/**
+ * @brief Записывает архив в файл: временный файл сбрасывается на диск и переименовывается поверх
+ *        архива, затем на диск сбрасывается каталог. После возврата архив переживает сбой питания,
+ *        поэтому секцию можно удалять.
+ * @param path Путь к файлу архива.
+ * @throws std::runtime_error При ошибке записи или недопустимом значении.
+ */
+void PartitionArchive::write(const std::string& path) const {
+    std::string out;
+    out.reserve(HEADER_SIZE + bookings.size() * BOOKING_RECORD_SIZE + services.size() * SERVICE_RECORD_SIZE);
+    out.append(ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+    put<std::uint16_t>(out, ARCHIVE_VERSION);
+    put<std::int32_t>(out, packDate(month));
+    put<std::uint32_t>(out, static_cast<std::uint32_t>(bookings.size()));
+    put<std::uint32_t>(out, static_cast<std::uint32_t>(services.size()));
+    for (const auto& booking : bookings) {
+        put<std::int32_t>(out, booking.id);
+        put<std::int32_t>(out, booking.userId);
+        put<std::int32_t>(out, booking.roomId);
+        put<std::int32_t>(out, packDate(booking.dateFrom));
+        put<std::int32_t>(out, packDate(booking.dateTo));
+        put<std::int32_t>(out, booking.version);
+        put<std::uint8_t>(out, packStatus(booking.status));
+    }
+    for (const auto& service : services) {
+        put<std::int32_t>(out, service.bookingId);
+        put<std::int32_t>(out, service.serviceId);
+        put<std::int32_t>(out, service.quantity);
+    }
+
+    std::string temporary = path + ".tmp";
+    writeDurably(temporary, out);
+    replaceDurably(temporary, path);
+}
+
+/**
+ * @brief Читает архив из файла.
+ * @param path Путь к файлу архива.
+ * @return Содержимое архива.
+ * @throws std::runtime_error Если файл не найден, поврежден или имеет другую версию формата.
+ */
+PartitionArchive PartitionArchive::read(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Cannot open archive " + path);
+    }
+    std::string in((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (in.size() < HEADER_SIZE || in.compare(0, sizeof(ARCHIVE_MAGIC), ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0) {
+        throw std::runtime_error("Not a partition archive: " + path);
+    }
+    std::size_t pos = sizeof(ARCHIVE_MAGIC);
+    if (take<std::uint16_t>(in, pos) != ARCHIVE_VERSION) {
+        throw std::runtime_error("Unsupported partition archive version: " + path);
+    }
+    PartitionArchive archive;
+    archive.month = unpackDate(take<std::int32_t>(in, pos));
+    std::uint32_t bookingCount = take<std::uint32_t>(in, pos);
+    std::uint32_t serviceCount = take<std::uint32_t>(in, pos);
+    if (in.size() != HEADER_SIZE + bookingCount * BOOKING_RECORD_SIZE + serviceCount * SERVICE_RECORD_SIZE) {
+        throw std::runtime_error("Truncated partition archive: " + path);
+    }
+
+    archive.bookings.resize(bookingCount);
+    for (auto& booking : archive.bookings) {
+        booking.id = take<std::int32_t>(in, pos);
+        booking.userId = take<std::int32_t>(in, pos);
+        booking.roomId = take<std::int32_t>(in, pos);
+        booking.dateFrom = unpackDate(take<std::int32_t>(in, pos));
+        booking.dateTo = unpackDate(take<std::int32_t>(in, pos));
+        booking.version = take<std::int32_t>(in, pos);
+        std::uint8_t status = take<std::uint8_t>(in, pos);
+        if (status >= std::size(STATUSES)) {
+            throw std::runtime_error("Corrupt booking status in archive: " + path);
+        }
+        booking.status = STATUSES[status];
+    }
+    archive.services.resize(serviceCount);
+    for (auto& service : archive.services) {
+        service.bookingId = take<std::int32_t>(in, pos);
+        service.serviceId = take<std::int32_t>(in, pos);
+        service.quantity = take<std::int32_t>(in, pos);
+    }
+    return archive;
+}
+
+/**
+ * @brief Конструктор менеджера секций.
+ * @param dbManager Соединение с основной базой данных.
+ */
+PartitionManager::PartitionManager(DBManager& dbManager) : dbManager(dbManager) {}
+
+/**
+ * @brief Возвращает секционированные таблицы в порядке создания секций.
+ * Секции bookings создаются первыми: на них ссылается внешний ключ booking_services.
+ */
+const std::vector<std::string>& PartitionManager::tables() {
+    static const std::vector<std::string> names = {"bookings", "booking_services"};
+    return names;
+}
+
+/**
+ * @brief Возвращает первый день месяца указанной даты.
+ * @param date Дата в формате YYYY-MM-DD.
+ * @return Дата в формате YYYY-MM-01.
+ * @throws std::invalid_argument Если дата имеет неверный формат.
+ */
+std::string PartitionManager::monthStart(const std::string& date) {
+    int year, month;
+    parseMonth(date, year, month);
+    return formatMonth(year, month);
+}
+
+/**
+ * @brief Сдвигает первый день месяца на указанное количество месяцев.
+ * @param month Дата в формате YYYY-MM-01.
+ * @param months Количество месяцев (может быть отрицательным).
+ */
+std::string PartitionManager::addMonths(const std::string& month, int months) {
+    int year, number;
+    parseMonth(month, year, number);
+    int total = year * 12 + (number - 1) + months;
+    return formatMonth(total / 12, total % 12 + 1);
+}
+
+/**
+ * @brief Возвращает имя секции таблицы за месяц, например bookings_2024_05.
+ */
+std::string PartitionManager::partitionName(const std::string& table, const std::string& month) {
+    std::string start = monthStart(month);
+    return table + "_" + start.substr(0, 4) + "_" + start.substr(5, 2);
+}
+
+/**
+ * @brief Возвращает месяц (YYYY-MM-01) по имени секции или пустую строку для других таблиц.
+ * Имя bookings_services_... не принимается за секцию bookings: после префикса должен идти год.
+ */
+std::string PartitionManager::monthOfPartition(const std::string& table, const std::string& partition) {
+    std::string prefix = table + "_";
+    if (partition.size() != prefix.size() + 7 || partition.compare(0, prefix.size(), prefix) != 0 ||
+        partition[prefix.size() + 4] != '_') {
+        return "";
+    }
+    std::string candidate = partition.substr(prefix.size(), 4) + "-" + partition.substr(prefix.size() + 5, 2);
+    try {
+        return monthStart(candidate);
+    } catch (const std::invalid_argument&) {
+        return "";
+    }
+}
+
+/**
+ * @brief Возвращает запрос создания секции таблицы за месяц.
+ */
+std::string PartitionManager::createStatement(const std::string& table, const std::string& month) {
+    std::string start = monthStart(month);
+    return "CREATE TABLE IF NOT EXISTS " + partitionName(table, start) + " PARTITION OF " + table +
+           " FOR VALUES FROM ('" + start + "') TO ('" + addMonths(start, 1) + "');";
+}
+
+/**
+ * @brief Проверяет, что таблица bookings секционирована.
+ */
+bool PartitionManager::isPartitioned() {
+    PGResultWrapper result = dbManager.executeQuery(
+        "SELECT 1 FROM pg_class WHERE relname = 'bookings' AND relkind = 'p' AND pg_table_is_visible(oid);");
+    return PQntuples(result.get()) == 1;
+}
+
+/**
+ * @brief Возвращает месяцы (YYYY-MM-01) существующих секций таблицы, по возрастанию.
+ */
+std::vector<std::string> PartitionManager::existingMonths(const std::string& table) {
+    PGResultWrapper result = dbManager.executeQuery(
+        "SELECT c.relname FROM pg_inherits i JOIN pg_class c ON c.oid = i.inhrelid "
+        "JOIN pg_class p ON p.oid = i.inhparent WHERE p.relname = '" + table + "' ORDER BY c.relname;");
+    std::vector<std::string> months;
+    for (int i = 0; i < PQntuples(result.get()); ++i) {
+        std::string month = monthOfPartition(table, PQgetvalue(result.get(), i, 0));
+        if (!month.empty()) {
+            months.push_back(month);
+        }
+    }
+    return months;
+}
+
+/**
+ * @brief Создает недостающие секции от текущего месяца на monthsAhead месяцев вперед.
+ * @param today Текущая дата в формате YYYY-MM-DD.
+ * @param monthsAhead Количество будущих месяцев.
+ * @return Количество созданных секций.
+ * @throws std::runtime_error При ошибке базы данных.
+ */
+int PartitionManager::ensurePartitions(const std::string& today, int monthsAhead) {
+    if (!isPartitioned()) {
+        return 0;
+    }
+    std::string current = monthStart(today);
+    int created = 0;
+    for (const auto& table : tables()) {
+        std::vector<std::string> months = existingMonths(table);
+        for (int offset = 0; offset <= monthsAhead; ++offset) {
+            std::string month = addMonths(current, offset);
+            if (std::find(months.begin(), months.end(), month) == months.end()) {
+                dbManager.executeUpdate(createStatement(table, month));
+                ++created;
+            }
+        }
+    }
+    return created;
+}
+
+/**
+ * @brief Архивирует месяцы, закончившиеся раньше чем за keepMonths месяцев до текущего.
+ * @param today Текущая дата в формате YYYY-MM-DD.
+ * @param keepMonths Сколько прошедших месяцев оставить в таблицах.
+ * @param directory Каталог файлов архивов.
+ * @param dropDetached Удалить отсоединенные секции (иначе они остаются отдельными таблицами).
+ * @return Отчет о выполнении.
+ * @throws std::runtime_error При ошибке базы данных или записи файла.
+ */
+PartitionReport PartitionManager::archive(const std::string& today, int keepMonths, const std::string& directory,
+                                          bool dropDetached) {
+    PartitionReport report;
+    if (!isPartitioned()) {
+        return report;
+    }
+    std::string cutoff = addMonths(monthStart(today), -std::max(keepMonths, 0));
+    for (const auto& month : existingMonths("bookings")) {
+        if (month >= cutoff) {
+            break;
+        }
+        if (archiveMonth(month, today, directory, dropDetached, report)) {
+            ++report.archived;
+        } else {
+            ++report.skipped;
+        }
+    }
+    return report;
+}
+
+/**
+ * @brief Выгружает, отсоединяет и при необходимости удаляет секции одного месяца.
+ * Обе таблицы блокируются от записи (в том же порядке, что и у изменений услуг бронирования),
+ * поэтому файл содержит ровно те строки, которые покидают таблицы.
+ * @param month Месяц (YYYY-MM-01).
+ * @param today Текущая дата: бронирования с более поздней датой выезда считаются незавершенными.
+ * @param directory Каталог файлов архивов.
+ * @param dropDetached Удалить отсоединенные секции.
+ * @param report Отчет, дополняемый строками и файлами.
+ * @return False, если в месяце есть незавершенные бронирования.
+ */
+bool PartitionManager::archiveMonth(const std::string& month, const std::string& today, const std::string& directory,
+                                    bool dropDetached, PartitionReport& report) {
+    std::string bookingsPart = partitionName("bookings", month);
+    std::string servicesPart = partitionName("booking_services", month);
+    std::vector<std::string> serviceMonths = existingMonths("booking_services");
+    bool hasServices = std::find(serviceMonths.begin(), serviceMonths.end(), month) != serviceMonths.end();
+
+    dbManager.beginTransaction();
+    try {
+        dbManager.executeUpdate("LOCK TABLE bookings, booking_services IN SHARE ROW EXCLUSIVE MODE;");
+        PGResultWrapper active = dbManager.executeQuery(
+            "SELECT COUNT(*) FROM " + bookingsPart + " WHERE status IN ('pending', 'confirmed') OR date_to >= '" + today + "';");
+        if (std::stoi(PQgetvalue(active.get(), 0, 0)) > 0) {
+            dbManager.rollback();
+            return false;
+        }
+
+        PartitionArchive archive;
+        archive.month = month;
+        PGResultWrapper bookings = dbManager.executeQuery(
+            "SELECT id, user_id, room_id, date_from, date_to, status, version FROM " + bookingsPart + " ORDER BY id;");
+        archive.bookings.resize(PQntuples(bookings.get()));
+        for (int i = 0; i < PQntuples(bookings.get()); ++i) {
+            ArchivedBooking& booking = archive.bookings[i];
+            booking.id = intValue(bookings, i, 0);
+            booking.userId = intValue(bookings, i, 1);
+            booking.roomId = intValue(bookings, i, 2);
+            booking.dateFrom = PQgetvalue(bookings.get(), i, 3);
+            booking.dateTo = PQgetvalue(bookings.get(), i, 4);
+            booking.status = PQgetvalue(bookings.get(), i, 5);
+            booking.version = intValue(bookings, i, 6);
+        }
+        if (hasServices) {
+            PGResultWrapper services = dbManager.executeQuery(
+                "SELECT booking_id, service_id, quantity FROM " + servicesPart + " ORDER BY booking_id, service_id;");
+            archive.services.resize(PQntuples(services.get()));
+            for (int i = 0; i < PQntuples(services.get()); ++i) {
+                archive.services[i] = {intValue(services, i, 0), intValue(services, i, 1), intValue(services, i, 2)};
+            }
+        }
+
+        std::string path = directory + "/" + bookingsPart + ".archive";
+        archive.write(path);
+
+        // Строки услуг ссылаются на секцию bookings, поэтому их секция уходит первой. Отсоединенная
+        // секция услуг сохраняет внешний ключ на bookings; он снимается, иначе секцию bookings нельзя отсоединить.
+        if (hasServices && dropDetached) {
+            dbManager.executeUpdate("DROP TABLE " + servicesPart + ";");
+        } else if (hasServices) {
+            dbManager.executeUpdate("ALTER TABLE booking_services DETACH PARTITION " + servicesPart + ";");
+            PGResultWrapper keys = dbManager.executeQuery(
+                "SELECT conname FROM pg_constraint WHERE contype = 'f' AND conrelid = '" + servicesPart +
+                "'::regclass AND confrelid = 'bookings'::regclass;");
+            for (int i = 0; i < PQntuples(keys.get()); ++i) {
+                dbManager.executeUpdate("ALTER TABLE " + servicesPart + " DROP CONSTRAINT \"" +
+                                        std::string(PQgetvalue(keys.get(), i, 0)) + "\";");
+            }
+        }
+        dbManager.executeUpdate("ALTER TABLE bookings DETACH PARTITION " + bookingsPart + ";");
+        if (dropDetached) {
+            dbManager.executeUpdate("DROP TABLE " + bookingsPart + ";");
+        }
+        dbManager.commit();
+
+        report.rowsArchived += static_cast<long long>(archive.bookings.size() + archive.services.size());
+        report.files.push_back(path);
+    } catch (const std::exception&) {
+        dbManager.rollback();
+        throw;
+    }
+    return true;
+}
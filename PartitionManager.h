@@ -0,0 +1,168 @@
+/**
+ * @file PartitionManager.h
+ * @brief Этот файл содержит объявление класса PartitionManager - обслуживания помесячных секций
+ *        таблиц bookings и booking_services (создание будущих секций, архивирование старых),
+ *        а также компактного формата файла архива секции.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "DBManager.h"
+
+/**
+ * @brief Бронирование в архиве секции.
+ */
+struct ArchivedBooking {
+    std::int32_t id = 0;
+    std::int32_t userId = 0;
+    std::int32_t roomId = 0;
+    std::string dateFrom;   ///< Дата заезда в формате YYYY-MM-DD.
+    std::string dateTo;     ///< Дата выезда в формате YYYY-MM-DD.
+    std::string status;
+    std::int32_t version = 0;
+};
+
+/**
+ * @brief Строка услуги бронирования в архиве секции.
+ */
+struct ArchivedService {
+    std::int32_t bookingId = 0;
+    std::int32_t serviceId = 0;
+    std::int32_t quantity = 0;
+};
+
+/**
+ * @brief Содержимое архива одной месячной секции.
+ * Файл двоичный: заголовок (сигнатура, версия, месяц, количества строк), затем записи
+ * фиксированной длины; даты хранятся числом YYYYMMDD, статус - одним байтом.
+ */
+struct PartitionArchive {
+    std::string month;                      ///< Первый день месяца секции (YYYY-MM-01).
+    std::vector<ArchivedBooking> bookings;
+    std::vector<ArchivedService> services;
+
+    /**
+     * @brief Записывает архив в файл через временный файл с fsync, переименование поверх архива и
+     *        fsync каталога: после возврата архив сохранен на диске.
+     * @param path Путь к файлу архива.
+     * @throws std::runtime_error При ошибке записи или недопустимом значении.
+     */
+    void write(const std::string& path) const;
+
+    /**
+     * @brief Читает архив из файла.
+     * @param path Путь к файлу архива.
+     * @return Содержимое архива.
+     * @throws std::runtime_error Если файл не найден, поврежден или имеет другую версию формата.
+     */
+    static PartitionArchive read(const std::string& path);
+};
+
+/**
+ * @brief Результат обслуживания секций.
+ */
+struct PartitionReport {
+    int created = 0;                    ///< Создано месячных секций (по всем таблицам).
+    int archived = 0;                   ///< Архивировано месяцев.
+    int skipped = 0;                    ///< Месяцев пропущено из-за незавершенных бронирований.
+    long long rowsArchived = 0;         ///< Выгружено строк bookings и booking_services.
+    std::vector<std::string> files;     ///< Созданные файлы архивов.
+};
+
+/**
+ * @brief Обслуживание помесячных секций bookings/booking_services (см. sql/002_partition_bookings.sql).
+ * Будущие секции создаются заранее, чтобы новые бронирования не попадали в секцию DEFAULT.
+ * Месяцы старше срока хранения, в которых все бронирования завершены или отменены, выгружаются
+ * в компактный файл, после чего секции отсоединяются от таблиц и (по желанию) удаляются.
+ * Запросы к текущим и ближайшим месяцам после этого не затрагивают историю.
+ * Если таблица bookings не секционирована (миграция не применена), методы ничего не делают.
+ */
+class PartitionManager {
+private:
+    DBManager& dbManager;
+
+    /**
+     * @brief Проверяет, что таблица bookings секционирована.
+     */
+    bool isPartitioned();
+
+    /**
+     * @brief Возвращает месяцы (YYYY-MM-01) существующих секций таблицы, по возрастанию.
+     */
+    std::vector<std::string> existingMonths(const std::string& table);
+
+    /**
+     * @brief Выгружает, отсоединяет и при необходимости удаляет секции одного месяца.
+     * @return False, если в месяце есть незавершенные бронирования.
+     */
+    bool archiveMonth(const std::string& month, const std::string& today, const std::string& directory,
+                      bool dropDetached, PartitionReport& report);
+
+public:
+    /**
+     * @brief Конструирует менеджер секций.
+     * @param dbManager Соединение с основной базой данных.
+     */
+    explicit PartitionManager(DBManager& dbManager);
+
+    /**
+     * @brief Возвращает секционированные таблицы в порядке создания секций.
+     */
+    static const std::vector<std::string>& tables();
+
+    /**
+     * @brief Возвращает первый день месяца указанной даты.
+     * @param date Дата в формате YYYY-MM-DD.
+     * @return Дата в формате YYYY-MM-01.
+     * @throws std::invalid_argument Если дата имеет неверный формат.
+     */
+    static std::string monthStart(const std::string& date);
+
+    /**
+     * @brief Сдвигает первый день месяца на указанное количество месяцев.
+     * @param month Дата в формате YYYY-MM-01.
+     * @param months Количество месяцев (может быть отрицательным).
+     */
+    static std::string addMonths(const std::string& month, int months);
+
+    /**
+     * @brief Возвращает имя секции таблицы за месяц, например bookings_2024_05.
+     */
+    static std::string partitionName(const std::string& table, const std::string& month);
+
+    /**
+     * @brief Возвращает месяц (YYYY-MM-01) по имени секции или пустую строку для других таблиц.
+     */
+    static std::string monthOfPartition(const std::string& table, const std::string& partition);
+
+    /**
+     * @brief Возвращает запрос создания секции таблицы за месяц.
+     */
+    static std::string createStatement(const std::string& table, const std::string& month);
+
+    /**
+     * @brief Создает недостающие секции от текущего месяца на monthsAhead месяцев вперед.
+     * @param today Текущая дата в формате YYYY-MM-DD.
+     * @param monthsAhead Количество будущих месяцев.
+     * @return Количество созданных секций.
+     * @throws std::runtime_error При ошибке базы данных.
+     */
+    int ensurePartitions(const std::string& today, int monthsAhead = 3);
+
+    /**
+     * @brief Архивирует месяцы, закончившиеся раньше чем за keepMonths месяцев до текущего.
+     * Для каждого месяца строки обеих секций записываются в файл <directory>/bookings_YYYY_MM.archive,
+     * затем секции отсоединяются в той же транзакции, в которой были прочитаны.
+     * @param today Текущая дата в формате YYYY-MM-DD.
+     * @param keepMonths Сколько прошедших месяцев оставить в таблицах.
+     * @param directory Каталог файлов архивов.
+     * @param dropDetached Удалить отсоединенные секции (иначе они остаются отдельными таблицами).
+     * @return Отчет о выполнении.
+     * @throws std::runtime_error При ошибке базы данных или записи файла.
+     */
+    PartitionReport archive(const std::string& today, int keepMonths, const std::string& directory,
+                            bool dropDetached = true);
+};
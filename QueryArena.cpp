@@ -0,0 +1,30 @@
+/**
+ * @file QueryArena.cpp
+ * @brief Этот файл содержит реализацию класса QueryArena.
+ */
+
+#include "QueryArena.h"
+#include <cstring>
+
+/**
+ * @brief Конструктор арены.
+ * @param initialSize Размер первого блока арены в байтах.
+ */
+QueryArena::QueryArena(std::size_t initialSize)
+    : heapCounter(std::pmr::new_delete_resource()),
+      buffer(initialSize, &heapCounter),
+      requestCounter(&buffer) {}
+
+/**
+ * @brief Копирует строку в арену.
+ * @param value Строка для копирования.
+ * @return Представление копии, действительное до уничтожения арены.
+ */
+std::string_view QueryArena::copy(std::string_view value) {
+    if (value.empty()) {
+        return std::string_view();
+    }
+    char* dest = static_cast<char*>(requestCounter.allocate(value.size(), alignof(char)));
+    std::memcpy(dest, value.data(), value.size());
+    return std::string_view(dest, value.size());
+}
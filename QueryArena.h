@@ -0,0 +1,101 @@
+/**
+ * @file QueryArena.h
+ * @brief Этот файл содержит класс QueryArena - арену памяти (PMR) для материализации результатов запросов,
+ *        и класс CountingResource для подсчета выделений памяти.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <string_view>
+
+/**
+ * @brief Статистика выделений памяти.
+ */
+struct AllocationStats {
+    std::size_t allocations = 0; ///< Количество выделений.
+    std::size_t bytes = 0;       ///< Суммарный объем выделений в байтах.
+};
+
+/**
+ * @brief Ресурс памяти, который считает выделения и передает их вышестоящему ресурсу.
+ */
+class CountingResource : public std::pmr::memory_resource {
+private:
+    std::pmr::memory_resource* upstream;
+    AllocationStats counters;
+
+public:
+    /**
+     * @brief Конструирует ресурс поверх вышестоящего ресурса.
+     * @param upstream Вышестоящий ресурс памяти.
+     */
+    explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream(upstream) {}
+
+    /**
+     * @brief Возвращает накопленную статистику.
+     */
+    AllocationStats stats() const { return counters; }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++counters.allocations;
+        counters.bytes += bytes;
+        return upstream->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        upstream->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+/**
+ * @brief Арена для результатов запросов, привязанная ко времени жизни запроса или экрана.
+ * Векторы сущностей и их строки размещаются в монотонном буфере и освобождаются одним разом
+ * при уничтожении арены. Арена не потокобезопасна.
+ */
+class QueryArena {
+private:
+    CountingResource heapCounter;                    ///< Считает обращения арены к куче.
+    std::pmr::monotonic_buffer_resource buffer;      ///< Монотонный буфер арены.
+    CountingResource requestCounter;                 ///< Считает выделения, запрошенные результатами.
+
+public:
+    /**
+     * @brief Конструирует арену.
+     * @param initialSize Размер первого блока арены в байтах.
+     */
+    explicit QueryArena(std::size_t initialSize = 16 * 1024);
+
+    QueryArena(const QueryArena&) = delete;
+    QueryArena& operator=(const QueryArena&) = delete;
+
+    /**
+     * @brief Возвращает ресурс памяти для контейнеров результатов (std::pmr::vector и т.п.).
+     */
+    std::pmr::memory_resource* resource() { return &requestCounter; }
+
+    /**
+     * @brief Копирует строку в арену.
+     * @param value Строка для копирования.
+     * @return Представление копии, действительное до уничтожения арены.
+     */
+    std::string_view copy(std::string_view value);
+
+    /**
+     * @brief Возвращает статистику выделений, запрошенных у арены
+     *        (без арены каждое из них было бы отдельным обращением к куче).
+     */
+    AllocationStats requested() const { return requestCounter.stats(); }
+
+    /**
+     * @brief Возвращает статистику реальных обращений арены к куче.
+     */
+    AllocationStats heap() const { return heapCounter.stats(); }
+};
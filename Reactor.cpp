@@ -0,0 +1,104 @@
+/**
+ * @file Reactor.cpp
+ * @brief Этот файл содержит реализацию класса Reactor (Linux: epoll).
+ */
+
+#include "Reactor.h"
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+/**
+ * @brief Конструктор. Создает экземпляр epoll.
+ * @throws std::runtime_error При ошибке epoll_create1.
+ */
+Reactor::Reactor() : epollFd(::epoll_create1(EPOLL_CLOEXEC)) {
+    if (epollFd < 0) {
+        throw std::runtime_error(std::string("epoll_create1 failed: ") + std::strerror(errno));
+    }
+}
+
+/**
+ * @brief Деструктор. Закрывает экземпляр epoll.
+ */
+Reactor::~Reactor() {
+    ::close(epollFd);
+}
+
+/**
+ * @brief Возвращает ожидание готовности дескриптора к чтению.
+ */
+Reactor::IoAwaiter Reactor::readable(int fd) {
+    return IoAwaiter{*this, fd, EPOLLIN};
+}
+
+/**
+ * @brief Возвращает ожидание готовности дескриптора к записи.
+ */
+Reactor::IoAwaiter Reactor::writable(int fd) {
+    return IoAwaiter{*this, fd, EPOLLOUT};
+}
+
+/**
+ * @brief Регистрирует сопрограмму, ожидающую события дескриптора.
+ * Первая регистрация добавляет дескриптор в epoll, последующие - перевзводят его (EPOLLONESHOT).
+ * @param fd Дескриптор.
+ * @param events События epoll (EPOLLIN, EPOLLOUT).
+ * @param handle Сопрограмма для возобновления.
+ * @throws std::logic_error Если дескриптор уже ожидается другой сопрограммой.
+ */
+void Reactor::arm(int fd, std::uint32_t events, std::coroutine_handle<> handle) {
+    if (waiters.count(fd)) {
+        throw std::logic_error("Reactor: descriptor " + std::to_string(fd) + " already has a waiter");
+    }
+    epoll_event event{};
+    event.events = events | EPOLLONESHOT;
+    event.data.fd = fd;
+    int op = registered.count(fd) ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    if (::epoll_ctl(epollFd, op, fd, &event) < 0) {
+        throw std::runtime_error(std::string("epoll_ctl failed: ") + std::strerror(errno));
+    }
+    registered.insert(fd);
+    waiters[fd] = handle;
+}
+
+/**
+ * @brief Удаляет дескриптор из реактора. Вызывается перед закрытием дескриптора.
+ * @param fd Дескриптор.
+ */
+void Reactor::forget(int fd) {
+    if (registered.erase(fd)) {
+        ::epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    }
+    waiters.erase(fd);
+}
+
+/**
+ * @brief Ждет событий и возобновляет готовые сопрограммы.
+ * Ошибки и разрыв соединения также возобновляют ожидающую сопрограмму: она узнает о них
+ * из следующей операции ввода-вывода.
+ * @param timeoutMs Максимальное время ожидания в миллисекундах (-1 - без ограничения).
+ * @return Количество возобновленных сопрограмм.
+ */
+std::size_t Reactor::poll(int timeoutMs) {
+    epoll_event events[64];
+    int ready = ::epoll_wait(epollFd, events, 64, timeoutMs);
+    if (ready < 0) {
+        if (errno == EINTR) return 0;
+        throw std::runtime_error(std::string("epoll_wait failed: ") + std::strerror(errno));
+    }
+    std::size_t resumed = 0;
+    for (int i = 0; i < ready; ++i) {
+        auto it = waiters.find(events[i].data.fd);
+        if (it == waiters.end()) {
+            continue;
+        }
+        std::coroutine_handle<> handle = it->second;
+        waiters.erase(it);
+        handle.resume();
+        ++resumed;
+    }
+    return resumed;
+}
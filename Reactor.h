@@ -0,0 +1,137 @@
+/**
+ * @file Reactor.h
+ * @brief Этот файл содержит объявление класса Reactor - однопоточного цикла событий epoll,
+ *        который возобновляет сопрограммы, ожидающие готовности дескрипторов.
+ */
+
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "Task.h"
+
+/**
+ * @brief Реактор ввода-вывода на epoll.
+ * Сопрограмма выполняет co_await reactor.readable(fd) или writable(fd) и приостанавливается;
+ * реактор возобновляет ее, когда дескриптор готов. На один дескриптор - не больше одного
+ * ожидающего (дескрипторы регистрируются с EPOLLONESHOT). Все сопрограммы реактора
+ * выполняются в потоке, вызвавшем run/runAll; класс не потокобезопасен.
+ */
+class Reactor {
+private:
+    int epollFd;
+    std::unordered_map<int, std::coroutine_handle<>> waiters;
+    std::unordered_set<int> registered;
+
+public:
+    /**
+     * @brief Ожидание готовности дескриптора.
+     */
+    struct IoAwaiter {
+        Reactor& reactor;
+        int fd;
+        std::uint32_t events;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) { reactor.arm(fd, events, handle); }
+        void await_resume() const noexcept {}
+    };
+
+    /**
+     * @brief Создает экземпляр epoll.
+     * @throws std::runtime_error При ошибке epoll_create1.
+     */
+    Reactor();
+
+    /**
+     * @brief Закрывает экземпляр epoll.
+     */
+    ~Reactor();
+
+    Reactor(const Reactor&) = delete;
+    Reactor& operator=(const Reactor&) = delete;
+
+    /**
+     * @brief Возвращает ожидание готовности дескриптора к чтению.
+     */
+    IoAwaiter readable(int fd);
+
+    /**
+     * @brief Возвращает ожидание готовности дескриптора к записи.
+     */
+    IoAwaiter writable(int fd);
+
+    /**
+     * @brief Регистрирует сопрограмму, ожидающую события дескриптора.
+     * @param fd Дескриптор.
+     * @param events События epoll (EPOLLIN, EPOLLOUT).
+     * @param handle Сопрограмма для возобновления.
+     * @throws std::logic_error Если дескриптор уже ожидается другой сопрограммой.
+     */
+    void arm(int fd, std::uint32_t events, std::coroutine_handle<> handle);
+
+    /**
+     * @brief Удаляет дескриптор из реактора. Вызывается перед закрытием дескриптора.
+     * @param fd Дескриптор.
+     */
+    void forget(int fd);
+
+    /**
+     * @brief Ждет событий и возобновляет готовые сопрограммы.
+     * @param timeoutMs Максимальное время ожидания в миллисекундах (-1 - без ограничения).
+     * @return Количество возобновленных сопрограмм.
+     */
+    std::size_t poll(int timeoutMs);
+
+    /**
+     * @brief Возвращает количество ожидающих сопрограмм.
+     */
+    std::size_t pending() const { return waiters.size(); }
+
+    /**
+     * @brief Выполняет задачу до завершения и возвращает ее результат.
+     * @param task Задача верхнего уровня.
+     * @return Результат задачи.
+     * @throws std::runtime_error Если задача приостановилась, не ожидая ни одного дескриптора.
+     */
+    template <typename T>
+    T run(Task<T> task) {
+        task.start();
+        while (!task.done()) {
+            if (waiters.empty()) {
+                throw std::runtime_error("Reactor: task is suspended without pending I/O");
+            }
+            poll(-1);
+        }
+        return task.result();
+    }
+
+    /**
+     * @brief Выполняет несколько задач конкурентно в текущем потоке до завершения всех.
+     * Результаты и исключения остаются в задачах и доступны через result().
+     * @param tasks Задачи верхнего уровня.
+     */
+    template <typename T>
+    void runAll(std::vector<Task<T>>& tasks) {
+        for (auto& task : tasks) {
+            task.start();
+        }
+        auto allDone = [&tasks] {
+            for (const auto& task : tasks) {
+                if (!task.done()) return false;
+            }
+            return true;
+        };
+        while (!allDone()) {
+            if (waiters.empty()) {
+                throw std::runtime_error("Reactor: task is suspended without pending I/O");
+            }
+            poll(-1);
+        }
+    }
+};
@@ -0,0 +1,116 @@
+/**
+ * @file ReplicaRouter.cpp
+ * @brief Этот файл содержит реализацию класса ReplicaRouter.
+ */
+
+#include "ReplicaRouter.h"
+#include <climits>
+#include <sstream>
+#include <stdexcept>
+
+/**
+ * @brief Конструктор маршрутизатора.
+ * @param endpoints Реплики.
+ * @param pinWindow Сколько после записи сеанса его чтения выполняются на основном сервере.
+ * @param retryAfter Сколько недоступная реплика исключена из выбора.
+ */
+ReplicaRouter::ReplicaRouter(std::vector<ReplicaEndpoint> endpoints, std::chrono::milliseconds pinWindow,
+                             std::chrono::milliseconds retryAfter)
+    : pinWindow(pinWindow), retryAfter(retryAfter) {
+    for (auto& endpoint : endpoints) {
+        auto replica = std::make_unique<Replica>();
+        replica->endpoint = std::move(endpoint);
+        replicas.push_back(std::move(replica));
+    }
+}
+
+/**
+ * @brief Переводит момент времени в наносекунды.
+ */
+std::int64_t ReplicaRouter::toNanos(Clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+/**
+ * @brief Выбирает доступную реплику с наименьшим числом выполняющихся запросов.
+ * Обход начинается с позиции, сдвигающейся при каждом вызове, поэтому при равных
+ * счетчиках запросы распределяются по кругу.
+ * @param now Текущее время.
+ * @return Индекс реплики или -1, если доступных реплик нет.
+ */
+int ReplicaRouter::acquire(Clock::time_point now) {
+    std::size_t count = replicas.size();
+    if (count == 0) {
+        return -1;
+    }
+    std::int64_t nowNanos = toNanos(now);
+    std::size_t start = cursor.fetch_add(1, std::memory_order_relaxed);
+    int best = -1;
+    int bestLoad = INT_MAX;
+    for (std::size_t k = 0; k < count; ++k) {
+        std::size_t index = (start + k) % count;
+        const Replica& replica = *replicas[index];
+        if (replica.downUntil.load(std::memory_order_relaxed) > nowNanos) {
+            continue;
+        }
+        int load = replica.outstanding.load(std::memory_order_relaxed);
+        if (load < bestLoad) {
+            best = static_cast<int>(index);
+            bestLoad = load;
+        }
+    }
+    if (best >= 0) {
+        replicas[best]->outstanding.fetch_add(1, std::memory_order_relaxed);
+        replicas[best]->served.fetch_add(1, std::memory_order_relaxed);
+    }
+    return best;
+}
+
+/**
+ * @brief Отмечает завершение запроса на реплике.
+ * @param index Индекс, полученный от acquire().
+ */
+void ReplicaRouter::release(int index) {
+    replicas[index]->outstanding.fetch_sub(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Исключает реплику из выбора на время retryAfter.
+ * @param index Индекс реплики.
+ * @param now Текущее время.
+ */
+void ReplicaRouter::markDown(int index, Clock::time_point now) {
+    replicas[index]->downUntil.store(toNanos(now + retryAfter), std::memory_order_relaxed);
+}
+
+/**
+ * @brief Разбирает список реплик вида "host[:port],host[:port]".
+ * @param list Список реплик.
+ * @param user Пользователь базы данных.
+ * @param password Пароль.
+ * @param database Имя базы данных.
+ * @return Параметры подключения к репликам.
+ * @throws std::invalid_argument Если порт не является числом.
+ */
+std::vector<ReplicaEndpoint> ReplicaRouter::parseEndpoints(const std::string& list, const std::string& user,
+                                                           const std::string& password, const std::string& database) {
+    std::vector<ReplicaEndpoint> endpoints;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (item.empty()) {
+            continue;
+        }
+        ReplicaEndpoint endpoint;
+        std::size_t colon = item.rfind(':');
+        endpoint.host = item.substr(0, colon);
+        if (colon != std::string::npos) {
+            endpoint.port = std::stoi(item.substr(colon + 1));
+        }
+        endpoint.user = user;
+        endpoint.password = password;
+        endpoint.database = database;
+        endpoints.push_back(std::move(endpoint));
+    }
+    return endpoints;
+}
@@ -0,0 +1,126 @@
+/**
+ * @file ReplicaRouter.h
+ * @brief Этот файл содержит объявление класса ReplicaRouter - выбора реплики базы данных
+ *        для запросов только на чтение по наименьшему числу выполняющихся запросов.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Параметры подключения к реплике.
+ */
+struct ReplicaEndpoint {
+    std::string host;
+    int port = 5432;
+    std::string user;
+    std::string password;
+    std::string database;
+};
+
+/**
+ * @brief Общий для всех соединений выбор реплики.
+ * Каждый DBManager держит собственные соединения с репликами, а маршрутизатор - общие счетчики
+ * выполняющихся на репликах запросов. Запрос получает реплику с наименьшим счетчиком (при равенстве -
+ * по кругу). Недоступная реплика исключается на время retryAfter. Потокобезопасен.
+ */
+class ReplicaRouter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    struct Replica {
+        ReplicaEndpoint endpoint;
+        std::atomic<int> outstanding{0};          ///< Выполняющиеся запросы.
+        std::atomic<std::int64_t> downUntil{0};   ///< До какого момента реплика исключена (нс steady_clock).
+        std::atomic<std::uint64_t> served{0};     ///< Всего направлено запросов.
+    };
+
+    std::vector<std::unique_ptr<Replica>> replicas;
+    std::chrono::milliseconds pinWindow;
+    std::chrono::milliseconds retryAfter;
+    std::atomic<std::size_t> cursor{0};
+
+    /**
+     * @brief Переводит момент времени в наносекунды.
+     */
+    static std::int64_t toNanos(Clock::time_point time);
+
+public:
+    /**
+     * @brief Конструирует маршрутизатор.
+     * @param endpoints Реплики.
+     * @param pinWindow Сколько после записи сеанса его чтения выполняются на основном сервере.
+     * @param retryAfter Сколько недоступная реплика исключена из выбора.
+     */
+    explicit ReplicaRouter(std::vector<ReplicaEndpoint> endpoints,
+                           std::chrono::milliseconds pinWindow = std::chrono::milliseconds(2000),
+                           std::chrono::milliseconds retryAfter = std::chrono::milliseconds(5000));
+
+    ReplicaRouter(const ReplicaRouter&) = delete;
+    ReplicaRouter& operator=(const ReplicaRouter&) = delete;
+
+    /**
+     * @brief Выбирает доступную реплику с наименьшим числом выполняющихся запросов и учитывает запрос.
+     * @param now Текущее время.
+     * @return Индекс реплики или -1, если доступных реплик нет. Для индекса не меньше нуля нужно вызвать release().
+     */
+    int acquire(Clock::time_point now = Clock::now());
+
+    /**
+     * @brief Отмечает завершение запроса на реплике.
+     * @param index Индекс, полученный от acquire().
+     */
+    void release(int index);
+
+    /**
+     * @brief Исключает реплику из выбора на время retryAfter.
+     * @param index Индекс реплики.
+     * @param now Текущее время.
+     */
+    void markDown(int index, Clock::time_point now = Clock::now());
+
+    /**
+     * @brief Возвращает количество реплик.
+     */
+    std::size_t size() const { return replicas.size(); }
+
+    /**
+     * @brief Возвращает параметры подключения к реплике.
+     */
+    const ReplicaEndpoint& endpoint(int index) const { return replicas[index]->endpoint; }
+
+    /**
+     * @brief Возвращает число выполняющихся на реплике запросов.
+     */
+    int outstanding(int index) const { return replicas[index]->outstanding.load(); }
+
+    /**
+     * @brief Возвращает, сколько всего запросов направлено на реплику.
+     */
+    std::uint64_t served(int index) const { return replicas[index]->served.load(); }
+
+    /**
+     * @brief Возвращает окно чтения своих записей.
+     */
+    std::chrono::milliseconds getPinWindow() const { return pinWindow; }
+
+    /**
+     * @brief Разбирает список реплик вида "host[:port],host[:port]".
+     * @param list Список реплик.
+     * @param user Пользователь базы данных.
+     * @param password Пароль.
+     * @param database Имя базы данных.
+     * @return Параметры подключения к репликам.
+     * @throws std::invalid_argument Если порт не является числом.
+     */
+    static std::vector<ReplicaEndpoint> parseEndpoints(const std::string& list, const std::string& user,
+                                                       const std::string& password, const std::string& database);
+};
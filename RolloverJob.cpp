@@ -0,0 +1,143 @@
+/**
+ * @file RolloverJob.cpp
+ * @brief Этот файл содержит реализацию класса RolloverJob.
+ */
+
+#include "RolloverJob.h"
+#include "PartitionManager.h"
+#include "Tracing.h"
+#include "Logger.h"
+#include <ctime>
+
+/**
+ * @brief Конструктор задачи.
+ * @param dbManager Выделенное соединение с базой данных.
+ * @param batchSize Максимальное количество строк в одном пакете.
+ * @param pause Пауза между пакетами.
+ */
+RolloverJob::RolloverJob(DBManager& dbManager, int batchSize, std::chrono::milliseconds pause)
+    : dbManager(dbManager), batchSize(batchSize > 0 ? batchSize : 500), pause(pause), stopping(false) {}
+
+/**
+ * @brief Деструктор. Останавливает фоновый поток, если он запущен.
+ */
+RolloverJob::~RolloverJob() {
+    stop();
+}
+
+/**
+ * @brief Возвращает ночные правила смены статусов на указанную дату.
+ * @param today Текущая дата в формате YYYY-MM-DD.
+ * @return Список правил.
+ */
+std::vector<StatusTransition> RolloverJob::nightlyRules(const std::string& today) {
+    return {
+        {BookingStatus::CONFIRMED, BookingStatus::COMPLETED, BookingDateField::DATE_TO, today},
+        {BookingStatus::PENDING, BookingStatus::CANCELLED, BookingDateField::DATE_FROM, today},
+    };
+}
+
+/**
+ * @brief Возвращает текущую локальную дату в формате YYYY-MM-DD.
+ */
+std::string RolloverJob::today() {
+    std::time_t now = std::time(nullptr);
+    char buffer[11];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d", std::localtime(&now));
+    return buffer;
+}
+
+/**
+ * @brief Применяет ночные правила пакетами до полной обработки и создает секции будущих месяцев.
+ * Каждое правило повторяется, пока очередной пакет не окажется неполным.
+ * @param today Дата, относительно которой применяются правила.
+ * @return Отчет о выполнении.
+ */
+RolloverReport RolloverJob::runOnce(const std::string& today) {
+    RolloverReport report;
+    report.partitionsCreated = PartitionManager(dbManager).ensurePartitions(today);
+    for (const auto& rule : nightlyRules(today)) {
+        while (true) {
+            int affected = Booking::applyTransition(dbManager, rule, batchSize);
+            ++report.batches;
+            if (rule.to == BookingStatus::COMPLETED) report.completed += affected;
+            else report.cancelled += affected;
+
+            if (affected < batchSize) {
+                break;
+            }
+            std::unique_lock<std::mutex> lock(mutex);
+            if (wakeUp.wait_for(lock, pause, [this] { return stopping; })) {
+                return report;
+            }
+        }
+    }
+    return report;
+}
+
+/**
+ * @brief Запускает фоновый поток, который выполняет задачу ежедневно в указанное локальное время.
+ * @param hour Час запуска (0-23).
+ * @param minute Минута запуска (0-59).
+ */
+void RolloverJob::start(int hour, int minute) {
+    if (worker.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = false;
+    }
+    worker = std::thread(&RolloverJob::loop, this, hour, minute);
+}
+
+/**
+ * @brief Останавливает фоновый поток и дожидается его завершения.
+ */
+void RolloverJob::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Цикл фонового потока: ждет наступления времени запуска и выполняет runOnce.
+ * @param hour Час запуска (0-23).
+ * @param minute Минута запуска (0-59).
+ */
+void RolloverJob::loop(int hour, int minute) {
+    Tracer::setThreadName("rollover");
+    while (true) {
+        std::time_t now = std::time(nullptr);
+        std::tm next = *std::localtime(&now);
+        next.tm_hour = hour;
+        next.tm_min = minute;
+        next.tm_sec = 0;
+        std::time_t runAt = std::mktime(&next);
+        if (runAt <= now) {
+            next.tm_mday += 1;
+            runAt = std::mktime(&next);
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            auto deadline = std::chrono::system_clock::from_time_t(runAt);
+            if (wakeUp.wait_until(lock, deadline, [this] { return stopping; })) {
+                return;
+            }
+        }
+
+        try {
+            RolloverReport report = runOnce(today());
+            Logger::info("Nightly rollover: {} completed, {} cancelled in {} batch(es), {} partition(s) created.",
+                         report.completed, report.cancelled, report.batches, report.partitionsCreated);
+        } catch (const std::exception& e) {
+            Logger::severe("Nightly rollover failed: {}", e.what());
+        }
+    }
+}
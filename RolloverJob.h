@@ -0,0 +1,100 @@
+/**
+ * @file RolloverJob.h
+ * @brief Этот файл содержит объявление класса RolloverJob - ночной задачи,
+ *        которая завершает прошедшие проживания, отменяет устаревшие неподтвержденные бронирования
+ *        и заранее создает месячные секции bookings.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "DBManager.h"
+#include "Booking.h"
+
+/**
+ * @brief Результат одного запуска задачи.
+ */
+struct RolloverReport {
+    int completed = 0;  ///< Количество бронирований, переведенных в completed.
+    int cancelled = 0;  ///< Количество бронирований, переведенных в cancelled.
+    int batches = 0;    ///< Количество выполненных пакетных запросов.
+    int partitionsCreated = 0; ///< Количество созданных месячных секций.
+};
+
+/**
+ * @brief Ночная задача смены статусов бронирований.
+ * Правила применяются пакетами ограниченного размера: каждый пакет - отдельный короткий
+ * запрос, поэтому задача не держит долгих блокировок на таблице bookings.
+ * Задаче нужен собственный DBManager, так как соединение используется из фонового потока.
+ */
+class RolloverJob {
+private:
+    DBManager& dbManager;
+    int batchSize;
+    std::chrono::milliseconds pause;
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    bool stopping;
+
+    /**
+     * @brief Цикл фонового потока: ждет наступления времени запуска и выполняет runOnce.
+     */
+    void loop(int hour, int minute);
+
+public:
+    /**
+     * @brief Конструирует задачу.
+     * @param dbManager Выделенное соединение с базой данных.
+     * @param batchSize Максимальное количество строк в одном пакете.
+     * @param pause Пауза между пакетами.
+     */
+    explicit RolloverJob(DBManager& dbManager, int batchSize = 500,
+                         std::chrono::milliseconds pause = std::chrono::milliseconds(50));
+
+    /**
+     * @brief Останавливает фоновый поток, если он запущен.
+     */
+    ~RolloverJob();
+
+    RolloverJob(const RolloverJob&) = delete;
+    RolloverJob& operator=(const RolloverJob&) = delete;
+
+    /**
+     * @brief Возвращает ночные правила смены статусов на указанную дату:
+     * confirmed с date_to < today -> completed, pending с date_from < today -> cancelled.
+     * @param today Текущая дата в формате YYYY-MM-DD.
+     * @return Список правил.
+     */
+    static std::vector<StatusTransition> nightlyRules(const std::string& today);
+
+    /**
+     * @brief Возвращает текущую локальную дату в формате YYYY-MM-DD.
+     */
+    static std::string today();
+
+    /**
+     * @brief Применяет ночные правила пакетами до полной обработки и создает секции будущих месяцев.
+     * @param today Дата, относительно которой применяются правила.
+     * @return Отчет о выполнении.
+     */
+    RolloverReport runOnce(const std::string& today);
+
+    /**
+     * @brief Запускает фоновый поток, который выполняет задачу ежедневно в указанное локальное время.
+     * @param hour Час запуска (0-23).
+     * @param minute Минута запуска (0-59).
+     */
+    void start(int hour = 3, int minute = 0);
+
+    /**
+     * @brief Останавливает фоновый поток и дожидается его завершения.
+     */
+    void stop();
+};
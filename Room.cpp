@@ -5,10 +5,19 @@
 
 #include "Room.h"
 #include "DBManager.h"
-#include <iostream>
+#include "Tracing.h"
+#include "Logger.h"
 #include <vector>
 #include <memory>
+#include <cstdlib>
 #include <string>
+#include <mutex>
+
+std::vector<Room> Room::indexedRooms;
+std::vector<std::chrono::steady_clock::time_point> Room::indexedAt;
+FlatHashIndex<std::size_t> Room::numberIndex;
+std::chrono::milliseconds Room::indexTtl{5000};
+std::shared_mutex Room::indexMutex;
 
 /**
  * @brief Конструктор класса Room.
@@ -32,13 +41,13 @@ int Room::getId() const { return id; }
  * @brief Возвращает номер комнаты.
  * @return Номер комнаты.
  */
-std::string Room::getNumber() const { return number; }
+const std::string& Room::getNumber() const { return number; }
 
 /**
  * @brief Возвращает тип комнаты.
  * @return Тип комнаты.
  */
-std::string Room::getType() const { return type; }
+const std::string& Room::getType() const { return type; }
 
 /**
  * @brief Возвращает цену за номер в день.
@@ -50,7 +59,7 @@ double Room::getPricePerDay() const { return pricePerDay; }
  * @brief Возвращает описание номера.
  * @return Описание номера.
  */
-std::string Room::getDescription() const { return description; }
+const std::string& Room::getDescription() const { return description; }
 
 /**
  * @brief Получает список всех номеров из базы данных.
@@ -58,10 +67,11 @@ std::string Room::getDescription() const { return description; }
  * @return Вектор объектов Room, представляющих все номера.
  */
 std::vector<Room> Room::getAllRooms(DBManager& dbManager) {
+    TraceSpan span("Room::getAllRooms", "entity");
     std::vector<Room> rooms;
     try {
         std::string query = "SELECT id, number, type, price_per_day, description FROM rooms;";
-        PGResultWrapper result = dbManager.executeQuery(query);
+        PGResultWrapper result = dbManager.executeRead(query);
 
         for (int i = 0; i < PQntuples(result.get()); i++) {
             int id = std::stoi(PQgetvalue(result.get(), i, 0));
@@ -71,14 +81,51 @@ std::vector<Room> Room::getAllRooms(DBManager& dbManager) {
             std::string description = PQgetvalue(result.get(), i, 4);
             rooms.emplace_back(id, number, type, pricePerDay, description);
         }
+        for (const auto& room : rooms) {
+            indexRoom(room);
+        }
+    } catch (const QueryTimeoutError&) {
+        throw;
     } catch (const std::exception& e) {
-        std::cerr << "Failed to get all rooms: " << e.what() << std::endl;
+        Logger::severe("Failed to get all rooms: {}", e.what());
     }
     return rooms;
 }
 
 /**
- * @brief Добавляет новый номер в базу данных.
+ * @brief Получает список всех номеров, размещая вектор и строковые поля в арене.
+ * @param dbManager Менеджер базы данных для взаимодействия с БД.
+ * @param arena Арена, в которой размещаются вектор и строки результата.
+ * @return Вектор строк номеров в памяти арены.
+ */
+std::pmr::vector<RoomRow> Room::getAllRooms(DBManager& dbManager, QueryArena& arena) {
+    TraceSpan span("Room::getAllRooms", "entity");
+    std::pmr::vector<RoomRow> rooms(arena.resource());
+    try {
+        std::string query = "SELECT id, number, type, price_per_day, description FROM rooms;";
+        PGResultWrapper result = dbManager.executeRead(query);
+
+        int numRows = PQntuples(result.get());
+        rooms.reserve(numRows);
+        for (int i = 0; i < numRows; i++) {
+            rooms.push_back(RoomRow{
+                std::atoi(PQgetvalue(result.get(), i, 0)),
+                arena.copy(std::string_view(PQgetvalue(result.get(), i, 1), PQgetlength(result.get(), i, 1))),
+                arena.copy(std::string_view(PQgetvalue(result.get(), i, 2), PQgetlength(result.get(), i, 2))),
+                std::atof(PQgetvalue(result.get(), i, 3)),
+                arena.copy(std::string_view(PQgetvalue(result.get(), i, 4), PQgetlength(result.get(), i, 4)))
+            });
+        }
+    } catch (const QueryTimeoutError&) {
+        throw;
+    } catch (const std::exception& e) {
+        Logger::severe("Failed to get all rooms: {}", e.what());
+    }
+    return rooms;
+}
+
+/**
+ * @brief Добавляет новый номер в базу данных и в индекс номеров.
  * @param dbManager Менеджер базы данных для взаимодействия с БД.
  * @param number Номер комнаты.
  * @param type Тип комнаты.
@@ -90,11 +137,17 @@ bool Room::addRoom(DBManager& dbManager, const std::string& number, const std::s
                    double pricePerDay, const std::string& description) {
     try {
         std::string query = "INSERT INTO rooms (number, type, price_per_day, description) VALUES ('" +
-                            number + "', '" + type + "', " + std::to_string(pricePerDay) + ", '" + description + "');";
-        dbManager.executeUpdate(query);
+                            number + "', '" + type + "', " + std::to_string(pricePerDay) + ", '" + description + "') RETURNING id;";
+        PGResultWrapper result = dbManager.executeQuery(query);
+        if (PQntuples(result.get()) == 1) {
+            int id = std::stoi(PQgetvalue(result.get(), 0, 0));
+            indexRoom(Room(id, number, type, pricePerDay, description));
+        }
         return true;
+    } catch (const QueryTimeoutError&) {
+        throw;
     } catch (const std::exception& e) {
-        std::cerr << "Failed to add room: " << e.what() << std::endl;
+        Logger::severe("Failed to add room: {}", e.what());
         return false;
     }
 }
@@ -106,9 +159,10 @@ bool Room::addRoom(DBManager& dbManager, const std::string& number, const std::s
  * @return Уникальный указатель на объект Room, если номер найден, иначе nullptr.
  */
 std::unique_ptr<Room> Room::findRoomById(DBManager& dbManager, int id) {
+    TraceSpan span("Room::findRoomById", "entity");
     try {
         std::string query = "SELECT number, type, price_per_day, description FROM rooms WHERE id = " + std::to_string(id) + ";";
-        PGResultWrapper result = dbManager.executeQuery(query);
+        PGResultWrapper result = dbManager.executeRead(query);
 
         if (PQntuples(result.get()) == 1) {
             std::string number = PQgetvalue(result.get(), 0, 0);
@@ -119,22 +173,35 @@ std::unique_ptr<Room> Room::findRoomById(DBManager& dbManager, int id) {
             auto room = std::make_unique<Room>(id, number, type, pricePerDay, description);
             return room; 
         }
+    } catch (const QueryTimeoutError&) {
+        throw;
     } catch (const std::exception& e) {
-        std::cerr << "Failed to find room by ID: " << e.what() << std::endl;
+        Logger::severe("Failed to find room by ID: {}", e.what());
     }
     return nullptr;
 }
 
 /**
- * @brief Находит номер по его номеру комнаты в базе данных.
+ * @brief Находит номер по его номеру комнаты.
+ * Запись индекса моложе indexTtl возвращается без обращения к базе данных. Номера меняют и в обход
+ * процесса (другие серверы, SQL), поэтому устаревшая запись не отдается: номер перечитывается из
+ * базы данных одним запросом и запись обновляется, а если номера больше нет - помечается устаревшей.
  * @param dbManager Менеджер базы данных для взаимодействия с БД.
  * @param number Номер комнаты для поиска.
  * @return Уникальный указатель на объект Room, если номер найден, иначе nullptr.
  */
 std::unique_ptr<Room> Room::findRoomByNumber(DBManager& dbManager, const std::string& number) {
+    TraceSpan span("Room::findRoomByNumber", "entity");
+    {
+        std::shared_lock<std::shared_mutex> lock(indexMutex);
+        const std::size_t* pos = numberIndex.find(number);
+        if (pos && std::chrono::steady_clock::now() - indexedAt[*pos] < indexTtl) {
+            return std::make_unique<Room>(indexedRooms[*pos]);
+        }
+    }
      try {
         std::string query = "SELECT id, type, price_per_day, description FROM rooms WHERE number = '" + number + "';";
-        PGResultWrapper result = dbManager.executeQuery(query);
+        PGResultWrapper result = dbManager.executeRead(query);
 
         if (PQntuples(result.get()) == 1) {
             int id = std::stoi(PQgetvalue(result.get(), 0, 0));
@@ -143,10 +210,143 @@ std::unique_ptr<Room> Room::findRoomByNumber(DBManager& dbManager, const std::st
             std::string description = PQgetvalue(result.get(), 0, 3);
             
             auto room = std::make_unique<Room>(id, number, type, pricePerDay, description);
+            indexRoom(*room);
             return room; 
         }
+        forgetRoom(number);
+    } catch (const QueryTimeoutError&) {
+        throw;
     } catch (const std::exception& e) {
-        std::cerr << "Failed to find room by number: " << e.what() << std::endl;
+        Logger::severe("Failed to find room by number: {}", e.what());
     }
     return nullptr;
-} 
\ No newline at end of file
+} 
+
+/**
+ * @brief Находит номера, свободные на указанные даты, одним запросом.
+ * Номер свободен, если у него нет неотмененных бронирований, пересекающихся с диапазоном дат.
+ * @param dbManager Менеджер базы данных для взаимодействия с БД.
+ * @param dateFrom Дата заезда.
+ * @param dateTo Дата выезда.
+ * @return Вектор свободных номеров.
+ */
+std::vector<Room> Room::findAvailableRooms(DBManager& dbManager, const std::string& dateFrom, const std::string& dateTo) {
+    TraceSpan span("Room::findAvailableRooms", "entity");
+    return queryAvailableRooms(dbManager, "", dateFrom, dateTo);
+}
+
+/**
+ * @brief Находит номера одного отеля, свободные на указанные даты.
+ * @param dbManager Соединение с базой данных (шардом), хранящей отель.
+ * @param propertyId Идентификатор отеля.
+ * @param dateFrom Дата заезда.
+ * @param dateTo Дата выезда.
+ * @return Вектор свободных номеров отеля.
+ */
+std::vector<Room> Room::findAvailableRooms(DBManager& dbManager, int propertyId, const std::string& dateFrom, const std::string& dateTo) {
+    TraceSpan span("Room::findAvailableRooms", "entity");
+    return queryAvailableRooms(dbManager, "r.property_id = " + std::to_string(propertyId), dateFrom, dateTo);
+}
+
+/**
+ * @brief Находит свободные на указанные даты номера, удовлетворяющие условию.
+ * @param dbManager Менеджер базы данных для взаимодействия с БД.
+ * @param condition Дополнительное условие на номер r (пустая строка - все номера).
+ * @param dateFrom Дата заезда.
+ * @param dateTo Дата выезда.
+ * @return Вектор свободных номеров.
+ */
+std::vector<Room> Room::queryAvailableRooms(DBManager& dbManager, const std::string& condition,
+                                            const std::string& dateFrom, const std::string& dateTo) {
+    std::vector<Room> rooms;
+    try {
+        std::string query = "SELECT r.id, r.number, r.type, r.price_per_day, r.description FROM rooms r "
+                            "WHERE " + (condition.empty() ? std::string() : condition + " AND ") +
+                            "NOT EXISTS (SELECT 1 FROM bookings b WHERE b.room_id = r.id AND b.status <> 'cancelled' "
+                            "AND b.date_from <= '" + dateTo + "' AND (b.date_from, b.date_to) OVERLAPS ('" + dateFrom + "', '" + dateTo + "')) ORDER BY r.id;";
+        PGResultWrapper result = dbManager.executeRead(query);
+
+        for (int i = 0; i < PQntuples(result.get()); i++) {
+            rooms.emplace_back(std::stoi(PQgetvalue(result.get(), i, 0)),
+                               PQgetvalue(result.get(), i, 1),
+                               PQgetvalue(result.get(), i, 2),
+                               std::stod(PQgetvalue(result.get(), i, 3)),
+                               PQgetvalue(result.get(), i, 4));
+        }
+    } catch (const QueryTimeoutError&) {
+        throw;
+    } catch (const std::exception& e) {
+        Logger::severe("Failed to find available rooms: {}", e.what());
+    }
+    return rooms;
+}
+
+/**
+ * @brief Добавляет номер в индекс или обновляет его запись (с текущим моментом загрузки).
+ * @param room Номер для индексации.
+ */
+void Room::indexRoom(const Room& room) {
+    auto now = std::chrono::steady_clock::now();
+    std::unique_lock<std::shared_mutex> lock(indexMutex);
+    if (const std::size_t* pos = numberIndex.find(room.number)) {
+        indexedRooms[*pos] = room;
+        indexedAt[*pos] = now;
+        return;
+    }
+    indexedRooms.push_back(room);
+    indexedAt.push_back(now);
+    numberIndex.insert(indexedRooms.back().number, indexedRooms.size() - 1);
+}
+
+/**
+ * @brief Помечает запись индекса устаревшей: номера комнаты больше нет в базе данных.
+ * Ключ остается в индексе (удаление ключей индекс не поддерживает), но запись больше не отдается;
+ * rebuildIndex убирает такие ключи.
+ * @param number Номер комнаты.
+ */
+void Room::forgetRoom(const std::string& number) {
+    std::unique_lock<std::shared_mutex> lock(indexMutex);
+    if (const std::size_t* pos = numberIndex.find(number)) {
+        indexedAt[*pos] = std::chrono::steady_clock::time_point();
+    }
+}
+
+/**
+ * @brief Задает время, в течение которого findRoomByNumber отдает номер из индекса без запроса.
+ * @param ttl Время жизни записи.
+ */
+void Room::setIndexTtl(std::chrono::milliseconds ttl) {
+    std::unique_lock<std::shared_mutex> lock(indexMutex);
+    indexTtl = ttl;
+}
+
+/**
+ * @brief Полностью перестраивает индекс номеров по данным из базы данных.
+ * @param dbManager Менеджер базы данных для взаимодействия с БД.
+ * @return Количество проиндексированных номеров.
+ */
+std::size_t Room::rebuildIndex(DBManager& dbManager) {
+    TraceSpan span("Room::rebuildIndex", "entity");
+    clearIndex();
+    getAllRooms(dbManager);
+    return indexedCount();
+}
+
+/**
+ * @brief Возвращает количество номеров в индексе.
+ * @return Количество проиндексированных номеров.
+ */
+std::size_t Room::indexedCount() {
+    std::shared_lock<std::shared_mutex> lock(indexMutex);
+    return numberIndex.size();
+}
+
+/**
+ * @brief Очищает индекс номеров.
+ */
+void Room::clearIndex() {
+    std::unique_lock<std::shared_mutex> lock(indexMutex);
+    numberIndex.clear();
+    indexedRooms.clear();
+    indexedAt.clear();
+}
@@ -5,10 +5,30 @@
 
 #pragma once
 
+#include <chrono>
 #include <string>
 #include <vector>
 #include <memory>
+#include <memory_resource>
+#include <shared_mutex>
+#include <string_view>
 #include "DBManager.h"
+#include "FlatHashIndex.h"
+#include "QueryArena.h"
+#include "Task.h"
+
+class AsyncDBManager;
+
+/**
+ * @brief Строка результата запроса номеров, размещенная в QueryArena.
+ */
+struct RoomRow {
+    int id;
+    std::string_view number;
+    std::string_view type;
+    double pricePerDay;
+    std::string_view description;
+};
 
 /**
  * @brief Класс Room представляет собой номер в отеле.
@@ -22,6 +42,35 @@ private:
     double pricePerDay;
     std::string description;
 
+    static std::vector<Room> indexedRooms;                           ///< Кэш номеров, на который ссылается индекс.
+    static std::vector<std::chrono::steady_clock::time_point> indexedAt; ///< Момент загрузки каждой записи кэша.
+    static FlatHashIndex<std::size_t> numberIndex;                   ///< Индекс: номер комнаты -> позиция в indexedRooms.
+    static std::chrono::milliseconds indexTtl;                       ///< Сколько запись кэша считается актуальной.
+    static std::shared_mutex indexMutex;                             ///< Защищает кэш, индекс и indexTtl.
+
+    /**
+     * @brief Добавляет номер в индекс или обновляет его запись (с текущим моментом загрузки).
+     * @param room Номер для индексации.
+     */
+    static void indexRoom(const Room& room);
+
+    /**
+     * @brief Помечает запись индекса устаревшей: номера комнаты больше нет в базе данных.
+     * @param number Номер комнаты.
+     */
+    static void forgetRoom(const std::string& number);
+
+    /**
+     * @brief Находит свободные на указанные даты номера, удовлетворяющие условию.
+     * @param dbManager Менеджер базы данных для взаимодействия с БД.
+     * @param condition Дополнительное условие на номер r (пустая строка - все номера).
+     * @param dateFrom Дата заезда.
+     * @param dateTo Дата выезда.
+     * @return Вектор свободных номеров.
+     */
+    static std::vector<Room> queryAvailableRooms(DBManager& dbManager, const std::string& condition,
+                                                 const std::string& dateFrom, const std::string& dateTo);
+
 public:
     /**
      * @brief Конструктор для создания нового объекта Room.
@@ -44,13 +93,13 @@ public:
      * @brief Возвращает номер комнаты.
      * @return Номер комнаты.
      */
-    std::string getNumber() const;
+    const std::string& getNumber() const;
         
     /**
      * @brief Возвращает тип комнаты.
      * @return Тип комнаты.
      */
-    std::string getType() const;
+    const std::string& getType() const;
         
     /**
      * @brief Возвращает цену за номер в день.
@@ -62,7 +111,7 @@ public:
      * @brief Возвращает описание номера.
      * @return Описание номера.
      */
-    std::string getDescription() const;
+    const std::string& getDescription() const;
     
     /**
      * @brief Получает список всех номеров из базы данных.
@@ -71,6 +120,14 @@ public:
      */
     static std::vector<Room> getAllRooms(DBManager& dbManager);
 
+    /**
+     * @brief Получает список всех номеров, размещая результат в арене.
+     * @param dbManager Менеджер базы данных для взаимодействия с БД.
+     * @param arena Арена, в которой размещаются вектор и строки результата.
+     * @return Вектор строк номеров в памяти арены.
+     */
+    static std::pmr::vector<RoomRow> getAllRooms(DBManager& dbManager, QueryArena& arena);
+
     /**
      * @brief Добавляет новый номер в базу данных.
      * @param dbManager Менеджер базы данных для взаимодействия с БД.
@@ -97,4 +154,56 @@ public:
      * @return Уникальный указатель на объект Room, если номер найден, иначе nullptr.
      */
     static std::unique_ptr<Room> findRoomByNumber(DBManager& dbManager, const std::string& number);
+
+    /**
+     * @brief Находит номера, свободные на указанные даты, одним запросом.
+     * @param dbManager Менеджер базы данных для взаимодействия с БД.
+     * @param dateFrom Дата заезда.
+     * @param dateTo Дата выезда.
+     * @return Вектор свободных номеров.
+     */
+    static std::vector<Room> findAvailableRooms(DBManager& dbManager, const std::string& dateFrom, const std::string& dateTo);
+
+    /**
+     * @brief Находит номера одного отеля, свободные на указанные даты.
+     * @param dbManager Соединение с базой данных (шардом), хранящей отель.
+     * @param propertyId Идентификатор отеля.
+     * @param dateFrom Дата заезда.
+     * @param dateTo Дата выезда.
+     * @return Вектор свободных номеров отеля.
+     */
+    static std::vector<Room> findAvailableRooms(DBManager& dbManager, int propertyId, const std::string& dateFrom, const std::string& dateTo);
+
+    /**
+     * @brief Асинхронно находит номера, свободные на указанные даты (см. findAvailableRooms).
+     * @param dbManager Асинхронное соединение с базой данных.
+     * @param dateFrom Дата заезда.
+     * @param dateTo Дата выезда.
+     * @return Задача с вектором свободных номеров.
+     */
+    static Task<std::vector<Room>> findAvailableRoomsAsync(AsyncDBManager& dbManager, std::string dateFrom, std::string dateTo);
+
+    /**
+     * @brief Полностью перестраивает индекс номеров по данным из базы данных.
+     * @param dbManager Менеджер базы данных для взаимодействия с БД.
+     * @return Количество проиндексированных номеров.
+     */
+    static std::size_t rebuildIndex(DBManager& dbManager);
+
+    /**
+     * @brief Возвращает количество номеров в индексе.
+     * @return Количество проиндексированных номеров.
+     */
+    static std::size_t indexedCount();
+
+    /**
+     * @brief Очищает индекс номеров.
+     */
+    static void clearIndex();
+
+    /**
+     * @brief Задает время, в течение которого findRoomByNumber отдает номер из индекса без запроса.
+     * @param ttl Время жизни записи (0 - каждый поиск идет в базу данных).
+     */
+    static void setIndexTtl(std::chrono::milliseconds ttl);
 }; 
\ No newline at end of file
@@ -0,0 +1,615 @@
+/**
+ * @file ServerRoutes.cpp
+ * @brief Этот файл содержит реализацию класса ServerRoutes.
+ */
+
+#include "ServerRoutes.h"
+#include "AuditJournal.h"
+#include "Bill.h"
+#include "Booking.h"
+#include "HoldManager.h"
+#include "Metrics.h"
+#include "OptimisticLock.h"
+#include "Room.h"
+#include "ServiceWriteBehind.h"
+#include "UIManager.h"
+#include <algorithm>
+#include <cctype>
+#include <map>
+#include <sstream>
+
+namespace {
+
+thread_local Deadline requestDeadline; ///< Крайний срок запроса, обрабатываемого потоком.
+
+/**
+ * @brief Собирает параметры из строки запроса и тела формы.
+ */
+std::map<std::string, std::string> requestParams(const HttpRequest& request) {
+    std::map<std::string, std::string> params = parseForm(request.query);
+    if (!request.body.empty()) {
+        for (auto& [name, value] : parseForm(request.body)) {
+            params[name] = value;
+        }
+    }
+    return params;
+}
+
+/**
+ * @brief Возвращает параметр или пустую строку.
+ */
+std::string param(const std::map<std::string, std::string>& params, const std::string& name) {
+    auto it = params.find(name);
+    return it == params.end() ? std::string() : it->second;
+}
+
+/**
+ * @brief Разбирает положительный идентификатор.
+ * @return Идентификатор или -1, если строка не является числом.
+ */
+int parseId(const std::string& text) {
+    if (text.empty() || text.size() > 9 || !std::all_of(text.begin(), text.end(), ::isdigit)) {
+        return -1;
+    }
+    return std::stoi(text);
+}
+
+/**
+ * @brief Разбирает идентификатор удержания.
+ * @return Идентификатор или 0, если строка не является числом.
+ */
+std::uint64_t parseHoldId(const std::string& text) {
+    if (text.empty() || text.size() > 19 || !std::all_of(text.begin(), text.end(), ::isdigit)) {
+        return 0;
+    }
+    return std::stoull(text);
+}
+
+/**
+ * @brief Проверяет, что логин или пароль можно безопасно подставить в запрос.
+ */
+bool isSafeCredential(const std::string& text) {
+    return !text.empty() && text.size() <= 64 &&
+           std::none_of(text.begin(), text.end(), [](char c) { return c == '\'' || c == '\\' || static_cast<unsigned char>(c) < 0x20; });
+}
+
+/**
+ * @brief Форматирует число для JSON.
+ */
+std::string jsonNumber(double value) {
+    std::ostringstream out;
+    out << value;
+    return out.str();
+}
+
+/**
+ * @brief Сериализует номер в JSON.
+ */
+std::string roomJson(const Room& room) {
+    return "{\"id\":" + std::to_string(room.getId()) +
+           ",\"number\":\"" + jsonEscape(room.getNumber()) +
+           "\",\"type\":\"" + jsonEscape(room.getType()) +
+           "\",\"price_per_day\":" + jsonNumber(room.getPricePerDay()) +
+           ",\"description\":\"" + jsonEscape(room.getDescription()) + "\"}";
+}
+
+/**
+ * @brief Сериализует бронирование в JSON.
+ */
+std::string bookingJson(const Booking& booking) {
+    return "{\"id\":" + std::to_string(booking.getId()) +
+           ",\"user_id\":" + std::to_string(booking.getUserId()) +
+           ",\"room_id\":" + std::to_string(booking.getRoomId()) +
+           ",\"date_from\":\"" + jsonEscape(booking.getDateFrom()) +
+           "\",\"date_to\":\"" + jsonEscape(booking.getDateTo()) +
+           "\",\"status\":\"" + booking.getStatusString() +
+           "\",\"version\":" + std::to_string(booking.getVersion()) + "}";
+}
+
+/**
+ * @brief Проверяет, является ли пользователь сотрудником (менеджером или администратором).
+ */
+bool isStaff(const User& user) {
+    return user.getRole() == UserRole::ADMIN || user.getRole() == UserRole::MANAGER;
+}
+
+/**
+ * @brief Создает ответ с JSON-телом.
+ */
+HttpResponse json(int status, std::string body) {
+    HttpResponse response;
+    response.status = status;
+    response.body = std::move(body);
+    return response;
+}
+
+} // namespace
+
+/**
+ * @brief Конструктор маршрутов.
+ * @param pool Пул соединений с базой данных.
+ * @param sessions Менеджер сессий.
+ * @param requestTimeout Крайний срок обработки одного запроса.
+ * @param serviceWrites Отложенная запись услуг бронирований (nullptr - каждое изменение записывается сразу).
+ * @param holds Удержания номеров (nullptr - маршруты /api/holds недоступны).
+ */
+ServerRoutes::ServerRoutes(ConnectionPool& pool, SessionManager& sessions, std::chrono::milliseconds requestTimeout,
+                           std::shared_ptr<ServiceWriteBehind> serviceWrites, std::shared_ptr<HoldManager> holds)
+    : pool(pool), sessions(sessions), requestTimeout(requestTimeout), serviceWrites(std::move(serviceWrites)),
+      holds(std::move(holds)) {}
+
+/**
+ * @brief Берет соединение из пула с крайним сроком текущего запроса.
+ * @param session Сессия, чьи недавние записи закрепляют чтения за основным сервером (nullptr - нет).
+ * @return Аренда соединения; срок запроса действует для всех его запросов к базе данных.
+ * @throw QueryTimeoutError Если свободное соединение не появилось до истечения срока.
+ */
+ConnectionPool::Lease ServerRoutes::acquire(const Session* session) {
+    ConnectionPool::Lease lease;
+    if (!requestDeadline.isBounded()) {
+        lease = pool.acquire();
+    } else {
+        lease = pool.tryAcquire(requestDeadline.remaining());
+        if (!lease) {
+            throw QueryTimeoutError("Timed out waiting for a database connection");
+        }
+        lease->setDeadline(requestDeadline);
+    }
+    if (session) {
+        std::int64_t lastWrite = session->lastWrite.load(std::memory_order_relaxed);
+        if (lastWrite != 0) {
+            lease->setLastWrite(ReplicaRouter::Clock::time_point(std::chrono::nanoseconds(lastWrite)));
+        }
+    }
+    return lease;
+}
+
+/**
+ * @brief Запоминает в сессии момент последней записи через соединение.
+ * Следующие запросы сеанса в течение окна маршрутизатора реплик читают с основного сервера,
+ * даже если получат из пула другое соединение.
+ * @param session Сессия пользователя.
+ * @param db Соединение, через которое выполнялись запросы.
+ */
+void ServerRoutes::rememberWrites(const Session& session, const DBManager& db) {
+    auto lastWrite = db.getLastWrite();
+    if (lastWrite != ReplicaRouter::Clock::time_point()) {
+        std::int64_t nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(lastWrite.time_since_epoch()).count();
+        session.lastWrite.store(nanos, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Находит сессию по заголовку Authorization.
+ * @param request HTTP-запрос.
+ * @return Сессия или nullptr.
+ */
+std::shared_ptr<Session> ServerRoutes::authorize(const HttpRequest& request) const {
+    std::string header = request.header("authorization");
+    const std::string prefix = "Bearer ";
+    if (header.compare(0, prefix.size(), prefix) != 0) {
+        return nullptr;
+    }
+    return sessions.find(header.substr(prefix.size()));
+}
+
+/**
+ * @brief Обрабатывает запрос с крайним сроком requestTimeout.
+ * @param request HTTP-запрос.
+ * @return HTTP-ответ; 504, если запрос не уложился в крайний срок.
+ */
+HttpResponse ServerRoutes::handle(const HttpRequest& request) {
+    static MetricHistogram& duration = MetricsRegistry::global().histogram(
+        "hotel_http_request_duration_seconds", "HTTP API request handling time.");
+    MetricTimer timer(duration);
+    requestDeadline = Deadline::after(requestTimeout);
+    try {
+        return route(request);
+    } catch (const QueryTimeoutError&) {
+        return HttpResponse::error(504, "Request timed out");
+    }
+}
+
+/**
+ * @brief Выбирает маршрут и проверяет сессию.
+ * @param request HTTP-запрос.
+ * @return HTTP-ответ.
+ */
+HttpResponse ServerRoutes::route(const HttpRequest& request) {
+    const std::string& path = request.path;
+    bool isGet = request.method == "GET";
+    bool isPost = request.method == "POST";
+
+    if (path == "/api/health" && isGet) {
+        return json(200, "{\"status\":\"ok\"}");
+    }
+    if (path == "/metrics" && isGet) {
+        HttpResponse response;
+        response.contentType = "text/plain; version=0.0.4";
+        response.body = MetricsRegistry::global().prometheusText();
+        return response;
+    }
+    if (path == "/api/login" && isPost) {
+        return login(request);
+    }
+    if (path == "/api/logout" && isPost) {
+        return logout(request);
+    }
+    if (path == "/api/rooms/available" && isGet) {
+        return availableRooms(request);
+    }
+
+    const std::string bookingsPrefix = "/api/bookings";
+    const std::string holdsPrefix = "/api/holds";
+    bool isHolds = holds && path.compare(0, holdsPrefix.size(), holdsPrefix) == 0;
+    if (path.compare(0, bookingsPrefix.size(), bookingsPrefix) != 0 && !isHolds) {
+        return HttpResponse::error(404, "Unknown endpoint");
+    }
+    std::shared_ptr<Session> session = authorize(request);
+    if (!session) {
+        return HttpResponse::error(401, "Login required");
+    }
+    AuditActor actor(session->user->getId());
+    if (isHolds) {
+        if (path == holdsPrefix) {
+            return isPost ? placeHold(request, *session) : HttpResponse::error(405, "Method not allowed");
+        }
+        std::string rest = path.substr(holdsPrefix.size());
+        std::size_t slash = rest.find('/', 1);
+        if (rest.size() < 2 || rest[0] != '/' || slash == std::string::npos || !isPost) {
+            return HttpResponse::error(404, "Unknown endpoint");
+        }
+        std::uint64_t holdId = parseHoldId(rest.substr(1, slash - 1));
+        std::string action = rest.substr(slash);
+        if (holdId == 0) {
+            return HttpResponse::error(400, "Invalid hold id");
+        }
+        if (action == "/confirm") return confirmHold(*session, holdId);
+        if (action == "/release") return releaseHold(*session, holdId);
+        return HttpResponse::error(404, "Unknown endpoint");
+    }
+    if (path == bookingsPrefix) {
+        if (isGet) return listBookings(*session);
+        if (isPost) return createBooking(request, *session);
+        return HttpResponse::error(405, "Method not allowed");
+    }
+
+    std::string rest = path.substr(bookingsPrefix.size());
+    std::size_t slash = rest.find('/', 1);
+    if (rest.size() < 2 || rest[0] != '/' || slash == std::string::npos) {
+        return HttpResponse::error(404, "Unknown endpoint");
+    }
+    int bookingId = parseId(rest.substr(1, slash - 1));
+    std::string action = rest.substr(slash);
+    if (bookingId < 0) {
+        return HttpResponse::error(400, "Invalid booking id");
+    }
+    if (action == "/bill" && isGet) {
+        return bill(*session, bookingId);
+    }
+    if (action == "/status" && isPost) {
+        return updateStatus(request, *session, bookingId);
+    }
+    if (action == "/services" && isPost) {
+        return changeService(request, *session, bookingId);
+    }
+    return HttpResponse::error(404, "Unknown endpoint");
+}
+
+/**
+ * @brief Вход пользователя: создает сессию и возвращает ее токен.
+ * @param request HTTP-запрос с параметрами login и password.
+ * @return Ответ с токеном или 401.
+ */
+HttpResponse ServerRoutes::login(const HttpRequest& request) {
+    auto params = requestParams(request);
+    std::string login = param(params, "login");
+    std::string password = param(params, "password");
+    if (!isSafeCredential(login) || !isSafeCredential(password)) {
+        return HttpResponse::error(400, "Invalid login or password format");
+    }
+
+    std::unique_ptr<User> user;
+    {
+        ConnectionPool::Lease db = acquire();
+        user = User::authenticate(*db, login, password);
+    }
+    if (!user) {
+        return HttpResponse::error(401, "Invalid login or password");
+    }
+    std::string role = user->getRoleString();
+    std::string token = sessions.createSession(std::move(user));
+    return json(200, "{\"token\":\"" + token + "\",\"role\":\"" + jsonEscape(role) + "\"}");
+}
+
+/**
+ * @brief Выход пользователя: завершает сессию.
+ * @param request HTTP-запрос с заголовком Authorization.
+ * @return Ответ 200.
+ */
+HttpResponse ServerRoutes::logout(const HttpRequest& request) {
+    std::shared_ptr<Session> session = authorize(request);
+    if (session) {
+        sessions.destroy(session->token);
+    }
+    return json(200, "{\"status\":\"ok\"}");
+}
+
+/**
+ * @brief Список номеров, свободных на указанные даты.
+ * @param request HTTP-запрос с параметрами from и to.
+ * @return Ответ с массивом номеров.
+ */
+HttpResponse ServerRoutes::availableRooms(const HttpRequest& request) {
+    auto params = requestParams(request);
+    std::string from = param(params, "from");
+    std::string to = param(params, "to");
+    if (!isValidDate(from) || !isValidDate(to) || !(from < to)) {
+        return HttpResponse::error(400, "Parameters from and to must be dates YYYY-MM-DD with from < to");
+    }
+
+    std::vector<Room> rooms;
+    {
+        ConnectionPool::Lease db = acquire();
+        rooms = Room::findAvailableRooms(*db, from, to);
+    }
+    if (holds) {
+        std::shared_ptr<Session> session = authorize(request);
+        int userId = session ? session->user->getId() : 0;
+        std::erase_if(rooms, [&](const Room& room) { return holds->isHeld(room.getId(), from, to, userId); });
+    }
+    std::string body = "[";
+    for (std::size_t i = 0; i < rooms.size(); ++i) {
+        if (i) body += ",";
+        body += roomJson(rooms[i]);
+    }
+    body += "]";
+    return json(200, std::move(body));
+}
+
+/**
+ * @brief Список бронирований: клиенту - свои, сотрудникам - все.
+ * @param session Сессия пользователя.
+ * @return Ответ с массивом бронирований.
+ */
+HttpResponse ServerRoutes::listBookings(const Session& session) {
+    std::vector<Booking> bookings;
+    {
+        ConnectionPool::Lease db = acquire(&session);
+        bookings = isStaff(*session.user) ? Booking::getAllBookings(*db)
+                                          : Booking::findBookingsByUserId(*db, session.user->getId());
+    }
+    std::string body = "[";
+    for (std::size_t i = 0; i < bookings.size(); ++i) {
+        if (i) body += ",";
+        body += bookingJson(bookings[i]);
+    }
+    body += "]";
+    return json(200, std::move(body));
+}
+
+/**
+ * @brief Создает бронирование для пользователя сессии.
+ * @param request HTTP-запрос с параметрами room_id, date_from, date_to.
+ * @param session Сессия пользователя.
+ * @return Ответ 201 с бронированием, 404 для неизвестного номера или 409, если номер занят.
+ */
+HttpResponse ServerRoutes::createBooking(const HttpRequest& request, const Session& session) {
+    auto params = requestParams(request);
+    int roomId = parseId(param(params, "room_id"));
+    std::string dateFrom = param(params, "date_from");
+    std::string dateTo = param(params, "date_to");
+    if (roomId < 0 || !isValidDate(dateFrom) || !isValidDate(dateTo) || !(dateFrom < dateTo)) {
+        return HttpResponse::error(400, "Parameters room_id, date_from and date_to are required, date_from < date_to");
+    }
+
+    if (holds && holds->isHeld(roomId, dateFrom, dateTo, session.user->getId())) {
+        return HttpResponse::error(409, "Room is held by another guest for the selected dates");
+    }
+    ConnectionPool::Lease db = acquire(&session);
+    if (!Room::findRoomById(*db, roomId)) {
+        return HttpResponse::error(404, "Room not found");
+    }
+    auto booking = Booking::createBooking(*db, session.user->getId(), roomId, dateFrom, dateTo);
+    rememberWrites(session, *db);
+    if (!booking) {
+        return HttpResponse::error(409, "Room is not available for the selected dates");
+    }
+    return json(201, bookingJson(*booking));
+}
+
+/**
+ * @brief Счет за бронирование. Клиент видит только свои счета.
+ * @param session Сессия пользователя.
+ * @param bookingId Идентификатор бронирования.
+ * @return Ответ со счетом или 404.
+ */
+HttpResponse ServerRoutes::bill(const Session& session, int bookingId) {
+    std::unique_ptr<Bill> result;
+    {
+        ConnectionPool::Lease db = acquire(&session);
+        result = Bill::forBooking(*db, bookingId, Deadline(), serviceWrites.get());
+    }
+    if (!result || (!isStaff(*session.user) && result->getUserId() != session.user->getId())) {
+        return HttpResponse::error(404, "Booking not found");
+    }
+
+    std::string body = "{\"booking_id\":" + std::to_string(result->getBookingId()) +
+                       ",\"room\":\"" + jsonEscape(result->getRoomNumber()) +
+                       "\",\"room_type\":\"" + jsonEscape(result->getRoomType()) +
+                       "\",\"days\":" + std::to_string(result->getDays()) +
+                       ",\"room_cost\":" + jsonNumber(result->getRoomCost()) + ",\"services\":[";
+    const auto& lines = result->getLines();
+    for (std::size_t i = 0; i < lines.size(); ++i) {
+        if (i) body += ",";
+        body += "{\"service_id\":" + std::to_string(lines[i].serviceId) +
+                ",\"name\":\"" + jsonEscape(lines[i].name) +
+                "\",\"quantity\":" + std::to_string(lines[i].quantity) +
+                ",\"cost\":" + jsonNumber(lines[i].cost) + "}";
+    }
+    body += "],\"total\":" + jsonNumber(result->getTotal()) + "}";
+    return json(200, std::move(body));
+}
+
+/**
+ * @brief Меняет статус бронирования с проверкой версии.
+ * Сотрудники могут установить любой статус, клиент - только отменить свое бронирование.
+ * Статус выбирается по увиденному состоянию бронирования, поэтому изменение не повторяется:
+ * если версия не совпала с переданной version (или изменилась между чтением и записью), клиент
+ * получает 409 и должен перечитать бронирование.
+ * @param request HTTP-запрос с параметрами status (pending, confirmed, cancelled, completed) и
+ *        version (версия, которую видел клиент; без нее проверяется версия, прочитанная сервером).
+ * @param session Сессия пользователя.
+ * @param bookingId Идентификатор бронирования.
+ * @return Ответ с результатом изменения.
+ */
+HttpResponse ServerRoutes::updateStatus(const HttpRequest& request, const Session& session, int bookingId) {
+    auto params = requestParams(request);
+    std::string statusName = param(params, "status");
+    BookingStatus newStatus;
+    if (statusName == "pending") newStatus = BookingStatus::PENDING;
+    else if (statusName == "confirmed") newStatus = BookingStatus::CONFIRMED;
+    else if (statusName == "cancelled") newStatus = BookingStatus::CANCELLED;
+    else if (statusName == "completed") newStatus = BookingStatus::COMPLETED;
+    else return HttpResponse::error(400, "Unknown status");
+
+    bool staff = isStaff(*session.user);
+    if (!staff && newStatus != BookingStatus::CANCELLED) {
+        return HttpResponse::error(403, "Only staff can set this status");
+    }
+
+    std::string versionText = param(params, "version");
+    int expectedVersion = versionText.empty() ? -1 : parseId(versionText);
+    if (!versionText.empty() && expectedVersion < 0) {
+        return HttpResponse::error(400, "Invalid version");
+    }
+
+    ConnectionPool::Lease db = acquire(&session);
+    DBManager::PrimaryReads primary(*db); // версия сравнивается с основным сервером
+    auto current = Booking::findBookingById(*db, bookingId);
+    if (!current || (!staff && current->getUserId() != session.user->getId())) {
+        return HttpResponse::error(404, "Booking not found");
+    }
+    UpdateResult result = expectedVersion >= 0 && current->getVersion() != expectedVersion
+                              ? UpdateResult::CONFLICT
+                              : current->updateStatus(*db, newStatus);
+    rememberWrites(session, *db);
+
+    if (result == UpdateResult::NOT_FOUND) {
+        return HttpResponse::error(404, "Booking not found");
+    }
+    if (result == UpdateResult::CONFLICT) {
+        return HttpResponse::error(409, "Booking was modified concurrently, reload it and retry");
+    }
+    return json(200, "{\"id\":" + std::to_string(bookingId) + ",\"status\":\"" + statusName +
+                         "\",\"version\":" + std::to_string(current->getVersion()) + "}");
+}
+
+/**
+ * @brief Добавляет услугу к бронированию или удаляет ее. Доступно только сотрудникам
+ *        (кассовые системы ресторана и спа работают под учетной записью сотрудника).
+ * С отложенной записью изменение попадает в журнал и подтверждается ответом 202; счет
+ * сразу учитывает его. Без нее изменение записывается в базу данных с повтором при конфликте версий.
+ * @param request HTTP-запрос с параметрами service_id и quantity (0 - удалить услугу).
+ * @param session Сессия пользователя.
+ * @param bookingId Идентификатор бронирования.
+ * @return Ответ 200 или 202 либо 404, если бронирование не найдено.
+ */
+HttpResponse ServerRoutes::changeService(const HttpRequest& request, const Session& session, int bookingId) {
+    if (!isStaff(*session.user)) {
+        return HttpResponse::error(403, "Only staff can change booking services");
+    }
+    auto params = requestParams(request);
+    int serviceId = parseId(param(params, "service_id"));
+    int quantity = parseId(param(params, "quantity"));
+    if (serviceId < 0 || quantity < 0) {
+        return HttpResponse::error(400, "Parameters service_id and quantity are required, quantity >= 0");
+    }
+
+    ConnectionPool::Lease db = acquire(&session);
+    if (serviceWrites) {
+        auto booking = Booking::findBookingById(*db, bookingId);
+        if (!booking) {
+            return HttpResponse::error(404, "Booking not found");
+        }
+        if (quantity > 0) {
+            serviceWrites->addService(*booking, serviceId, quantity);
+        } else {
+            serviceWrites->removeService(*booking, serviceId);
+        }
+        return json(202, "{\"id\":" + std::to_string(bookingId) + ",\"status\":\"queued\"}");
+    }
+
+    UpdateResult result = retryOnConflict([&] {
+        auto current = Booking::findBookingById(*db, bookingId);
+        if (!current) {
+            return UpdateResult::NOT_FOUND;
+        }
+        return quantity > 0 ? current->addService(*db, serviceId, quantity) : current->removeService(*db, serviceId);
+    });
+    rememberWrites(session, *db);
+    if (result == UpdateResult::NOT_FOUND) {
+        return HttpResponse::error(404, "Booking not found");
+    }
+    if (result == UpdateResult::CONFLICT) {
+        return HttpResponse::error(409, "Booking was modified concurrently, please retry");
+    }
+    return json(200, "{\"id\":" + std::to_string(bookingId) + ",\"status\":\"ok\"}");
+}
+
+/**
+ * @brief Удерживает номер за пользователем сессии на время оформления.
+ * База данных не используется: номер, уже занятый в базе данных, обнаружится при подтверждении.
+ * @param request HTTP-запрос с параметрами room_id, date_from, date_to.
+ * @param session Сессия пользователя.
+ * @return Ответ 201 с удержанием или 409, если номер удерживает другой пользователь.
+ */
+HttpResponse ServerRoutes::placeHold(const HttpRequest& request, const Session& session) {
+    auto params = requestParams(request);
+    int roomId = parseId(param(params, "room_id"));
+    std::string dateFrom = param(params, "date_from");
+    std::string dateTo = param(params, "date_to");
+    if (roomId < 0 || !isValidDate(dateFrom) || !isValidDate(dateTo) || !(dateFrom < dateTo)) {
+        return HttpResponse::error(400, "Parameters room_id, date_from and date_to are required, date_from < date_to");
+    }
+    std::optional<Hold> hold = holds->place(roomId, session.user->getId(), dateFrom, dateTo);
+    if (!hold) {
+        return HttpResponse::error(409, "Room is held by another guest for the selected dates");
+    }
+    return json(201, "{\"hold_id\":" + std::to_string(hold->id) + ",\"room_id\":" + std::to_string(roomId) +
+                     ",\"date_from\":\"" + dateFrom + "\",\"date_to\":\"" + dateTo +
+                     "\",\"expires_in\":" + std::to_string(holds->getTtl().count()) + "}");
+}
+
+/**
+ * @brief Создает бронирование по удержанию.
+ * @param session Сессия пользователя (владельца удержания).
+ * @param holdId Идентификатор удержания.
+ * @return Ответ 201 с бронированием, 404, если удержание не найдено или истекло, или 409, если номер занят.
+ */
+HttpResponse ServerRoutes::confirmHold(const Session& session, std::uint64_t holdId) {
+    std::optional<Hold> hold = holds->find(holdId);
+    if (!hold || hold->userId != session.user->getId()) {
+        return HttpResponse::error(404, "Hold not found or expired");
+    }
+    ConnectionPool::Lease db = acquire(&session);
+    auto booking = holds->confirm(*db, holdId, session.user->getId());
+    rememberWrites(session, *db);
+    if (!booking) {
+        return HttpResponse::error(409, "Room is not available for the selected dates");
+    }
+    return json(201, bookingJson(*booking));
+}
+
+/**
+ * @brief Снимает удержание пользователя сессии.
+ * @param session Сессия пользователя.
+ * @param holdId Идентификатор удержания.
+ * @return Ответ 200 или 404.
+ */
+HttpResponse ServerRoutes::releaseHold(const Session& session, std::uint64_t holdId) {
+    if (!holds->release(holdId, session.user->getId())) {
+        return HttpResponse::error(404, "Hold not found");
+    }
+    return json(200, "{\"status\":\"ok\"}");
+}
@@ -0,0 +1,154 @@
+/**
+ * @file ServerRoutes.h
+ * @brief Этот файл содержит объявление класса ServerRoutes - HTTP/JSON интерфейса к операциям системы
+ *        (поиск номеров, удержание и бронирование, просмотр бронирований, счет, смена статуса).
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "ConnectionPool.h"
+#include "Deadline.h"
+#include "HttpMessage.h"
+#include "SessionManager.h"
+
+class HoldManager;
+class ServiceWriteBehind;
+
+/**
+ * @brief Маршруты HTTP API сервера.
+ *
+ * POST /api/login (login, password)            -> {"token", "role"}
+ * POST /api/logout
+ * GET  /api/health
+ * GET  /metrics                                 (метрики в текстовом формате Prometheus)
+ * GET  /api/rooms/available?from=&to=
+ * GET  /api/bookings                            (свои; менеджер и администратор - все)
+ * POST /api/bookings (room_id, date_from, date_to)
+ * GET  /api/bookings/{id}/bill
+ * POST /api/bookings/{id}/status (status, version) (клиент может только отменить свое бронирование;
+ *                                               409, если версия не совпала)
+ * POST /api/bookings/{id}/services (service_id, quantity) (сотрудники; quantity=0 удаляет услугу)
+ * POST /api/holds (room_id, date_from, date_to) -> {"hold_id", "expires_in"} (удержание номера)
+ * POST /api/holds/{id}/confirm                  (бронирование по удержанию)
+ * POST /api/holds/{id}/release
+ *
+ * Параметры передаются в строке запроса или телом application/x-www-form-urlencoded,
+ * токен сессии - в заголовке "Authorization: Bearer <token>". Каждый запрос берет
+ * соединение из пула только на время обращения к базе данных.
+ *
+ * У каждого запроса есть крайний срок: ожидание соединения и все запросы к базе данных
+ * должны уложиться в него, иначе клиент получает 504.
+ */
+class ServerRoutes {
+private:
+    ConnectionPool& pool;
+    SessionManager& sessions;
+    std::chrono::milliseconds requestTimeout;
+    std::shared_ptr<ServiceWriteBehind> serviceWrites;  ///< Отложенная запись услуг (nullptr - запись сразу).
+    std::shared_ptr<HoldManager> holds;                 ///< Удержания номеров (nullptr - удержаний нет).
+
+    /**
+     * @brief Берет соединение из пула с крайним сроком текущего запроса.
+     * @param session Сессия, чьи недавние записи закрепляют чтения за основным сервером (nullptr - нет).
+     * @return Аренда соединения; срок запроса действует для всех его запросов к базе данных.
+     * @throw QueryTimeoutError Если свободное соединение не появилось до истечения срока.
+     */
+    ConnectionPool::Lease acquire(const Session* session = nullptr);
+
+    /**
+     * @brief Запоминает в сессии момент последней записи через соединение (чтение своих записей).
+     */
+    static void rememberWrites(const Session& session, const DBManager& db);
+
+    /**
+     * @brief Выбирает маршрут и проверяет сессию.
+     */
+    HttpResponse route(const HttpRequest& request);
+
+    /**
+     * @brief Находит сессию по заголовку Authorization.
+     * @param request HTTP-запрос.
+     * @return Сессия или nullptr.
+     */
+    std::shared_ptr<Session> authorize(const HttpRequest& request) const;
+
+    /**
+     * @brief Вход пользователя: создает сессию и возвращает ее токен.
+     */
+    HttpResponse login(const HttpRequest& request);
+
+    /**
+     * @brief Выход пользователя: завершает сессию.
+     */
+    HttpResponse logout(const HttpRequest& request);
+
+    /**
+     * @brief Список номеров, свободных на указанные даты.
+     */
+    HttpResponse availableRooms(const HttpRequest& request);
+
+    /**
+     * @brief Список бронирований: клиенту - свои, сотрудникам - все.
+     */
+    HttpResponse listBookings(const Session& session);
+
+    /**
+     * @brief Создает бронирование для пользователя сессии.
+     */
+    HttpResponse createBooking(const HttpRequest& request, const Session& session);
+
+    /**
+     * @brief Счет за бронирование.
+     */
+    HttpResponse bill(const Session& session, int bookingId);
+
+    /**
+     * @brief Меняет статус бронирования.
+     */
+    HttpResponse updateStatus(const HttpRequest& request, const Session& session, int bookingId);
+
+    /**
+     * @brief Добавляет услугу к бронированию или удаляет ее (начисления кассовых систем).
+     */
+    HttpResponse changeService(const HttpRequest& request, const Session& session, int bookingId);
+
+    /**
+     * @brief Удерживает номер за пользователем сессии на время оформления.
+     */
+    HttpResponse placeHold(const HttpRequest& request, const Session& session);
+
+    /**
+     * @brief Создает бронирование по удержанию.
+     */
+    HttpResponse confirmHold(const Session& session, std::uint64_t holdId);
+
+    /**
+     * @brief Снимает удержание.
+     */
+    HttpResponse releaseHold(const Session& session, std::uint64_t holdId);
+
+public:
+    /**
+     * @brief Конструирует маршруты.
+     * @param pool Пул соединений с базой данных.
+     * @param sessions Менеджер сессий.
+     * @param requestTimeout Крайний срок обработки одного запроса.
+     * @param serviceWrites Отложенная запись услуг бронирований (nullptr - каждое изменение записывается сразу).
+     * @param holds Удержания номеров (nullptr - маршруты /api/holds недоступны).
+     */
+    ServerRoutes(ConnectionPool& pool, SessionManager& sessions,
+                 std::chrono::milliseconds requestTimeout = std::chrono::milliseconds(2000),
+                 std::shared_ptr<ServiceWriteBehind> serviceWrites = nullptr,
+                 std::shared_ptr<HoldManager> holds = nullptr);
+
+    /**
+     * @brief Обрабатывает запрос. Потокобезопасен.
+     * @param request HTTP-запрос.
+     * @return HTTP-ответ; 504, если запрос не уложился в крайний срок.
+     */
+    HttpResponse handle(const HttpRequest& request);
+};
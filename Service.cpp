@@ -4,7 +4,8 @@
  */
 #include "Service.h"
 #include "DBManager.h"
-#include <iostream>
+#include "Tracing.h"
+#include "Logger.h"
 #include <vector>
 #include <memory>
 #include <string>
@@ -28,7 +29,7 @@ int Service::getId() const { return id; }
  * @brief Возвращает название услуги.
  * @return Название услуги.
  */
-std::string Service::getName() const { return name; }
+const std::string& Service::getName() const { return name; }
 
 /**
  * @brief Возвращает цену услуги.
@@ -42,10 +43,11 @@ double Service::getPrice() const { return price; }
  * @return Вектор объектов Service, представляющих все услуги.
  */
 std::vector<Service> Service::getAllServices(DBManager& dbManager) {
+    TraceSpan span("Service::getAllServices", "entity");
     std::vector<Service> services;
     try {
         std::string query = "SELECT id, name, price FROM services;";
-        PGResultWrapper result = dbManager.executeQuery(query);
+        PGResultWrapper result = dbManager.executeRead(query);
 
         for (int i = 0; i < PQntuples(result.get()); i++) {
             int id = std::stoi(PQgetvalue(result.get(), i, 0));
@@ -53,8 +55,10 @@ std::vector<Service> Service::getAllServices(DBManager& dbManager) {
             double price = std::stod(PQgetvalue(result.get(), i, 2));
             services.emplace_back(id, name, price);
         }
+    } catch (const QueryTimeoutError&) {
+        throw;
     } catch (const std::exception& e) {
-        std::cerr << "Failed to get all services: " << e.what() << std::endl;
+        Logger::severe("Failed to get all services: {}", e.what());
     }
     return services;
 }
@@ -67,13 +71,16 @@ std::vector<Service> Service::getAllServices(DBManager& dbManager) {
  * @return True, если услуга успешно добавлена, иначе false.
  */
 bool Service::addService(DBManager& dbManager, const std::string& name, double price) {
+    TraceSpan span("Service::addService", "entity");
     try {
         std::string query = "INSERT INTO services (name, price) VALUES ('" +
                             name + "', " + std::to_string(price) + ");";
         dbManager.executeUpdate(query);
         return true;
+    } catch (const QueryTimeoutError&) {
+        throw;
     } catch (const std::exception& e) {
-        std::cerr << "Failed to add service: " << e.what() << std::endl;
+        Logger::severe("Failed to add service: {}", e.what());
         return false;
     }
 }
@@ -85,9 +92,10 @@ bool Service::addService(DBManager& dbManager, const std::string& name, double p
  * @return Уникальный указатель на объект Service, если услуга найдена, иначе nullptr.
  */
 std::unique_ptr<Service> Service::findServiceById(DBManager& dbManager, int id) {
+    TraceSpan span("Service::findServiceById", "entity");
     try {
         std::string query = "SELECT name, price FROM services WHERE id = " + std::to_string(id) + ";";
-        PGResultWrapper result = dbManager.executeQuery(query);
+        PGResultWrapper result = dbManager.executeRead(query);
 
         if (PQntuples(result.get()) == 1) {
             std::string name = PQgetvalue(result.get(), 0, 0);
@@ -96,8 +104,10 @@ std::unique_ptr<Service> Service::findServiceById(DBManager& dbManager, int id)
             auto service = std::make_unique<Service>(id, name, price);
             return service;
         }
+    } catch (const QueryTimeoutError&) {
+        throw;
     } catch (const std::exception& e) {
-        std::cerr << "Failed to find service by ID: " << e.what() << std::endl;
+        Logger::severe("Failed to find service by ID: {}", e.what());
     }
     return nullptr;
 } 
\ No newline at end of file
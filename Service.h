@@ -39,7 +39,7 @@ public:
      * @brief Возвращает название услуги.
      * @return Название услуги.
      */
-    std::string getName() const;
+    const std::string& getName() const;
 
     /**
      * @brief Возвращает цену услуги.
@@ -0,0 +1,632 @@
+/**
+ * @file ServiceWriteBehind.cpp
+ * @brief Этот файл содержит реализацию отложенной записи услуг бронирований.
+ */
+
+#include "ServiceWriteBehind.h"
+#include "Booking.h"
+#include "DBManager.h"
+#include "Logger.h"
+#include "Metrics.h"
+#include "Tracing.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+/**
+ * @brief Метрики отложенной записи услуг.
+ */
+struct WriteBehindMetrics {
+    MetricCounter& changes;
+    MetricCounter& batches;
+    MetricCounter& failures;
+    MetricGauge& pending;
+};
+
+/**
+ * @brief Возвращает метрики отложенной записи (регистрирует их при первом обращении).
+ */
+WriteBehindMetrics& writeBehindMetrics() {
+    MetricsRegistry& registry = MetricsRegistry::global();
+    static WriteBehindMetrics metrics{
+        registry.counter("hotel_service_writes_total", "Booking service changes accepted by the write-behind queue."),
+        registry.counter("hotel_service_write_batches_total", "Write-behind batches committed to the database."),
+        registry.counter("hotel_service_write_failures_total", "Write-behind batches that failed and will be retried."),
+        registry.gauge("hotel_service_writes_pending", "Coalesced service lines not yet written to the database."),
+    };
+    return metrics;
+}
+
+/**
+ * @brief Сбрасывает буферы файла на диск.
+ */
+bool syncFile(std::FILE* file) {
+    if (std::fflush(file) != 0) {
+        return false;
+    }
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+/**
+ * @brief Возвращает копию дескриптора файла (-1 при ошибке): по ней файл сбрасывается на диск,
+ *        даже если его тем временем закрыли.
+ */
+int duplicateHandle(std::FILE* file) {
+    if (!file) {
+        return -1;
+    }
+#ifdef _WIN32
+    return _dup(_fileno(file));
+#else
+    return dup(fileno(file));
+#endif
+}
+
+/**
+ * @brief Сбрасывает на диск файл копии дескриптора и закрывает ее.
+ */
+bool syncHandle(int fd) {
+    if (fd < 0) {
+        return false;
+    }
+#ifdef _WIN32
+    bool synced = _commit(fd) == 0;
+    _close(fd);
+#else
+    bool synced = fsync(fd) == 0;
+    close(fd);
+#endif
+    return synced;
+}
+
+/**
+ * @brief Считает строки услуг во всех бронированиях.
+ */
+std::size_t lineCount(const ServiceWriteBehind::Changes& changes) {
+    std::size_t lines = 0;
+    for (const auto& [key, services] : changes) {
+        lines += services.size();
+    }
+    return lines;
+}
+
+/**
+ * @brief Читает журнал и объединяет его изменения.
+ * Неполная последняя строка (запись прервана аварийным завершением) пропускается.
+ * @param path Путь к журналу.
+ * @param changes Изменения, к которым добавляются прочитанные.
+ * @return Номер пачки из заголовка или 0, если файла нет или заголовка нет.
+ */
+std::uint64_t readJournal(const std::string& path, ServiceWriteBehind::Changes& changes) {
+    std::ifstream in(path);
+    std::uint64_t batch = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        char kind = 0;
+        fields >> kind;
+        if (kind == 'B') {
+            fields >> batch;
+            continue;
+        }
+        int bookingId = 0, serviceId = 0, quantity = 0;
+        std::string dateFrom;
+        fields >> bookingId >> dateFrom >> serviceId;
+        ServiceLineChange change{kind == 'R', 0};
+        if (kind == 'A') {
+            fields >> quantity;
+            change.quantity = quantity;
+        }
+        if (!fields || (kind != 'A' && kind != 'R')) {
+            Logger::warning("Skipping malformed service journal line in {}: {}", path, line);
+            continue;
+        }
+        auto& services = changes[{bookingId, dateFrom}];
+        auto [entry, inserted] = services.try_emplace(serviceId, change);
+        if (!inserted) {
+            ServiceWriteBehind::coalesce(entry->second, change);
+        }
+    }
+    return batch;
+}
+
+/**
+ * @brief Возвращает строки журнала для изменения: замена - строка R, добавление - строка A
+ *        (замена с количеством - обе).
+ */
+std::string journalLines(int bookingId, const std::string& dateFrom, int serviceId, const ServiceLineChange& change) {
+    std::string prefix = std::to_string(bookingId) + " " + dateFrom + " " + std::to_string(serviceId);
+    std::string lines = change.replace ? "R " + prefix + "\n" : "";
+    if (change.quantity > 0) {
+        lines += "A " + prefix + " " + std::to_string(change.quantity) + "\n";
+    }
+    return lines;
+}
+
+/**
+ * @brief Начальный номер пачки для нового журнала: микросекунды от эпохи Unix, поэтому номера
+ *        растут и после удаления файлов журнала.
+ */
+std::uint64_t freshBatch() {
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
+/**
+ * @brief Конструирует отложенную запись и восстанавливает изменения из журнала.
+ * Неподтвержденная пачка <journalPath>.flushing будет отправлена первой со своим номером.
+ * @param writerConnection Фабрика соединения записи.
+ * @param config Параметры.
+ * @throw std::runtime_error Если журнал не удалось открыть.
+ */
+ServiceWriteBehind::ServiceWriteBehind(Factory writerConnection, ServiceWriteBehindConfig config)
+    : connect(std::move(writerConnection)), config(std::move(config)) {
+    inFlightBatch = readJournal(flushingPath(), inFlight);
+    journalBatch = readJournal(this->config.journalPath, pending);
+    pendingLines = lineCount(pending);
+    oldestPending = std::chrono::steady_clock::now();
+
+    // Журнал переписывается заново: без неполной последней строки и с заголовком, даже если его не было.
+    std::lock_guard<std::mutex> lock(mutex);
+    openJournal(journalBatch != 0 ? journalBatch : std::max(freshBatch(), inFlightBatch + 1));
+    for (const auto& [key, services] : pending) {
+        for (const auto& [serviceId, change] : services) {
+            append(journalLines(key.first, key.second, serviceId, change));
+        }
+    }
+    if (this->config.syncJournal && !syncFile(journal)) {
+        throw std::runtime_error("Failed to sync service journal " + this->config.journalPath);
+    }
+    writeBehindMetrics().pending.add(static_cast<double>(pendingLines + lineCount(inFlight)));
+    worker = std::thread(&ServiceWriteBehind::loop, this);
+}
+
+/**
+ * @brief Записывает накопленное и останавливает фоновый поток.
+ */
+ServiceWriteBehind::~ServiceWriteBehind() {
+    stop();
+    if (journal) {
+        std::fclose(journal);
+    }
+}
+
+/**
+ * @brief Открывает новый журнал с заголовком номера пачки.
+ * @param batch Номер пачки.
+ */
+void ServiceWriteBehind::openJournal(std::uint64_t batch) {
+    if (journal) {
+        std::fclose(journal);
+    }
+    journal = std::fopen(config.journalPath.c_str(), "wb");
+    if (!journal) {
+        throw std::runtime_error("Failed to open service journal " + config.journalPath);
+    }
+    journalBatch = batch;
+    append("B " + std::to_string(batch) + "\n");
+    if (config.syncJournal && !syncFile(journal)) {
+        throw std::runtime_error("Failed to sync service journal " + config.journalPath);
+    }
+}
+
+/**
+ * @brief Дописывает строку в журнал и передает ее операционной системе. На диск ее сбрасывает
+ *        syncJournalThrough.
+ * @param line Строка с переводом строки.
+ * @throw std::runtime_error Если запись не удалась.
+ */
+void ServiceWriteBehind::append(const std::string& line) {
+    if (!journal || std::fwrite(line.data(), 1, line.size(), journal) != line.size() || std::fflush(journal) != 0) {
+        throw std::runtime_error("Failed to write service journal " + config.journalPath);
+    }
+}
+
+/**
+ * @brief Ждет, пока изменение с номером change не будет сброшено на диск.
+ * Первый вызывающий сбрасывает журнал вне mutex и подтверждает все изменения, дописанные к началу
+ * сброса; остальные ждут его и, если их изменения не вошли, выполняют следующий сброс.
+ * @param change Номер изменения (appendedChanges после его записи).
+ * @throw std::runtime_error Если сброс не удался.
+ */
+void ServiceWriteBehind::syncJournalThrough(std::uint64_t change) {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (syncedChanges < change) {
+        if (syncing) {
+            journalSynced.wait_for(lock, std::chrono::milliseconds(10));
+            continue;
+        }
+        syncing = true;
+        std::uint64_t target = appendedChanges;
+        int fd = duplicateHandle(journal);  // под mutex: flush не закроет журнал раньше
+        lock.unlock();
+        bool synced = syncHandle(fd);
+        lock.lock();
+        syncing = false;
+        if (synced) {
+            syncedChanges = std::max(syncedChanges, target);
+        }
+        journalSynced.notify_all();
+        if (!synced) {
+            throw std::runtime_error("Failed to sync service journal " + config.journalPath);
+        }
+    }
+}
+
+/**
+ * @brief Объединяет изменение next с предыдущим изменением той же строки.
+ * Замена отменяет все предыдущие изменения, добавление прибавляется к ним.
+ * @param into Предыдущее изменение (изменяется на месте).
+ * @param next Следующее изменение.
+ */
+void ServiceWriteBehind::coalesce(ServiceLineChange& into, const ServiceLineChange& next) {
+    if (next.replace) {
+        into = next;
+    } else {
+        into.quantity += next.quantity;
+    }
+}
+
+/**
+ * @brief Ставит изменение в очередь: журнал, объединение, пробуждение потока записи.
+ * Возвращается после сброса журнала на диск (групповым fsync вне mutex).
+ * @param booking Бронирование.
+ * @param serviceId Идентификатор услуги.
+ * @param change Изменение.
+ */
+void ServiceWriteBehind::enqueue(const Booking& booking, int serviceId, ServiceLineChange change) {
+    WriteBehindMetrics& metrics = writeBehindMetrics();
+    bool full;
+    std::uint64_t appended;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        append(journalLines(booking.getId(), booking.getDateFrom(), serviceId, change));
+        appended = ++appendedChanges;
+        if (pendingLines == 0) {
+            oldestPending = std::chrono::steady_clock::now();
+        }
+        auto& services = pending[{booking.getId(), booking.getDateFrom()}];
+        auto [entry, inserted] = services.try_emplace(serviceId, change);
+        if (inserted) {
+            ++pendingLines;
+            metrics.pending.add(1);
+        } else {
+            coalesce(entry->second, change);
+        }
+        full = pendingLines >= config.maxPending;
+    }
+    metrics.changes.increment();
+    if (full) {
+        wakeUp.notify_one();
+    }
+    if (config.syncJournal) {
+        syncJournalThrough(appended);
+    }
+}
+
+/**
+ * @brief Добавляет услугу к бронированию (количество прибавляется к имеющемуся).
+ * @param booking Бронирование.
+ * @param serviceId Идентификатор услуги.
+ * @param quantity Количество (больше нуля).
+ */
+void ServiceWriteBehind::addService(const Booking& booking, int serviceId, int quantity) {
+    if (quantity <= 0) {
+        throw std::invalid_argument("Service quantity must be positive");
+    }
+    enqueue(booking, serviceId, ServiceLineChange{false, quantity});
+}
+
+/**
+ * @brief Удаляет услугу из бронирования.
+ * @param booking Бронирование.
+ * @param serviceId Идентификатор услуги.
+ */
+void ServiceWriteBehind::removeService(const Booking& booking, int serviceId) {
+    enqueue(booking, serviceId, ServiceLineChange{true, 0});
+}
+
+/**
+ * @brief Применяет незаписанные изменения бронирования к строкам услуг: сначала отправляемую пачку,
+ *        затем ожидающие изменения.
+ * @param bookingId Идентификатор бронирования.
+ * @param dateFrom Дата начала бронирования.
+ * @param services Услуги и их количество (изменяются на месте).
+ */
+void ServiceWriteBehind::overlay(int bookingId, const std::string& dateFrom, std::map<int, int>& services) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    overlayLocked({bookingId, dateFrom}, services);
+}
+
+/**
+ * @brief Применяет незаписанные изменения бронирования к строкам услуг (вызывается под mutex).
+ * @param key Идентификатор и дата начала бронирования.
+ * @param services Услуги и их количество (изменяются на месте).
+ */
+void ServiceWriteBehind::overlayLocked(const BookingKey& key, std::map<int, int>& services) const {
+    for (const Changes* changes : {&inFlight, &pending}) {
+        auto found = changes->find(key);
+        if (found == changes->end()) {
+            continue;
+        }
+        for (const auto& [serviceId, change] : found->second) {
+            if (change.replace) {
+                services.erase(serviceId);
+            }
+            if (change.quantity > 0) {
+                services[serviceId] += change.quantity;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Возвращает услуги бронирования с учетом незаписанных изменений.
+ * Строки читаются с основного сервера.
+ * @param dbManager Менеджер базы данных.
+ * @param booking Бронирование.
+ * @return Карта, где ключ - ID услуги, значение - количество.
+ */
+std::map<int, int> ServiceWriteBehind::getServices(DBManager& dbManager, Booking& booking) const {
+    DBManager::PrimaryReads primary(dbManager);
+    return getServices([&dbManager, &booking] { return booking.getServices(dbManager); }, booking.getId(),
+                       booking.getDateFrom());
+}
+
+/**
+ * @brief Возвращает услуги бронирования с учетом незаписанных изменений.
+ * Пока пачка записывается (generation нечетный), чтение ждет ее завершения. Проверка generation
+ * после чтения из базы данных и наложение выполняются под одной блокировкой: если запись пачки
+ * началась или завершилась во время чтения, чтение повторяется, иначе изменения пачки учитывались бы
+ * дважды или (если пачка уже снята с inFlight) не учитывались совсем.
+ * @param readDatabase Читает строки услуг бронирования из базы данных.
+ * @param bookingId Идентификатор бронирования.
+ * @param dateFrom Дата начала бронирования.
+ * @return Карта, где ключ - ID услуги, значение - количество.
+ */
+std::map<int, int> ServiceWriteBehind::getServices(const std::function<std::map<int, int>()>& readDatabase,
+                                                   int bookingId, const std::string& dateFrom) const {
+    while (true) {
+        std::uint64_t before;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (generation % 2 != 0) {
+                batchSettled.wait_for(lock, std::chrono::milliseconds(10));
+            }
+            before = generation;
+        }
+        std::map<int, int> services = readDatabase();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (generation != before) {
+            continue;
+        }
+        overlayLocked({bookingId, dateFrom}, services);
+        return services;
+    }
+}
+
+/**
+ * @brief Записывает пачку в базу данных одной транзакцией.
+ * Номер пачки фиксируется в service_write_batches в той же транзакции; пачка с номером не больше
+ * зафиксированного уже записана и пропускается.
+ * @param batch Изменения.
+ * @param number Номер пачки.
+ * @return True, если пачка записана сейчас или уже была записана раньше.
+ */
+bool ServiceWriteBehind::commit(const Changes& batch, std::uint64_t number) {
+    TraceSpan span("ServiceWriteBehind::commit", "db");
+    if (!db || !db->isConnected()) {
+        db = connect ? connect() : nullptr;
+        if (!db) {
+            return false;
+        }
+    }
+
+    std::string deletes;
+    std::string inserts;
+    std::string bookings;
+    for (const auto& [key, services] : batch) {
+        std::string booking = std::to_string(key.first);
+        std::string date = "'" + key.second + "'::date";
+        bookings += (bookings.empty() ? "(" : ", (") + booking + ", " + date + ")";
+        for (const auto& [serviceId, change] : services) {
+            std::string service = std::to_string(serviceId);
+            if (change.replace) {
+                deletes += (deletes.empty() ? "(" : ", (") + booking + ", " + service + ", " + date + ")";
+            }
+            if (change.quantity > 0) {
+                inserts += (inserts.empty() ? "(" : ", (") + booking + ", " + service + ", " +
+                           std::to_string(change.quantity) + ", " + date + ")";
+            }
+        }
+    }
+    std::string writer = "'" + config.writerName + "'";
+
+    db->beginTransaction();
+    try {
+        db->executeUpdate("INSERT INTO service_write_batches (writer, last_batch) VALUES (" + writer +
+                          ", 0) ON CONFLICT (writer) DO NOTHING;");
+        PGResultWrapper last = db->executeQuery("SELECT last_batch FROM service_write_batches WHERE writer = " + writer +
+                                                " FOR UPDATE;");
+        if (PQntuples(last.get()) == 1 && std::stoull(PQgetvalue(last.get(), 0, 0)) >= number) {
+            db->rollback();
+            return true;
+        }
+        if (!deletes.empty()) {
+            db->executeUpdate("DELETE FROM booking_services WHERE (booking_id, service_id, booking_date_from) IN (VALUES " +
+                              deletes + ");");
+        }
+        if (!inserts.empty()) {
+            db->executeUpdate("INSERT INTO booking_services (booking_id, service_id, quantity, booking_date_from) "
+                              "SELECT v.booking_id, v.service_id, v.quantity, v.date_from FROM (VALUES " + inserts +
+                              ") AS v(booking_id, service_id, quantity, date_from) "
+                              "JOIN bookings b ON b.id = v.booking_id AND b.date_from = v.date_from "
+                              "JOIN services s ON s.id = v.service_id "
+                              "ON CONFLICT (booking_id, service_id, booking_date_from) "
+                              "DO UPDATE SET quantity = booking_services.quantity + EXCLUDED.quantity;");
+        }
+        // Версия меняется, как при Booking::addService: изменения с проверкой версии увидят конфликт.
+        db->executeUpdate("UPDATE bookings SET version = version + 1 WHERE (id, date_from) IN (VALUES " + bookings + ");");
+        db->executeUpdate("UPDATE service_write_batches SET last_batch = " + std::to_string(number) +
+                          " WHERE writer = " + writer + ";");
+        db->commit();
+    } catch (const std::exception&) {
+        try {
+            db->rollback();
+        } catch (const std::exception&) {
+            db.reset(); // соединение в неизвестном состоянии - следующая попытка откроет новое
+        }
+        throw;
+    }
+    return true;
+}
+
+/**
+ * @brief Записывает накопленные изменения сейчас.
+ * Сначала дописывается неподтвержденная пачка (если есть), затем журнал переименовывается в
+ * <journalPath>.flushing, ожидающие изменения становятся новой пачкой и записываются.
+ * @return True, если все изменения, поставленные до вызова, записаны в базу данных.
+ */
+bool ServiceWriteBehind::flush() {
+    TraceSpan span("ServiceWriteBehind::flush", "db");
+    WriteBehindMetrics& metrics = writeBehindMetrics();
+    std::lock_guard<std::mutex> flushing(flushMutex);
+    while (true) {
+        Changes batch;
+        std::uint64_t number;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (inFlight.empty()) {
+                if (pending.empty()) {
+                    return true;
+                }
+                if (config.syncJournal && journal) {
+                    // Изменения, еще не сброшенные группой, уходят в пачку: сбрасываются здесь.
+                    if (!syncFile(journal)) {
+                        throw std::runtime_error("Failed to sync service journal " + config.journalPath);
+                    }
+                    syncedChanges = appendedChanges;
+                    journalSynced.notify_all();
+                }
+                if (journal) {
+                    std::fclose(journal);
+                    journal = nullptr;
+                }
+                std::remove(flushingPath().c_str()); // rename на Windows не заменяет существующий файл
+                if (std::rename(config.journalPath.c_str(), flushingPath().c_str()) != 0) {
+                    journal = std::fopen(config.journalPath.c_str(), "ab");
+                    throw std::runtime_error("Failed to rename service journal " + config.journalPath);
+                }
+                inFlight = std::move(pending);
+                pending.clear();
+                inFlightBatch = journalBatch;
+                pendingLines = 0;
+                openJournal(journalBatch + 1);
+            }
+            batch = inFlight;
+            number = inFlightBatch;
+            ++generation;  // нечетный: читатели не знают, видна ли пачка в базе данных
+        }
+        auto settle = [this](bool written) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (written) {
+                    inFlight.clear();
+                }
+                ++generation;
+            }
+            batchSettled.notify_all();
+        };
+
+        bool written = false;
+        try {
+            written = commit(batch, number);
+            if (!written) {
+                Logger::warning("Service write-behind batch {} not written: database unavailable", number);
+            }
+        } catch (const std::exception& e) {
+            Logger::warning("Service write-behind batch {} failed: {}", number, e.what());
+        }
+        settle(written);
+        if (!written) {
+            metrics.failures.increment();
+            return false;
+        }
+
+        std::size_t lines = lineCount(batch);
+        std::remove(flushingPath().c_str());
+        metrics.batches.increment();
+        metrics.pending.add(-static_cast<double>(lines));
+    }
+}
+
+/**
+ * @brief Возвращает количество незаписанных строк услуг (с отправляемой пачкой).
+ */
+std::size_t ServiceWriteBehind::pendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return pendingLines + lineCount(inFlight);
+}
+
+/**
+ * @brief Цикл фонового потока записи: ждет порога количества или времени и записывает пачку.
+ * После неудачи следующая попытка - не раньше чем через retryDelay. При остановке выполняет
+ * последнюю попытку записи.
+ */
+void ServiceWriteBehind::loop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        wakeUp.wait_for(lock, config.maxDelay, [this] { return stopping || pendingLines >= config.maxPending; });
+        auto now = std::chrono::steady_clock::now();
+        bool due = !inFlight.empty() || pendingLines >= config.maxPending ||
+                   (pendingLines > 0 && now - oldestPending >= config.maxDelay);
+        if (!due || stopping || now < retryAfter) {
+            continue;
+        }
+        lock.unlock();
+        try {
+            if (!flush()) {
+                retryAfter = std::chrono::steady_clock::now() + config.retryDelay;
+            }
+        } catch (const std::exception& e) {
+            Logger::severe("Service write-behind flush failed: {}", e.what());
+            retryAfter = std::chrono::steady_clock::now() + config.retryDelay;
+        }
+        lock.lock();
+    }
+    lock.unlock();
+    try {
+        flush();
+    } catch (const std::exception& e) {
+        Logger::severe("Service write-behind flush failed: {}", e.what());
+    }
+}
+
+/**
+ * @brief Записывает накопленное и останавливает фоновый поток; последующие изменения остаются
+ *        в журнале до следующего запуска.
+ */
+void ServiceWriteBehind::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
@@ -0,0 +1,223 @@
+/**
+ * @file ServiceWriteBehind.h
+ * @brief Этот файл содержит отложенную запись услуг бронирований (ServiceWriteBehind): изменения
+ *        сначала попадают в журнал на диске, объединяются по бронированию и записываются в базу
+ *        данных пачками многострочных запросов.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+class Booking;
+class DBManager;
+
+/**
+ * @brief Параметры отложенной записи.
+ */
+struct ServiceWriteBehindConfig {
+    std::string journalPath = "hotel_services.journal"; ///< Журнал неподтвержденных изменений.
+    std::string writerName = "services";                 ///< Имя записывающего процесса в service_write_batches.
+    std::size_t maxPending = 256;                        ///< Запись начинается, когда накопилось столько строк услуг.
+    std::chrono::milliseconds maxDelay{200};             ///< ...или когда самое старое изменение ждет дольше.
+    std::chrono::milliseconds retryDelay{1000};          ///< Пауза перед повтором после неудачной записи.
+    bool syncJournal = true;                             ///< Сбрасывать журнал на диск до возврата из addService.
+};
+
+/**
+ * @brief Объединенное изменение одной строки услуги бронирования.
+ * replace = false: к количеству добавляется quantity; replace = true: строка заменяется
+ * количеством quantity (0 - удаляется).
+ */
+struct ServiceLineChange {
+    bool replace = false;
+    int quantity = 0;
+};
+
+/**
+ * @brief Отложенная запись изменений услуг бронирований.
+ *
+ * addService и removeService дописывают изменение в журнал и объединяют его с ожидающими изменениями
+ * той же строки (несколько добавлений одной услуги - одно прибавление суммы). Фоновый поток
+ * записывает накопленное, когда строк больше maxPending или самое старое изменение ждет дольше
+ * maxDelay: одна транзакция на собственном соединении с одним DELETE, одним INSERT ... ON CONFLICT
+ * и одним увеличением версии затронутых бронирований. Строки удаленных бронирований и услуг
+ * пропускаются.
+ *
+ * Журнал переживает аварийное завершение: перед записью он переименовывается в
+ * <journalPath>.flushing, а номер пачки из его заголовка фиксируется в таблице
+ * service_write_batches (sql/005_service_write_batches.sql) в той же транзакции, поэтому после
+ * перезапуска пачка применяется ровно один раз. Пока пачка не записана, следующая не начинается.
+ * Журнал сбрасывается на диск группами: один fsync вне блокировки подтверждает все изменения,
+ * дописанные к его началу, а остальные вызывающие ждут его.
+ *
+ * getServices и overlay дают чтение своих записей: к строкам из базы данных добавляются
+ * незаписанные изменения. Изменения в обход объекта (Booking::addService) учитываются, но порядок
+ * относительно отложенных изменений не гарантируется. Потокобезопасен.
+ */
+class ServiceWriteBehind {
+public:
+    using Factory = std::function<std::unique_ptr<DBManager>()>;
+    using BookingKey = std::pair<int, std::string>;                       ///< Идентификатор и дата начала бронирования.
+    using Changes = std::map<BookingKey, std::map<int, ServiceLineChange>>; ///< Изменения по бронированиям и услугам.
+
+private:
+    Factory connect;
+    ServiceWriteBehindConfig config;
+
+    mutable std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::condition_variable journalSynced;  ///< Сброс журнала на диск завершен.
+    mutable std::condition_variable batchSettled;  ///< Запись пачки завершена (generation снова четный).
+    Changes pending;                  ///< Изменения в журнале, еще не отправленные.
+    Changes inFlight;                 ///< Пачка в <journalPath>.flushing, еще не подтвержденная.
+    std::size_t pendingLines = 0;
+    std::uint64_t journalBatch = 0;   ///< Номер пачки текущего журнала.
+    std::uint64_t inFlightBatch = 0;
+    std::uint64_t generation = 0;     ///< Нечетный, пока пачка записывается; меняется при каждой записи.
+    std::uint64_t appendedChanges = 0; ///< Изменений дописано в журнал.
+    std::uint64_t syncedChanges = 0;   ///< Из них сброшено на диск.
+    bool syncing = false;              ///< Журнал сбрасывается на диск (вне mutex).
+    std::chrono::steady_clock::time_point oldestPending;
+    std::FILE* journal = nullptr;
+    bool stopping = false;
+    std::thread worker;
+
+    std::mutex flushMutex;            ///< Одна запись пачки за раз.
+    std::unique_ptr<DBManager> db;    ///< Соединение записи (под flushMutex).
+    std::chrono::steady_clock::time_point retryAfter;
+
+    /**
+     * @brief Путь файла отправляемой пачки.
+     */
+    std::string flushingPath() const { return config.journalPath + ".flushing"; }
+
+    /**
+     * @brief Открывает новый журнал с заголовком номера пачки (под mutex).
+     */
+    void openJournal(std::uint64_t batch);
+
+    /**
+     * @brief Дописывает строку в журнал и передает ее операционной системе (под mutex).
+     */
+    void append(const std::string& line);
+
+    /**
+     * @brief Ждет, пока изменение с номером change не будет сброшено на диск (групповой сброс вне mutex).
+     */
+    void syncJournalThrough(std::uint64_t change);
+
+    /**
+     * @brief Ставит изменение в очередь: журнал, объединение, пробуждение потока записи.
+     */
+    void enqueue(const Booking& booking, int serviceId, ServiceLineChange change);
+
+    /**
+     * @brief Записывает пачку в базу данных одной транзакцией.
+     * @return True, если пачка записана сейчас или уже была записана раньше.
+     */
+    bool commit(const Changes& batch, std::uint64_t number);
+
+    /**
+     * @brief Цикл фонового потока записи.
+     */
+    void loop();
+
+    /**
+     * @brief Применяет незаписанные изменения бронирования к строкам услуг (под mutex).
+     */
+    void overlayLocked(const BookingKey& key, std::map<int, int>& services) const;
+
+public:
+    /**
+     * @brief Конструирует отложенную запись и восстанавливает изменения из журнала.
+     * @param writerConnection Фабрика соединения записи (nullptr от фабрики - база данных недоступна).
+     * @param config Параметры.
+     * @throw std::runtime_error Если журнал не удалось открыть.
+     */
+    explicit ServiceWriteBehind(Factory writerConnection, ServiceWriteBehindConfig config = {});
+
+    /**
+     * @brief Записывает накопленное и останавливает фоновый поток.
+     */
+    ~ServiceWriteBehind();
+
+    ServiceWriteBehind(const ServiceWriteBehind&) = delete;
+    ServiceWriteBehind& operator=(const ServiceWriteBehind&) = delete;
+
+    /**
+     * @brief Объединяет изменение next с предыдущим изменением той же строки.
+     */
+    static void coalesce(ServiceLineChange& into, const ServiceLineChange& next);
+
+    /**
+     * @brief Добавляет услугу к бронированию (количество прибавляется к имеющемуся).
+     * @param booking Бронирование.
+     * @param serviceId Идентификатор услуги.
+     * @param quantity Количество (больше нуля).
+     * @throw std::invalid_argument Если quantity не больше нуля.
+     * @throw std::runtime_error Если изменение не удалось записать в журнал.
+     */
+    void addService(const Booking& booking, int serviceId, int quantity);
+
+    /**
+     * @brief Удаляет услугу из бронирования.
+     * @throw std::runtime_error Если изменение не удалось записать в журнал.
+     */
+    void removeService(const Booking& booking, int serviceId);
+
+    /**
+     * @brief Применяет незаписанные изменения бронирования к строкам услуг.
+     * @param bookingId Идентификатор бронирования.
+     * @param dateFrom Дата начала бронирования.
+     * @param services Услуги и их количество (изменяются на месте).
+     */
+    void overlay(int bookingId, const std::string& dateFrom, std::map<int, int>& services) const;
+
+    /**
+     * @brief Возвращает услуги бронирования с учетом незаписанных изменений.
+     * Строки читаются с основного сервера.
+     * @param dbManager Менеджер базы данных.
+     * @param booking Бронирование.
+     * @return Карта, где ключ - ID услуги, значение - количество.
+     */
+    std::map<int, int> getServices(DBManager& dbManager, Booking& booking) const;
+
+    /**
+     * @brief Возвращает услуги бронирования с учетом незаписанных изменений.
+     * @param readDatabase Читает строки услуг бронирования из базы данных (может вызываться повторно).
+     * @param bookingId Идентификатор бронирования.
+     * @param dateFrom Дата начала бронирования.
+     * @return Карта, где ключ - ID услуги, значение - количество.
+     */
+    std::map<int, int> getServices(const std::function<std::map<int, int>()>& readDatabase, int bookingId,
+                                   const std::string& dateFrom) const;
+
+    /**
+     * @brief Записывает накопленные изменения сейчас.
+     * @return True, если все изменения, поставленные до вызова, записаны в базу данных.
+     */
+    bool flush();
+
+    /**
+     * @brief Возвращает количество незаписанных строк услуг (с отправляемой пачкой).
+     */
+    std::size_t pendingCount() const;
+
+    /**
+     * @brief Записывает накопленное и останавливает фоновый поток; последующие изменения остаются
+     *        в журнале до следующего запуска.
+     */
+    void stop();
+};
@@ -0,0 +1,173 @@
+/**
+ * @file SessionManager.cpp
+ * @brief Этот файл содержит реализацию классов SessionManager и SessionContext.
+ */
+
+#include "SessionManager.h"
+#include "Metrics.h"
+#include <random>
+
+/**
+ * @brief Конструктор менеджера сессий.
+ * @param idleTimeout Время бездействия, после которого сессия истекает.
+ * @param wheelSlots Количество слотов колеса таймеров.
+ */
+SessionManager::SessionManager(std::chrono::seconds idleTimeout, std::size_t wheelSlots)
+    : expiry(wheelSlots, static_cast<std::uint64_t>(toSeconds(Clock::now()))), idleTimeout(idleTimeout) {}
+
+/**
+ * @brief Переводит момент времени в секунды (тики колеса).
+ */
+std::int64_t SessionManager::toSeconds(Clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+}
+
+/**
+ * @brief Создает сессию для пользователя.
+ * @param user Вошедший пользователь.
+ * @param now Текущее время.
+ * @return Токен новой сессии.
+ */
+std::string SessionManager::createSession(std::unique_ptr<User> user, Clock::time_point now) {
+    static MetricCounter& created = MetricsRegistry::global().counter(
+        "hotel_sessions_created_total", "Sessions opened after a successful login.");
+    created.increment();
+    std::int64_t seconds = toSeconds(now);
+    std::string token = generateToken();
+    auto session = std::make_shared<Session>(token, std::move(user), seconds);
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    sessions.emplace(token, std::move(session));
+    expiry.schedule(token, static_cast<std::uint64_t>(seconds + idleTimeout.count()));
+    return token;
+}
+
+/**
+ * @brief Находит сессию по токену и отмечает ее активность.
+ * Истекшая, но еще не удаленная сессия не возвращается.
+ * @param token Токен сессии.
+ * @param now Текущее время.
+ * @return Сессия или nullptr, если токен неизвестен или сессия истекла.
+ */
+std::shared_ptr<Session> SessionManager::find(const std::string& token, Clock::time_point now) {
+    if (token.empty()) {
+        return nullptr;
+    }
+    std::int64_t seconds = toSeconds(now);
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto it = sessions.find(token);
+    if (it == sessions.end()) {
+        return nullptr;
+    }
+    if (seconds - it->second->lastSeen.load(std::memory_order_relaxed) >= idleTimeout.count()) {
+        return nullptr;
+    }
+    it->second->lastSeen.store(seconds, std::memory_order_relaxed);
+    return it->second;
+}
+
+/**
+ * @brief Завершает сессию. Запись в колесе таймеров удаляется лениво.
+ * @param token Токен сессии.
+ * @return True, если сессия существовала.
+ */
+bool SessionManager::destroy(const std::string& token) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    return sessions.erase(token) > 0;
+}
+
+/**
+ * @brief Удаляет сессии, бездействующие дольше idleTimeout.
+ * Сессии, проявившие активность после постановки таймера, ставятся на новый срок.
+ * @param now Текущее время.
+ * @return Количество удаленных сессий.
+ */
+std::size_t SessionManager::expireIdle(Clock::time_point now) {
+    static MetricCounter& expired = MetricsRegistry::global().counter(
+        "hotel_sessions_expired_total", "Sessions removed after the idle timeout.");
+    std::int64_t seconds = toSeconds(now);
+    std::size_t removed = 0;
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    expiry.advance(static_cast<std::uint64_t>(seconds), [&](const std::string& token) {
+        auto it = sessions.find(token);
+        if (it == sessions.end()) {
+            return;
+        }
+        std::int64_t lastSeen = it->second->lastSeen.load(std::memory_order_relaxed);
+        if (seconds - lastSeen >= idleTimeout.count()) {
+            sessions.erase(it);
+            ++removed;
+        } else {
+            expiry.schedule(token, static_cast<std::uint64_t>(lastSeen + idleTimeout.count()));
+        }
+    });
+    expired.increment(removed);
+    return removed;
+}
+
+/**
+ * @brief Возвращает количество активных сессий.
+ */
+std::size_t SessionManager::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return sessions.size();
+}
+
+/**
+ * @brief Генерирует непрозрачный токен сессии (128 случайных бит в шестнадцатеричном виде).
+ */
+std::string SessionManager::generateToken() {
+    static const char hex[] = "0123456789abcdef";
+    thread_local std::random_device random;
+    std::string token;
+    token.reserve(32);
+    for (int i = 0; i < 4; ++i) {
+        std::uint32_t bits = random();
+        for (int j = 0; j < 8; ++j) {
+            token.push_back(hex[bits & 0xF]);
+            bits >>= 4;
+        }
+    }
+    return token;
+}
+
+/**
+ * @brief Конструктор контекста без вошедшего пользователя.
+ * @param manager Менеджер сессий.
+ */
+SessionContext::SessionContext(SessionManager& manager) : manager(manager) {}
+
+/**
+ * @brief Конструктор контекста для существующей сессии.
+ * @param manager Менеджер сессий.
+ * @param token Токен сессии.
+ */
+SessionContext::SessionContext(SessionManager& manager, std::string token)
+    : manager(manager), token(std::move(token)) {}
+
+/**
+ * @brief Возвращает сессию контекста и отмечает ее активность.
+ * @return Сессия или nullptr, если пользователь не вошел или сессия истекла.
+ */
+std::shared_ptr<Session> SessionContext::session() const {
+    return manager.find(token);
+}
+
+/**
+ * @brief Открывает сессию для вошедшего пользователя, завершая предыдущую.
+ * @param user Вошедший пользователь.
+ */
+void SessionContext::login(std::unique_ptr<User> user) {
+    logout();
+    token = manager.createSession(std::move(user));
+}
+
+/**
+ * @brief Завершает сессию контекста.
+ */
+void SessionContext::logout() {
+    if (!token.empty()) {
+        manager.destroy(token);
+        token.clear();
+    }
+}
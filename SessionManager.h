@@ -0,0 +1,150 @@
+/**
+ * @file SessionManager.h
+ * @brief Этот файл содержит объявление класса SessionManager, управляющего сессиями вошедших пользователей,
+ *        и класса SessionContext - контекста сессии, передаваемого в функции интерфейса.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include "TimingWheel.h"
+#include "User.h"
+
+/**
+ * @brief Сессия вошедшего пользователя.
+ */
+struct Session {
+    std::string token;                                   ///< Непрозрачный токен сессии.
+    std::unique_ptr<User> user;                          ///< Пользователь сессии.
+    std::atomic<std::int64_t> lastSeen;                  ///< Последняя активность (секунды steady_clock).
+    mutable std::atomic<std::int64_t> lastWrite{0};      ///< Последняя запись сеанса (нс steady_clock, 0 - не было).
+
+    Session(std::string token, std::unique_ptr<User> user, std::int64_t lastSeen)
+        : token(std::move(token)), user(std::move(user)), lastSeen(lastSeen) {}
+};
+
+/**
+ * @brief Потокобезопасный менеджер сессий.
+ * Поиск сессии по токену - O(1) (хэш-таблица), истечение по бездействию - через колесо таймеров
+ * с шагом в одну секунду. Отметка активности не трогает колесо: при срабатывании таймера
+ * сессия, которая была активна, просто ставится на новый срок.
+ */
+class SessionManager {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    mutable std::shared_mutex mutex;
+    std::unordered_map<std::string, std::shared_ptr<Session>> sessions;
+    TimingWheel<std::string> expiry;
+    std::chrono::seconds idleTimeout;
+
+    /**
+     * @brief Переводит момент времени в секунды (тики колеса).
+     */
+    static std::int64_t toSeconds(Clock::time_point time);
+
+public:
+    /**
+     * @brief Конструирует менеджер сессий.
+     * @param idleTimeout Время бездействия, после которого сессия истекает.
+     * @param wheelSlots Количество слотов колеса таймеров.
+     */
+    explicit SessionManager(std::chrono::seconds idleTimeout = std::chrono::minutes(30), std::size_t wheelSlots = 512);
+
+    /**
+     * @brief Создает сессию для пользователя.
+     * @param user Вошедший пользователь.
+     * @param now Текущее время.
+     * @return Токен новой сессии.
+     */
+    std::string createSession(std::unique_ptr<User> user, Clock::time_point now = Clock::now());
+
+    /**
+     * @brief Находит сессию по токену и отмечает ее активность.
+     * @param token Токен сессии.
+     * @param now Текущее время.
+     * @return Сессия или nullptr, если токен неизвестен или сессия истекла.
+     */
+    std::shared_ptr<Session> find(const std::string& token, Clock::time_point now = Clock::now());
+
+    /**
+     * @brief Завершает сессию.
+     * @param token Токен сессии.
+     * @return True, если сессия существовала.
+     */
+    bool destroy(const std::string& token);
+
+    /**
+     * @brief Удаляет сессии, бездействующие дольше idleTimeout.
+     * @param now Текущее время.
+     * @return Количество удаленных сессий.
+     */
+    std::size_t expireIdle(Clock::time_point now = Clock::now());
+
+    /**
+     * @brief Возвращает количество активных сессий.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Генерирует непрозрачный токен сессии (128 случайных бит в шестнадцатеричном виде).
+     */
+    static std::string generateToken();
+};
+
+/**
+ * @brief Контекст сессии одного терминала или запроса, передаваемый в функции интерфейса.
+ */
+class SessionContext {
+private:
+    SessionManager& manager;
+    std::string token;
+
+public:
+    /**
+     * @brief Конструирует контекст без вошедшего пользователя.
+     * @param manager Менеджер сессий.
+     */
+    explicit SessionContext(SessionManager& manager);
+
+    /**
+     * @brief Конструирует контекст для существующей сессии.
+     * @param manager Менеджер сессий.
+     * @param token Токен сессии.
+     */
+    SessionContext(SessionManager& manager, std::string token);
+
+    /**
+     * @brief Возвращает сессию контекста и отмечает ее активность.
+     * @return Сессия или nullptr, если пользователь не вошел или сессия истекла.
+     */
+    std::shared_ptr<Session> session() const;
+
+    /**
+     * @brief Открывает сессию для вошедшего пользователя, завершая предыдущую.
+     * @param user Вошедший пользователь.
+     */
+    void login(std::unique_ptr<User> user);
+
+    /**
+     * @brief Завершает сессию контекста.
+     */
+    void logout();
+
+    /**
+     * @brief Возвращает токен сессии (пустой, если пользователь не вошел).
+     */
+    const std::string& getToken() const { return token; }
+
+    /**
+     * @brief Возвращает менеджер сессий.
+     */
+    SessionManager& getManager() const { return manager; }
+};
@@ -0,0 +1,124 @@
+/**
+ * @file ShardRouter.cpp
+ * @brief Этот файл содержит реализацию класса ShardRouter.
+ */
+
+#include "ShardRouter.h"
+#include <sstream>
+#include <stdexcept>
+
+/**
+ * @brief Конструктор маршрутизатора.
+ * @param scheduler Планировщик, выполняющий запросы отчетов по сети.
+ */
+ShardRouter::ShardRouter(TaskScheduler& scheduler) : scheduler(scheduler) {}
+
+/**
+ * @brief Добавляет шард.
+ * @param pool Пул соединений с базой данных шарда.
+ * @param properties Отели, данные которых хранит шард.
+ * @return Индекс шарда.
+ * @throws std::invalid_argument Если отель уже размещен в другом шарде или пул не задан.
+ */
+std::size_t ShardRouter::addShard(std::unique_ptr<ConnectionPool> pool, std::vector<int> properties) {
+    if (!pool) {
+        throw std::invalid_argument("Shard requires a connection pool");
+    }
+    std::size_t index = shards.size();
+    for (int property : properties) {
+        if (placement.count(property)) {
+            throw std::invalid_argument("Property " + std::to_string(property) + " is already placed on shard " +
+                                        std::to_string(placement.at(property)));
+        }
+    }
+    for (int property : properties) {
+        placement.emplace(property, index);
+    }
+    shards.push_back(Shard{std::move(pool), std::move(properties)});
+    return index;
+}
+
+/**
+ * @brief Возвращает индекс шарда, хранящего отель.
+ * @param propertyId Идентификатор отеля.
+ * @throws std::out_of_range Если отель не размещен ни в одном шарде.
+ */
+std::size_t ShardRouter::shardOf(int propertyId) const {
+    auto it = placement.find(propertyId);
+    if (it == placement.end()) {
+        throw std::out_of_range("Unknown property " + std::to_string(propertyId));
+    }
+    return it->second;
+}
+
+/**
+ * @brief Берет соединение шарда, хранящего отель.
+ * @param propertyId Идентификатор отеля.
+ * @return Аренда соединения.
+ * @throws std::out_of_range Если отель не размещен ни в одном шарде.
+ */
+ConnectionPool::Lease ShardRouter::acquire(int propertyId) {
+    return shards[shardOf(propertyId)].pool->acquire();
+}
+
+/**
+ * @brief Выполняет функцию в каждом шарде параллельно и ждет завершения.
+ * Каждая задача берет соединение своего шарда, поэтому медленный шард не занимает соединения других.
+ * @param work Функция вида void(std::size_t shard, DBManager& connection); вызывается конкурентно.
+ * @throws Первое исключение, выброшенное функцией.
+ */
+void ShardRouter::forEachShard(const std::function<void(std::size_t, DBManager&)>& work) {
+    TaskGroup group(scheduler);
+    for (std::size_t shard = 0; shard < shards.size(); ++shard) {
+        group.run([this, shard, &work] {
+            ConnectionPool::Lease lease = shards[shard].pool->acquire();
+            work(shard, *lease);
+        });
+    }
+    group.wait();
+}
+
+/**
+ * @brief Разбирает описание шардов вида "host[:port]/database=1,2;host[:port]/database=3".
+ * @param list Описание шардов.
+ * @param user Пользователь базы данных.
+ * @param password Пароль.
+ * @return Описания шардов.
+ * @throws std::invalid_argument Если описание шарда не содержит базы данных или отелей.
+ */
+std::vector<ShardConfig> ShardRouter::parseShards(const std::string& list, const std::string& user, const std::string& password) {
+    std::vector<ShardConfig> configs;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ';')) {
+        if (item.empty()) {
+            continue;
+        }
+        std::size_t slash = item.find('/');
+        std::size_t equals = item.find('=', slash == std::string::npos ? 0 : slash);
+        if (slash == std::string::npos || equals == std::string::npos || equals == slash + 1) {
+            throw std::invalid_argument("Invalid shard description: '" + item + "'");
+        }
+
+        ShardConfig config;
+        std::vector<ReplicaEndpoint> endpoints =
+            ReplicaRouter::parseEndpoints(item.substr(0, slash), user, password, item.substr(slash + 1, equals - slash - 1));
+        if (endpoints.size() != 1) {
+            throw std::invalid_argument("Invalid shard host: '" + item + "'");
+        }
+        config.endpoint = endpoints.front();
+
+        std::stringstream properties(item.substr(equals + 1));
+        std::string property;
+        while (std::getline(properties, property, ',')) {
+            if (!property.empty()) {
+                config.properties.push_back(std::stoi(property));
+            }
+        }
+        if (config.properties.empty()) {
+            throw std::invalid_argument("Shard has no properties: '" + item + "'");
+        }
+        configs.push_back(std::move(config));
+    }
+    return configs;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file ShardRouter.h
+ * @brief Этот файл содержит объявление класса ShardRouter - распределения отелей сети по базам данных
+ *        (шардам): запросы одного отеля идут в его шард, отчеты по сети выполняются во всех шардах параллельно.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ConnectionPool.h"
+#include "ReplicaRouter.h"
+#include "TaskScheduler.h"
+
+/**
+ * @brief Описание шарда: параметры подключения и отели, данные которых он хранит.
+ */
+struct ShardConfig {
+    ReplicaEndpoint endpoint;
+    std::vector<int> properties;
+};
+
+/**
+ * @brief Маршрутизатор шардов.
+ * У каждого шарда собственный пул соединений. Операция над одним отелем получает соединение
+ * ровно одного шарда; отчет по сети выполняет одну и ту же функцию во всех шардах параллельно
+ * (задачи планировщика) и объединяет результаты в порядке шардов. Каждый отель размещен
+ * ровно в одном шарде. После настройки маршрутизатор только читается, поэтому потокобезопасен.
+ */
+class ShardRouter {
+private:
+    struct Shard {
+        std::unique_ptr<ConnectionPool> pool;
+        std::vector<int> properties;
+    };
+
+    TaskScheduler& scheduler;
+    std::vector<Shard> shards;
+    std::unordered_map<int, std::size_t> placement;
+
+public:
+    /**
+     * @brief Конструирует маршрутизатор без шардов.
+     * @param scheduler Планировщик, выполняющий запросы отчетов по сети.
+     */
+    explicit ShardRouter(TaskScheduler& scheduler);
+
+    ShardRouter(const ShardRouter&) = delete;
+    ShardRouter& operator=(const ShardRouter&) = delete;
+
+    /**
+     * @brief Добавляет шард.
+     * @param pool Пул соединений с базой данных шарда.
+     * @param properties Отели, данные которых хранит шард.
+     * @return Индекс шарда.
+     * @throws std::invalid_argument Если отель уже размещен в другом шарде или пул не задан.
+     */
+    std::size_t addShard(std::unique_ptr<ConnectionPool> pool, std::vector<int> properties);
+
+    /**
+     * @brief Возвращает индекс шарда, хранящего отель.
+     * @param propertyId Идентификатор отеля.
+     * @throws std::out_of_range Если отель не размещен ни в одном шарде.
+     */
+    std::size_t shardOf(int propertyId) const;
+
+    /**
+     * @brief Берет соединение шарда, хранящего отель.
+     * @param propertyId Идентификатор отеля.
+     * @return Аренда соединения.
+     * @throws std::out_of_range Если отель не размещен ни в одном шарде.
+     */
+    ConnectionPool::Lease acquire(int propertyId);
+
+    /**
+     * @brief Возвращает количество шардов.
+     */
+    std::size_t shardCount() const { return shards.size(); }
+
+    /**
+     * @brief Возвращает отели шарда.
+     */
+    const std::vector<int>& properties(std::size_t shard) const { return shards[shard].properties; }
+
+    /**
+     * @brief Возвращает пул соединений шарда.
+     */
+    ConnectionPool& pool(std::size_t shard) { return *shards[shard].pool; }
+
+    /**
+     * @brief Выполняет функцию в каждом шарде параллельно и ждет завершения.
+     * @param work Функция вида void(std::size_t shard, DBManager& connection); вызывается конкурентно.
+     * @throws Первое исключение, выброшенное функцией.
+     */
+    void forEachShard(const std::function<void(std::size_t, DBManager&)>& work);
+
+    /**
+     * @brief Выполняет запрос отчета во всех шардах параллельно и объединяет строки.
+     * @tparam Row Тип строки отчета.
+     * @param work Функция, возвращающая строки отчета одного шарда; вызывается конкурентно.
+     * @return Строки всех шардов в порядке шардов.
+     */
+    template <typename Row>
+    std::vector<Row> gather(const std::function<std::vector<Row>(DBManager&)>& work) {
+        std::vector<std::vector<Row>> parts(shards.size());
+        forEachShard([&](std::size_t shard, DBManager& connection) { parts[shard] = work(connection); });
+        std::vector<Row> merged;
+        for (auto& part : parts) {
+            merged.insert(merged.end(), std::make_move_iterator(part.begin()), std::make_move_iterator(part.end()));
+        }
+        return merged;
+    }
+
+    /**
+     * @brief Разбирает описание шардов вида "host[:port]/database=1,2;host[:port]/database=3".
+     * @param list Описание шардов.
+     * @param user Пользователь базы данных.
+     * @param password Пароль.
+     * @return Описания шардов.
+     * @throws std::invalid_argument Если описание шарда не содержит базы данных или отелей.
+     */
+    static std::vector<ShardConfig> parseShards(const std::string& list, const std::string& user, const std::string& password);
+};
@@ -0,0 +1,497 @@
+/**
+ * @file SlowQueryLog.cpp
+ * @brief Этот файл содержит реализацию сбора планов медленных запросов.
+ */
+
+#include "SlowQueryLog.h"
+#include "DBManager.h"
+#include "Logger.h"
+#include "Metrics.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+bool identifierChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$';
+}
+
+/**
+ * @brief Заключает строку в кавычки SQL (удваивает одинарные кавычки).
+ * Рассчитано на standard_conforming_strings = on (значение по умолчанию PostgreSQL).
+ */
+std::string quoteLiteral(const std::string& text) {
+    std::string quoted = "'";
+    for (char c : text) {
+        quoted += c;
+        if (c == '\'') {
+            quoted += '\'';
+        }
+    }
+    return quoted + "'";
+}
+
+/**
+ * @brief Слово запроса (вне строк и идентификаторов в кавычках) в верхнем регистре.
+ */
+struct QueryWord {
+    std::string text;
+    bool call;      ///< За словом следует открывающая скобка.
+};
+
+/**
+ * @brief Разбивает запрос на слова, пропуская строковые литералы и идентификаторы в двойных кавычках.
+ */
+std::vector<QueryWord> queryWords(const std::string& query) {
+    std::vector<QueryWord> words;
+    std::size_t i = 0;
+    while (i < query.size()) {
+        char c = query[i];
+        if (c == '\'' || c == '"') {
+            std::size_t end = query.find(c, i + 1);
+            i = end == std::string::npos ? query.size() : end + 1;
+        } else if (identifierChar(c)) {
+            std::string word;
+            while (i < query.size() && identifierChar(query[i])) {
+                word += static_cast<char>(std::toupper(static_cast<unsigned char>(query[i++])));
+            }
+            std::size_t next = i;
+            while (next < query.size() && std::isspace(static_cast<unsigned char>(query[next]))) {
+                ++next;
+            }
+            words.push_back({std::move(word), next < query.size() && query[next] == '('});
+        } else {
+            ++i;
+        }
+    }
+    return words;
+}
+
+/**
+ * @brief Проверяет, может ли слово перед скобкой быть вызовом функции с побочными эффектами.
+ * Разрешены ключевые слова, встречающиеся перед скобкой, типы с параметрами и неизменяющие функции,
+ * которые использует приложение; все остальное (nextval, setval, pg_advisory_xact_lock, функции
+ * пользователя) считается небезопасным.
+ */
+bool unsafeCall(const QueryWord& word) {
+    static constexpr std::string_view SAFE[] = {
+        "ALL", "AND", "ANY", "AS", "BY", "EXISTS", "FILTER", "FROM", "IN", "JOIN", "NOT", "ON", "OR", "OVER",
+        "OVERLAPS", "SELECT", "SOME", "THEN", "ELSE", "USING", "VALUES", "WHEN", "WHERE", "WITHIN",
+        "CHAR", "DECIMAL", "NUMERIC", "VARCHAR",
+        "ABS", "AVG", "CEIL", "COALESCE", "COUNT", "DATE_PART", "DATE_TRUNC", "EXTRACT", "FLOOR", "GREATEST",
+        "LEAST", "LENGTH", "LOWER", "MAX", "MIN", "NULLIF", "ROUND", "SUBSTRING", "SUM", "TO_CHAR", "TRIM", "UPPER",
+    };
+    return word.call && std::find(std::begin(SAFE), std::end(SAFE), word.text) == std::end(SAFE);
+}
+
+/**
+ * @brief Выполняет EXPLAIN и склеивает строки плана.
+ */
+std::string explain(DBManager& side, const std::string& options, const std::string& query) {
+    PGResultWrapper result = side.executeQuery("EXPLAIN " + options + query);
+    std::string plan;
+    for (int i = 0; i < PQntuples(result.get()); ++i) {
+        plan += PQgetvalue(result.get(), i, 0);
+        plan += '\n';
+    }
+    return plan;
+}
+
+} // namespace
+
+/**
+ * @brief Конструирует сборщик.
+ * @param sideConnection Фабрика отдельного соединения.
+ * @param config Параметры.
+ */
+SlowQueryLog::SlowQueryLog(Factory sideConnection, SlowQueryConfig config)
+    : connect(std::move(sideConnection)), config(config) {}
+
+/**
+ * @brief Останавливает фоновый поток.
+ */
+SlowQueryLog::~SlowQueryLog() {
+    stop();
+}
+
+/**
+ * @brief Заменяет литералы (строки и числа) на ?, списки значений - на ?..., схлопывает пробелы.
+ * Цифры внутри идентификаторов (room2, $1) сохраняются.
+ */
+std::string SlowQueryLog::normalize(const std::string& query) {
+    std::string out;
+    out.reserve(query.size());
+    bool pendingSpace = false;
+    std::size_t i = 0;
+    while (i < query.size()) {
+        char c = query[i];
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            pendingSpace = true;
+            ++i;
+            continue;
+        }
+        if (pendingSpace && !out.empty()) {
+            out += ' ';
+        }
+        pendingSpace = false;
+
+        if (c == '\'') {
+            for (++i; i < query.size(); ++i) {
+                if (query[i] == '\'') {
+                    if (i + 1 < query.size() && query[i + 1] == '\'') {
+                        ++i;
+                        continue;
+                    }
+                    ++i;
+                    break;
+                }
+            }
+            out += '?';
+        } else if (c == '"') {
+            std::size_t end = query.find('"', i + 1);
+            end = end == std::string::npos ? query.size() : end + 1;
+            out.append(query, i, end - i);
+            i = end;
+        } else if (std::isdigit(static_cast<unsigned char>(c)) && (out.empty() || !identifierChar(out.back()))) {
+            while (i < query.size() && (std::isdigit(static_cast<unsigned char>(query[i])) || query[i] == '.')) {
+                ++i;
+            }
+            out += '?';
+        } else if (identifierChar(c)) {
+            while (i < query.size() && identifierChar(query[i])) {
+                out += query[i++];
+            }
+        } else {
+            out += c;
+            ++i;
+        }
+    }
+    while (!out.empty() && (out.back() == ';' || out.back() == ' ')) {
+        out.pop_back();
+    }
+
+    // IN (?, ?, ?) и VALUES (?, ?) с разным числом значений - один и тот же запрос.
+    std::string collapsed;
+    collapsed.reserve(out.size());
+    for (std::size_t at = 0; at < out.size();) {
+        if (out.compare(at, 4, "?, ?") == 0 || out.compare(at, 3, "?,?") == 0) {
+            collapsed += "?...";
+            ++at;
+            while (true) {
+                std::size_t next = at;
+                if (next < out.size() && out[next] == ',') ++next;
+                if (next < out.size() && out[next] == ' ') ++next;
+                if (next < out.size() && out[next] == '?' && next > at) {
+                    at = next + 1;
+                } else {
+                    break;
+                }
+            }
+        } else {
+            collapsed += out[at++];
+        }
+    }
+    return collapsed;
+}
+
+/**
+ * @brief Заменяет содержимое строковых литералов ('...', включая E'...' и удвоенные кавычки) на ?.
+ * Числа, идентификаторы в двойных кавычках и отступы сохраняются, поэтому функция подходит и для
+ * вывода EXPLAIN, где литералы условий стоят среди оценок стоимости.
+ */
+std::string SlowQueryLog::redact(const std::string& text) {
+    std::string out;
+    out.reserve(text.size());
+    std::size_t i = 0;
+    while (i < text.size()) {
+        char c = text[i];
+        if (c == '"') {
+            std::size_t end = text.find('"', i + 1);
+            end = end == std::string::npos ? text.size() : end + 1;
+            out.append(text, i, end - i);
+            i = end;
+        } else if (c == '\'') {
+            bool escapes = i > 0 && (text[i - 1] == 'E' || text[i - 1] == 'e');
+            for (++i; i < text.size(); ++i) {
+                if (escapes && text[i] == '\\') {
+                    ++i;
+                } else if (text[i] == '\'') {
+                    if (i + 1 < text.size() && text[i + 1] == '\'') {
+                        ++i;
+                        continue;
+                    }
+                    ++i;
+                    break;
+                }
+            }
+            out += "'?'";
+        } else {
+            out += c;
+            ++i;
+        }
+    }
+    return out;
+}
+
+/**
+ * @brief Возвращает отпечаток нормализованного текста (FNV-1a, 16 шестнадцатеричных цифр).
+ */
+std::string SlowQueryLog::fingerprint(const std::string& normalized) {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (char c : normalized) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    char text[17];
+    std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(hash));
+    return text;
+}
+
+/**
+ * @brief Проверяет, можно ли выполнить запрос под EXPLAIN: одна команда SELECT, INSERT, UPDATE,
+ *        DELETE или WITH. SELECT без FROM, вызывающий функцию (pg_advisory_xact_lock, setval),
+ *        пропускается: его длительность - ожидание или побочный эффект, а не план.
+ */
+bool SlowQueryLog::explainable(const std::string& query) {
+    std::size_t start = 0;
+    while (start < query.size() && (std::isspace(static_cast<unsigned char>(query[start])) || query[start] == '(')) {
+        ++start;
+    }
+    std::string keyword;
+    while (start < query.size() && std::isalpha(static_cast<unsigned char>(query[start]))) {
+        keyword += static_cast<char>(std::toupper(static_cast<unsigned char>(query[start++])));
+    }
+    if (keyword != "SELECT" && keyword != "INSERT" && keyword != "UPDATE" && keyword != "DELETE" && keyword != "WITH") {
+        return false;
+    }
+    // Точка с запятой вне строк допустима только в конце.
+    bool quoted = false;
+    for (std::size_t i = start; i < query.size(); ++i) {
+        if (query[i] == '\'') {
+            quoted = !quoted;
+        } else if (query[i] == ';' && !quoted) {
+            for (std::size_t rest = i + 1; rest < query.size(); ++rest) {
+                if (!std::isspace(static_cast<unsigned char>(query[rest]))) {
+                    return false;
+                }
+            }
+        }
+    }
+    if (keyword == "SELECT") {
+        std::vector<QueryWord> words = queryWords(query);
+        bool hasFrom = std::any_of(words.begin(), words.end(), [](const QueryWord& word) { return word.text == "FROM"; });
+        if (!hasFrom && std::any_of(words.begin(), words.end(), unsafeCall)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Проверяет, можно ли выполнить запрос под EXPLAIN ANALYZE, то есть на самом деле: только
+ *        SELECT без блокировки строк (FOR UPDATE/SHARE) и без вызовов функций, которые могут
+ *        менять данные или ждать блокировок. Изменяющие запросы повторно не выполняются - они
+ *        взяли бы те же блокировки строк и израсходовали бы значения последовательностей.
+ */
+bool SlowQueryLog::analyzable(const std::string& query) {
+    if (!explainable(query)) {
+        return false;
+    }
+    std::vector<QueryWord> words = queryWords(query);
+    if (words.empty() || words.front().text != "SELECT") {
+        return false;
+    }
+    for (std::size_t i = 0; i + 1 < words.size(); ++i) {
+        if (words[i].text == "FOR" && (words[i + 1].text == "UPDATE" || words[i + 1].text == "SHARE" ||
+                                       words[i + 1].text == "NO" || words[i + 1].text == "KEY")) {
+            return false;
+        }
+    }
+    return std::none_of(words.begin(), words.end(), unsafeCall);
+}
+
+/**
+ * @brief Сообщает о выполненном запросе.
+ * Быстрые запросы отсекаются сравнением длительности; для медленных проверяются ограничения:
+ * один план отпечатка за perFingerprint, не больше maxPerMinute в минуту, место в очереди.
+ * @param query Текст запроса.
+ * @param elapsed Длительность выполнения.
+ * @return True, если запрос поставлен в очередь на сбор плана.
+ */
+bool SlowQueryLog::report(const std::string& query, std::chrono::steady_clock::duration elapsed) {
+    if (elapsed < config.threshold) {
+        return false;
+    }
+    static MetricCounter& slow = MetricsRegistry::global().counter(
+        "hotel_slow_queries_total", "Queries slower than the slow query threshold.");
+    slow.increment();
+    if (!explainable(query)) {
+        return false;
+    }
+    std::string normalized = normalize(query);
+    std::string print = fingerprint(normalized);
+    double durationMs = std::chrono::duration<double, std::milli>(elapsed).count();
+
+    auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(mutex);
+    if (stopping) {
+        return false;
+    }
+    auto last = lastCapture.find(print);
+    if (last != lastCapture.end() && now - last->second < config.perFingerprint) {
+        return false;
+    }
+    while (!lastMinute.empty() && now - lastMinute.front() >= std::chrono::minutes(1)) {
+        lastMinute.pop_front();
+    }
+    if (lastMinute.size() >= config.maxPerMinute || queue.size() >= config.queueCapacity) {
+        return false;
+    }
+    if (lastCapture.size() >= 4096) {
+        std::erase_if(lastCapture, [&](const auto& entry) { return now - entry.second >= config.perFingerprint; });
+    }
+    lastCapture[print] = now;
+    lastMinute.push_back(now);
+    queue.push_back({print, std::move(normalized), query, durationMs});
+    if (!worker.joinable()) {
+        worker = std::thread(&SlowQueryLog::loop, this);
+    }
+    wakeUp.notify_one();
+    return true;
+}
+
+/**
+ * @brief Цикл фонового потока: собирает планы из очереди; при остановке обрабатывает остаток очереди.
+ */
+void SlowQueryLog::loop() {
+    static MetricCounter& capturedPlans = MetricsRegistry::global().counter(
+        "hotel_slow_query_plans_total", "Slow query plans captured with EXPLAIN.");
+    std::unique_ptr<DBManager> side;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wakeUp.wait_for(lock, std::chrono::seconds(1), [this] { return stopping || !queue.empty(); });
+        if (queue.empty()) {
+            if (stopping) {
+                return;
+            }
+            continue;
+        }
+        Pending pending = std::move(queue.front());
+        queue.pop_front();
+        lock.unlock();
+
+        SlowQueryPlan plan;
+        if (!side || !side->isConnected()) {
+            side = connect ? connect() : nullptr;
+            if (side) {
+                side->useSlowQueryLog(nullptr); // планы собственных запросов не собираются
+                side->setDefaultTimeout(config.explainTimeout);
+            }
+        }
+        if (side) {
+            plan = capture(*side, pending);
+        } else {
+            plan = describe(pending);
+            plan.error = "side connection unavailable";
+        }
+        if (!plan.plan.empty()) {
+            capturedPlans.increment();
+            Logger::warning("Slow query {} took {} ms, plan captured: {}", plan.fingerprint, plan.durationMs, plan.normalized);
+        } else {
+            Logger::warning("Slow query {} took {} ms, no plan: {}", plan.fingerprint, plan.durationMs, plan.error);
+        }
+
+        lock.lock();
+        plans.push_back(std::move(plan));
+        while (plans.size() > config.keepRecent) {
+            plans.pop_front();
+        }
+        ++capturedCount;
+    }
+}
+
+/**
+ * @brief Создает план без вывода EXPLAIN: отпечаток, тексты без строковых литералов, длительность.
+ */
+SlowQueryPlan SlowQueryLog::describe(const Pending& pending) {
+    SlowQueryPlan plan;
+    plan.fingerprint = pending.fingerprint;
+    plan.normalized = pending.normalized;
+    plan.sample = redact(pending.sample);
+    plan.durationMs = pending.durationMs;
+    return plan;
+}
+
+/**
+ * @brief Получает план запроса на отдельном соединении и сохраняет его в базе данных.
+ * Безопасный SELECT (analyzable) выполняется под EXPLAIN (ANALYZE, BUFFERS) в транзакции только для
+ * чтения, которая откатывается. Для изменяющих запросов и запросов с вызовами функций, а также если
+ * ANALYZE не удался (например, истекло время), берется оценочный план EXPLAIN без выполнения запроса.
+ * Образец и план сохраняются без строковых литералов (redact).
+ */
+SlowQueryPlan SlowQueryLog::capture(DBManager& side, const Pending& pending) {
+    SlowQueryPlan plan = describe(pending);
+    try {
+        if (analyzable(pending.sample)) {
+            side.beginTransaction(IsolationLevel::READ_COMMITTED, true);
+            try {
+                plan.plan = redact(explain(side, "(ANALYZE, BUFFERS) ", pending.sample));
+                plan.analyzed = true;
+            } catch (const std::exception& e) {
+                plan.error = e.what();
+            }
+            side.rollback();
+        }
+        if (!plan.analyzed) {
+            plan.plan = redact(explain(side, "", pending.sample));
+        }
+    } catch (const std::exception& e) {
+        plan.error = e.what();
+        return plan;
+    }
+
+    try {
+        side.executeUpdate("INSERT INTO slow_query_plans (fingerprint, normalized_query, sample_query, duration_ms, "
+                           "analyzed, plan) VALUES (" + quoteLiteral(plan.fingerprint) + ", " +
+                           quoteLiteral(plan.normalized) + ", " + quoteLiteral(plan.sample) + ", " +
+                           std::to_string(plan.durationMs) + ", " + (plan.analyzed ? "TRUE" : "FALSE") + ", " +
+                           quoteLiteral(plan.plan) + ");");
+    } catch (const std::exception& e) {
+        plan.error = std::string("plan not stored: ") + e.what();
+    }
+    return plan;
+}
+
+/**
+ * @brief Возвращает последние собранные планы (новые в конце).
+ */
+std::vector<SlowQueryPlan> SlowQueryLog::recent() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return std::vector<SlowQueryPlan>(plans.begin(), plans.end());
+}
+
+/**
+ * @brief Возвращает количество обработанных запросов на сбор плана.
+ */
+std::size_t SlowQueryLog::captured() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return capturedCount;
+}
+
+/**
+ * @brief Обрабатывает оставшуюся очередь и останавливает фоновый поток.
+ */
+void SlowQueryLog::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
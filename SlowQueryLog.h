@@ -0,0 +1,178 @@
+/**
+ * @file SlowQueryLog.h
+ * @brief Этот файл содержит автоматический сбор планов медленных запросов (SlowQueryLog):
+ *        запрос дольше порога выполняется повторно через EXPLAIN (ANALYZE, BUFFERS) на отдельном
+ *        соединении, а план сохраняется вместе с отпечатком запроса.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class DBManager;
+
+/**
+ * @brief Параметры сбора планов.
+ */
+struct SlowQueryConfig {
+    std::chrono::milliseconds threshold{500};             ///< Запрос дольше порога считается медленным.
+    std::chrono::milliseconds perFingerprint{600000};     ///< Не чаще одного плана одного отпечатка за этот период.
+    std::size_t maxPerMinute = 6;                         ///< Не больше планов в минуту всего.
+    std::size_t queueCapacity = 16;                       ///< Очередь запросов на сбор плана.
+    std::chrono::milliseconds explainTimeout{30000};      ///< Ограничение EXPLAIN ANALYZE на отдельном соединении.
+    std::size_t keepRecent = 32;                          ///< Сколько последних планов хранить в памяти.
+};
+
+/**
+ * @brief Собранный план медленного запроса.
+ */
+struct SlowQueryPlan {
+    std::string fingerprint;   ///< Отпечаток нормализованного текста (16 шестнадцатеричных цифр).
+    std::string normalized;    ///< Текст с литералами, замененными на ?.
+    std::string sample;        ///< Исходный текст со строковыми литералами, замененными на '?' (образец параметров).
+    double durationMs = 0;     ///< Длительность исходного выполнения.
+    bool analyzed = false;     ///< План с фактическими строками и временем (ANALYZE), а не оценочный.
+    std::string plan;          ///< Вывод EXPLAIN (строковые литералы заменены на '?'); пустой, если план не получен.
+    std::string error;         ///< Причина, если план не получен или не сохранен.
+};
+
+/**
+ * @brief Сбор планов медленных запросов.
+ *
+ * DBManager сообщает о каждом запросе дольше порога (report). Отобранные с учетом ограничений запросы
+ * ставятся в очередь, и фоновый поток на собственном соединении собирает их планы. Повторно под
+ * EXPLAIN (ANALYZE, BUFFERS) в откатываемой транзакции только для чтения выполняются лишь SELECT без
+ * блокировок строк и без вызовов функций с возможными побочными эффектами (analyzable); для
+ * INSERT/UPDATE/DELETE и остальных SELECT берется оценочный план EXPLAIN без выполнения, а SELECT из
+ * одних вызовов функций (pg_advisory_xact_lock, setval) не собирается вовсе. Если ANALYZE не уложился
+ * в explainTimeout, сохраняется оценочный план EXPLAIN. План записывается в таблицу slow_query_plans
+ * (sql/004_slow_query_plans.sql) и хранится в памяти (recent).
+ *
+ * В приложении SQL-запросы собираются со значениями в тексте, поэтому образцом параметров служит
+ * исходный текст запроса, а отпечаток считается по тексту с литералами, замененными на ?. В тексте
+ * могут быть пароли и персональные данные (User::authenticate), поэтому в образце и плане строковые
+ * литералы заменяются на '?' (redact); исходный текст живет только в очереди до выполнения EXPLAIN.
+ * Потокобезопасен; один объект обычно общий для всех соединений процесса.
+ */
+class SlowQueryLog {
+public:
+    using Factory = std::function<std::unique_ptr<DBManager>()>;
+
+private:
+    struct Pending {
+        std::string fingerprint;
+        std::string normalized;
+        std::string sample;
+        double durationMs;
+    };
+
+    Factory connect;
+    SlowQueryConfig config;
+
+    mutable std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::deque<Pending> queue;
+    std::unordered_map<std::string, std::chrono::steady_clock::time_point> lastCapture;
+    std::deque<std::chrono::steady_clock::time_point> lastMinute;
+    std::deque<SlowQueryPlan> plans;
+    std::size_t capturedCount = 0;
+    bool stopping = false;
+    std::thread worker;
+
+    /**
+     * @brief Цикл фонового потока: собирает планы из очереди.
+     */
+    void loop();
+
+    /**
+     * @brief Создает план без вывода EXPLAIN: отпечаток, тексты без строковых литералов, длительность.
+     */
+    static SlowQueryPlan describe(const Pending& pending);
+
+    /**
+     * @brief Получает план запроса на отдельном соединении и сохраняет его в базе данных.
+     */
+    static SlowQueryPlan capture(DBManager& side, const Pending& pending);
+
+public:
+    /**
+     * @brief Конструирует сборщик.
+     * @param sideConnection Фабрика отдельного соединения (вызывается в фоновом потоке при первой
+     *        необходимости и после обрыва; nullptr от фабрики - соединение недоступно).
+     * @param config Параметры.
+     */
+    explicit SlowQueryLog(Factory sideConnection, SlowQueryConfig config = {});
+
+    /**
+     * @brief Останавливает фоновый поток.
+     */
+    ~SlowQueryLog();
+
+    SlowQueryLog(const SlowQueryLog&) = delete;
+    SlowQueryLog& operator=(const SlowQueryLog&) = delete;
+
+    /**
+     * @brief Заменяет литералы (строки и числа) на ?, списки значений - на ?..., схлопывает пробелы.
+     */
+    static std::string normalize(const std::string& query);
+
+    /**
+     * @brief Заменяет содержимое строковых литералов на ?, остальной текст (числа, отступы плана) сохраняет.
+     */
+    static std::string redact(const std::string& text);
+
+    /**
+     * @brief Возвращает отпечаток нормализованного текста (FNV-1a, 16 шестнадцатеричных цифр).
+     */
+    static std::string fingerprint(const std::string& normalized);
+
+    /**
+     * @brief Проверяет, можно ли выполнить запрос под EXPLAIN: одна команда SELECT, INSERT, UPDATE,
+     *        DELETE или WITH.
+     */
+    static bool explainable(const std::string& query);
+
+    /**
+     * @brief Проверяет, можно ли выполнить запрос под EXPLAIN ANALYZE: SELECT без FOR UPDATE/SHARE и
+     *        без вызовов функций, кроме известных неизменяющих.
+     */
+    static bool analyzable(const std::string& query);
+
+    /**
+     * @brief Возвращает порог медленного запроса.
+     */
+    std::chrono::milliseconds threshold() const { return config.threshold; }
+
+    /**
+     * @brief Сообщает о выполненном запросе.
+     * @param query Текст запроса.
+     * @param elapsed Длительность выполнения.
+     * @return True, если запрос поставлен в очередь на сбор плана.
+     */
+    bool report(const std::string& query, std::chrono::steady_clock::duration elapsed);
+
+    /**
+     * @brief Возвращает последние собранные планы (новые в конце).
+     */
+    std::vector<SlowQueryPlan> recent() const;
+
+    /**
+     * @brief Возвращает количество обработанных запросов на сбор плана.
+     */
+    std::size_t captured() const;
+
+    /**
+     * @brief Обрабатывает оставшуюся очередь и останавливает фоновый поток.
+     */
+    void stop();
+};
@@ -0,0 +1,479 @@
+/**
+ * @file SnapshotFile.cpp
+ * @brief Этот файл содержит реализацию SnapshotWriter и SnapshotFile.
+ */
+
+#include "SnapshotFile.h"
+#include "DurableFile.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char SNAPSHOT_MAGIC[8] = {'H', 'O', 'T', 'E', 'L', 'S', 'N', 'P'};
+constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+enum SectionIndex { ROOMS, ROOMS_BY_NUMBER, SERVICES, USERS, BOOKINGS, STRINGS, SECTION_COUNT };
+
+/**
+ * @brief Положение раздела в файле: смещение от начала файла и количество элементов.
+ */
+struct SnapshotSection {
+    std::uint64_t offset;
+    std::uint64_t count;
+};
+
+/**
+ * @brief Заголовок файла снимка. Контрольная сумма покрывает все байты после заголовка.
+ */
+struct SnapshotHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::int64_t createdAt;
+    std::uint64_t fileSize;
+    std::uint64_t checksum;
+    SnapshotSection sections[SECTION_COUNT];
+};
+
+static_assert(std::is_trivially_copyable_v<SnapshotHeader> && sizeof(SnapshotHeader) == 136, "Snapshot header layout");
+static_assert(std::is_trivially_copyable_v<SnapshotRoom> && sizeof(SnapshotRoom) == 40, "Snapshot room layout");
+static_assert(std::is_trivially_copyable_v<SnapshotService> && sizeof(SnapshotService) == 24, "Snapshot service layout");
+static_assert(std::is_trivially_copyable_v<SnapshotUser> && sizeof(SnapshotUser) == 16, "Snapshot user layout");
+static_assert(std::is_trivially_copyable_v<SnapshotBooking> && sizeof(SnapshotBooking) == 32, "Snapshot booking layout");
+
+/**
+ * @brief Контрольная сумма FNV-1a (64 бита).
+ */
+std::uint64_t checksum(const unsigned char* data, std::size_t size) {
+    std::uint64_t hash = 1469598103934665603ull;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash = (hash ^ data[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * @brief Дополняет буфер нулями до границы 8 байт.
+ */
+void align(std::string& out) {
+    out.append((8 - out.size() % 8) % 8, '\0');
+}
+
+/**
+ * @brief Дописывает массив записей в буфер и возвращает его раздел.
+ */
+template <typename T>
+SnapshotSection append(std::string& out, const std::vector<T>& items) {
+    align(out);
+    SnapshotSection section{out.size(), items.size()};
+    out.append(reinterpret_cast<const char*>(items.data()), items.size() * sizeof(T));
+    return section;
+}
+
+/**
+ * @brief Размер элемента раздела в байтах.
+ */
+std::size_t elementSize(int index) {
+    switch (index) {
+        case ROOMS: return sizeof(SnapshotRoom);
+        case ROOMS_BY_NUMBER: return sizeof(std::uint32_t);
+        case SERVICES: return sizeof(SnapshotService);
+        case USERS: return sizeof(SnapshotUser);
+        case BOOKINGS: return sizeof(SnapshotBooking);
+        default: return 1;
+    }
+}
+
+/**
+ * @brief Находит запись по идентификатору в массиве, упорядоченном по id.
+ */
+template <typename T>
+const T* findById(std::span<const T> items, int id) {
+    auto it = std::lower_bound(items.begin(), items.end(), id, [](const T& item, int key) { return item.id < key; });
+    return it != items.end() && it->id == id ? &*it : nullptr;
+}
+
+} // namespace
+
+/**
+ * @brief Сохраняет строку в области строк (повторяющиеся строки хранятся один раз).
+ */
+SnapshotString SnapshotWriter::intern(std::string_view value) {
+    auto it = interned.find(std::string(value));
+    if (it != interned.end()) {
+        return it->second;
+    }
+    SnapshotString ref{static_cast<std::uint32_t>(strings.size()), static_cast<std::uint32_t>(value.size())};
+    strings.append(value);
+    interned.emplace(std::string(value), ref);
+    return ref;
+}
+
+/**
+ * @brief Добавляет номер.
+ */
+void SnapshotWriter::addRoom(int id, int propertyId, std::string_view number, std::string_view type, double pricePerDay,
+                             std::string_view description) {
+    rooms.push_back(SnapshotRoom{id, propertyId, pricePerDay, intern(number), intern(type), intern(description)});
+}
+
+/**
+ * @brief Добавляет услугу.
+ */
+void SnapshotWriter::addService(int id, std::string_view name, double price) {
+    services.push_back(SnapshotService{id, 0, price, intern(name)});
+}
+
+/**
+ * @brief Добавляет пользователя.
+ */
+void SnapshotWriter::addUser(int id, std::string_view login, UserRole role) {
+    users.push_back(SnapshotUser{id, static_cast<std::int32_t>(role), intern(login)});
+}
+
+/**
+ * @brief Добавляет бронирование.
+ * @param dateFrom Дата заезда в формате YYYY-MM-DD.
+ * @param dateTo Дата выезда в формате YYYY-MM-DD.
+ */
+void SnapshotWriter::addBooking(int id, int userId, int roomId, const std::string& dateFrom, const std::string& dateTo,
+                                BookingStatus status, int version) {
+    bookings.push_back(SnapshotBooking{id, userId, roomId, SnapshotFile::packDate(dateFrom), SnapshotFile::packDate(dateTo),
+                                       static_cast<std::int32_t>(status), version, 0});
+}
+
+/**
+ * @brief Записывает снимок в файл: временный файл сбрасывается на диск и атомарно заменяет снимок,
+ *        поэтому после сбоя на диске остается либо прежний, либо новый снимок целиком.
+ * @param path Путь к файлу снимка.
+ * @param createdAt Время создания (секунды Unix).
+ * @throws std::runtime_error При ошибке записи.
+ */
+void SnapshotWriter::write(const std::string& path, std::int64_t createdAt) const {
+    auto byId = [](const auto& a, const auto& b) { return a.id < b.id; };
+    std::vector<SnapshotRoom> sortedRooms = rooms;
+    std::sort(sortedRooms.begin(), sortedRooms.end(), byId);
+    std::vector<SnapshotService> sortedServices = services;
+    std::sort(sortedServices.begin(), sortedServices.end(), byId);
+    std::vector<SnapshotUser> sortedUsers = users;
+    std::sort(sortedUsers.begin(), sortedUsers.end(), byId);
+    std::vector<SnapshotBooking> sortedBookings = bookings;
+    std::sort(sortedBookings.begin(), sortedBookings.end(), [](const SnapshotBooking& a, const SnapshotBooking& b) {
+        return a.roomId != b.roomId ? a.roomId < b.roomId : a.dateFrom < b.dateFrom;
+    });
+
+    auto text = [this](SnapshotString value) { return std::string_view(strings).substr(value.offset, value.length); };
+    std::vector<std::uint32_t> byNumber(sortedRooms.size());
+    std::iota(byNumber.begin(), byNumber.end(), 0u);
+    std::sort(byNumber.begin(), byNumber.end(), [&](std::uint32_t a, std::uint32_t b) {
+        return text(sortedRooms[a].number) < text(sortedRooms[b].number);
+    });
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = SnapshotFile::FORMAT_VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.createdAt = createdAt;
+
+    std::string out(sizeof(SnapshotHeader), '\0');
+    header.sections[ROOMS] = append(out, sortedRooms);
+    header.sections[ROOMS_BY_NUMBER] = append(out, byNumber);
+    header.sections[SERVICES] = append(out, sortedServices);
+    header.sections[USERS] = append(out, sortedUsers);
+    header.sections[BOOKINGS] = append(out, sortedBookings);
+    align(out);
+    header.sections[STRINGS] = SnapshotSection{out.size(), strings.size()};
+    out.append(strings);
+
+    header.fileSize = out.size();
+    header.checksum = checksum(reinterpret_cast<const unsigned char*>(out.data()) + sizeof(SnapshotHeader),
+                               out.size() - sizeof(SnapshotHeader));
+    std::memcpy(out.data(), &header, sizeof(header));
+
+    std::string temporary = path + ".tmp";
+    writeDurably(temporary, out);
+    replaceDurably(temporary, path);
+}
+
+/**
+ * @brief Собирает снимок из базы данных.
+ * Хэши паролей не запрашиваются. Ошибка любого запроса прерывает сборку, чтобы неполный
+ * снимок не заменил предыдущий.
+ * @param dbManager Менеджер базы данных для взаимодействия с БД.
+ * @param today Текущая дата в формате YYYY-MM-DD.
+ * @return Заполненный построитель снимка.
+ * @throws std::runtime_error При ошибке базы данных.
+ */
+SnapshotWriter SnapshotWriter::fromDatabase(DBManager& dbManager, const std::string& today) {
+    SnapshotWriter writer;
+    PGResultWrapper rooms = dbManager.executeRead("SELECT id, property_id, number, type, price_per_day, description FROM rooms;");
+    for (int i = 0; i < PQntuples(rooms.get()); ++i) {
+        writer.addRoom(std::stoi(PQgetvalue(rooms.get(), i, 0)), std::stoi(PQgetvalue(rooms.get(), i, 1)),
+                       PQgetvalue(rooms.get(), i, 2), PQgetvalue(rooms.get(), i, 3),
+                       std::stod(PQgetvalue(rooms.get(), i, 4)), PQgetvalue(rooms.get(), i, 5));
+    }
+    PGResultWrapper services = dbManager.executeRead("SELECT id, name, price FROM services;");
+    for (int i = 0; i < PQntuples(services.get()); ++i) {
+        writer.addService(std::stoi(PQgetvalue(services.get(), i, 0)), PQgetvalue(services.get(), i, 1),
+                          std::stod(PQgetvalue(services.get(), i, 2)));
+    }
+    PGResultWrapper users = dbManager.executeRead("SELECT id, login, role FROM users;");
+    for (int i = 0; i < PQntuples(users.get()); ++i) {
+        std::string role = PQgetvalue(users.get(), i, 2);
+        writer.addUser(std::stoi(PQgetvalue(users.get(), i, 0)), PQgetvalue(users.get(), i, 1),
+                       role == "admin" ? UserRole::ADMIN : role == "manager" ? UserRole::MANAGER : UserRole::USER);
+    }
+    PGResultWrapper bookings = dbManager.executeRead(
+        "SELECT id, user_id, room_id, date_from, date_to, status, version FROM bookings "
+        "WHERE status IN ('pending', 'confirmed') AND date_to >= '" + today + "';");
+    for (int i = 0; i < PQntuples(bookings.get()); ++i) {
+        std::string status = PQgetvalue(bookings.get(), i, 5);
+        writer.addBooking(std::stoi(PQgetvalue(bookings.get(), i, 0)), std::stoi(PQgetvalue(bookings.get(), i, 1)),
+                          std::stoi(PQgetvalue(bookings.get(), i, 2)), PQgetvalue(bookings.get(), i, 3),
+                          PQgetvalue(bookings.get(), i, 4),
+                          status == "confirmed" ? BookingStatus::CONFIRMED : BookingStatus::PENDING,
+                          std::stoi(PQgetvalue(bookings.get(), i, 6)));
+    }
+    return writer;
+}
+
+/**
+ * @brief Отображает файл снимка в память и проверяет его.
+ * @param path Путь к файлу снимка.
+ * @param verifyChecksum Проверить контрольную сумму (читает весь файл).
+ * @throws std::runtime_error Если файл не найден, поврежден или имеет другую версию формата.
+ */
+SnapshotFile::SnapshotFile(const std::string& path, bool verifyChecksum) : base(nullptr), length(0) {
+#ifdef _WIN32
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Cannot open snapshot " + path);
+    }
+    fileHandle = file;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart < static_cast<LONGLONG>(sizeof(SnapshotHeader))) {
+        unmap();
+        throw std::runtime_error("Snapshot is truncated: " + path);
+    }
+    length = static_cast<std::size_t>(size.QuadPart);
+    mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle) {
+        base = static_cast<const unsigned char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    }
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open snapshot " + path);
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(SnapshotHeader))) {
+        ::close(fd);
+        throw std::runtime_error("Snapshot is truncated: " + path);
+    }
+    length = static_cast<std::size_t>(info.st_size);
+    void* mapped = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped != MAP_FAILED) {
+        base = static_cast<const unsigned char*>(mapped);
+    }
+#endif
+    if (!base) {
+        unmap();
+        throw std::runtime_error("Cannot map snapshot " + path);
+    }
+
+    const SnapshotHeader& header = *reinterpret_cast<const SnapshotHeader*>(base);
+    std::string problem;
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+        problem = "not a snapshot file";
+    } else if (header.byteOrder != BYTE_ORDER_MARK) {
+        problem = "byte order mismatch";
+    } else if (header.version != FORMAT_VERSION) {
+        problem = "unsupported format version " + std::to_string(header.version);
+    } else if (header.fileSize != length) {
+        problem = "file size mismatch";
+    } else {
+        for (int index = 0; index < SECTION_COUNT && problem.empty(); ++index) {
+            const SnapshotSection& section = header.sections[index];
+            if (section.offset % 8 != 0 || section.offset < sizeof(SnapshotHeader) || section.offset > length ||
+                section.count > (length - section.offset) / elementSize(index)) {
+                problem = "section out of bounds";
+            }
+        }
+    }
+    if (problem.empty() && verifyChecksum &&
+        checksum(base + sizeof(SnapshotHeader), length - sizeof(SnapshotHeader)) != header.checksum) {
+        problem = "checksum mismatch";
+    }
+    if (!problem.empty()) {
+        unmap();
+        throw std::runtime_error("Invalid snapshot " + path + ": " + problem);
+    }
+}
+
+/**
+ * @brief Деструктор. Снимает отображение файла.
+ */
+SnapshotFile::~SnapshotFile() {
+    unmap();
+}
+
+/**
+ * @brief Снимает отображение и закрывает файл.
+ */
+void SnapshotFile::unmap() {
+#ifdef _WIN32
+    if (base) UnmapViewOfFile(base);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+#else
+    if (base) ::munmap(const_cast<unsigned char*>(base), length);
+#endif
+    base = nullptr;
+}
+
+/**
+ * @brief Возвращает раздел снимка как массив записей.
+ */
+template <typename T>
+std::span<const T> SnapshotFile::section(int index) const {
+    const SnapshotSection& section = reinterpret_cast<const SnapshotHeader*>(base)->sections[index];
+    return std::span<const T>(reinterpret_cast<const T*>(base + section.offset), section.count);
+}
+
+/**
+ * @brief Возвращает время создания снимка (секунды Unix).
+ */
+std::int64_t SnapshotFile::createdAt() const {
+    return reinterpret_cast<const SnapshotHeader*>(base)->createdAt;
+}
+
+std::span<const SnapshotRoom> SnapshotFile::rooms() const { return section<SnapshotRoom>(ROOMS); }
+std::span<const SnapshotService> SnapshotFile::services() const { return section<SnapshotService>(SERVICES); }
+std::span<const SnapshotUser> SnapshotFile::users() const { return section<SnapshotUser>(USERS); }
+std::span<const SnapshotBooking> SnapshotFile::bookings() const { return section<SnapshotBooking>(BOOKINGS); }
+
+/**
+ * @brief Возвращает строку снимка. Ссылка за пределами области строк дает пустую строку.
+ */
+std::string_view SnapshotFile::text(SnapshotString value) const {
+    std::span<const char> strings = section<char>(STRINGS);
+    if (value.offset > strings.size() || value.length > strings.size() - value.offset) {
+        return std::string_view();
+    }
+    return std::string_view(strings.data() + value.offset, value.length);
+}
+
+/**
+ * @brief Находит номер по идентификатору (двоичный поиск).
+ * @return Указатель на запись или nullptr.
+ */
+const SnapshotRoom* SnapshotFile::findRoom(int id) const {
+    return findById(rooms(), id);
+}
+
+/**
+ * @brief Находит номер по номеру комнаты (двоичный поиск по индексу).
+ * @return Указатель на запись или nullptr.
+ */
+const SnapshotRoom* SnapshotFile::findRoomByNumber(std::string_view number) const {
+    std::span<const SnapshotRoom> all = rooms();
+    std::span<const std::uint32_t> index = section<std::uint32_t>(ROOMS_BY_NUMBER);
+    auto it = std::lower_bound(index.begin(), index.end(), number, [&](std::uint32_t position, std::string_view key) {
+        return position < all.size() && text(all[position].number) < key;
+    });
+    if (it == index.end() || *it >= all.size() || text(all[*it].number) != number) {
+        return nullptr;
+    }
+    return &all[*it];
+}
+
+/**
+ * @brief Находит услугу по идентификатору.
+ * @return Указатель на запись или nullptr.
+ */
+const SnapshotService* SnapshotFile::findService(int id) const {
+    return findById(services(), id);
+}
+
+/**
+ * @brief Находит пользователя по идентификатору.
+ * @return Указатель на запись или nullptr.
+ */
+const SnapshotUser* SnapshotFile::findUser(int id) const {
+    return findById(users(), id);
+}
+
+/**
+ * @brief Находит номера без пересекающихся бронирований на момент снимка.
+ * Бронирования упорядочены по номеру, поэтому бронирования каждого номера находятся двоичным поиском.
+ * @param dateFrom Дата заезда в формате YYYY-MM-DD.
+ * @param dateTo Дата выезда в формате YYYY-MM-DD.
+ * @return Свободные номера по возрастанию идентификатора.
+ */
+std::vector<const SnapshotRoom*> SnapshotFile::findAvailableRooms(const std::string& dateFrom, const std::string& dateTo) const {
+    std::int32_t from = packDate(dateFrom);
+    std::int32_t to = packDate(dateTo);
+    std::span<const SnapshotBooking> all = bookings();
+    std::vector<const SnapshotRoom*> available;
+    for (const SnapshotRoom& room : rooms()) {
+        auto first = std::lower_bound(all.begin(), all.end(), room.id,
+                                      [](const SnapshotBooking& booking, int id) { return booking.roomId < id; });
+        bool free = true;
+        for (auto it = first; it != all.end() && it->roomId == room.id && it->dateFrom < to; ++it) {
+            if (it->dateTo > from) {
+                free = false;
+                break;
+            }
+        }
+        if (free) {
+            available.push_back(&room);
+        }
+    }
+    return available;
+}
+
+/**
+ * @brief Переводит дату YYYY-MM-DD в число YYYYMMDD.
+ * @throws std::invalid_argument Если дата имеет неверный формат.
+ */
+std::int32_t SnapshotFile::packDate(const std::string& date) {
+    bool valid = date.size() == 10 && date[4] == '-' && date[7] == '-';
+    for (std::size_t i = 0; valid && i < date.size(); ++i) {
+        valid = i == 4 || i == 7 || std::isdigit(static_cast<unsigned char>(date[i]));
+    }
+    if (!valid) {
+        throw std::invalid_argument("Invalid date: '" + date + "'");
+    }
+    return std::stoi(date.substr(0, 4)) * 10000 + std::stoi(date.substr(5, 2)) * 100 + std::stoi(date.substr(8, 2));
+}
+
+/**
+ * @brief Переводит число YYYYMMDD в дату YYYY-MM-DD.
+ */
+std::string SnapshotFile::unpackDate(std::int32_t date) {
+    char buffer[16];
+    std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d", date / 10000, date / 100 % 100, date % 100);
+    return buffer;
+}
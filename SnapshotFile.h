@@ -0,0 +1,241 @@
+/**
+ * @file SnapshotFile.h
+ * @brief Этот файл содержит формат двоичного снимка справочных данных (номера, услуги, пользователи,
+ *        действующие бронирования), SnapshotWriter для его записи и SnapshotFile для чтения
+ *        через отображение файла в память (mmap) без разбора.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "Booking.h"
+#include "DBManager.h"
+#include "User.h"
+
+/**
+ * @brief Ссылка на строку в области строк снимка.
+ */
+struct SnapshotString {
+    std::uint32_t offset;
+    std::uint32_t length;
+};
+
+/**
+ * @brief Запись номера в снимке.
+ */
+struct SnapshotRoom {
+    std::int32_t id;
+    std::int32_t propertyId;
+    double pricePerDay;
+    SnapshotString number;
+    SnapshotString type;
+    SnapshotString description;
+};
+
+/**
+ * @brief Запись услуги в снимке.
+ */
+struct SnapshotService {
+    std::int32_t id;
+    std::uint32_t reserved;
+    double price;
+    SnapshotString name;
+};
+
+/**
+ * @brief Запись пользователя в снимке. Хэш пароля в снимок не попадает.
+ */
+struct SnapshotUser {
+    std::int32_t id;
+    std::int32_t role;          ///< Значение UserRole.
+    SnapshotString login;
+};
+
+/**
+ * @brief Запись действующего бронирования в снимке. Даты хранятся числом YYYYMMDD.
+ */
+struct SnapshotBooking {
+    std::int32_t id;
+    std::int32_t userId;
+    std::int32_t roomId;
+    std::int32_t dateFrom;
+    std::int32_t dateTo;
+    std::int32_t status;        ///< Значение BookingStatus.
+    std::int32_t version;
+    std::int32_t reserved;
+};
+
+/**
+ * @brief Построение и запись снимка.
+ * Записи копятся в памяти; write() сортирует их (номера и услуги - по идентификатору,
+ * бронирования - по номеру и дате заезда), строит индекс номеров по номеру комнаты и записывает
+ * файл целиком через временный файл, так что читатели никогда не видят частично записанный снимок.
+ */
+class SnapshotWriter {
+private:
+    std::vector<SnapshotRoom> rooms;
+    std::vector<SnapshotService> services;
+    std::vector<SnapshotUser> users;
+    std::vector<SnapshotBooking> bookings;
+    std::string strings;
+    std::unordered_map<std::string, SnapshotString> interned;
+
+    /**
+     * @brief Сохраняет строку в области строк (повторяющиеся строки хранятся один раз).
+     */
+    SnapshotString intern(std::string_view value);
+
+public:
+    /**
+     * @brief Добавляет номер.
+     */
+    void addRoom(int id, int propertyId, std::string_view number, std::string_view type, double pricePerDay,
+                 std::string_view description);
+
+    /**
+     * @brief Добавляет услугу.
+     */
+    void addService(int id, std::string_view name, double price);
+
+    /**
+     * @brief Добавляет пользователя.
+     */
+    void addUser(int id, std::string_view login, UserRole role);
+
+    /**
+     * @brief Добавляет бронирование.
+     * @param dateFrom Дата заезда в формате YYYY-MM-DD.
+     * @param dateTo Дата выезда в формате YYYY-MM-DD.
+     */
+    void addBooking(int id, int userId, int roomId, const std::string& dateFrom, const std::string& dateTo,
+                    BookingStatus status, int version);
+
+    /**
+     * @brief Записывает снимок в файл.
+     * @param path Путь к файлу снимка.
+     * @param createdAt Время создания (секунды Unix).
+     * @throws std::runtime_error При ошибке записи.
+     */
+    void write(const std::string& path, std::int64_t createdAt) const;
+
+    /**
+     * @brief Собирает снимок из базы данных: все номера, услуги и пользователи, а также
+     *        неотмененные и незавершенные бронирования с датой выезда не раньше today.
+     * @param dbManager Менеджер базы данных для взаимодействия с БД.
+     * @param today Текущая дата в формате YYYY-MM-DD.
+     * @return Заполненный построитель снимка.
+     * @throws std::runtime_error При ошибке базы данных.
+     */
+    static SnapshotWriter fromDatabase(DBManager& dbManager, const std::string& today);
+};
+
+/**
+ * @brief Снимок, отображенный в память только для чтения.
+ * Записи читаются прямо из отображенных страниц: методы возвращают указатели и std::string_view
+ * на данные файла, действительные, пока жив объект. Открытие проверяет сигнатуру, версию формата,
+ * порядок байт, границы разделов и (по умолчанию) контрольную сумму.
+ */
+class SnapshotFile {
+public:
+    static constexpr std::uint32_t FORMAT_VERSION = 1;
+
+private:
+    const unsigned char* base;
+    std::size_t length;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+
+    /**
+     * @brief Возвращает раздел снимка как массив записей.
+     */
+    template <typename T>
+    std::span<const T> section(int index) const;
+
+    /**
+     * @brief Снимает отображение и закрывает файл.
+     */
+    void unmap();
+
+public:
+    /**
+     * @brief Отображает файл снимка в память.
+     * @param path Путь к файлу снимка.
+     * @param verifyChecksum Проверить контрольную сумму (читает весь файл).
+     * @throws std::runtime_error Если файл не найден, поврежден или имеет другую версию формата.
+     */
+    explicit SnapshotFile(const std::string& path, bool verifyChecksum = true);
+
+    /**
+     * @brief Снимает отображение файла.
+     */
+    ~SnapshotFile();
+
+    SnapshotFile(const SnapshotFile&) = delete;
+    SnapshotFile& operator=(const SnapshotFile&) = delete;
+
+    /**
+     * @brief Возвращает время создания снимка (секунды Unix).
+     */
+    std::int64_t createdAt() const;
+
+    std::span<const SnapshotRoom> rooms() const;
+    std::span<const SnapshotService> services() const;
+    std::span<const SnapshotUser> users() const;
+    std::span<const SnapshotBooking> bookings() const;
+
+    /**
+     * @brief Возвращает строку снимка.
+     */
+    std::string_view text(SnapshotString value) const;
+
+    /**
+     * @brief Находит номер по идентификатору (двоичный поиск).
+     * @return Указатель на запись или nullptr.
+     */
+    const SnapshotRoom* findRoom(int id) const;
+
+    /**
+     * @brief Находит номер по номеру комнаты (двоичный поиск по индексу).
+     * @return Указатель на запись или nullptr.
+     */
+    const SnapshotRoom* findRoomByNumber(std::string_view number) const;
+
+    /**
+     * @brief Находит услугу по идентификатору.
+     * @return Указатель на запись или nullptr.
+     */
+    const SnapshotService* findService(int id) const;
+
+    /**
+     * @brief Находит пользователя по идентификатору.
+     * @return Указатель на запись или nullptr.
+     */
+    const SnapshotUser* findUser(int id) const;
+
+    /**
+     * @brief Находит номера без пересекающихся бронирований на момент снимка.
+     * @param dateFrom Дата заезда в формате YYYY-MM-DD.
+     * @param dateTo Дата выезда в формате YYYY-MM-DD.
+     * @return Свободные номера по возрастанию идентификатора.
+     */
+    std::vector<const SnapshotRoom*> findAvailableRooms(const std::string& dateFrom, const std::string& dateTo) const;
+
+    /**
+     * @brief Переводит дату YYYY-MM-DD в число YYYYMMDD.
+     * @throws std::invalid_argument Если дата имеет неверный формат.
+     */
+    static std::int32_t packDate(const std::string& date);
+
+    /**
+     * @brief Переводит число YYYYMMDD в дату YYYY-MM-DD.
+     */
+    static std::string unpackDate(std::int32_t date);
+};
@@ -0,0 +1,152 @@
+/**
+ * @file SnapshotScan.cpp
+ * @brief Этот файл содержит реализацию класса SnapshotScan.
+ */
+
+#include "SnapshotScan.h"
+#include "Logger.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+
+namespace {
+
+/**
+ * @brief Сколько ждать свободного соединения для дополнительного читателя.
+ */
+constexpr std::chrono::milliseconds WORKER_ACQUIRE_TIMEOUT{100};
+
+/**
+ * @brief Читает диапазоны, пока они не закончатся.
+ * @param db Соединение, уже находящееся в транзакции со снимком.
+ * @param ranges Все диапазоны.
+ * @param next Индекс следующего свободного диапазона.
+ * @param query Построитель запроса для диапазона.
+ * @param results Результаты по индексам диапазонов.
+ */
+void drainRanges(DBManager& db, const std::vector<ScanRange>& ranges, std::atomic<std::size_t>& next,
+                 const SnapshotScan::QueryBuilder& query, std::vector<PGResultWrapper>& results) {
+    while (true) {
+        std::size_t index = next.fetch_add(1);
+        if (index >= ranges.size()) {
+            return;
+        }
+        results[index] = db.executeQuery(query(ranges[index]));
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Конструктор параллельного чтения.
+ * @param pool Пул соединений; соединения берутся на время чтения.
+ * @param scheduler Планировщик, выполняющий чтение дополнительными соединениями.
+ * @param parallelism Количество соединений, включая ведущее.
+ */
+SnapshotScan::SnapshotScan(ConnectionPool& pool, TaskScheduler& scheduler, std::size_t parallelism)
+    : pool(pool), scheduler(scheduler), parallelism(std::max<std::size_t>(1, parallelism)) {}
+
+/**
+ * @brief Делит отрезок [first, last] на не более parts непересекающихся полуинтервалов.
+ * Части отличаются по длине не больше чем на единицу.
+ * @param first Наименьшее значение ключа.
+ * @param last Наибольшее значение ключа.
+ * @param parts Желаемое количество частей.
+ * @return Полуинтервалы по возрастанию, вместе покрывающие [first, last].
+ */
+std::vector<ScanRange> SnapshotScan::splitRange(long long first, long long last, std::size_t parts) {
+    std::vector<ScanRange> ranges;
+    if (last < first || parts == 0) {
+        return ranges;
+    }
+    unsigned long long span = static_cast<unsigned long long>(last - first) + 1;
+    unsigned long long count = std::min<unsigned long long>(parts, span);
+    unsigned long long base = span / count;
+    unsigned long long extra = span % count;
+    long long lower = first;
+    for (unsigned long long i = 0; i < count; ++i) {
+        long long size = static_cast<long long>(base + (i < extra ? 1 : 0));
+        ranges.push_back(ScanRange{lower, lower + size});
+        lower += size;
+    }
+    return ranges;
+}
+
+/**
+ * @brief Выполняет запрос для каждого диапазона в общем снимке.
+ * Дополнительные соединения начинают транзакцию, принимают снимок ведущего и разбирают
+ * диапазоны из общей очереди. Ведущая транзакция остается открытой, пока все читатели
+ * не закончат: снимок действителен только до ее завершения.
+ * @param bounds Запрос, возвращающий одну строку (min, max) ключа; выполняется в снимке.
+ * @param query Строит запрос для диапазона (запрос должен упорядочивать строки по ключу).
+ * @param rangeCount Количество диапазонов (0 - по четыре на соединение).
+ * @return Результаты по диапазонам в порядке возрастания ключа.
+ * @throw std::runtime_error При ошибке любого из запросов.
+ */
+std::vector<PGResultWrapper> SnapshotScan::run(const std::string& bounds, const QueryBuilder& query, std::size_t rangeCount) {
+    ConnectionPool::Lease leader = pool.acquire();
+    leader->beginTransaction(IsolationLevel::REPEATABLE_READ, true);
+    try {
+        PGResultWrapper snapshotResult = leader->executeQuery("SELECT pg_export_snapshot();");
+        std::string snapshot = PQgetvalue(snapshotResult.get(), 0, 0);
+
+        PGResultWrapper boundsResult = leader->executeQuery(bounds);
+        std::vector<PGResultWrapper> results;
+        if (PQntuples(boundsResult.get()) != 1 || PQgetisnull(boundsResult.get(), 0, 0)) {
+            leader->commit();
+            return results; // таблица пуста
+        }
+        long long first = std::atoll(PQgetvalue(boundsResult.get(), 0, 0));
+        long long last = std::atoll(PQgetvalue(boundsResult.get(), 0, 1));
+
+        std::vector<ConnectionPool::Lease> workers;
+        for (std::size_t i = 1; i < parallelism; ++i) {
+            ConnectionPool::Lease worker = pool.tryAcquire(WORKER_ACQUIRE_TIMEOUT);
+            if (!worker) {
+                break;
+            }
+            workers.push_back(std::move(worker));
+        }
+
+        std::vector<ScanRange> ranges = splitRange(first, last, rangeCount ? rangeCount : (workers.size() + 1) * 4);
+        results.reserve(ranges.size());
+        for (std::size_t i = 0; i < ranges.size(); ++i) {
+            results.emplace_back(nullptr);
+        }
+        std::atomic<std::size_t> next{0};
+
+        TaskGroup group(scheduler);
+        for (auto& worker : workers) {
+            DBManager* db = worker.get();
+            group.run([db, &snapshot, &ranges, &next, &query, &results] {
+                db->beginTransaction(IsolationLevel::REPEATABLE_READ, true);
+                try {
+                    db->executeQuery("SET TRANSACTION SNAPSHOT '" + snapshot + "';");
+                    drainRanges(*db, ranges, next, query, results);
+                    db->commit();
+                } catch (const std::exception&) {
+                    db->rollback();
+                    throw;
+                }
+            });
+        }
+        try {
+            drainRanges(*leader, ranges, next, query, results);
+        } catch (const std::exception&) {
+            next.store(ranges.size()); // остальные читатели прекращают работу
+            group.wait();
+            throw;
+        }
+        group.wait();
+        leader->commit();
+        return results;
+    } catch (const std::exception&) {
+        try {
+            leader->rollback();
+        } catch (const std::exception& e) {
+            Logger::severe("Snapshot scan rollback failed: {}", e.what());
+        }
+        throw;
+    }
+}
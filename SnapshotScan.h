@@ -0,0 +1,69 @@
+/**
+ * @file SnapshotScan.h
+ * @brief Этот файл содержит объявление класса SnapshotScan - параллельного согласованного чтения
+ *        таблицы несколькими соединениями через экспортированный снимок (pg_export_snapshot).
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+#include "ConnectionPool.h"
+#include "DBManager.h"
+#include "TaskScheduler.h"
+
+/**
+ * @brief Полуинтервал значений ключа [lower, upper).
+ */
+struct ScanRange {
+    long long lower;
+    long long upper;
+};
+
+/**
+ * @brief Параллельное чтение с одним снимком данных.
+ * Ведущее соединение открывает транзакцию REPEATABLE READ и экспортирует ее снимок; остальные
+ * соединения принимают его командой SET TRANSACTION SNAPSHOT, поэтому все части чтения видят
+ * базу данных на один и тот же момент. Диапазоны раздаются соединениям по мере освобождения,
+ * а результаты возвращаются в порядке диапазонов. Ведущее соединение тоже читает диапазоны.
+ */
+class SnapshotScan {
+public:
+    using QueryBuilder = std::function<std::string(const ScanRange&)>;
+
+private:
+    ConnectionPool& pool;
+    TaskScheduler& scheduler;
+    std::size_t parallelism;
+
+public:
+    /**
+     * @brief Конструирует параллельное чтение.
+     * @param pool Пул соединений; соединения берутся на время чтения.
+     * @param scheduler Планировщик, выполняющий чтение дополнительными соединениями.
+     * @param parallelism Количество соединений, включая ведущее.
+     */
+    SnapshotScan(ConnectionPool& pool, TaskScheduler& scheduler, std::size_t parallelism);
+
+    /**
+     * @brief Выполняет запрос для каждого диапазона в общем снимке.
+     * Если в пуле не хватает соединений, чтение выполняется меньшим их числом.
+     * @param bounds Запрос, возвращающий одну строку (min, max) ключа; выполняется в снимке.
+     * @param query Строит запрос для диапазона (запрос должен упорядочивать строки по ключу).
+     * @param rangeCount Количество диапазонов (0 - по четыре на соединение).
+     * @return Результаты по диапазонам в порядке возрастания ключа.
+     * @throw std::runtime_error При ошибке любого из запросов.
+     */
+    std::vector<PGResultWrapper> run(const std::string& bounds, const QueryBuilder& query, std::size_t rangeCount = 0);
+
+    /**
+     * @brief Делит отрезок [first, last] на не более parts непересекающихся полуинтервалов.
+     * @param first Наименьшее значение ключа.
+     * @param last Наибольшее значение ключа.
+     * @param parts Желаемое количество частей.
+     * @return Полуинтервалы по возрастанию, вместе покрывающие [first, last].
+     */
+    static std::vector<ScanRange> splitRange(long long first, long long last, std::size_t parts);
+};
@@ -0,0 +1,177 @@
+/**
+ * @file Task.h
+ * @brief Этот файл содержит шаблон Task - ленивую сопрограмму C++20, результат которой
+ *        получается через co_await. Используется асинхронным API базы данных.
+ */
+
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+template <typename T>
+class Task;
+
+namespace detail {
+
+/**
+ * @brief Ожидание завершения сопрограммы: передает управление ожидающей сопрограмме
+ *        (симметричная передача управления, без роста стека).
+ */
+struct FinalAwaiter {
+    bool await_ready() const noexcept { return false; }
+
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) const noexcept {
+        std::coroutine_handle<> continuation = handle.promise().continuation;
+        return continuation ? continuation : std::noop_coroutine();
+    }
+
+    void await_resume() const noexcept {}
+};
+
+/**
+ * @brief Общая часть обещания Task: продолжение и исключение.
+ */
+struct TaskPromiseBase {
+    std::coroutine_handle<> continuation;   ///< Сопрограмма, ожидающая результата.
+    std::exception_ptr error;               ///< Исключение, выброшенное телом сопрограммы.
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() { error = std::current_exception(); }
+};
+
+} // namespace detail
+
+/**
+ * @brief Ленивая сопрограмма с результатом типа T.
+ * Тело начинает выполняться при первом co_await (или при start()). Исключение тела
+ * передается ожидающей стороне. Объект Task владеет кадром сопрограммы.
+ * @tparam T Тип результата (void для сопрограмм без результата).
+ */
+template <typename T>
+class Task {
+public:
+    struct promise_type : detail::TaskPromiseBase {
+        std::optional<T> value;
+
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+
+        template <typename U>
+        void return_value(U&& result) { value.emplace(std::forward<U>(result)); }
+    };
+
+private:
+    std::coroutine_handle<promise_type> handle;
+
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+public:
+    Task() = default;
+    Task(Task&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle) handle.destroy();
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() {
+        if (handle) handle.destroy();
+    }
+
+    /**
+     * @brief Запускает сопрограмму до первой точки приостановки (для задач верхнего уровня).
+     */
+    void start() { handle.resume(); }
+
+    /**
+     * @brief Проверяет, завершилась ли сопрограмма.
+     */
+    bool done() const { return !handle || handle.done(); }
+
+    /**
+     * @brief Возвращает результат завершившейся сопрограммы или выбрасывает ее исключение.
+     */
+    T result() {
+        if (handle.promise().error) {
+            std::rethrow_exception(handle.promise().error);
+        }
+        return std::move(*handle.promise().value);
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        return handle;
+    }
+
+    T await_resume() { return result(); }
+};
+
+/**
+ * @brief Специализация Task для сопрограмм без результата.
+ */
+template <>
+class Task<void> {
+public:
+    struct promise_type : detail::TaskPromiseBase {
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        void return_void() {}
+    };
+
+private:
+    std::coroutine_handle<promise_type> handle;
+
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+public:
+    Task() = default;
+    Task(Task&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle) handle.destroy();
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() {
+        if (handle) handle.destroy();
+    }
+
+    /**
+     * @brief Запускает сопрограмму до первой точки приостановки (для задач верхнего уровня).
+     */
+    void start() { handle.resume(); }
+
+    /**
+     * @brief Проверяет, завершилась ли сопрограмма.
+     */
+    bool done() const { return !handle || handle.done(); }
+
+    /**
+     * @brief Выбрасывает исключение завершившейся сопрограммы, если оно было.
+     */
+    void result() {
+        if (handle.promise().error) {
+            std::rethrow_exception(handle.promise().error);
+        }
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        return handle;
+    }
+
+    void await_resume() { result(); }
+};
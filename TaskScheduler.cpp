@@ -0,0 +1,334 @@
+/**
+ * @file TaskScheduler.cpp
+ * @brief Этот файл содержит реализацию классов TaskScheduler, TaskGroup и функции parallelFor.
+ */
+
+#include "TaskScheduler.h"
+#include "Logger.h"
+#include <algorithm>
+
+namespace {
+
+thread_local const TaskScheduler* currentScheduler = nullptr; ///< Планировщик рабочего потока.
+thread_local int currentIndex = -1;                           ///< Индекс рабочего потока.
+
+} // namespace
+
+/**
+ * @brief Конструктор. Запускает рабочие потоки.
+ * @param threadCount Количество рабочих потоков (0 - по числу ядер).
+ * @param queueCapacity Емкость общей очереди внешних задач.
+ */
+TaskScheduler::TaskScheduler(std::size_t threadCount, std::size_t queueCapacity)
+    : capacity(queueCapacity ? queueCapacity : 1), queued(0), sleeping(0), stopping(false),
+      helperExecuted(0), submittedCount(0), rejectedCount(0) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (std::size_t i = 0; i < threadCount; ++i) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    for (std::size_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back(&TaskScheduler::workerLoop, this, static_cast<int>(i));
+    }
+}
+
+/**
+ * @brief Деструктор. Рабочие потоки выполняют оставшиеся задачи и завершаются.
+ */
+TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+/**
+ * @brief Возвращает индекс рабочего потока этого планировщика, выполняющего вызов, или -1.
+ */
+int TaskScheduler::currentWorker() const {
+    return currentScheduler == this ? currentIndex : -1;
+}
+
+/**
+ * @brief Будит один спящий рабочий поток.
+ * Счетчик queued увеличивается до проверки sleeping, а поток перед сном увеличивает sleeping
+ * до проверки queued, поэтому хотя бы одна сторона видит изменение другой.
+ */
+void TaskScheduler::notifyWorker() {
+    if (sleeping.load() > 0) {
+        { std::lock_guard<std::mutex> lock(sleepMutex); }
+        wakeUp.notify_one();
+    }
+}
+
+/**
+ * @brief Кладет задачу в очередь текущего рабочего потока или в общую очередь.
+ * @param job Задача.
+ * @param bounded Ждать ли места в общей очереди.
+ */
+void TaskScheduler::enqueue(Job job, bool bounded) {
+    int self = currentWorker();
+    queued.fetch_add(1);
+    if (self >= 0) {
+        std::lock_guard<std::mutex> lock(workers[self]->mutex);
+        workers[self]->jobs.push_back(std::move(job));
+    } else {
+        std::unique_lock<std::mutex> lock(injectionMutex);
+        while (bounded && injection.size() >= capacity) {
+            notFull.wait_for(lock, std::chrono::milliseconds(10));
+        }
+        injection.push_back(std::move(job));
+    }
+    submittedCount.fetch_add(1, std::memory_order_relaxed);
+    notifyWorker();
+}
+
+/**
+ * @brief Ставит задачу. Из внешнего потока ждет места в общей очереди.
+ * @param job Задача.
+ */
+void TaskScheduler::submit(Job job) {
+    enqueue(std::move(job), true);
+}
+
+/**
+ * @brief Пытается поставить задачу без ожидания.
+ * @param job Задача.
+ * @return False, если общая очередь заполнена.
+ */
+bool TaskScheduler::trySubmit(Job job) {
+    if (currentWorker() < 0) {
+        std::lock_guard<std::mutex> lock(injectionMutex);
+        if (injection.size() >= capacity) {
+            rejectedCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+    enqueue(std::move(job), false);
+    return true;
+}
+
+/**
+ * @brief Берет задачу для потока: своя очередь (с конца), общая очередь, перехват у других (с начала).
+ * @param self Индекс рабочего потока или -1 для внешнего потока.
+ * @param job Заполняется найденной задачей.
+ * @return True, если задача найдена.
+ */
+bool TaskScheduler::findJob(int self, Job& job) {
+    if (self >= 0) {
+        Worker& own = *workers[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            job = std::move(own.jobs.back());
+            own.jobs.pop_back();
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(injectionMutex);
+        if (!injection.empty()) {
+            job = std::move(injection.front());
+            injection.pop_front();
+            queued.fetch_sub(1);
+            notFull.notify_one();
+            return true;
+        }
+    }
+    std::size_t count = workers.size();
+    std::size_t start = self >= 0 ? static_cast<std::size_t>(self) + 1 : 0;
+    for (std::size_t k = 0; k < count; ++k) {
+        std::size_t victimIndex = (start + k) % count;
+        if (static_cast<int>(victimIndex) == self) {
+            continue;
+        }
+        Worker& victim = *workers[victimIndex];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            queued.fetch_sub(1);
+            if (self >= 0) {
+                workers[self]->steals.fetch_add(1, std::memory_order_relaxed);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Выполняет задачу. Исключение задачи записывается в журнал и не останавливает поток.
+ * @param self Индекс рабочего потока или -1 для внешнего потока.
+ * @param job Задача.
+ */
+void TaskScheduler::execute(int self, Job& job) {
+    try {
+        job();
+    } catch (const std::exception& e) {
+        Logger::severe("Scheduled task failed: {}", e.what());
+    } catch (...) {
+        Logger::severe("Scheduled task failed with unknown exception");
+    }
+    if (self >= 0) {
+        workers[self]->executed.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        helperExecuted.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Выполняет одну готовую задачу в вызывающем потоке (помощь при ожидании).
+ * @return True, если задача была выполнена.
+ */
+bool TaskScheduler::runPending() {
+    int self = currentWorker();
+    Job job;
+    if (!findJob(self, job)) {
+        return false;
+    }
+    execute(self, job);
+    return true;
+}
+
+/**
+ * @brief Цикл рабочего потока: выполняет задачи, пока они есть, иначе спит до уведомления.
+ * При остановке поток завершается только после того, как все очереди опустеют.
+ * @param index Индекс рабочего потока.
+ */
+void TaskScheduler::workerLoop(int index) {
+    currentScheduler = this;
+    currentIndex = index;
+    Worker& self = *workers[index];
+    while (true) {
+        Job job;
+        if (findJob(index, job)) {
+            execute(index, job);
+            continue;
+        }
+        if (stopping.load() && queued.load() <= 0) {
+            break;
+        }
+        auto idleStart = std::chrono::steady_clock::now();
+        {
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleeping.fetch_add(1);
+            wakeUp.wait_for(lock, std::chrono::milliseconds(50), [this] { return queued.load() > 0 || stopping.load(); });
+            sleeping.fetch_sub(1);
+        }
+        auto idle = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - idleStart);
+        self.idleNanos.fetch_add(idle.count(), std::memory_order_relaxed);
+    }
+    currentScheduler = nullptr;
+    currentIndex = -1;
+}
+
+/**
+ * @brief Возвращает статистику планировщика.
+ */
+SchedulerStats TaskScheduler::stats() const {
+    SchedulerStats result;
+    result.submitted = submittedCount.load(std::memory_order_relaxed);
+    result.rejected = rejectedCount.load(std::memory_order_relaxed);
+    result.executed = helperExecuted.load(std::memory_order_relaxed);
+    std::int64_t idle = 0;
+    for (const auto& worker : workers) {
+        result.executed += worker->executed.load(std::memory_order_relaxed);
+        result.steals += worker->steals.load(std::memory_order_relaxed);
+        idle += worker->idleNanos.load(std::memory_order_relaxed);
+    }
+    result.queueDepth = static_cast<std::size_t>(std::max<std::int64_t>(0, queued.load()));
+    result.idleTime = std::chrono::nanoseconds(idle);
+    return result;
+}
+
+/**
+ * @brief Конструктор группы.
+ * @param scheduler Планировщик, выполняющий задачи группы.
+ */
+TaskGroup::TaskGroup(TaskScheduler& scheduler) : scheduler(scheduler), state(std::make_shared<State>()) {}
+
+/**
+ * @brief Деструктор. Ждет незавершенные задачи группы.
+ */
+TaskGroup::~TaskGroup() {
+    while (state->pending.load(std::memory_order_acquire) > 0) {
+        if (!scheduler.runPending()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+/**
+ * @brief Ставит задачу группы. Исключение задачи сохраняется для wait().
+ * @param job Задача.
+ */
+void TaskGroup::run(TaskScheduler::Job job) {
+    state->pending.fetch_add(1, std::memory_order_relaxed);
+    std::shared_ptr<State> shared = state;
+    scheduler.submit([shared, job = std::move(job)] {
+        try {
+            job();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(shared->errorMutex);
+            if (!shared->error) {
+                shared->error = std::current_exception();
+            }
+        }
+        shared->pending.fetch_sub(1, std::memory_order_release);
+    });
+}
+
+/**
+ * @brief Ждет завершения всех задач группы, выполняя тем временем готовые задачи планировщика.
+ * @throws Первое исключение, выброшенное задачей группы.
+ */
+void TaskGroup::wait() {
+    while (state->pending.load(std::memory_order_acquire) > 0) {
+        if (!scheduler.runPending()) {
+            std::this_thread::yield();
+        }
+    }
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(state->errorMutex);
+        std::swap(error, state->error);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+/**
+ * @brief Выполняет body(begin, end) для поддиапазонов [first, last) и ждет завершения всех частей.
+ * Последняя часть выполняется в вызывающем потоке.
+ * @param scheduler Планировщик.
+ * @param first Начало диапазона.
+ * @param last Конец диапазона (не включительно).
+ * @param grain Максимальный размер части (0 - выбрать по числу потоков).
+ * @param body Функция вида void(std::size_t begin, std::size_t end).
+ */
+void parallelFor(TaskScheduler& scheduler, std::size_t first, std::size_t last, std::size_t grain,
+                 const std::function<void(std::size_t, std::size_t)>& body) {
+    if (last <= first) {
+        return;
+    }
+    std::size_t total = last - first;
+    if (grain == 0) {
+        grain = std::max<std::size_t>(1, total / (scheduler.threadCount() * 4));
+    }
+    TaskGroup group(scheduler);
+    std::size_t begin = first;
+    while (last - begin > grain) {
+        std::size_t end = begin + grain;
+        group.run([&body, begin, end] { body(begin, end); });
+        begin = end;
+    }
+    body(begin, last);
+    group.wait();
+}
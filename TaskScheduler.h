@@ -0,0 +1,212 @@
+/**
+ * @file TaskScheduler.h
+ * @brief Этот файл содержит объявление класса TaskScheduler - общего пула потоков с перехватом работы
+ *        (work stealing), а также TaskGroup для структурного ожидания задач и parallelFor.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Статистика планировщика.
+ */
+struct SchedulerStats {
+    std::uint64_t submitted = 0;    ///< Задач принято (submit, trySubmit, задачи из рабочих потоков).
+    std::uint64_t rejected = 0;     ///< Отказов trySubmit из-за заполненной очереди.
+    std::uint64_t executed = 0;     ///< Задач выполнено.
+    std::uint64_t steals = 0;       ///< Задач перехвачено из очередей других потоков.
+    std::size_t queueDepth = 0;     ///< Задач в очередях на момент снятия статистики.
+    std::chrono::nanoseconds idleTime{0}; ///< Суммарное время простоя рабочих потоков.
+};
+
+/**
+ * @brief Планировщик задач с перехватом работы.
+ * У каждого рабочего потока своя очередь: поток кладет порожденные задачи в ее конец и берет
+ * оттуда же (LIFO, горячий кэш), а простаивающие потоки перехватывают задачи с начала чужих
+ * очередей (FIFO, самые крупные части работы). Задачи извне попадают в общую очередь
+ * ограниченного размера: submit ждет освобождения места, trySubmit сразу возвращает false.
+ * Задачи, порожденные внутри рабочих потоков, ограничением не сдерживаются, чтобы
+ * структурное ожидание не могло заблокировать пул.
+ */
+class TaskScheduler {
+public:
+    using Job = std::function<void()>;
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+        std::atomic<std::uint64_t> executed{0};
+        std::atomic<std::uint64_t> steals{0};
+        std::atomic<std::int64_t> idleNanos{0};
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+
+    std::mutex injectionMutex;
+    std::condition_variable notFull;
+    std::deque<Job> injection;
+    std::size_t capacity;
+
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+    std::atomic<std::int64_t> queued;
+    std::atomic<int> sleeping;
+    std::atomic<bool> stopping;
+    std::atomic<std::uint64_t> helperExecuted;
+    std::atomic<std::uint64_t> submittedCount;
+    std::atomic<std::uint64_t> rejectedCount;
+
+    /**
+     * @brief Возвращает индекс рабочего потока этого планировщика, выполняющего вызов, или -1.
+     */
+    int currentWorker() const;
+
+    /**
+     * @brief Кладет задачу в очередь текущего рабочего потока или в общую очередь.
+     */
+    void enqueue(Job job, bool bounded);
+
+    /**
+     * @brief Берет задачу для потока: своя очередь, общая очередь, перехват.
+     * @param self Индекс рабочего потока или -1 для внешнего потока.
+     * @param job Заполняется найденной задачей.
+     * @return True, если задача найдена.
+     */
+    bool findJob(int self, Job& job);
+
+    /**
+     * @brief Выполняет задачу, перехватывая исключения.
+     */
+    void execute(int self, Job& job);
+
+    /**
+     * @brief Будит один спящий рабочий поток.
+     */
+    void notifyWorker();
+
+    /**
+     * @brief Цикл рабочего потока.
+     */
+    void workerLoop(int index);
+
+public:
+    /**
+     * @brief Запускает рабочие потоки.
+     * @param threadCount Количество рабочих потоков (0 - по числу ядер).
+     * @param queueCapacity Емкость общей очереди внешних задач.
+     */
+    explicit TaskScheduler(std::size_t threadCount = 0, std::size_t queueCapacity = 1024);
+
+    /**
+     * @brief Дожидается выполнения всех поставленных задач и останавливает рабочие потоки.
+     */
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    /**
+     * @brief Ставит задачу. Из внешнего потока ждет места в общей очереди.
+     * @param job Задача.
+     */
+    void submit(Job job);
+
+    /**
+     * @brief Пытается поставить задачу без ожидания.
+     * @param job Задача.
+     * @return False, если общая очередь заполнена.
+     */
+    bool trySubmit(Job job);
+
+    /**
+     * @brief Выполняет одну готовую задачу в вызывающем потоке (помощь при ожидании).
+     * @return True, если задача была выполнена.
+     */
+    bool runPending();
+
+    /**
+     * @brief Возвращает количество рабочих потоков.
+     */
+    std::size_t threadCount() const { return workers.size(); }
+
+    /**
+     * @brief Возвращает статистику планировщика.
+     */
+    SchedulerStats stats() const;
+};
+
+/**
+ * @brief Группа задач со структурным ожиданием.
+ * wait() не возвращает управление, пока не завершатся все задачи группы; ожидающий поток
+ * тем временем выполняет готовые задачи планировщика. Первое исключение задачи
+ * выбрасывается из wait(). Деструктор ждет незавершенные задачи.
+ */
+class TaskGroup {
+private:
+    struct State {
+        std::atomic<std::size_t> pending{0};
+        std::mutex errorMutex;
+        std::exception_ptr error;
+    };
+
+    TaskScheduler& scheduler;
+    std::shared_ptr<State> state;
+
+public:
+    /**
+     * @brief Конструирует пустую группу.
+     * @param scheduler Планировщик, выполняющий задачи группы.
+     */
+    explicit TaskGroup(TaskScheduler& scheduler);
+
+    /**
+     * @brief Ждет завершения задач группы (исключения при этом не выбрасываются).
+     */
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    /**
+     * @brief Ставит задачу группы.
+     * @param job Задача.
+     */
+    void run(TaskScheduler::Job job);
+
+    /**
+     * @brief Ждет завершения всех задач группы.
+     * @throws Первое исключение, выброшенное задачей группы.
+     */
+    void wait();
+
+    /**
+     * @brief Возвращает количество незавершенных задач группы.
+     */
+    std::size_t pending() const { return state->pending.load(std::memory_order_acquire); }
+};
+
+/**
+ * @brief Выполняет body(begin, end) для поддиапазонов [first, last), разбивая его на части
+ *        не больше grain элементов, и ждет завершения всех частей.
+ * @param scheduler Планировщик.
+ * @param first Начало диапазона.
+ * @param last Конец диапазона (не включительно).
+ * @param grain Максимальный размер части (0 - выбрать по числу потоков).
+ * @param body Функция вида void(std::size_t begin, std::size_t end).
+ */
+void parallelFor(TaskScheduler& scheduler, std::size_t first, std::size_t last, std::size_t grain,
+                 const std::function<void(std::size_t, std::size_t)>& body);
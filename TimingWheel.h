@@ -0,0 +1,99 @@
+/**
+ * @file TimingWheel.h
+ * @brief Этот файл содержит шаблон TimingWheel - хэшированное колесо таймеров
+ *        для истечения большого количества объектов по времени (сессии, временные удержания).
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Хэшированное колесо таймеров.
+ * Время измеряется в тиках; запись с моментом истечения t попадает в слот t % slotCount.
+ * Постановка записи - O(1), продвижение на один тик обрабатывает только один слот.
+ * Отмена ленивая: вызывающая сторона проверяет актуальность записи в обработчике истечения
+ * и при необходимости ставит ее заново.
+ * @tparam Key Тип ключа записи.
+ */
+template <typename Key>
+class TimingWheel {
+private:
+    struct Entry {
+        Key key;
+        std::uint64_t expiresAt;
+    };
+
+    std::vector<std::vector<Entry>> slots;
+    std::uint64_t currentTick;
+    std::size_t count;
+
+public:
+    /**
+     * @brief Конструирует колесо.
+     * @param slotCount Количество слотов.
+     * @param startTick Начальный тик.
+     */
+    explicit TimingWheel(std::size_t slotCount = 512, std::uint64_t startTick = 0)
+        : slots(slotCount ? slotCount : 1), currentTick(startTick), count(0) {}
+
+    /**
+     * @brief Ставит запись на истечение.
+     * Записи с уже наступившим моментом истекают при следующем продвижении колеса.
+     * @param key Ключ записи.
+     * @param expiresAt Тик истечения.
+     */
+    void schedule(Key key, std::uint64_t expiresAt) {
+        if (expiresAt <= currentTick) {
+            expiresAt = currentTick + 1;
+        }
+        slots[expiresAt % slots.size()].push_back(Entry{std::move(key), expiresAt});
+        ++count;
+    }
+
+    /**
+     * @brief Продвигает колесо до указанного тика и вызывает обработчик для каждой истекшей записи.
+     * Обработчик может ставить новые записи через schedule.
+     * @param toTick Новый текущий тик.
+     * @param onExpire Обработчик вида void(const Key&).
+     * @return Количество истекших записей.
+     */
+    template <typename OnExpire>
+    std::size_t advance(std::uint64_t toTick, OnExpire&& onExpire) {
+        if (toTick <= currentTick) {
+            return 0;
+        }
+        std::uint64_t steps = std::min<std::uint64_t>(toTick - currentTick, slots.size());
+        std::uint64_t from = currentTick;
+        currentTick = toTick;
+        std::size_t expired = 0;
+        std::vector<Entry> due;
+        for (std::uint64_t i = 1; i <= steps; ++i) {
+            std::vector<Entry>& slot = slots[(from + i) % slots.size()];
+            auto split = std::partition(slot.begin(), slot.end(),
+                                        [toTick](const Entry& e) { return e.expiresAt > toTick; });
+            due.insert(due.end(), std::make_move_iterator(split), std::make_move_iterator(slot.end()));
+            slot.erase(split, slot.end());
+        }
+        count -= due.size();
+        for (const Entry& entry : due) {
+            onExpire(entry.key);
+            ++expired;
+        }
+        return expired;
+    }
+
+    /**
+     * @brief Возвращает текущий тик колеса.
+     */
+    std::uint64_t now() const { return currentTick; }
+
+    /**
+     * @brief Возвращает количество записей в колесе.
+     */
+    std::size_t size() const { return count; }
+};
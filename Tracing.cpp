@@ -0,0 +1,233 @@
+/**
+ * @file Tracing.cpp
+ * @brief Этот файл содержит реализацию трассировщика и выгрузки в формате Chrome trace-event JSON.
+ */
+
+#include "Tracing.h"
+#include "HttpMessage.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Кольцевой буфер событий одного потока.
+ * Мьютекс берет только поток-владелец и выгрузка, поэтому он практически всегда свободен.
+ */
+struct ThreadBuffer {
+    std::mutex mutex;
+    std::vector<TraceEvent> events;
+    std::uint64_t written = 0;
+    int tid = 0;
+    std::string threadName;
+    bool exited = false;
+};
+
+/**
+ * @brief Общий список буферов потоков.
+ */
+struct BufferRegistry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    int nextTid = 1;
+};
+
+BufferRegistry& registry() {
+    static BufferRegistry instance;
+    return instance;
+}
+
+/**
+ * @brief Владеет буфером потока и отмечает буфер при завершении потока.
+ */
+struct ThreadSlot {
+    std::shared_ptr<ThreadBuffer> buffer;
+    std::string threadName; ///< Имя, заданное до создания буфера.
+
+    ~ThreadSlot() {
+        if (buffer) {
+            std::lock_guard<std::mutex> lock(buffer->mutex);
+            buffer->exited = true;
+        }
+    }
+};
+
+thread_local ThreadSlot slot;
+
+/**
+ * @brief Возвращает буфер текущего потока, создавая и регистрируя его при первом обращении.
+ */
+ThreadBuffer& currentBuffer() {
+    if (!slot.buffer) {
+        auto buffer = std::make_shared<ThreadBuffer>();
+        buffer->events.resize(Tracer::BUFFER_EVENTS);
+        buffer->threadName = slot.threadName;
+        BufferRegistry& shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        buffer->tid = shared.nextTid++;
+        shared.buffers.push_back(buffer);
+        slot.buffer = std::move(buffer);
+    }
+    return *slot.buffer;
+}
+
+/**
+ * @brief Момент запуска трассировщика (начало отсчета времени событий).
+ */
+const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+/**
+ * @brief Переводит наносекунды в микросекунды с дробной частью (единица ts/dur формата).
+ */
+std::string micros(std::uint64_t nanoseconds) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%llu.%03llu", static_cast<unsigned long long>(nanoseconds / 1000),
+                  static_cast<unsigned long long>(nanoseconds % 1000));
+    return text;
+}
+
+} // namespace
+
+/**
+ * @brief Включает или выключает трассировку. Уже записанные события сохраняются.
+ */
+void Tracer::setEnabled(bool on) {
+    active.store(on, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Задает имя текущего потока в выгрузке. Буфер при этом не создается.
+ */
+void Tracer::setThreadName(const std::string& name) {
+    slot.threadName = name;
+    if (slot.buffer) {
+        std::lock_guard<std::mutex> lock(slot.buffer->mutex);
+        slot.buffer->threadName = name;
+    }
+}
+
+/**
+ * @brief Возвращает время в наносекундах от запуска трассировщика.
+ */
+std::uint64_t Tracer::now() {
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
+}
+
+/**
+ * @brief Записывает событие в буфер текущего потока, затирая самое старое при переполнении.
+ */
+void Tracer::record(const TraceEvent& event) {
+    ThreadBuffer& buffer = currentBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.events[buffer.written % BUFFER_EVENTS] = event;
+    ++buffer.written;
+}
+
+/**
+ * @brief Возвращает количество событий, хранящихся во всех буферах.
+ */
+std::size_t Tracer::eventCount() {
+    BufferRegistry& shared = registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    std::size_t count = 0;
+    for (const auto& buffer : shared.buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        count += static_cast<std::size_t>(std::min<std::uint64_t>(buffer->written, BUFFER_EVENTS));
+    }
+    return count;
+}
+
+/**
+ * @brief Возвращает события всех потоков в формате Chrome trace-event JSON.
+ * Каждая область - событие "X" (начало и длительность в микросекундах), имена потоков -
+ * метаданные "M". События одного потока идут в порядке записи.
+ */
+std::string Tracer::chromeJson() {
+    BufferRegistry& shared = registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    std::ostringstream out;
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    auto separator = [&] {
+        if (!first) out << ",";
+        first = false;
+        out << "\n";
+    };
+    for (const auto& buffer : shared.buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        if (!buffer->threadName.empty()) {
+            separator();
+            out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid
+                << ",\"args\":{\"name\":\"" << jsonEscape(buffer->threadName) << "\"}}";
+        }
+        std::uint64_t stored = std::min<std::uint64_t>(buffer->written, BUFFER_EVENTS);
+        for (std::uint64_t i = buffer->written - stored; i < buffer->written; ++i) {
+            const TraceEvent& event = buffer->events[i % BUFFER_EVENTS];
+            separator();
+            out << "{\"name\":\"" << jsonEscape(event.name) << "\",\"cat\":\"" << jsonEscape(event.category)
+                << "\",\"ph\":\"X\",\"ts\":" << micros(event.startNs) << ",\"dur\":" << micros(event.durationNs)
+                << ",\"pid\":1,\"tid\":" << buffer->tid;
+            if (event.detail[0] != '\0') {
+                out << ",\"args\":{\"detail\":\"" << jsonEscape(event.detail) << "\"}";
+            }
+            out << "}";
+        }
+    }
+    out << "\n]}\n";
+    return out.str();
+}
+
+/**
+ * @brief Записывает выгрузку в файл.
+ * @return False, если файл не удалось записать.
+ */
+bool Tracer::writeChromeTrace(const std::string& path) {
+    std::ofstream out(path, std::ios::trunc);
+    out << chromeJson();
+    return static_cast<bool>(out);
+}
+
+/**
+ * @brief Удаляет записанные события и буферы завершившихся потоков.
+ */
+void Tracer::clear() {
+    BufferRegistry& shared = registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    auto last = std::remove_if(shared.buffers.begin(), shared.buffers.end(), [](const std::shared_ptr<ThreadBuffer>& buffer) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        buffer->written = 0;
+        return buffer->exited;
+    });
+    shared.buffers.erase(last, shared.buffers.end());
+}
+
+/**
+ * @brief Заполняет событие и засекает начало.
+ */
+void TraceSpan::begin(const char* name, const char* category, std::string_view detail) {
+    event.name = name;
+    event.category = category;
+    std::size_t length = std::min(detail.size(), TraceEvent::DETAIL_SIZE - 1);
+    while (length < detail.size() && length > 0 && (static_cast<unsigned char>(detail[length]) & 0xC0) == 0x80) {
+        --length; // не разрезаем многобайтовый символ UTF-8
+    }
+    std::memcpy(event.detail, detail.data(), length);
+    event.detail[length] = '\0';
+    event.startNs = Tracer::now();
+}
+
+/**
+ * @brief Засекает длительность и записывает событие.
+ */
+void TraceSpan::finish() {
+    event.durationNs = Tracer::now() - event.startNs;
+    Tracer::record(event);
+}
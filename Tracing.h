@@ -0,0 +1,134 @@
+/**
+ * @file Tracing.h
+ * @brief Этот файл содержит трассировку операций: области (TraceSpan) записываются в кольцевые
+ *        буферы потоков и выгружаются в формате Chrome trace-event JSON (chrome://tracing, Perfetto).
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Завершенная область трассировки.
+ * Поля не инициализируются по умолчанию, чтобы выключенная область ничего не заполняла.
+ */
+struct TraceEvent {
+    static constexpr std::size_t DETAIL_SIZE = 48;
+
+    const char* name;          ///< Имя области (строковый литерал).
+    const char* category;      ///< Категория: ui, entity, db.
+    std::uint64_t startNs;     ///< Начало, нс от запуска трассировщика.
+    std::uint64_t durationNs;  ///< Длительность, нс.
+    char detail[DETAIL_SIZE];  ///< Подробность (например, начало SQL-запроса), обрезается.
+};
+
+/**
+ * @brief Трассировщик процесса.
+ * Каждый поток пишет в собственный кольцевой буфер на BUFFER_EVENTS событий (при переполнении
+ * затираются самые старые), поэтому потоки не конкурируют между собой. Буфер создается при первой
+ * записи из потока и переживает поток до выгрузки. Пока трассировка выключена, область стоит
+ * одного чтения атомарного флага.
+ */
+class Tracer {
+public:
+    static constexpr std::size_t BUFFER_EVENTS = 4096;
+
+private:
+    inline static std::atomic<bool> active{false};
+
+public:
+    /**
+     * @brief Проверяет, включена ли трассировка.
+     */
+    static bool enabled() { return active.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Включает или выключает трассировку. Уже записанные события сохраняются.
+     */
+    static void setEnabled(bool on);
+
+    /**
+     * @brief Задает имя текущего потока в выгрузке.
+     */
+    static void setThreadName(const std::string& name);
+
+    /**
+     * @brief Возвращает время в наносекундах от запуска трассировщика.
+     */
+    static std::uint64_t now();
+
+    /**
+     * @brief Записывает событие в буфер текущего потока.
+     */
+    static void record(const TraceEvent& event);
+
+    /**
+     * @brief Возвращает количество событий, хранящихся во всех буферах.
+     */
+    static std::size_t eventCount();
+
+    /**
+     * @brief Возвращает события всех потоков в формате Chrome trace-event JSON.
+     */
+    static std::string chromeJson();
+
+    /**
+     * @brief Записывает выгрузку в файл.
+     * @return False, если файл не удалось записать.
+     */
+    static bool writeChromeTrace(const std::string& path);
+
+    /**
+     * @brief Удаляет записанные события и буферы завершившихся потоков.
+     */
+    static void clear();
+};
+
+/**
+ * @brief Область трассировки: от создания до уничтожения объекта.
+ * Создается, только если трассировка включена в момент входа в область.
+ */
+class TraceSpan {
+private:
+    TraceEvent event;
+    bool recording;
+
+    /**
+     * @brief Заполняет событие и засекает начало.
+     */
+    void begin(const char* name, const char* category, std::string_view detail);
+
+    /**
+     * @brief Засекает длительность и записывает событие.
+     */
+    void finish();
+
+public:
+    /**
+     * @brief Открывает область.
+     * @param name Имя области (строковый литерал, например "Booking::createBooking").
+     * @param category Категория (строковый литерал).
+     * @param detail Подробность; копируется с обрезкой до TraceEvent::DETAIL_SIZE - 1 символов.
+     */
+    TraceSpan(const char* name, const char* category, std::string_view detail = {}) : recording(Tracer::enabled()) {
+        if (recording) {
+            begin(name, category, detail);
+        }
+    }
+
+    /**
+     * @brief Закрывает область и записывает событие.
+     */
+    ~TraceSpan() {
+        if (recording) {
+            finish();
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+};
@@ -9,11 +9,19 @@
 #include "Room.h"
 #include "Booking.h"
 #include "Service.h"
+#include "RolloverJob.h"
+#include "SessionManager.h"
+#include "Bill.h"
+#include "SnapshotFile.h"
+#include "Metrics.h"
+#include "Tracing.h"
+#include <chrono>
 #include <iostream>
 #include <iomanip>
 #include <vector>
 #include <limits>
 #include <regex>
+#include <ctime>
 
 /**
  * @brief Отображает детали конкретного бронирования.
@@ -22,6 +30,13 @@
  */
 void displayBooking(DBManager& db, Booking& booking);
 
+/**
+ * @brief Отображает детали бронирования, загруженного в арену.
+ * @param db Ссылка на объект DBManager для получения связанных данных (комната).
+ * @param booking Строка бронирования для отображения.
+ */
+void displayBooking(DBManager& db, const BookingRow& booking);
+
 /**
  * @brief Отображает детали конкретного номера.
  * @param room Объект Room для отображения.
@@ -35,11 +50,11 @@ void displayRoom(const Room& room);
 void displayService(const Service& service);
 
 /**
- * @brief Проверяет, является ли строка допустимой датой в формате YYYY-MM-DD.
- * @param date Строка для проверки.
- * @return True, если строка является действительной датой, иначе false.
+ * @brief Выводит сообщение о результате изменения бронирования с проверкой версии.
+ * @param result Результат изменения.
+ * @param successMessage Сообщение при успешном изменении.
  */
-bool isValidDate(const std::string& date);
+void printUpdateResult(UpdateResult result, const std::string& successMessage);
 
 
 /**
@@ -68,6 +83,9 @@ void showAdminMenu() {
               << "8. Add New Room\n"
               << "9. View All Services\n"
               << "10. Add New Service\n"
+              << "11. Run Nightly Rollover\n"
+              << "12. View System Statistics\n"
+              << "13. Start/Save Operation Trace\n"
               << "0. Logout\n"
               << "======================\n";
 }
@@ -104,18 +122,21 @@ void showUserMenu() {
 /**
  * @brief Обрабатывает процесс входа пользователя в систему.
  * Запрашивает логин и пароль, затем пытается аутентифицировать пользователя через DBManager.
- * Если аутентификация успешна, устанавливает текущего пользователя.
+ * Если аутентификация успешна, открывает сессию пользователя в контексте.
  * @param db Ссылка на объект DBManager для взаимодействия с базой данных.
+ * @param ctx Контекст сессии, в котором открывается сессия пользователя.
  * @return True, если вход выполнен успешно, иначе false.
  */
-bool login(DBManager& db) {
+bool login(DBManager& db, SessionContext& ctx) {
+    TraceSpan span("login", "ui");
     std::string login, password;
     std::cout << "\n===== Login =====\nUsername: ";
     std::cin >> login;
     std::cout << "Password: ";
     std::cin >> password;
     
-    if (User::authenticate(db, login, password)) {
+    if (auto user = User::authenticate(db, login, password)) {
+        ctx.login(std::move(user));
         std::cout << "Login successful!" << std::endl;
         return true;
     }
@@ -128,13 +149,16 @@ bool login(DBManager& db) {
  * Если текущий пользователь является администратором, позволяет выбрать роль для нового пользователя.
  * В противном случае новый пользователь регистрируется с ролью USER по умолчанию.
  * @param db Ссылка на объект DBManager для взаимодействия с базой данных.
+ * @param ctx Контекст сессии текущего пользователя.
  * @return True, если регистрация успешна, иначе false.
  */
-bool registerUser(DBManager& db) {
+bool registerUser(DBManager& db, SessionContext& ctx) {
+    TraceSpan span("registerUser", "ui");
     std::string login, password;
     UserRole role = UserRole::USER; // Default role
 
-    User* admin = User::getCurrentUser();
+    auto session = ctx.session();
+    User* admin = session ? session->user.get() : nullptr;
     if (admin != nullptr && admin->getRole() == UserRole::ADMIN) {
         std::cout << "\n===== Admin: Register New User =====\n";
         int roleChoice = 0;
@@ -175,13 +199,15 @@ bool registerUser(DBManager& db) {
  * @param db Ссылка на объект DBManager для взаимодействия с базой данных.
  */
 void viewAllBookings(DBManager& db) {
+    TraceSpan span("viewAllBookings", "ui");
     std::cout << "\n--- All Bookings ---" << std::endl;
-    std::vector<Booking> bookings = Booking::getAllBookings(db);
+    QueryArena arena;
+    std::pmr::vector<BookingRow> bookings = Booking::getAllBookings(db, arena);
     if (bookings.empty()) {
         std::cout << "No bookings found." << std::endl;
         return;
     }
-    for (auto& booking : bookings) {
+    for (const auto& booking : bookings) {
         displayBooking(db, booking);
     }
 }
@@ -192,6 +218,7 @@ void viewAllBookings(DBManager& db) {
  * @param db Ссылка на объект DBManager для взаимодействия с базой данных.
  */
 void manageBooking(DBManager& db) {
+    TraceSpan span("manageBooking", "ui");
     int bookingId;
     std::cout << "Enter booking ID to manage: ";
     std::cin >> bookingId;
@@ -213,8 +240,9 @@ void manageBooking(DBManager& db) {
         case 3: newStatus = BookingStatus::COMPLETED; break;
         default: std::cout << "Invalid choice." << std::endl; return;
     }
-    booking->updateStatus(db, newStatus);
-    std::cout << "Booking status updated." << std::endl;
+    // Новый статус выбран по показанному статусу, поэтому изменение не повторяется: если бронирование
+    // изменили после загрузки, решение нужно принять заново.
+    printUpdateResult(booking->updateStatus(db, newStatus), "Booking status updated.");
 }
 
 /**
@@ -223,6 +251,7 @@ void manageBooking(DBManager& db) {
  * @param db Ссылка на объект DBManager для взаимодействия с базой данных.
  */
 void addServiceToBooking(DBManager& db) {
+    TraceSpan span("addServiceToBooking", "ui");
     int bookingId, serviceId, quantity;
     std::cout << "Enter booking ID: ";
     std::cin >> bookingId;
@@ -240,52 +269,67 @@ void addServiceToBooking(DBManager& db) {
     std::cout << "Enter quantity: ";
     std::cin >> quantity;
 
-    booking->addService(db, serviceId, quantity);
-    std::cout << "Service added." << std::endl;
+    // Первая попытка проверяет версию, которую видел пользователь. Добавление количества не зависит
+    // от других изменений услуг, поэтому при конфликте его можно повторить по перечитанной версии,
+    // но только пока статус бронирования остался показанным: иначе конфликт окончательный.
+    std::unique_ptr<Booking> current = std::move(booking);
+    const BookingStatus seenStatus = current->getStatus();
+    UpdateResult result = retryOnConflict([&](RetryControl& control) {
+        if (!current) {
+            current = Booking::findBookingById(db, bookingId);
+            if (!current) {
+                return UpdateResult::NOT_FOUND;
+            }
+            if (current->getStatus() != seenStatus) {
+                control.stop();
+                return UpdateResult::CONFLICT;
+            }
+        }
+        UpdateResult attempt = current->addService(db, serviceId, quantity);
+        current.reset();
+        return attempt;
+    });
+    printUpdateResult(result, "Service added.");
 }
 
+/**
+ * @brief Крайний срок расчета счета: все запросы расчета вместе должны уложиться в него.
+ */
+static constexpr std::chrono::seconds BILL_TIMEOUT{5};
+
 /**
  * @brief Рассчитывает и отображает итоговый счет для конкретного бронирования.
  * Учитывает стоимость номера и стоимость добавленных услуг.
  * @param db Ссылка на объект DBManager для взаимодействия с базой данных.
  */
 void calculateBill(DBManager& db) {
+    TraceSpan span("calculateBill", "ui");
     int bookingId;
     std::cout << "Enter booking ID to calculate bill: ";
     std::cin >> bookingId;
-    auto booking = Booking::findBookingById(db, bookingId);
-    if (!booking) {
-        std::cout << "Booking not found." << std::endl;
+    std::unique_ptr<Bill> bill;
+    try {
+        bill = Bill::forBooking(db, bookingId, Deadline::after(BILL_TIMEOUT));
+    } catch (const QueryTimeoutError& e) {
+        std::cerr << "Bill calculation timed out: " << e.what() << std::endl;
         return;
     }
-
-    auto room = Room::findRoomById(db, booking->getRoomId());
-    if (!room) {
-        std::cout << "Room associated with booking not found." << std::endl;
+    if (!bill) {
+        std::cout << "Booking or its room not found." << std::endl;
         return;
     }
 
-    long days = 1;
-    double roomCost = room->getPricePerDay() * days;
-    double servicesCost = 0;
-
-    std::cout << "\n--- Bill for Booking #" << booking->getId() << " ---" << std::endl;
-    std::cout << "Room: " << room->getNumber() << " (" << room->getType() << ") for " << days << " day(s): $" << roomCost << std::endl;
+    std::cout << "\n--- Bill for Booking #" << bill->getBookingId() << " ---" << std::endl;
+    std::cout << "Room: " << bill->getRoomNumber() << " (" << bill->getRoomType() << ") for " << bill->getDays() << " day(s): $" << bill->getRoomCost() << std::endl;
     
-    std::map<int, int> bookingServices = booking->getServices(db);
-    if (!bookingServices.empty()) {
+    if (!bill->getLines().empty()) {
         std::cout << "Services:" << std::endl;
-        for (auto const& [s_id, qty] : bookingServices) {
-            auto service = Service::findServiceById(db, s_id);
-            if (service) {
-                double cost = service->getPrice() * qty;
-                servicesCost += cost;
-                std::cout << "  - " << service->getName() << " (x" << qty << "): $" << cost << std::endl;
-            }
+        for (const auto& line : bill->getLines()) {
+            std::cout << "  - " << line.name << " (x" << line.quantity << "): $" << line.cost << std::endl;
         }
     }
     std::cout << "--------------------" << std::endl;
-    std::cout << "Total cost: $" << (roomCost + servicesCost) << std::endl;
+    std::cout << "Total cost: $" << bill->getTotal() << std::endl;
 }
 
 /**
@@ -294,6 +338,7 @@ void calculateBill(DBManager& db) {
  * @param db Ссылка на объект DBManager для взаимодействия с базой данных.
  */
 void viewAvailableRooms(DBManager& db) {
+    TraceSpan span("viewAvailableRooms", "ui");
     std::string dateFrom, dateTo;
 
     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
@@ -317,15 +362,11 @@ void viewAvailableRooms(DBManager& db) {
     }
 
     std::cout << "\n--- Available Rooms ---" << std::endl;
-    std::vector<Room> allRooms = Room::getAllRooms(db);
-    bool anyAvailable = false;
-    for (const auto& room : allRooms) {
-        if (Booking::isRoomAvailable(db, room.getId(), dateFrom, dateTo)) {
-            displayRoom(room);
-            anyAvailable = true;
-        }
+    std::vector<Room> availableRooms = Room::findAvailableRooms(db, dateFrom, dateTo);
+    for (const auto& room : availableRooms) {
+        displayRoom(room);
     }
-    if (!anyAvailable) {
+    if (availableRooms.empty()) {
         std::cout << "No rooms available for the selected dates." << std::endl;
     }
 }
@@ -334,9 +375,12 @@ void viewAvailableRooms(DBManager& db) {
  * @brief Позволяет пользователю создать новое бронирование.
  * Запрашивает ID комнаты и даты заезда/выезда, затем пытается создать бронирование.
  * @param db Ссылка на объект DBManager для взаимодействия с базой данных.
+ * @param ctx Контекст сессии текущего пользователя.
  */
-void makeBooking(DBManager& db) {
-    User* currentUser = User::getCurrentUser();
+void makeBooking(DBManager& db, SessionContext& ctx) {
+    TraceSpan span("makeBooking", "ui");
+    auto session = ctx.session();
+    User* currentUser = session ? session->user.get() : nullptr;
     if (!currentUser) {
         std::cout << "Error: You must be logged in to make a booking." << std::endl;
         return;
@@ -396,9 +440,12 @@ void makeBooking(DBManager& db) {
 /**
  * @brief Просматривает все бронирования текущего вошедшего пользователя.
  * @param db Ссылка на объект DBManager для взаимодействия с базой данных.
+ * @param ctx Контекст сессии текущего пользователя.
  */
-void viewMyBookings(DBManager& db) {
-    User* currentUser = User::getCurrentUser();
+void viewMyBookings(DBManager& db, SessionContext& ctx) {
+    TraceSpan span("viewMyBookings", "ui");
+    auto session = ctx.session();
+    User* currentUser = session ? session->user.get() : nullptr;
     if (!currentUser) {
         std::cout << "Error: You must be logged in to view bookings." << std::endl;
         return;
@@ -441,6 +488,21 @@ void displayBooking(DBManager& db, Booking& booking) {
     std::cout << "--------------------" << std::endl;
 }
 
+/**
+ * @brief Отображает подробную информацию о бронировании, загруженном в арену.
+ * @param db Ссылка на объект DBManager для получения информации о номере.
+ * @param booking Строка бронирования для отображения.
+ */
+void displayBooking(DBManager& db, const BookingRow& booking) {
+    std::cout << "\n--------------------" << std::endl;
+    std::cout << "Booking ID: " << booking.id << std::endl;
+    auto room = Room::findRoomById(db, booking.roomId);
+    std::cout << "Room: " << (room ? room->getNumber() : "N/A") << std::endl;
+    std::cout << "Dates: " << booking.dateFrom << " to " << booking.dateTo << std::endl;
+    std::cout << "Status: " << Booking::statusToString(booking.status) << std::endl;
+    std::cout << "--------------------" << std::endl;
+}
+
 /**
  * @brief Отображает подробную информацию об услуге.
  * @param service Объект Service для отображения.
@@ -452,13 +514,34 @@ void displayService(const Service& service) {
 }
 
 /**
- * @brief Проверяет, соответствует ли строка формату даты YYYY-MM-DD.
+ * @brief Выводит сообщение о результате изменения бронирования с проверкой версии.
+ * @param result Результат изменения.
+ * @param successMessage Сообщение при успешном изменении.
+ */
+void printUpdateResult(UpdateResult result, const std::string& successMessage) {
+    switch (result) {
+        case UpdateResult::OK: std::cout << successMessage << std::endl; break;
+        case UpdateResult::CONFLICT: std::cout << "Booking is being modified by another user. Please try again." << std::endl; break;
+        case UpdateResult::NOT_FOUND: std::cout << "Booking not found." << std::endl; break;
+    }
+}
+
+/**
+ * @brief Проверяет, является ли строка существующей датой в формате YYYY-MM-DD.
+ * Кроме формата проверяется календарь: 2025-02-30 и 2024-13-01 отклоняются, 2024-02-29 допустима.
  * @param date Строка для проверки.
- * @return True, если формат даты корректен, иначе false.
+ * @return True, если строка является действительной датой, иначе false.
  */
 bool isValidDate(const std::string& date) {
-    const std::regex pattern(R"((\d{4})-(\d{2})-(\d{2}))");
-    return std::regex_match(date, pattern);
+    static const std::regex pattern(R"((\d{4})-(\d{2})-(\d{2}))");
+    std::smatch parts;
+    if (!std::regex_match(date, parts, pattern)) {
+        return false;
+    }
+    std::chrono::year_month_day day{std::chrono::year(std::stoi(parts[1].str())),
+                                    std::chrono::month(static_cast<unsigned>(std::stoi(parts[2].str()))),
+                                    std::chrono::day(static_cast<unsigned>(std::stoi(parts[3].str())))};
+    return day.ok();
 }
 
 /**
@@ -467,8 +550,10 @@ bool isValidDate(const std::string& date) {
  * @param db Ссылка на объект DBManager для взаимодействия с базой данных.
  */
 void manageUserRoles(DBManager& db) {
+    TraceSpan span("manageUserRoles", "ui");
     std::cout << "\n--- User Role Management ---" << std::endl;
-    std::vector<User> users = User::getAllUsers(db);
+    QueryArena arena;
+    std::pmr::vector<UserRow> users = User::getAllUsers(db, arena);
 
     if (users.empty()) {
         std::cout << "No users found in the system." << std::endl;
@@ -479,9 +564,9 @@ void manageUserRoles(DBManager& db) {
     std::cout << std::left << std::setw(5) << "ID" << std::setw(20) << "Login" << std::setw(10) << "Role" << std::endl;
     std::cout << "------------------------------------" << std::endl;
     for (const auto& user : users) {
-        std::cout << std::left << std::setw(5) << user.getId() 
-                  << std::setw(20) << user.getLogin() 
-                  << std::setw(10) << user.getRoleString() << std::endl;
+        std::cout << std::left << std::setw(5) << user.id
+                  << std::setw(20) << user.login
+                  << std::setw(10) << User::roleToString(user.role) << std::endl;
     }
     std::cout << "------------------------------------" << std::endl;
 
@@ -558,8 +643,10 @@ void manageUserRoles(DBManager& db) {
  * @param db Ссылка на объект DBManager для взаимодействия с базой данных.
  */
 void viewAllRooms(DBManager& db) {
+    TraceSpan span("viewAllRooms", "ui");
     std::cout << "\n--- All Rooms ---" << std::endl;
-    std::vector<Room> rooms = Room::getAllRooms(db);
+    QueryArena arena;
+    std::pmr::vector<RoomRow> rooms = Room::getAllRooms(db, arena);
     if (rooms.empty()) {
         std::cout << "No rooms found." << std::endl;
         return;
@@ -571,11 +658,11 @@ void viewAllRooms(DBManager& db) {
     std::cout << "------------------------------------------------------------------------" << std::endl;
     
     for (const auto& room : rooms) {
-        std::cout << std::left << std::setw(5) << room.getId() 
-                  << std::setw(10) << room.getNumber()
-                  << std::setw(15) << room.getType()
-                  << std::setw(10) << "$" + std::to_string(room.getPricePerDay())
-                  << std::setw(30) << room.getDescription() << std::endl;
+        std::cout << std::left << std::setw(5) << room.id
+                  << std::setw(10) << room.number
+                  << std::setw(15) << room.type
+                  << std::setw(10) << "$" + std::to_string(room.pricePerDay)
+                  << std::setw(30) << room.description << std::endl;
     }
 }
 
@@ -585,6 +672,7 @@ void viewAllRooms(DBManager& db) {
  * @param db Ссылка на объект DBManager для взаимодействия с базой данных.
  */
 void addRoom(DBManager& db) {
+    TraceSpan span("addRoom", "ui");
     std::string number, type, description;
     double pricePerDay;
     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
@@ -624,6 +712,7 @@ void addRoom(DBManager& db) {
  * @param db Ссылка на объект DBManager для взаимодействия с базой данных.
  */
 void viewAllServices(DBManager& db) {
+    TraceSpan span("viewAllServices", "ui");
     std::cout << "\n--- All Services ---" << std::endl;
     std::vector<Service> services = Service::getAllServices(db);
     if (services.empty()) {
@@ -648,6 +737,7 @@ void viewAllServices(DBManager& db) {
  * @param db Ссылка на объект DBManager для взаимодействия с базой данных.
  */
 void addService(DBManager& db) {
+    TraceSpan span("addService", "ui");
     std::string name;
     double price;
     
@@ -673,4 +763,153 @@ void addService(DBManager& db) {
     } else {
         std::cout << "Failed to add service. Service name might already exist." << std::endl;
     }
-} 
\ No newline at end of file
+} 
+
+/**
+ * @brief Запускает ночную смену статусов бронирований вручную.
+ * Прошедшие подтвержденные проживания завершаются, неподтвержденные бронирования с наступившей датой заезда отменяются.
+ * @param db Ссылка на объект DBManager для взаимодействия с базой данных.
+ */
+void runNightlyRollover(DBManager& db) {
+    TraceSpan span("runNightlyRollover", "ui");
+    std::cout << "\n--- Nightly Rollover ---" << std::endl;
+    try {
+        RolloverJob job(db);
+        RolloverReport report = job.runOnce(RolloverJob::today());
+        std::cout << "Completed: " << report.completed << std::endl;
+        std::cout << "Cancelled: " << report.cancelled << std::endl;
+        std::cout << "Batches: " << report.batches << std::endl;
+        std::cout << "Partitions created: " << report.partitionsCreated << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Rollover error: " << e.what() << std::endl;
+    }
+}
+
+/**
+ * @brief Показывает статистику работы системы по реестру метрик (доступно только администраторам).
+ * Счетчики накоплены с момента запуска процесса; для гистограмм выводятся количество,
+ * среднее и оценки перцентилей по границам корзин.
+ */
+void viewSystemStats() {
+    TraceSpan span("viewSystemStats", "ui");
+    std::cout << "\n--- System Statistics ---" << std::endl;
+    std::vector<MetricSample> samples = MetricsRegistry::global().samples();
+    if (samples.empty()) {
+        std::cout << "No metrics recorded yet." << std::endl;
+        return;
+    }
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& sample : samples) {
+        std::string name = sample.labels.empty() ? sample.name : sample.name + "{" + sample.labels + "}";
+        std::cout << std::left << std::setw(64) << name << std::right;
+        if (sample.kind == MetricKind::HISTOGRAM) {
+            std::cout << "count " << static_cast<std::uint64_t>(sample.value) << ", mean " << sample.meanMs
+                      << " ms, p50 <= " << sample.p50Ms << " ms, p99 <= " << sample.p99Ms << " ms";
+        } else {
+            std::cout << static_cast<std::int64_t>(sample.value);
+        }
+        std::cout << std::endl;
+    }
+    std::cout << std::defaultfloat;
+}
+
+/**
+ * @brief Включает трассировку операций или, если она уже включена, сохраняет записанные
+ *        области в файл Chrome trace-event JSON и начинает запись заново.
+ * Файл открывается в chrome://tracing или ui.perfetto.dev.
+ * @param path Путь к файлу трассировки.
+ */
+void saveOperationTrace(const std::string& path) {
+    if (!Tracer::enabled()) {
+        Tracer::clear();
+        Tracer::setEnabled(true);
+        std::cout << "Operation tracing started. Choose this item again to save the trace." << std::endl;
+        return;
+    }
+    std::size_t events = Tracer::eventCount();
+    if (!Tracer::writeChromeTrace(path)) {
+        std::cerr << "Failed to write trace file " << path << std::endl;
+        return;
+    }
+    Tracer::clear();
+    std::cout << "Saved " << events << " spans to " << path << std::endl;
+}
+
+/**
+ * @brief Работает в режиме только для чтения по снимку, когда база данных недоступна.
+ * Свободные номера определяются по бронированиям на момент снимка, поэтому результат может
+ * быть устаревшим; бронирование в этом режиме невозможно.
+ * @param snapshot Отображенный в память снимок.
+ */
+void browseOffline(const SnapshotFile& snapshot) {
+    std::time_t created = static_cast<std::time_t>(snapshot.createdAt());
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M", std::localtime(&created));
+    std::cout << "Database is unavailable. Read-only mode using the snapshot of " << stamp << "." << std::endl;
+
+    auto readDate = [](const char* prompt) {
+        std::string date;
+        std::cout << prompt;
+        while (std::getline(std::cin, date) && !isValidDate(date)) {
+            std::cout << "Invalid format. Please use YYYY-MM-DD: ";
+        }
+        return date;
+    };
+    auto printRoom = [&](const SnapshotRoom& room) {
+        std::cout << "Room ID: " << room.id
+                  << ", Number: " << snapshot.text(room.number)
+                  << ", Type: " << snapshot.text(room.type)
+                  << ", Price: $" << room.pricePerDay << std::endl;
+    };
+
+    while (true) {
+        std::cout << "\n--- Read-only Menu ---" << std::endl;
+        std::cout << "1. View all rooms" << std::endl;
+        std::cout << "2. View available rooms" << std::endl;
+        std::cout << "3. View all services" << std::endl;
+        std::cout << "0. Exit" << std::endl;
+        std::cout << "Select action: ";
+        int choice = -1;
+        std::cin >> choice;
+        if (std::cin.fail()) {
+            std::cout << "Invalid input. Please enter a number." << std::endl;
+            std::cin.clear();
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            continue;
+        }
+        switch (choice) {
+            case 1:
+                for (const auto& room : snapshot.rooms()) {
+                    printRoom(room);
+                }
+                break;
+            case 2: {
+                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                std::string dateFrom = readDate("Enter check-in date (YYYY-MM-DD): ");
+                std::string dateTo = readDate("Enter check-out date (YYYY-MM-DD): ");
+                if (!std::cin) {
+                    return;
+                }
+                std::vector<const SnapshotRoom*> rooms = snapshot.findAvailableRooms(dateFrom, dateTo);
+                for (const SnapshotRoom* room : rooms) {
+                    printRoom(*room);
+                }
+                if (rooms.empty()) {
+                    std::cout << "No rooms available for the selected dates." << std::endl;
+                }
+                break;
+            }
+            case 3:
+                for (const auto& service : snapshot.services()) {
+                    std::cout << "Service ID: " << service.id << ", Name: " << snapshot.text(service.name)
+                              << ", Price: $" << service.price << std::endl;
+                }
+                break;
+            case 0:
+                return;
+            default:
+                std::cout << "Invalid choice." << std::endl;
+                break;
+        }
+    }
+}
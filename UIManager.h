@@ -10,6 +10,8 @@
 #include <string>
 
 class DBManager;
+class SessionContext;
+class SnapshotFile;
 
 /**
  * @brief Отображает главное меню приложения.
@@ -34,16 +36,18 @@ void showUserMenu();
 /**
  * @brief Выполняет вход пользователя в систему.
  * @param db Ссылка на объект DBManager для взаимодействия с базой данных.
+ * @param ctx Контекст сессии, в котором открывается сессия пользователя.
  * @return True, если вход выполнен успешно, иначе false.
  */
-bool login(DBManager& db);
+bool login(DBManager& db, SessionContext& ctx);
 
 /**
  * @brief Регистрирует нового пользователя в системе.
  * @param db Ссылка на объект DBManager для взаимодействия с базой данных.
+ * @param ctx Контекст сессии (администратор может выбрать роль нового пользователя).
  * @return True, если регистрация успешна, иначе false.
  */
-bool registerUser(DBManager& db);
+bool registerUser(DBManager& db, SessionContext& ctx);
 
 /**
  * @brief Просматривает все бронирования в системе.
@@ -102,14 +106,16 @@ void viewAvailableRooms(DBManager& db);
 /**
  * @brief Создает новое бронирование.
  * @param db Ссылка на объект DBManager для взаимодействия с базой данных.
+ * @param ctx Контекст сессии текущего пользователя.
  */
-void makeBooking(DBManager& db);
+void makeBooking(DBManager& db, SessionContext& ctx);
 
 /**
  * @brief Просматривает бронирования текущего пользователя.
  * @param db Ссылка на объект DBManager для взаимодействия с базой данных.
+ * @param ctx Контекст сессии текущего пользователя.
  */
-void viewMyBookings(DBManager& db);
+void viewMyBookings(DBManager& db, SessionContext& ctx);
 
 /**
  * @brief Получает от пользователя валидную дату.
@@ -117,10 +123,42 @@ void viewMyBookings(DBManager& db);
  */
 std::string getValidDate();
 
+/**
+ * @brief Проверяет, является ли строка допустимой датой в формате YYYY-MM-DD.
+ * @param date Строка для проверки.
+ * @return True, если строка является действительной датой, иначе false.
+ */
+bool isValidDate(const std::string& date);
+
 /**
  * @brief Управляет ролями пользователей (доступно только администраторам).
  * @param db Ссылка на объект DBManager для взаимодействия с базой данных.
  */
 void manageUserRoles(DBManager& db);
 
+/**
+ * @brief Запускает ночную смену статусов бронирований вручную (доступно только администраторам).
+ * @param db Ссылка на объект DBManager для взаимодействия с базой данных.
+ */
+void runNightlyRollover(DBManager& db);
+
+/**
+ * @brief Показывает статистику работы системы по реестру метрик (доступно только администраторам).
+ */
+void viewSystemStats();
+
+/**
+ * @brief Включает трассировку операций или, если она уже включена, сохраняет записанные
+ *        области в файл Chrome trace-event JSON (доступно только администраторам).
+ * @param path Путь к файлу трассировки.
+ */
+void saveOperationTrace(const std::string& path);
+
+/**
+ * @brief Работает в режиме только для чтения по снимку, когда база данных недоступна:
+ *        просмотр номеров, поиск свободных номеров и просмотр услуг.
+ * @param snapshot Отображенный в память снимок.
+ */
+void browseOffline(const SnapshotFile& snapshot);
+
 #endif // UIMANAGER_H 
\ No newline at end of file
@@ -5,16 +5,19 @@
 
 #include "User.h"
 #include "DBManager.h"
+#include "Metrics.h"
+#include "Tracing.h"
+#include "Logger.h"
+#include "AuditJournal.h"
 #include <iostream>
 #include <vector>
 #include <string>
 #include <memory>
+#include <cstdlib>
+#include <mutex>
 
-/**
- * @brief Статическая переменная, представляющая текущего вошедшего в систему пользователя.
- * Инициализируется как nullptr, когда никто не вошел в систему.
- */
-std::unique_ptr<User> User::currentUser = nullptr;
+FlatHashIndex<int> User::loginIndex;
+std::shared_mutex User::indexMutex;
 
 /**
  * @brief Конструктор класса User.
@@ -50,6 +53,15 @@ UserRole User::getRole() const { return role; }
  * @return Строка, представляющая роль пользователя.
  */
 std::string User::getRoleString() const {
+    return roleToString(role);
+}
+
+/**
+ * @brief Возвращает строковое представление роли.
+ * @param role Роль пользователя.
+ * @return Строка, представляющая роль.
+ */
+std::string User::roleToString(UserRole role) {
     switch (role) {
         case UserRole::ADMIN: return "admin";
         case UserRole::MANAGER: return "manager";
@@ -60,15 +72,28 @@ std::string User::getRoleString() const {
 
 /**
  * @brief Аутентифицирует пользователя по логину и паролю, взаимодействуя с базой данных.
- * Если аутентификация успешна, устанавливает текущего пользователя.
+ * Если логин уже есть в индексе логинов, пользователь ищется по первичному ключу.
  * @param dbManager Менеджер базы данных для взаимодействия с БД.
  * @param login Логин пользователя.
  * @param password Пароль пользователя (предполагается, что он уже хэширован).
- * @return True, если аутентификация успешна, иначе false.
+ * @return Уникальный указатель на аутентифицированного пользователя или nullptr, если аутентификация не удалась.
  */
-bool User::authenticate(DBManager& dbManager, const std::string& login, const std::string& password) {
+std::unique_ptr<User> User::authenticate(DBManager& dbManager, const std::string& login, const std::string& password) {
+    TraceSpan span("User::authenticate", "entity");
+    static MetricCounter& succeeded = MetricsRegistry::global().counter(
+        "hotel_logins_total", "Login attempts by result.", "result=\"success\"");
+    static MetricCounter& failed = MetricsRegistry::global().counter(
+        "hotel_logins_total", "Login attempts by result.", "result=\"failure\"");
+    static MetricCounter& indexHits = MetricsRegistry::global().counter(
+        "hotel_login_index_lookups_total", "In-memory login index lookups by result.", "result=\"hit\"");
+    static MetricCounter& indexMisses = MetricsRegistry::global().counter(
+        "hotel_login_index_lookups_total", "In-memory login index lookups by result.", "result=\"miss\"");
     try {
-        std::string query = "SELECT id, login, password_hash, role FROM users WHERE login = '" + login + "' AND password_hash = '" + password + "';";
+        int indexedId = findIndexedUserId(login);
+        (indexedId >= 0 ? indexHits : indexMisses).increment();
+        std::string query = indexedId >= 0
+            ? "SELECT id, login, password_hash, role FROM users WHERE id = " + std::to_string(indexedId) + " AND password_hash = '" + password + "';"
+            : "SELECT id, login, password_hash, role FROM users WHERE login = '" + login + "' AND password_hash = '" + password + "';";
         PGResultWrapper result = dbManager.executeQuery(query);
 
         if (PQntuples(result.get()) == 1) {
@@ -82,45 +107,26 @@ bool User::authenticate(DBManager& dbManager, const std::string& login, const st
             else if (roleStr == "manager") role = UserRole::MANAGER;
             else role = UserRole::USER;
 
-            setCurrentUser(std::make_unique<User>(id, dbLogin, dbPassword, role));
-            return true; // PGResultWrapper automatically cleans up
+            indexLogin(dbLogin, id);
+            succeeded.increment();
+            return std::make_unique<User>(id, dbLogin, dbPassword, role); // PGResultWrapper automatically cleans up
         }
 
-        return false; // PGResultWrapper automatically cleans up
+        failed.increment();
+        return nullptr; // PGResultWrapper automatically cleans up
+    } catch (const QueryTimeoutError&) {
+        throw;
     } catch (const std::exception& e) {
-        std::cerr << "Authentication failed: " << e.what() << std::endl;
-        return false;
+        Logger::severe("Authentication failed: {}", e.what());
+        failed.increment();
+        return nullptr;
     }
 }
 
-/**
- * @brief Возвращает указатель на текущего вошедшего пользователя.
- * @return Указатель на объект User текущего пользователя, или nullptr, если никто не вошел.
- */
-User* User::getCurrentUser() {
-    return currentUser.get();
-}
-
-/**
- * @brief Устанавливает текущего вошедшего пользователя.
- * Предыдущий текущий пользователь будет удален.
- * @param user Уникальный указатель на объект User, который будет установлен как текущий пользователь.
- */
-void User::setCurrentUser(std::unique_ptr<User> user) {
-    currentUser = std::move(user);
-}
-
-/**
- * @brief Выполняет выход текущего пользователя из системы.
- * Удаляет объект текущего пользователя.
- */
-void User::logout() {
-    currentUser.reset();
-}
-
 /**
  * @brief Добавляет нового пользователя в базу данных.
- * Перед добавлением проверяет, существует ли пользователь с таким логином.
+ * Перед добавлением проверяет, существует ли пользователь с таким логином
+ * (сначала по индексу логинов, затем в базе данных).
  * @param dbManager Менеджер базы данных для взаимодействия с БД.
  * @param login Логин нового пользователя.
  * @param password Пароль нового пользователя.
@@ -128,10 +134,17 @@ void User::logout() {
  * @return True, если пользователь успешно добавлен, иначе false (например, если пользователь с таким логином уже существует).
  */
 bool User::addUser(DBManager& dbManager, const std::string& login, const std::string& password, UserRole role) {
+    TraceSpan span("User::addUser", "entity");
     try {
-        std::string checkQuery = "SELECT id FROM users WHERE login = '" + login + "';";
-        PGResultWrapper result = dbManager.executeQuery(checkQuery);
-        bool userExists = (PQntuples(result.get()) > 0);
+        bool userExists = findIndexedUserId(login) >= 0;
+        if (!userExists) {
+            std::string checkQuery = "SELECT id FROM users WHERE login = '" + login + "';";
+            PGResultWrapper result = dbManager.executeQuery(checkQuery);
+            userExists = (PQntuples(result.get()) > 0);
+            if (userExists) {
+                indexLogin(login, std::stoi(PQgetvalue(result.get(), 0, 0)));
+            }
+        }
 
         if (userExists) {
             std::cout << "User with login '" << login << "' already exists." << std::endl;
@@ -145,11 +158,16 @@ bool User::addUser(DBManager& dbManager, const std::string& login, const std::st
             case UserRole::USER: roleStr = "user"; break;
         }
 
-        std::string insertQuery = "INSERT INTO users (login, password_hash, role) VALUES ('" + login + "', '" + password + "', '" + roleStr + "');";
-        dbManager.executeUpdate(insertQuery);
+        std::string insertQuery = "INSERT INTO users (login, password_hash, role) VALUES ('" + login + "', '" + password + "', '" + roleStr + "') RETURNING id;";
+        PGResultWrapper inserted = dbManager.executeQuery(insertQuery);
+        if (PQntuples(inserted.get()) == 1) {
+            indexLogin(login, std::stoi(PQgetvalue(inserted.get(), 0, 0)));
+        }
         return true;
+    } catch (const QueryTimeoutError&) {
+        throw;
     } catch (const std::exception& e) {
-        std::cerr << "Failed to add user: " << e.what() << std::endl;
+        Logger::severe("Failed to add user: {}", e.what());
         return false;
     }
 }
@@ -161,9 +179,10 @@ bool User::addUser(DBManager& dbManager, const std::string& login, const std::st
  * @return Уникальный указатель на объект User, если пользователь найден, иначе nullptr.
  */
 std::unique_ptr<User> User::findUserById(DBManager& dbManager, int id) {
+    TraceSpan span("User::findUserById", "entity");
     try {
         std::string query = "SELECT id, login, password_hash, role FROM users WHERE id = " + std::to_string(id) + ";";
-        PGResultWrapper result = dbManager.executeQuery(query);
+        PGResultWrapper result = dbManager.executeRead(query);
 
         if (PQntuples(result.get()) == 1) {
             int userId = std::stoi(PQgetvalue(result.get(), 0, 0));
@@ -181,8 +200,10 @@ std::unique_ptr<User> User::findUserById(DBManager& dbManager, int id) {
         }
 
         return nullptr; 
+    } catch (const QueryTimeoutError&) {
+        throw;
     } catch (const std::exception& e) {
-        std::cerr << "User lookup failed: " << e.what() << std::endl;
+        Logger::severe("User lookup failed: {}", e.what());
         return nullptr;
     }
 }
@@ -193,10 +214,11 @@ std::unique_ptr<User> User::findUserById(DBManager& dbManager, int id) {
  * @return Вектор объектов User, представляющих всех пользователей.
  */
 std::vector<User> User::getAllUsers(DBManager& dbManager) {
+    TraceSpan span("User::getAllUsers", "entity");
     std::vector<User> users;
     try {
         std::string query = "SELECT id, login, password_hash, role FROM users;";
-        PGResultWrapper result = dbManager.executeQuery(query);
+        PGResultWrapper result = dbManager.executeRead(query);
 
         int numRows = PQntuples(result.get());
         for (int i = 0; i < numRows; ++i) {
@@ -211,9 +233,49 @@ std::vector<User> User::getAllUsers(DBManager& dbManager) {
             else role = UserRole::USER;
             
             users.emplace_back(id, login, password, role);
+            indexLogin(login, id);
+        }
+    } catch (const QueryTimeoutError&) {
+        throw;
+    } catch (const std::exception& e) {
+        Logger::severe("Failed to get all users: {}", e.what());
+    }
+    return users;
+}
+
+/**
+ * @brief Получает список всех пользователей, размещая вектор и строковые поля в арене.
+ * @param dbManager Менеджер базы данных для взаимодействия с БД.
+ * @param arena Арена, в которой размещаются вектор и строки результата.
+ * @return Вектор строк пользователей в памяти арены.
+ */
+std::pmr::vector<UserRow> User::getAllUsers(DBManager& dbManager, QueryArena& arena) {
+    TraceSpan span("User::getAllUsers", "entity");
+    std::pmr::vector<UserRow> users(arena.resource());
+    try {
+        std::string query = "SELECT id, login, role FROM users;";
+        PGResultWrapper result = dbManager.executeRead(query);
+
+        int numRows = PQntuples(result.get());
+        users.reserve(numRows);
+        for (int i = 0; i < numRows; ++i) {
+            std::string_view roleStr(PQgetvalue(result.get(), i, 2), PQgetlength(result.get(), i, 2));
+
+            UserRole role;
+            if (roleStr == "admin") role = UserRole::ADMIN;
+            else if (roleStr == "manager") role = UserRole::MANAGER;
+            else role = UserRole::USER;
+
+            users.push_back(UserRow{
+                std::atoi(PQgetvalue(result.get(), i, 0)),
+                arena.copy(std::string_view(PQgetvalue(result.get(), i, 1), PQgetlength(result.get(), i, 1))),
+                role
+            });
         }
+    } catch (const QueryTimeoutError&) {
+        throw;
     } catch (const std::exception& e) {
-        std::cerr << "Failed to get all users: " << e.what() << std::endl;
+        Logger::severe("Failed to get all users: {}", e.what());
     }
     return users;
 }
@@ -225,6 +287,7 @@ std::vector<User> User::getAllUsers(DBManager& dbManager) {
  * @return True, если роль успешно обновлена, иначе false.
  */
 bool User::updateRole(DBManager& dbManager, UserRole newRole) {
+    TraceSpan span("User::updateRole", "entity");
     try {
         std::string roleStr;
         switch (newRole) {
@@ -235,10 +298,42 @@ bool User::updateRole(DBManager& dbManager, UserRole newRole) {
 
         std::string query = "UPDATE users SET role = '" + roleStr + "' WHERE id = " + std::to_string(this->id) + ";";
         dbManager.executeUpdate(query);
+        AuditJournal::note(AuditAction::ROLE_CHANGE, this->id, getRoleString() + "->" + roleStr);
         this->role = newRole; // Update role in the current object as well
         return true;
+    } catch (const QueryTimeoutError&) {
+        throw;
     } catch (const std::exception& e) {
-        std::cerr << "Failed to update user role: " << e.what() << std::endl;
+        Logger::severe("Failed to update user role: {}", e.what());
         return false;
     }
-} 
\ No newline at end of file
+} 
+
+/**
+ * @brief Добавляет логин в индекс логинов.
+ * @param login Логин пользователя.
+ * @param id Идентификатор пользователя.
+ */
+void User::indexLogin(const std::string& login, int id) {
+    std::unique_lock<std::shared_mutex> lock(indexMutex);
+    loginIndex.insert(login, id);
+}
+
+/**
+ * @brief Ищет идентификатор пользователя по логину в индексе логинов (без обращения к БД).
+ * @param login Логин пользователя.
+ * @return Идентификатор пользователя или -1, если логин отсутствует в индексе.
+ */
+int User::findIndexedUserId(const std::string& login) {
+    std::shared_lock<std::shared_mutex> lock(indexMutex);
+    const int* id = loginIndex.find(login);
+    return id ? *id : -1;
+}
+
+/**
+ * @brief Очищает индекс логинов.
+ */
+void User::clearIndex() {
+    std::unique_lock<std::shared_mutex> lock(indexMutex);
+    loginIndex.clear();
+}
@@ -9,7 +9,12 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <memory_resource>
+#include <shared_mutex>
+#include <string_view>
 #include "DBManager.h"
+#include "FlatHashIndex.h"
+#include "QueryArena.h"
 
 /**
  * @brief Перечисление, определяющее возможные роли пользователя в системе.
@@ -20,10 +25,20 @@ enum class UserRole {
     USER
 };
 
+/**
+ * @brief Строка результата запроса пользователей, размещенная в QueryArena. Хэш пароля не загружается.
+ */
+struct UserRow {
+    int id;
+    std::string_view login;
+    UserRole role;
+};
+
 /**
  * @brief Класс User представляет пользователя системы.
  * Он содержит информацию об идентификаторе, логине, пароле, роли пользователя.
- * Также предоставляет статические методы для управления пользователями и текущей сессией.
+ * Также предоставляет статические методы для управления пользователями.
+ * Сессии вошедших пользователей хранятся в SessionManager.
  */
 class User {
 private:
@@ -31,7 +46,15 @@ private:
     std::string login;
     std::string password;
     UserRole role;
-    static std::unique_ptr<User> currentUser;
+    static FlatHashIndex<int> loginIndex;   ///< Индекс: логин -> идентификатор пользователя.
+    static std::shared_mutex indexMutex;    ///< Защищает loginIndex.
+
+    /**
+     * @brief Добавляет логин в индекс логинов.
+     * @param login Логин пользователя.
+     * @param id Идентификатор пользователя.
+     */
+    static void indexLogin(const std::string& login, int id);
 
 public:
     /**
@@ -66,15 +89,22 @@ public:
      * @return Строка, представляющая роль пользователя.
      */
     std::string getRoleString() const;
+
+    /**
+     * @brief Возвращает строковое представление роли.
+     * @param role Роль пользователя.
+     * @return Строка, представляющая роль.
+     */
+    static std::string roleToString(UserRole role);
     
     /**
      * @brief Аутентифицирует пользователя по логину и паролю.
      * @param db Менеджер базы данных для взаимодействия с БД.
      * @param login Логин пользователя.
      * @param password Пароль пользователя.
-     * @return True, если аутентификация успешна, иначе false.
+     * @return Уникальный указатель на аутентифицированного пользователя или nullptr, если аутентификация не удалась.
      */
-    static bool authenticate(DBManager& db, const std::string& login, const std::string& password);
+    static std::unique_ptr<User> authenticate(DBManager& db, const std::string& login, const std::string& password);
 
     /**
      * @brief Добавляет нового пользователя в базу данных.
@@ -100,6 +130,14 @@ public:
      * @return Вектор объектов User, представляющих всех пользователей.
      */
     static std::vector<User> getAllUsers(DBManager& db);
+
+    /**
+     * @brief Получает список всех пользователей, размещая результат в арене.
+     * @param db Менеджер базы данных для взаимодействия с БД.
+     * @param arena Арена, в которой размещаются вектор и строки результата.
+     * @return Вектор строк пользователей в памяти арены.
+     */
+    static std::pmr::vector<UserRow> getAllUsers(DBManager& db, QueryArena& arena);
     
     /**
      * @brief Обновляет роль текущего пользователя в базе данных.
@@ -110,19 +148,14 @@ public:
     bool updateRole(DBManager& db, UserRole newRole);
     
     /**
-     * @brief Возвращает указатель на текущего вошедшего пользователя.
-     * @return Указатель на объект User текущего пользователя, или nullptr, если никто не вошел.
-     */
-    static User* getCurrentUser();
-
-    /**
-     * @brief Устанавливает текущего вошедшего пользователя.
-     * @param user Уникальный указатель на объект User, который будет установлен как текущий пользователь.
+     * @brief Ищет идентификатор пользователя по логину в индексе логинов (без обращения к БД).
+     * @param login Логин пользователя.
+     * @return Идентификатор пользователя или -1, если логин отсутствует в индексе.
      */
-    static void setCurrentUser(std::unique_ptr<User> user);
+    static int findIndexedUserId(const std::string& login);
 
     /**
-     * @brief Выполняет выход текущего пользователя из системы.
+     * @brief Очищает индекс логинов.
      */
-    static void logout();
+    static void clearIndex();
 }; 
\ No newline at end of file
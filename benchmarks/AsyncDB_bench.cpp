@@ -0,0 +1,61 @@
+#include <benchmark/benchmark.h>
+#include "AsyncDBManager.h"
+#include "Room.h"
+#include "BenchDB.h"
+#include <memory>
+#include <vector>
+
+// Один поток выполняет поиск свободных номеров на N соединениях:
+// блокирующий API - запросы по очереди, асинхронный - все N одновременно через реактор.
+static const char* DATE_FROM = "2030-01-10";
+static const char* DATE_TO = "2030-01-15";
+
+static void BM_BlockingSearchOnConnections(benchmark::State& state) {
+    std::vector<std::unique_ptr<DBManager>> connections;
+    for (int i = 0; i < state.range(0); ++i) {
+        auto db = connectBenchDB();
+        if (!db) {
+            state.SkipWithError("database is not available");
+            return;
+        }
+        connections.push_back(std::move(db));
+    }
+    for (auto _ : state) {
+        for (auto& db : connections) {
+            benchmark::DoNotOptimize(Room::findAvailableRooms(*db, DATE_FROM, DATE_TO));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BlockingSearchOnConnections)->RangeMultiplier(2)->Range(1, 32)->UseRealTime();
+
+static void BM_AsyncSearchOnConnections(benchmark::State& state) {
+    Reactor reactor;
+    std::vector<std::unique_ptr<AsyncDBManager>> connections;
+    for (int i = 0; i < state.range(0); ++i) {
+        auto db = std::make_unique<AsyncDBManager>(reactor, benchEnv("HOTEL_DB_HOST", "127.0.0.1"),
+                                                   benchEnv("HOTEL_DB_USER", "postgres"),
+                                                   benchEnv("HOTEL_DB_PASSWORD", ""),
+                                                   benchEnv("HOTEL_DB_NAME", "hotel_management"),
+                                                   std::stoi(benchEnv("HOTEL_DB_PORT", "5432")));
+        if (!db->connect()) {
+            state.SkipWithError("database is not available");
+            return;
+        }
+        connections.push_back(std::move(db));
+    }
+    for (auto _ : state) {
+        std::vector<Task<std::vector<Room>>> searches;
+        for (auto& db : connections) {
+            searches.push_back(Room::findAvailableRoomsAsync(*db, DATE_FROM, DATE_TO));
+        }
+        reactor.runAll(searches);
+        for (auto& search : searches) {
+            benchmark::DoNotOptimize(search.result());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AsyncSearchOnConnections)->RangeMultiplier(2)->Range(1, 32)->UseRealTime();
+
+BENCHMARK_MAIN();
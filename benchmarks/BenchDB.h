@@ -0,0 +1,37 @@
+/**
+ * @file BenchDB.h
+ * @brief Подключение бенчмарков к локальной базе данных PostgreSQL.
+ *        Параметры берутся из переменных окружения HOTEL_DB_HOST, HOTEL_DB_PORT,
+ *        HOTEL_DB_USER, HOTEL_DB_PASSWORD и HOTEL_DB_NAME.
+ */
+
+#pragma once
+
+#include "DBManager.h"
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+/**
+ * @brief Возвращает значение переменной окружения или значение по умолчанию.
+ */
+inline std::string benchEnv(const char* name, const char* fallback) {
+    const char* value = std::getenv(name);
+    return value ? value : fallback;
+}
+
+/**
+ * @brief Создает и подключает DBManager для бенчмарков.
+ * @return Подключенный DBManager или nullptr, если база данных недоступна.
+ */
+inline std::unique_ptr<DBManager> connectBenchDB() {
+    auto db = std::make_unique<DBManager>(benchEnv("HOTEL_DB_HOST", "127.0.0.1"),
+                                          benchEnv("HOTEL_DB_USER", "postgres"),
+                                          benchEnv("HOTEL_DB_PASSWORD", ""),
+                                          benchEnv("HOTEL_DB_NAME", "hotel_management"),
+                                          std::stoi(benchEnv("HOTEL_DB_PORT", "5432")));
+    if (!db->connect()) {
+        return nullptr;
+    }
+    return db;
+}
@@ -0,0 +1,49 @@
+#include <benchmark/benchmark.h>
+#include "Booking.h"
+#include "BenchDB.h"
+#include <atomic>
+#include <random>
+#include <vector>
+
+// Конкурентные писатели меняют статусы небольшого набора «горячих» бронирований
+// через compare-and-set с повторами. Каждый поток использует собственное соединение.
+static std::vector<int> hotBookings;
+static std::atomic<long long> totalConflicts{0};
+
+static void BM_HotBookingStatusUpdates(benchmark::State& state) {
+    auto db = connectBenchDB();
+    if (!db) {
+        state.SkipWithError("database is not available");
+        return;
+    }
+    if (state.thread_index() == 0) {
+        hotBookings.clear();
+        totalConflicts = 0;
+        PGResultWrapper result = db->executeQuery("SELECT id FROM bookings ORDER BY id LIMIT " + std::to_string(state.range(0)) + ";");
+        for (int i = 0; i < PQntuples(result.get()); ++i) {
+            hotBookings.push_back(std::stoi(PQgetvalue(result.get(), i, 0)));
+        }
+    }
+    std::minstd_rand random(state.thread_index() + 1);
+    long long conflicts = 0;
+    for (auto _ : state) {
+        if (hotBookings.empty()) {
+            state.SkipWithError("bookings table is empty");
+            break;
+        }
+        int bookingId = hotBookings[random() % hotBookings.size()];
+        BookingStatus target = random() % 2 ? BookingStatus::CONFIRMED : BookingStatus::PENDING;
+        int attempts = 0;
+        retryOnConflict([&] {
+            auto booking = Booking::findBookingById(*db, bookingId);
+            return booking ? booking->updateStatus(*db, target) : UpdateResult::NOT_FOUND;
+        }, RetryPolicy(), &attempts);
+        conflicts += attempts - 1;
+    }
+    totalConflicts += conflicts;
+    state.SetItemsProcessed(state.iterations());
+    state.counters["conflicts"] = benchmark::Counter(static_cast<double>(conflicts), benchmark::Counter::kAvgThreadsRate);
+}
+BENCHMARK(BM_HotBookingStatusUpdates)->Arg(4)->Arg(64)->ThreadRange(1, 32)->UseRealTime();
+
+BENCHMARK_MAIN();
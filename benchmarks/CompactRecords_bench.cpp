@@ -0,0 +1,82 @@
+#include <benchmark/benchmark.h>
+#include "CompactRecords.h"
+#include "Room.h"
+#include <string>
+#include <vector>
+
+static const char* kTypes[] = {"Single", "Double", "Suite", "Family"};
+
+static std::string describe(int i) {
+    return "Room " + std::to_string(i) + " with a view of the inner courtyard and a work desk";
+}
+
+static void BM_LoadRoomObjects(benchmark::State& state) {
+    int count = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        std::vector<Room> rooms;
+        rooms.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            rooms.emplace_back(i, std::to_string(100 + i), kTypes[i % 4], 50.0 + i % 7, describe(i));
+        }
+        benchmark::DoNotOptimize(rooms.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_LoadRoomObjects)->Range(1024, 100000);
+
+static void BM_LoadRoomTable(benchmark::State& state) {
+    int count = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        RoomTable table;
+        table.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            table.add(i, std::to_string(100 + i), kTypes[i % 4], 50.0 + i % 7, describe(i));
+        }
+        benchmark::DoNotOptimize(table.size());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_LoadRoomTable)->Range(1024, 100000);
+
+static void BM_IterateRoomObjects(benchmark::State& state) {
+    int count = static_cast<int>(state.range(0));
+    std::vector<Room> rooms;
+    for (int i = 0; i < count; ++i) {
+        rooms.emplace_back(i, std::to_string(100 + i), kTypes[i % 4], 50.0 + i % 7, describe(i));
+    }
+    for (auto _ : state) {
+        std::size_t suites = 0;
+        double total = 0;
+        for (const auto& room : rooms) {
+            suites += room.getType() == "Suite";
+            total += room.getPricePerDay();
+        }
+        benchmark::DoNotOptimize(suites);
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_IterateRoomObjects)->Range(1024, 100000);
+
+static void BM_IterateRoomTable(benchmark::State& state) {
+    int count = static_cast<int>(state.range(0));
+    RoomTable table;
+    for (int i = 0; i < count; ++i) {
+        table.add(i, std::to_string(100 + i), kTypes[i % 4], 50.0 + i % 7, describe(i));
+    }
+    std::uint16_t suiteId = 2;
+    for (auto _ : state) {
+        std::size_t suites = 0;
+        double total = 0;
+        for (const auto& room : table) {
+            suites += room.typeId == suiteId;
+            total += room.pricePerDay;
+        }
+        benchmark::DoNotOptimize(suites);
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_IterateRoomTable)->Range(1024, 100000);
+
+BENCHMARK_MAIN();
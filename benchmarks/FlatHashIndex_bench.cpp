@@ -0,0 +1,117 @@
+#include <benchmark/benchmark.h>
+#include "FlatHashIndex.h"
+#include "Room.h"
+#include "BenchDB.h"
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+static std::vector<std::string> makeKeys(int count) {
+    std::vector<std::string> keys;
+    keys.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        keys.push_back(std::to_string(100 + i));
+    }
+    return keys;
+}
+
+static void BM_FlatHashIndexFind(benchmark::State& state) {
+    std::vector<std::string> keys = makeKeys(static_cast<int>(state.range(0)));
+    FlatHashIndex<int> index(keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        index.insert(keys[i], static_cast<int>(i));
+    }
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(index.find(keys[i]));
+        if (++i == keys.size()) i = 0;
+    }
+}
+BENCHMARK(BM_FlatHashIndexFind)->Range(64, 1 << 17);
+
+static void BM_UnorderedMapFind(benchmark::State& state) {
+    std::vector<std::string> keys = makeKeys(static_cast<int>(state.range(0)));
+    std::unordered_map<std::string, int> index;
+    index.reserve(keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        index.emplace(keys[i], static_cast<int>(i));
+    }
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(index.find(keys[i]));
+        if (++i == keys.size()) i = 0;
+    }
+}
+BENCHMARK(BM_UnorderedMapFind)->Range(64, 1 << 17);
+
+static void BM_FlatHashIndexInsert(benchmark::State& state) {
+    std::vector<std::string> keys = makeKeys(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        FlatHashIndex<int> index;
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            index.insert(keys[i], static_cast<int>(i));
+        }
+        benchmark::DoNotOptimize(index.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FlatHashIndexInsert)->Range(64, 1 << 17);
+
+static void BM_UnorderedMapInsert(benchmark::State& state) {
+    std::vector<std::string> keys = makeKeys(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        std::unordered_map<std::string, int> index;
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            index.emplace(keys[i], static_cast<int>(i));
+        }
+        benchmark::DoNotOptimize(index.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_UnorderedMapInsert)->Range(64, 1 << 17);
+
+static void BM_FindRoomByNumberDatabase(benchmark::State& state) {
+    auto db = connectBenchDB();
+    if (!db) {
+        state.SkipWithError("database is not available");
+        return;
+    }
+    std::vector<Room> rooms = Room::getAllRooms(*db);
+    if (rooms.empty()) {
+        state.SkipWithError("rooms table is empty");
+        return;
+    }
+    std::size_t i = 0;
+    for (auto _ : state) {
+        std::string query = "SELECT id, type, price_per_day, description FROM rooms WHERE number = '" + rooms[i].getNumber() + "';";
+        PGResultWrapper result = db->executeQuery(query);
+        benchmark::DoNotOptimize(PQntuples(result.get()));
+        if (++i == rooms.size()) i = 0;
+    }
+}
+BENCHMARK(BM_FindRoomByNumberDatabase);
+
+static void BM_FindRoomByNumberIndexed(benchmark::State& state) {
+    auto db = connectBenchDB();
+    if (!db) {
+        state.SkipWithError("database is not available");
+        return;
+    }
+    std::vector<Room> rooms = Room::getAllRooms(*db);
+    if (rooms.empty()) {
+        state.SkipWithError("rooms table is empty");
+        return;
+    }
+    Room::setIndexTtl(std::chrono::milliseconds(state.range(0)));
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Room::findRoomByNumber(*db, rooms[i].getNumber()));
+        if (++i == rooms.size()) i = 0;
+    }
+    Room::setIndexTtl(std::chrono::milliseconds(5000));
+}
+// 0 мс: каждая запись устарела, поиск всегда идет в БД; 5000 мс: записи отдаются из индекса.
+BENCHMARK(BM_FindRoomByNumberIndexed)->Arg(0)->Arg(5000);
+
+BENCHMARK_MAIN();
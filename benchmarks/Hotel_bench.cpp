@@ -0,0 +1,330 @@
+#include <benchmark/benchmark.h>
+#include "Bill.h"
+#include "Booking.h"
+#include "Room.h"
+#include "Service.h"
+#include "SnapshotFile.h"
+#include "Tracing.h"
+#include "Logger.h"
+#include "UIManager.h"
+#include "BenchDB.h"
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Микробенчмарки горячих путей приложения. Каждая операция измеряется в двух вариантах:
+// в памяти (синтетические данные, масштаб задается аргументами) и против локальной базы данных
+// PostgreSQL, заполненной заранее (варианты BM_Db* пропускаются, если база недоступна).
+// По умолчанию результаты дополнительно пишутся в hotel_bench.json.
+
+namespace {
+
+const char* const kStatuses[] = {"pending", "confirmed", "cancelled", "completed"};
+const char* const kTypes[] = {"Single", "Double", "Suite", "Family"};
+
+/**
+ * @brief Возвращает дату YYYY-MM-DD.
+ */
+std::string makeDate(int year, int month, int day) {
+    char buffer[11];
+    std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d", year, month, day);
+    return buffer;
+}
+
+/**
+ * @brief Строит в памяти результат запроса getAllBookings с указанным числом строк.
+ */
+std::unique_ptr<PGresult, decltype(&PQclear)> makeBookingsResult(int rows) {
+    std::unique_ptr<PGresult, decltype(&PQclear)> result(PQmakeEmptyPGresult(nullptr, PGRES_TUPLES_OK), &PQclear);
+    const char* names[] = {"id", "user_id", "room_id", "date_from", "date_to", "status", "version"};
+    PGresAttDesc attributes[7] = {};
+    for (int column = 0; column < 7; ++column) {
+        attributes[column].name = const_cast<char*>(names[column]);
+        attributes[column].typlen = -1;
+    }
+    PQsetResultAttrs(result.get(), 7, attributes);
+    for (int row = 0; row < rows; ++row) {
+        std::string values[] = {
+            std::to_string(row + 1),
+            std::to_string(row % 500 + 1),
+            std::to_string(row % 200 + 1),
+            makeDate(2025, row % 12 + 1, row % 20 + 1),
+            makeDate(2025, row % 12 + 1, row % 20 + 4),
+            kStatuses[row % 4],
+            std::to_string(row % 3),
+        };
+        for (int column = 0; column < 7; ++column) {
+            PQsetvalue(result.get(), row, column, values[column].data(), static_cast<int>(values[column].size()));
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Снимок с указанным числом номеров и бронирований на номер во временном файле.
+ */
+struct BenchSnapshot {
+    std::string path;
+    std::unique_ptr<SnapshotFile> file;
+
+    BenchSnapshot(int rooms, int bookingsPerRoom) {
+        path = (std::filesystem::temp_directory_path() /
+                ("hotel_bench_" + std::to_string(rooms) + "_" + std::to_string(bookingsPerRoom) + ".bin")).string();
+        SnapshotWriter writer;
+        int bookingId = 1;
+        for (int room = 1; room <= rooms; ++room) {
+            writer.addRoom(room, 1, std::to_string(100 + room), kTypes[room % 4], 50.0 + room % 7, "Room");
+            for (int j = 0; j < bookingsPerRoom; ++j) {
+                int month = (room + j) % 12 + 1;
+                int day = (room * 7 + j * 3) % 24 + 1;
+                writer.addBooking(bookingId++, room % 500 + 1, room, makeDate(2025, month, day),
+                                  makeDate(2025, month, day + 3), BookingStatus::CONFIRMED, 0);
+            }
+        }
+        writer.write(path, 0);
+        file = std::make_unique<SnapshotFile>(path);
+    }
+
+    ~BenchSnapshot() {
+        file.reset();
+        std::filesystem::remove(path);
+    }
+};
+
+} // namespace
+
+static void BM_DecodeBookingsInMemory(benchmark::State& state) {
+    int rows = static_cast<int>(state.range(0));
+    auto result = makeBookingsResult(rows);
+    for (auto _ : state) {
+        std::vector<Booking> bookings;
+        Booking::appendRows(result.get(), bookings);
+        benchmark::DoNotOptimize(bookings.data());
+    }
+    state.SetItemsProcessed(state.iterations() * rows);
+}
+BENCHMARK(BM_DecodeBookingsInMemory)->RangeMultiplier(4)->Range(64, 65536);
+
+static void BM_DbGetAllBookings(benchmark::State& state) {
+    auto db = connectBenchDB();
+    if (!db) {
+        state.SkipWithError("database is not available");
+        return;
+    }
+    std::size_t rows = 0;
+    for (auto _ : state) {
+        std::vector<Booking> bookings = Booking::getAllBookings(*db);
+        rows = bookings.size();
+        benchmark::DoNotOptimize(bookings.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(rows));
+    state.counters["bookings"] = static_cast<double>(rows);
+}
+BENCHMARK(BM_DbGetAllBookings)->Unit(benchmark::kMillisecond);
+
+static void BM_IsValidDate(benchmark::State& state) {
+    const std::string dates[] = {"2025-06-15", "2024-02-29", "2025-02-30", "2025-6-15", "not a date"};
+    const std::string& date = dates[state.range(0)];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(isValidDate(date));
+    }
+    state.SetLabel(date);
+}
+BENCHMARK(BM_IsValidDate)->DenseRange(0, 4);
+
+static void BM_RoomCopy(benchmark::State& state) {
+    int count = static_cast<int>(state.range(0));
+    std::vector<Room> rooms;
+    for (int i = 0; i < count; ++i) {
+        rooms.emplace_back(i + 1, std::to_string(100 + i), kTypes[i % 4], 50.0 + i % 7,
+                           "Room with a view of the old town square and a balcony");
+    }
+    for (auto _ : state) {
+        std::vector<Room> copy = rooms;
+        benchmark::DoNotOptimize(copy.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_RoomCopy)->RangeMultiplier(8)->Range(64, 32768);
+
+static void BM_BookingConstruct(benchmark::State& state) {
+    int count = static_cast<int>(state.range(0));
+    std::vector<std::pair<std::string, std::string>> dates;
+    for (int i = 0; i < count; ++i) {
+        dates.emplace_back(makeDate(2025, i % 12 + 1, i % 20 + 1), makeDate(2025, i % 12 + 1, i % 20 + 4));
+    }
+    for (auto _ : state) {
+        std::vector<Booking> bookings;
+        bookings.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            bookings.emplace_back(i + 1, i % 500 + 1, i % 200 + 1, dates[i].first, dates[i].second,
+                                  BookingStatus::PENDING, 0);
+        }
+        benchmark::DoNotOptimize(bookings.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_BookingConstruct)->RangeMultiplier(8)->Range(64, 32768);
+
+static void BM_BookingCopy(benchmark::State& state) {
+    int count = static_cast<int>(state.range(0));
+    std::vector<Booking> bookings;
+    Booking::appendRows(makeBookingsResult(count).get(), bookings);
+    for (auto _ : state) {
+        std::vector<Booking> copy = bookings;
+        benchmark::DoNotOptimize(copy.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_BookingCopy)->RangeMultiplier(8)->Range(64, 32768);
+
+// Свободные номера по снимку: число номеров x число бронирований на номер.
+static void BM_AvailabilityInMemory(benchmark::State& state) {
+    BenchSnapshot snapshot(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+    for (auto _ : state) {
+        auto rooms = snapshot.file->findAvailableRooms("2025-06-10", "2025-06-14");
+        benchmark::DoNotOptimize(rooms.data());
+    }
+    state.counters["bookings"] = static_cast<double>(snapshot.file->bookings().size());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AvailabilityInMemory)->ArgsProduct({{64, 512, 4096}, {1, 4, 16}})->ArgNames({"rooms", "per_room"});
+
+static void BM_DbIsRoomAvailable(benchmark::State& state) {
+    auto db = connectBenchDB();
+    if (!db) {
+        state.SkipWithError("database is not available");
+        return;
+    }
+    std::vector<int> roomIds;
+    PGResultWrapper result = db->executeRead("SELECT id FROM rooms ORDER BY id LIMIT 256;");
+    for (int i = 0; i < PQntuples(result.get()); ++i) {
+        roomIds.push_back(std::stoi(PQgetvalue(result.get(), i, 0)));
+    }
+    if (roomIds.empty()) {
+        state.SkipWithError("rooms table is empty");
+        return;
+    }
+    std::size_t next = 0;
+    for (auto _ : state) {
+        int roomId = roomIds[next++ % roomIds.size()];
+        benchmark::DoNotOptimize(Booking::isRoomAvailable(*db, roomId, "2025-06-10", "2025-06-14"));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DbIsRoomAvailable);
+
+static void BM_DbFindAvailableRooms(benchmark::State& state) {
+    auto db = connectBenchDB();
+    if (!db) {
+        state.SkipWithError("database is not available");
+        return;
+    }
+    std::size_t found = 0;
+    for (auto _ : state) {
+        std::vector<Room> rooms = Room::findAvailableRooms(*db, "2025-06-10", "2025-06-14");
+        found = rooms.size();
+        benchmark::DoNotOptimize(rooms.data());
+    }
+    state.counters["rooms"] = static_cast<double>(found);
+}
+BENCHMARK(BM_DbFindAvailableRooms)->Unit(benchmark::kMillisecond);
+
+static void BM_BillComposeInMemory(benchmark::State& state) {
+    int lines = static_cast<int>(state.range(0));
+    Booking booking(1, 1, 1, "2025-06-10", "2025-06-14", BookingStatus::CONFIRMED, 0);
+    Room room(1, "101", "Double", 80.0, "Room");
+    std::vector<std::pair<Service, int>> services;
+    for (int i = 0; i < lines; ++i) {
+        services.emplace_back(Service(i + 1, "Service " + std::to_string(i + 1), 5.0 + i % 10), i % 3 + 1);
+    }
+    for (auto _ : state) {
+        Bill bill = Bill::compose(booking, room, services);
+        benchmark::DoNotOptimize(bill.getTotal());
+    }
+    state.SetItemsProcessed(state.iterations() * lines);
+}
+BENCHMARK(BM_BillComposeInMemory)->RangeMultiplier(4)->Range(1, 256);
+
+static void BM_DbBillForBooking(benchmark::State& state) {
+    auto db = connectBenchDB();
+    if (!db) {
+        state.SkipWithError("database is not available");
+        return;
+    }
+    std::vector<int> bookingIds;
+    PGResultWrapper result = db->executeRead(
+        "SELECT booking_id FROM booking_services GROUP BY booking_id ORDER BY count(*) DESC LIMIT 64;");
+    for (int i = 0; i < PQntuples(result.get()); ++i) {
+        bookingIds.push_back(std::stoi(PQgetvalue(result.get(), i, 0)));
+    }
+    if (bookingIds.empty()) {
+        state.SkipWithError("booking_services table is empty");
+        return;
+    }
+    std::size_t next = 0;
+    for (auto _ : state) {
+        auto bill = Bill::forBooking(*db, bookingIds[next++ % bookingIds.size()]);
+        benchmark::DoNotOptimize(bill.get());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DbBillForBooking);
+
+// Стоимость области трассировки: 0 - трассировка выключена, 1 - включена (с подробностью).
+static void BM_TraceSpan(benchmark::State& state) {
+    bool enabled = state.range(0) != 0;
+    const std::string query = "SELECT id, room_id, date_from, date_to FROM bookings WHERE room_id = 42;";
+    Tracer::clear();
+    Tracer::setEnabled(enabled);
+    for (auto _ : state) {
+        TraceSpan span("DBManager::execute", "db", query);
+        benchmark::ClobberMemory();
+    }
+    Tracer::setEnabled(false);
+    Tracer::clear();
+}
+BENCHMARK(BM_TraceSpan)->Arg(0)->Arg(1);
+
+// Стоимость записи в журнал на вызывающем потоке: 0 - уровень отключен, 1 - запись в буфер потока.
+// Вывод идет в пустой приемник; при заполнении буфера запись отбрасывается, а не ждет.
+static void BM_LogRecord(benchmark::State& state) {
+    const std::string error = "server closed the connection unexpectedly";
+    Logger::setSink([](std::string_view) {});
+    Logger::setRateLimit(0);
+    LogLevel level = state.range(0) != 0 ? LogLevel::SEVERE : LogLevel::VERBOSE;
+    for (auto _ : state) {
+        Logger::log(level, "Failed to find room by ID {}: {}", 42, error);
+    }
+    Logger::flush();
+    Logger::setSink(nullptr);
+    Logger::setRateLimit(Logger::DEFAULT_RATE_LIMIT);
+}
+BENCHMARK(BM_LogRecord)->Arg(0)->Arg(1);
+
+// Если путь вывода не задан, результаты пишутся в hotel_bench.json в формате JSON.
+int main(int argc, char** argv) {
+    std::vector<char*> args(argv, argv + argc);
+    std::string out = "--benchmark_out=hotel_bench.json";
+    std::string format = "--benchmark_out_format=json";
+    bool hasOut = false;
+    for (int i = 1; i < argc; ++i) {
+        hasOut = hasOut || std::string_view(argv[i]).starts_with("--benchmark_out=");
+    }
+    if (!hasOut) {
+        args.push_back(out.data());
+        args.push_back(format.data());
+    }
+    int count = static_cast<int>(args.size());
+    benchmark::Initialize(&count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(count, args.data())) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
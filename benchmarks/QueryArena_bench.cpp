@@ -0,0 +1,114 @@
+#include <benchmark/benchmark.h>
+#include "Booking.h"
+#include "BenchDB.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Подсчет обращений к глобальной куче, чтобы сравнить обычную и арен-материализацию.
+static std::atomic<std::size_t> heapAllocations{0};
+static std::atomic<std::size_t> heapBytes{0};
+
+void* operator new(std::size_t size) {
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    heapBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    heapBytes.fetch_add(size, std::memory_order_relaxed);
+    std::size_t align = static_cast<std::size_t>(alignment);
+    if (void* p = std::aligned_alloc(align, (size + align - 1) / align * align)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+static void reportPerCall(benchmark::State& state, std::size_t allocations, std::size_t bytes) {
+    double calls = static_cast<double>(state.iterations());
+    state.counters["allocs_per_call"] = benchmark::Counter(allocations / calls);
+    state.counters["bytes_per_call"] = benchmark::Counter(bytes / calls);
+}
+
+static void BM_GetAllBookingsHeap(benchmark::State& state) {
+    auto db = connectBenchDB();
+    if (!db) {
+        state.SkipWithError("database is not available");
+        return;
+    }
+    std::size_t allocations = 0, bytes = 0;
+    for (auto _ : state) {
+        std::size_t a0 = heapAllocations, b0 = heapBytes;
+        std::vector<Booking> bookings = Booking::getAllBookings(*db);
+        benchmark::DoNotOptimize(bookings.data());
+        allocations += heapAllocations - a0;
+        bytes += heapBytes - b0;
+    }
+    reportPerCall(state, allocations, bytes);
+}
+BENCHMARK(BM_GetAllBookingsHeap);
+
+static void BM_GetAllBookingsArena(benchmark::State& state) {
+    auto db = connectBenchDB();
+    if (!db) {
+        state.SkipWithError("database is not available");
+        return;
+    }
+    std::size_t allocations = 0, bytes = 0;
+    for (auto _ : state) {
+        std::size_t a0 = heapAllocations, b0 = heapBytes;
+        QueryArena arena;
+        std::pmr::vector<BookingRow> bookings = Booking::getAllBookings(*db, arena);
+        benchmark::DoNotOptimize(bookings.data());
+        allocations += heapAllocations - a0;
+        bytes += heapBytes - b0;
+    }
+    reportPerCall(state, allocations, bytes);
+}
+BENCHMARK(BM_GetAllBookingsArena);
+
+static void BM_MaterialiseRowsHeap(benchmark::State& state) {
+    int count = static_cast<int>(state.range(0));
+    std::size_t allocations = 0, bytes = 0;
+    for (auto _ : state) {
+        std::size_t a0 = heapAllocations, b0 = heapBytes;
+        std::vector<Booking> bookings;
+        for (int i = 0; i < count; ++i) {
+            bookings.emplace_back(i, 1, 2, "2023-01-01 00:00:00", "2023-01-05 00:00:00", BookingStatus::CONFIRMED);
+        }
+        benchmark::DoNotOptimize(bookings.data());
+        allocations += heapAllocations - a0;
+        bytes += heapBytes - b0;
+    }
+    reportPerCall(state, allocations, bytes);
+}
+BENCHMARK(BM_MaterialiseRowsHeap)->Range(1024, 65536);
+
+static void BM_MaterialiseRowsArena(benchmark::State& state) {
+    int count = static_cast<int>(state.range(0));
+    std::size_t allocations = 0, bytes = 0;
+    for (auto _ : state) {
+        std::size_t a0 = heapAllocations, b0 = heapBytes;
+        QueryArena arena;
+        std::pmr::vector<BookingRow> bookings(arena.resource());
+        for (int i = 0; i < count; ++i) {
+            bookings.push_back(BookingRow{i, 1, 2, arena.copy("2023-01-01 00:00:00"), arena.copy("2023-01-05 00:00:00"), BookingStatus::CONFIRMED});
+        }
+        benchmark::DoNotOptimize(bookings.data());
+        allocations += heapAllocations - a0;
+        bytes += heapBytes - b0;
+    }
+    reportPerCall(state, allocations, bytes);
+}
+BENCHMARK(BM_MaterialiseRowsArena)->Range(1024, 65536);
+
+BENCHMARK_MAIN();
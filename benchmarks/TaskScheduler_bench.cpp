@@ -0,0 +1,142 @@
+#include <benchmark/benchmark.h>
+#include "TaskScheduler.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Базовая линия: пул с одной общей очередью под одним мьютексом.
+class GlobalQueuePool {
+private:
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<std::function<void()>> jobs;
+    std::vector<std::thread> threads;
+    bool stopping = false;
+
+public:
+    explicit GlobalQueuePool(std::size_t threadCount) {
+        for (std::size_t i = 0; i < threadCount; ++i) {
+            threads.emplace_back([this] {
+                while (true) {
+                    std::function<void()> job;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        ready.wait(lock, [this] { return stopping || !jobs.empty(); });
+                        if (jobs.empty()) return;
+                        job = std::move(jobs.front());
+                        jobs.pop_front();
+                    }
+                    job();
+                }
+            });
+        }
+    }
+
+    ~GlobalQueuePool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        ready.notify_all();
+        for (auto& thread : threads) thread.join();
+    }
+
+    void submit(std::function<void()> job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.push_back(std::move(job));
+        }
+        ready.notify_one();
+    }
+};
+
+static constexpr int TREE_DEPTH = 13; // 2^14 - 1 задач за итерацию
+
+/**
+ * @brief Рекурсивно порождает двоичное дерево задач через общую очередь.
+ */
+static void spawnGlobal(GlobalQueuePool& pool, std::atomic<int>& done, int depth) {
+    done.fetch_add(1, std::memory_order_relaxed);
+    if (depth == 0) return;
+    pool.submit([&pool, &done, depth] { spawnGlobal(pool, done, depth - 1); });
+    pool.submit([&pool, &done, depth] { spawnGlobal(pool, done, depth - 1); });
+}
+
+/**
+ * @brief Рекурсивно порождает двоичное дерево задач через локальные очереди планировщика.
+ */
+static void spawnStealing(TaskScheduler& scheduler, std::atomic<int>& done, int depth) {
+    done.fetch_add(1, std::memory_order_relaxed);
+    if (depth == 0) return;
+    scheduler.submit([&scheduler, &done, depth] { spawnStealing(scheduler, done, depth - 1); });
+    scheduler.submit([&scheduler, &done, depth] { spawnStealing(scheduler, done, depth - 1); });
+}
+
+// Мелкие задачи порождают дочерние: в пуле с общей очередью все потоки конкурируют
+// за один мьютекс, в планировщике дочерние задачи остаются в локальной очереди потока,
+// а простаивающие потоки перехватывают их.
+static void BM_GlobalQueueSpawn(benchmark::State& state) {
+    GlobalQueuePool pool(static_cast<std::size_t>(state.range(0)));
+    const int total = (1 << (TREE_DEPTH + 1)) - 1;
+    for (auto _ : state) {
+        std::atomic<int> done{0};
+        pool.submit([&pool, &done] { spawnGlobal(pool, done, TREE_DEPTH); });
+        while (done.load() < total) std::this_thread::yield();
+    }
+    state.SetItemsProcessed(state.iterations() * total);
+}
+BENCHMARK(BM_GlobalQueueSpawn)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
+
+static void BM_WorkStealingSpawn(benchmark::State& state) {
+    TaskScheduler scheduler(static_cast<std::size_t>(state.range(0)));
+    const int total = (1 << (TREE_DEPTH + 1)) - 1;
+    for (auto _ : state) {
+        std::atomic<int> done{0};
+        scheduler.submit([&scheduler, &done] { spawnStealing(scheduler, done, TREE_DEPTH); });
+        while (done.load() < total) std::this_thread::yield();
+    }
+    SchedulerStats stats = scheduler.stats();
+    state.SetItemsProcessed(state.iterations() * total);
+    state.counters["steals"] = static_cast<double>(stats.steals);
+    state.counters["idle_ms"] = static_cast<double>(stats.idleTime.count()) / 1e6;
+}
+BENCHMARK(BM_WorkStealingSpawn)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
+
+// Рекурсивное разбиение работы (parallelFor) по сравнению с нарезкой через общую очередь.
+static void BM_GlobalQueueRange(benchmark::State& state) {
+    GlobalQueuePool pool(static_cast<std::size_t>(state.range(0)));
+    std::vector<double> data(1 << 20, 1.0);
+    for (auto _ : state) {
+        std::atomic<int> remaining{0};
+        std::size_t grain = 1 << 12;
+        for (std::size_t begin = 0; begin < data.size(); begin += grain) {
+            remaining.fetch_add(1);
+            pool.submit([&, begin] {
+                for (std::size_t i = begin; i < begin + grain; ++i) data[i] = data[i] * 1.000001 + 0.5;
+                remaining.fetch_sub(1);
+            });
+        }
+        while (remaining.load() > 0) std::this_thread::yield();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<long long>(data.size()));
+}
+BENCHMARK(BM_GlobalQueueRange)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
+
+static void BM_WorkStealingRange(benchmark::State& state) {
+    TaskScheduler scheduler(static_cast<std::size_t>(state.range(0)));
+    std::vector<double> data(1 << 20, 1.0);
+    for (auto _ : state) {
+        parallelFor(scheduler, 0, data.size(), 1 << 12, [&data](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) data[i] = data[i] * 1.000001 + 0.5;
+        });
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<long long>(data.size()));
+    state.counters["steals"] = static_cast<double>(scheduler.stats().steals);
+}
+BENCHMARK(BM_WorkStealingRange)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
+
+BENCHMARK_MAIN();
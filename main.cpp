@@ -1,13 +1,88 @@
 #include "DBManager.h"
 #include "User.h"
 #include "UIManager.h"
+#include "RolloverJob.h"
+#include "SessionManager.h"
+#include "SnapshotFile.h"
+#include "Metrics.h"
+#include "Tracing.h"
+#include "Logger.h"
+#include "SlowQueryLog.h"
+#include "AuditJournal.h"
 #include <iostream>
 #include <exception>
+#include <chrono>
+#include <cstdlib>
 #include <limits>
 #include <memory>
+#include <thread>
+#include <ctime>
+
+/**
+ * @brief Открывает снимок и запускает режим только для чтения.
+ * @param path Путь к файлу снимка.
+ * @return Код завершения программы.
+ */
+static int runOffline(const std::string& path) {
+    try {
+        SnapshotFile snapshot(path);
+        browseOffline(snapshot);
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "FATAL: No usable snapshot: " << e.what() << std::endl;
+        return 1;
+    }
+}
 
 /** @brief Точка входа. */
 int main() {
+    Logger::configureFromEnvironment();
+    const char* snapshotEnv = std::getenv("HOTEL_SNAPSHOT");
+    const std::string snapshotPath = snapshotEnv && *snapshotEnv ? snapshotEnv : "hotel_snapshot.bin";
+
+    /**
+     * @brief Если задан HOTEL_TRACE_FILE, трассировка операций включена с запуска и сохраняется
+     *        в этот файл при выходе; иначе ее включает и сохраняет администратор из меню.
+     */
+    const char* traceEnv = std::getenv("HOTEL_TRACE_FILE");
+    const std::string tracePath = traceEnv && *traceEnv ? traceEnv : "hotel_trace.json";
+    Tracer::setThreadName("ui");
+    Tracer::setEnabled(traceEnv && *traceEnv);
+
+    /**
+     * @brief Если задан HOTEL_SLOW_QUERY_MS, для запросов дольше порога собираются планы
+     *        EXPLAIN (ANALYZE, BUFFERS) на отдельном соединении.
+     */
+    std::shared_ptr<SlowQueryLog> slowQueries;
+    if (const char* slowEnv = std::getenv("HOTEL_SLOW_QUERY_MS"); slowEnv && std::strtol(slowEnv, nullptr, 10) > 0) {
+        SlowQueryConfig config;
+        config.threshold = std::chrono::milliseconds(std::strtol(slowEnv, nullptr, 10));
+        slowQueries = std::make_shared<SlowQueryLog>([]() -> std::unique_ptr<DBManager> {
+            auto side = std::make_unique<DBManager>("127.0.0.1", "postgres", "dfvgbh04", "hotel_management", 5432);
+            return side->connect() ? std::move(side) : nullptr;
+        }, config);
+    }
+
+    /**
+     * @brief Если задан HOTEL_AUDIT_DIR, смена ролей и статусов и расчет счетов записываются в журнал
+     *        аудита в этом каталоге и в фоне отправляются в таблицу audit_log.
+     */
+    std::unique_ptr<AuditJournal> audit;
+    if (const char* auditDir = std::getenv("HOTEL_AUDIT_DIR"); auditDir && *auditDir) {
+        AuditJournalConfig config;
+        config.directory = auditDir;
+        try {
+            audit = std::make_unique<AuditJournal>([]() -> std::unique_ptr<DBManager> {
+                auto side = std::make_unique<DBManager>("127.0.0.1", "postgres", "dfvgbh04", "hotel_management", 5432);
+                return side->connect() ? std::move(side) : nullptr;
+            }, config);
+            AuditJournal::install(audit.get());
+        } catch (const std::exception& e) {
+            std::cerr << "FATAL: Audit journal unavailable: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
     std::unique_ptr<DBManager> db;
     /**
      * @brief Установка соединения с базой данных PostgreSQL.
@@ -16,102 +91,191 @@ int main() {
     try {
         db = std::make_unique<DBManager>("127.0.0.1", "postgres", "dfvgbh04", "hotel_management", 5432);
         if (!db->connect()) {
-            std::cerr << "FATAL: Failed to connect to database!" << std::endl;
-            return 1;
+            std::cerr << "Failed to connect to database!" << std::endl;
+            return runOffline(snapshotPath);
+        }
+        db->setDefaultTimeout(std::chrono::seconds(10)); // один запрос не может заморозить меню
+        db->useSlowQueryLog(slowQueries);
+        if (const char* replicaList = std::getenv("HOTEL_DB_REPLICAS")) {
+            auto endpoints = ReplicaRouter::parseEndpoints(replicaList, "postgres", "dfvgbh04", "hotel_management");
+            if (!endpoints.empty()) {
+                db->useReplicas(std::make_shared<ReplicaRouter>(std::move(endpoints)));
+            }
         }
     } catch (const std::exception& e) {
-        std::cerr << "FATAL: DB connection error: " << e.what() << std::endl;
-        return 1;
+        std::cerr << "DB connection error: " << e.what() << std::endl;
+        return runOffline(snapshotPath);
+    }
+
+    /**
+     * @brief Ночная смена статусов бронирований выполняется в фоне на отдельном соединении.
+     */
+    DBManager rolloverDb("127.0.0.1", "postgres", "dfvgbh04", "hotel_management", 5432);
+    std::unique_ptr<RolloverJob> rollover;
+    if (rolloverDb.connect()) {
+        rolloverDb.useSlowQueryLog(slowQueries);
+        rollover = std::make_unique<RolloverJob>(rolloverDb);
+        rollover->start();
     }
     
+    /**
+     * @brief Выгрузка метрик в формате Prometheus в файл HOTEL_METRICS_FILE (если задан)
+     *        каждые HOTEL_METRICS_INTERVAL_MS миллисекунд (по умолчанию 15 секунд).
+     */
+    std::unique_ptr<MetricsFileExporter> metricsExporter;
+    if (const char* metricsFile = std::getenv("HOTEL_METRICS_FILE"); metricsFile && *metricsFile) {
+        const char* intervalEnv = std::getenv("HOTEL_METRICS_INTERVAL_MS");
+        long interval = intervalEnv ? std::strtol(intervalEnv, nullptr, 10) : 0;
+        metricsExporter = std::make_unique<MetricsFileExporter>(
+            MetricsRegistry::global(), metricsFile, std::chrono::milliseconds(interval > 0 ? interval : 15000));
+        metricsExporter->start();
+    }
+
+    /**
+     * @brief Снимок для режима только для чтения обновляется в фоне на отдельном соединении,
+     *        поэтому запуск не ждет выгрузки.
+     */
+    std::thread snapshotRefresh([snapshotPath] {
+        Tracer::setThreadName("snapshot");
+        try {
+            DBManager snapshotDb("127.0.0.1", "postgres", "dfvgbh04", "hotel_management", 5432);
+            if (snapshotDb.connect()) {
+                SnapshotWriter::fromDatabase(snapshotDb, RolloverJob::today()).write(snapshotPath, std::time(nullptr));
+                snapshotDb.disconnect();
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Snapshot refresh failed: " << e.what() << std::endl;
+        }
+    });
+
+    /**
+     * @brief Сессия терминала. Истекает после 30 минут бездействия.
+     */
+    SessionManager sessions;
+    SessionContext ctx(sessions);
+
     /**
      * @brief Основной цикл приложения. Показывает меню в зависимости от роли.
      */
     bool running = true;
     while (running) {
-        User* currentUser = User::getCurrentUser();
+        sessions.expireIdle();
+        std::shared_ptr<Session> session = ctx.session();
+        if (!session && !ctx.getToken().empty()) {
+            std::cout << "Session expired. Please log in again." << std::endl;
+            ctx.logout();
+        }
+        User* currentUser = session ? session->user.get() : nullptr;
+        AuditActor actor(currentUser ? currentUser->getId() : 0);
         int choice = -1;
 
-        if (currentUser == nullptr) {
-            showMainMenu();
-            std::cout << "Select action: ";
-            std::cin >> choice;
-            if(std::cin.fail()) {
-                 std::cout << "Invalid input. Please enter a number." << std::endl;
-                 std::cin.clear();
-                 std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-                 continue;
-            }
-            switch (choice) {
-                case 1: login(*db); break;
-                case 2: registerUser(*db); break;
-                case 0: running = false; break;
-                default: std::cout << "Invalid choice.\n"; break;
-            }
-        } else {
-            switch (currentUser->getRole()) {
-                case UserRole::ADMIN:   showAdminMenu();   break;
-                case UserRole::MANAGER: showManagerMenu(); break;
-                case UserRole::USER:    showUserMenu();    break;
-            }
-            std::cout << "Select action: ";
-            std::cin >> choice;
-            if(std::cin.fail()) {
-                std::cout << "Invalid input. Please enter a number." << std::endl;
-                std::cin.clear();
-                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-                continue;
-            }
+        /**
+         * @brief Запрос, не уложившийся в ограничение времени, прерывается; меню остается доступным.
+         */
+        try {
+            if (currentUser == nullptr) {
+                showMainMenu();
+                std::cout << "Select action: ";
+                std::cin >> choice;
+                if(std::cin.fail()) {
+                     std::cout << "Invalid input. Please enter a number." << std::endl;
+                     std::cin.clear();
+                     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                     continue;
+                }
+                switch (choice) {
+                    case 1: login(*db, ctx); break;
+                    case 2: registerUser(*db, ctx); break;
+                    case 0: running = false; break;
+                    default: std::cout << "Invalid choice.\n"; break;
+                }
+            } else {
+                switch (currentUser->getRole()) {
+                    case UserRole::ADMIN:   showAdminMenu();   break;
+                    case UserRole::MANAGER: showManagerMenu(); break;
+                    case UserRole::USER:    showUserMenu();    break;
+                }
+                std::cout << "Select action: ";
+                std::cin >> choice;
+                if(std::cin.fail()) {
+                    std::cout << "Invalid input. Please enter a number." << std::endl;
+                    std::cin.clear();
+                    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                    continue;
+                }
 
-            switch (currentUser->getRole()) {
-                case UserRole::ADMIN:
-                    switch (choice) {
-                        case 1: viewAllBookings(*db); break;
-                        case 2: manageBooking(*db); break;
-                        case 3: addServiceToBooking(*db); break;
-                        case 4: calculateBill(*db); break;
-                        case 5: manageUserRoles(*db); break;
-                        case 6: registerUser(*db); break;
-                        case 7: viewAllRooms(*db); break;
-                        case 8: addRoom(*db); break;
-                        case 9: viewAllServices(*db); break;
-                        case 10: addService(*db); break;
-                        case 0: User::logout(); break;
-                        default: std::cout << "Invalid choice.\n"; break;
-                    }
-                    break;
-                case UserRole::MANAGER:
-                     switch (choice) {
-                        case 1: viewAllBookings(*db); break;
-                        case 2: manageBooking(*db); break;
-                        case 3: calculateBill(*db); break;
-                        case 4: viewAllRooms(*db); break;
-                        case 5: addRoom(*db); break;
-                        case 6: viewAllServices(*db); break;
-                        case 7: addService(*db); break;
-                        case 0: User::logout(); break;
-                        default: std::cout << "Invalid choice.\n"; break;
-                    }
-                    break;
-                case UserRole::USER:
-                     switch (choice) {
-                        case 1: viewAvailableRooms(*db); break;
-                        case 2: makeBooking(*db); break;
-                        case 3: viewMyBookings(*db); break;
-                        case 0: User::logout(); break;
-                        default: std::cout << "Invalid choice.\n"; break;
-                    }
-                    break;
+                switch (currentUser->getRole()) {
+                    case UserRole::ADMIN:
+                        switch (choice) {
+                            case 1: viewAllBookings(*db); break;
+                            case 2: manageBooking(*db); break;
+                            case 3: addServiceToBooking(*db); break;
+                            case 4: calculateBill(*db); break;
+                            case 5: manageUserRoles(*db); break;
+                            case 6: registerUser(*db, ctx); break;
+                            case 7: viewAllRooms(*db); break;
+                            case 8: addRoom(*db); break;
+                            case 9: viewAllServices(*db); break;
+                            case 10: addService(*db); break;
+                            case 11: runNightlyRollover(*db); break;
+                            case 12: viewSystemStats(); break;
+                            case 13: saveOperationTrace(tracePath); break;
+                            case 0: ctx.logout(); break;
+                            default: std::cout << "Invalid choice.\n"; break;
+                        }
+                        break;
+                    case UserRole::MANAGER:
+                         switch (choice) {
+                            case 1: viewAllBookings(*db); break;
+                            case 2: manageBooking(*db); break;
+                            case 3: calculateBill(*db); break;
+                            case 4: viewAllRooms(*db); break;
+                            case 5: addRoom(*db); break;
+                            case 6: viewAllServices(*db); break;
+                            case 7: addService(*db); break;
+                            case 0: ctx.logout(); break;
+                            default: std::cout << "Invalid choice.\n"; break;
+                        }
+                        break;
+                    case UserRole::USER:
+                         switch (choice) {
+                            case 1: viewAvailableRooms(*db); break;
+                            case 2: makeBooking(*db, ctx); break;
+                            case 3: viewMyBookings(*db, ctx); break;
+                            case 0: ctx.logout(); break;
+                            default: std::cout << "Invalid choice.\n"; break;
+                        }
+                        break;
+                }
             }
+        } catch (const QueryTimeoutError& e) {
+            std::cerr << "Operation timed out: " << e.what() << std::endl;
         }
         std::cout << std::endl;
     }
 
+    if (rollover) {
+        rollover->stop();
+    }
+    if (metricsExporter) {
+        metricsExporter->stop();
+    }
+    snapshotRefresh.join();
+
     if (db) {
         db->disconnect();
     }
     
-    User::logout();
+    ctx.logout();
+
+    if (audit) {
+        AuditJournal::install(nullptr);
+        audit->stop();
+    }
+
+    if (Tracer::enabled() && !Tracer::writeChromeTrace(tracePath)) {
+        std::cerr << "Failed to write trace file " << tracePath << std::endl;
+    }
     
     std::cout << "Thank you for using the Hotel Management System!" << std::endl;
     return 0;
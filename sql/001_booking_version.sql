@@ -0,0 +1,2 @@
+-- Версия строки бронирования для оптимистичной блокировки (Booking::updateStatus, addService, removeService).
+ALTER TABLE bookings ADD COLUMN IF NOT EXISTS version INTEGER NOT NULL DEFAULT 0;
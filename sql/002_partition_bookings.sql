@@ -0,0 +1,58 @@
+-- Помесячное секционирование bookings и booking_services по дате заезда (PartitionManager).
+-- Ключ секционирования должен входить в первичный ключ и в уникальные ограничения, поэтому
+-- первичный ключ bookings становится (id, date_from), а booking_services получает столбец
+-- booking_date_from - дату заезда бронирования, по которой секционируется таблица услуг.
+-- Секции называются <таблица>_YYYY_MM; секции DEFAULT принимают строки вне созданных месяцев.
+-- Миграция создает секции для всей истории и трех месяцев вперед; дальше их создает PartitionManager.
+
+BEGIN;
+
+ALTER TABLE booking_services RENAME TO booking_services_legacy;
+ALTER TABLE bookings RENAME TO bookings_legacy;
+
+CREATE TABLE bookings (LIKE bookings_legacy INCLUDING DEFAULTS INCLUDING CONSTRAINTS)
+    PARTITION BY RANGE (date_from);
+ALTER TABLE bookings ADD PRIMARY KEY (id, date_from);
+ALTER TABLE bookings ADD FOREIGN KEY (user_id) REFERENCES users(id);
+ALTER TABLE bookings ADD FOREIGN KEY (room_id) REFERENCES rooms(id);
+CREATE INDEX ON bookings (room_id, date_from);
+CREATE INDEX ON bookings (user_id);
+CREATE INDEX ON bookings (id);
+ALTER SEQUENCE bookings_id_seq OWNED BY bookings.id;
+
+CREATE TABLE booking_services (LIKE booking_services_legacy INCLUDING DEFAULTS INCLUDING CONSTRAINTS,
+                               booking_date_from DATE NOT NULL)
+    PARTITION BY RANGE (booking_date_from);
+ALTER TABLE booking_services ADD PRIMARY KEY (booking_id, service_id, booking_date_from);
+ALTER TABLE booking_services ADD FOREIGN KEY (service_id) REFERENCES services(id);
+ALTER TABLE booking_services ADD FOREIGN KEY (booking_id, booking_date_from)
+    REFERENCES bookings(id, date_from) ON DELETE CASCADE;
+
+CREATE TABLE bookings_default PARTITION OF bookings DEFAULT;
+CREATE TABLE booking_services_default PARTITION OF booking_services DEFAULT;
+
+DO $$
+DECLARE
+    month DATE := date_trunc('month', COALESCE((SELECT min(date_from) FROM bookings_legacy), current_date));
+    last DATE := date_trunc('month', current_date) + INTERVAL '3 months';
+    suffix TEXT;
+BEGIN
+    WHILE month <= last LOOP
+        suffix := to_char(month, 'YYYY_MM');
+        EXECUTE format('CREATE TABLE bookings_%s PARTITION OF bookings FOR VALUES FROM (%L) TO (%L)',
+                       suffix, month, month + INTERVAL '1 month');
+        EXECUTE format('CREATE TABLE booking_services_%s PARTITION OF booking_services FOR VALUES FROM (%L) TO (%L)',
+                       suffix, month, month + INTERVAL '1 month');
+        month := month + INTERVAL '1 month';
+    END LOOP;
+END $$;
+
+INSERT INTO bookings SELECT * FROM bookings_legacy;
+INSERT INTO booking_services (booking_id, service_id, quantity, booking_date_from)
+    SELECT s.booking_id, s.service_id, s.quantity, b.date_from
+    FROM booking_services_legacy s JOIN bookings b ON b.id = s.booking_id;
+
+DROP TABLE booking_services_legacy;
+DROP TABLE bookings_legacy;
+
+COMMIT;
@@ -0,0 +1,14 @@
+-- Принадлежность номеров и бронирований отелю сети (ShardRouter).
+-- Каждая база данных-шард хранит один или несколько отелей; существующие данные относятся к отелю 1.
+-- Номера комнат остаются уникальными в пределах базы данных.
+
+CREATE TABLE IF NOT EXISTS properties (
+    id INTEGER PRIMARY KEY,
+    name VARCHAR(100) NOT NULL
+);
+INSERT INTO properties (id, name) VALUES (1, 'Main') ON CONFLICT (id) DO NOTHING;
+
+ALTER TABLE rooms ADD COLUMN IF NOT EXISTS property_id INTEGER NOT NULL DEFAULT 1 REFERENCES properties(id);
+ALTER TABLE bookings ADD COLUMN IF NOT EXISTS property_id INTEGER NOT NULL DEFAULT 1 REFERENCES properties(id);
+CREATE INDEX IF NOT EXISTS rooms_property_idx ON rooms (property_id);
+CREATE INDEX IF NOT EXISTS bookings_property_idx ON bookings (property_id, date_from);
@@ -0,0 +1,14 @@
+-- Планы медленных запросов (SlowQueryLog): отпечаток нормализованного текста, образец исходного
+-- текста и вывод EXPLAIN (ANALYZE, BUFFERS) или оценочного EXPLAIN, если analyzed = FALSE.
+
+CREATE TABLE IF NOT EXISTS slow_query_plans (
+    id BIGSERIAL PRIMARY KEY,
+    fingerprint CHAR(16) NOT NULL,
+    normalized_query TEXT NOT NULL,
+    sample_query TEXT NOT NULL,
+    duration_ms DOUBLE PRECISION NOT NULL,
+    analyzed BOOLEAN NOT NULL,
+    plan TEXT NOT NULL,
+    captured_at TIMESTAMPTZ NOT NULL DEFAULT now()
+);
+CREATE INDEX IF NOT EXISTS slow_query_plans_fingerprint_idx ON slow_query_plans (fingerprint, captured_at DESC);
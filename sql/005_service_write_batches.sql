@@ -0,0 +1,8 @@
+-- Последняя записанная пачка отложенной записи услуг (ServiceWriteBehind) каждого процесса.
+-- Номер пачки фиксируется в одной транзакции с ее изменениями booking_services, поэтому пачка,
+-- повторно отправленная после аварийного завершения, не применяется дважды.
+
+CREATE TABLE IF NOT EXISTS service_write_batches (
+    writer VARCHAR(100) PRIMARY KEY,
+    last_batch BIGINT NOT NULL
+);
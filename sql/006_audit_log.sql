@@ -0,0 +1,17 @@
+-- Журнал аудита: смена ролей пользователей, смена статусов бронирований и расчет счетов.
+-- Записи переносятся сюда из локальных сегментов AuditJournal; номер записи уникален в пределах
+-- узла, поэтому повторная отправка пачки после сбоя ничего не дублирует.
+
+CREATE TABLE IF NOT EXISTS audit_log (
+    node VARCHAR(100) NOT NULL,
+    sequence BIGINT NOT NULL,
+    recorded_at TIMESTAMPTZ NOT NULL,
+    actor_id INTEGER,
+    action VARCHAR(32) NOT NULL,
+    target_id INTEGER NOT NULL,
+    detail TEXT NOT NULL,
+    PRIMARY KEY (node, sequence)
+);
+
+CREATE INDEX IF NOT EXISTS audit_log_target_idx ON audit_log (action, target_id, recorded_at);
+CREATE INDEX IF NOT EXISTS audit_log_actor_idx ON audit_log (actor_id, recorded_at);
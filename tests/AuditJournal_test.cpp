@@ -0,0 +1,147 @@
+#include "gtest/gtest.h"
+#include "AuditJournal.h"
+#include "DBManager.h"
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+std::string journalDirectory(const std::string& name) {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove_all(path);
+    return path.string();
+}
+
+AuditJournalConfig offlineConfig(const std::string& directory) {
+    AuditJournalConfig config;
+    config.directory = directory;
+    config.segmentBytes = 64 << 10;
+    config.shipInterval = 1h;  // отправка только при остановке
+    return config;
+}
+
+AuditJournal::Factory unavailable() {
+    return []() -> std::unique_ptr<DBManager> { return nullptr; };
+}
+
+} // namespace
+
+TEST(AuditJournalTest, ConcurrentAppendsAreDurableAndSurviveRestart) {
+    std::string directory = journalDirectory("audit_restart_test");
+    {
+        AuditJournal journal(unavailable(), offlineConfig(directory));
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&journal, t] {
+                for (int i = 0; i < 25; ++i) {
+                    journal.append(AuditAction::STATUS_CHANGE, t * 100 + i, "pending->confirmed", t + 1);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        EXPECT_EQ(journal.lastSequence(), 100u);
+        EXPECT_FALSE(journal.ship());
+        EXPECT_EQ(journal.shippedSequence(), 0u);
+    }
+    std::vector<AuditRecord> records = AuditJournal::readDirectory(directory);
+    ASSERT_EQ(records.size(), 100u);
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        EXPECT_EQ(records[i].sequence, i + 1);
+        EXPECT_EQ(records[i].detail, "pending->confirmed");
+    }
+    {
+        AuditJournal journal(unavailable(), offlineConfig(directory));
+        EXPECT_EQ(journal.append(AuditAction::ROLE_CHANGE, 5, "user->manager", 1), 101u);
+    }
+    records = AuditJournal::readDirectory(directory);
+    ASSERT_EQ(records.size(), 101u);
+    EXPECT_EQ(records.back().action, AuditAction::ROLE_CHANGE);
+    EXPECT_EQ(records.back().targetId, 5);
+    EXPECT_EQ(records.back().actorId, 1);
+    std::filesystem::remove_all(directory);
+}
+
+TEST(AuditJournalTest, TornRecordIsDroppedOnRecovery) {
+    std::string directory = journalDirectory("audit_torn_test");
+    {
+        AuditJournal journal(unavailable(), offlineConfig(directory));
+        journal.append(AuditAction::BILL_CALCULATED, 7, "total=150.000000", 2);
+        journal.append(AuditAction::BILL_CALCULATED, 8, "total=90.000000", 2);
+    }
+    std::string segment = std::filesystem::directory_iterator(directory)->path().string();
+    {
+        // Повреждение подробностей последней записи (аварийное завершение во время записи).
+        std::fstream file(segment, std::ios::in | std::ios::out | std::ios::binary);
+        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        std::size_t at = content.find("total=90");
+        ASSERT_NE(at, std::string::npos);
+        file.seekp(static_cast<std::streamoff>(at));
+        file.write("X", 1);
+    }
+    {
+        AuditJournal journal(unavailable(), offlineConfig(directory));
+        EXPECT_EQ(journal.lastSequence(), 1u);
+        EXPECT_EQ(journal.append(AuditAction::STATUS_CHANGE, 8, "confirmed->cancelled", 2), 2u);
+    }
+    std::vector<AuditRecord> records = AuditJournal::readDirectory(directory);
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_EQ(records[0].detail, "total=150.000000");
+    EXPECT_EQ(records[1].detail, "confirmed->cancelled");
+    std::filesystem::remove_all(directory);
+}
+
+TEST(AuditJournalTest, RotatesSegmentsAndTruncatesDetail) {
+    std::string directory = journalDirectory("audit_rotate_test");
+    AuditJournalConfig config = offlineConfig(directory);
+    config.segmentBytes = 4096;
+    config.waitForSync = false;
+    {
+        AuditJournal journal(unavailable(), config);
+        for (int i = 0; i < 40; ++i) {
+            journal.append(AuditAction::STATUS_CHANGE, i, std::string(200, 'a'), 0);
+        }
+        std::uint64_t last = journal.append(AuditAction::STATUS_CHANGE, 0, std::string(5000, 'b'), 0);
+        journal.waitDurable(last);
+        EXPECT_GT(journal.segmentCount(), 2u);
+    }
+    std::vector<AuditRecord> records = AuditJournal::readDirectory(directory);
+    ASSERT_EQ(records.size(), 41u);
+    EXPECT_EQ(records.back().sequence, 41u);
+    EXPECT_EQ(records.back().detail.size(), AuditJournal::MAX_DETAIL);
+    std::filesystem::remove_all(directory);
+}
+
+TEST(AuditJournalTest, NoteRecordsCurrentActor) {
+    std::string directory = journalDirectory("audit_note_test");
+    AuditJournal::note(AuditAction::ROLE_CHANGE, 1, "ignored");  // журнал не установлен
+    {
+        AuditJournal journal(unavailable(), offlineConfig(directory));
+        AuditJournal::install(&journal);
+        {
+            AuditActor admin(3);
+            AuditJournal::note(AuditAction::ROLE_CHANGE, 9, "user->admin");
+            {
+                AuditActor system(0);
+                AuditJournal::note(AuditAction::STATUS_CHANGE, 4, "confirmed->completed");
+            }
+            EXPECT_EQ(AuditActor::current(), 3);
+        }
+        EXPECT_EQ(AuditActor::current(), 0);
+    }
+    AuditJournal::note(AuditAction::ROLE_CHANGE, 1, "ignored");  // журнал снят деструктором
+
+    std::vector<AuditRecord> records = AuditJournal::readDirectory(directory);
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_EQ(records[0].actorId, 3);
+    EXPECT_EQ(records[1].actorId, 0);
+    EXPECT_EQ(AuditJournal::parseAction("status_change"), AuditAction::STATUS_CHANGE);
+    EXPECT_STREQ(AuditJournal::actionName(AuditAction::BILL_CALCULATED), "bill_calculated");
+    EXPECT_THROW(AuditJournal::parseAction("delete"), std::invalid_argument);
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,60 @@
+#include "gtest/gtest.h"
+#include "CompactRecords.h"
+#include <string>
+
+TEST(CompactRecordsTest, InlineStringStoresValue) {
+    InlineString<13> number("101");
+    ASSERT_EQ(number.view(), "101");
+    ASSERT_THROW(InlineString<3>("1234"), std::length_error);
+}
+
+TEST(CompactRecordsTest, StringArenaKeepsViewsStable) {
+    StringArena arena(64);
+    std::string_view first = arena.store("A cozy single room.");
+    std::string longText(200, 'x');
+    std::string_view second = arena.store(longText);
+    for (int i = 0; i < 100; ++i) {
+        arena.store("filler text");
+    }
+
+    ASSERT_EQ(first, "A cozy single room.");
+    ASSERT_EQ(second, longText);
+    ASSERT_EQ(arena.bytesStored(), 19u + 200u + 100u * 11u);
+}
+
+TEST(CompactRecordsTest, RoomTableEncodesTypes) {
+    RoomTable table;
+    table.add(1, "101", "Single", 50.0, "A cozy single room.");
+    table.add(2, "102", "Double", 80.0, "Two beds.");
+    table.add(3, "103", "Single", 55.0, "");
+
+    ASSERT_EQ(table.size(), 3u);
+    ASSERT_EQ(table.typeDictionary().size(), 2u);
+    ASSERT_EQ(table[0].typeId, table[2].typeId);
+    ASSERT_EQ(table.number(table[1]), "102");
+    ASSERT_EQ(table.type(table[1]), "Double");
+    ASSERT_EQ(table.description(table[0]), "A cozy single room.");
+    ASSERT_EQ(table[2].pricePerDay, 55.0);
+}
+
+TEST(CompactRecordsTest, TypeNamesStayValidWhileDictionaryGrows) {
+    TypeDictionary types;
+    std::string_view first = types.name(types.intern("Suite"));  // короткая строка в буфере SSO
+    for (int i = 0; i < 1000; ++i) {
+        types.intern("Type " + std::to_string(i));
+    }
+    ASSERT_EQ(first, "Suite");
+    ASSERT_EQ(types.size(), 1001u);
+}
+
+TEST(CompactRecordsTest, UserAndServiceTables) {
+    UserTable users;
+    users.add(1, "admin", UserRole::ADMIN);
+    ServiceTable services;
+    services.add(1, "Breakfast", 15.0);
+
+    ASSERT_EQ(users[0].login.view(), "admin");
+    ASSERT_EQ(users[0].role, UserRole::ADMIN);
+    ASSERT_EQ(services[0].name, "Breakfast");
+    ASSERT_EQ(services[0].price, 15.0);
+}
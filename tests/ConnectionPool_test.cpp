@@ -0,0 +1,39 @@
+#include "gtest/gtest.h"
+#include "ConnectionPool.h"
+#include <thread>
+
+namespace {
+ConnectionPool::Factory offlineFactory() {
+    return [] { return std::make_unique<DBManager>("127.0.0.1", "user", "pass", "db", 5432); };
+}
+}
+
+TEST(ConnectionPoolTest, LeaseReturnsConnectionToPool) {
+    ConnectionPool pool(offlineFactory(), 2);
+    ASSERT_EQ(pool.size(), 2u);
+    {
+        ConnectionPool::Lease first = pool.acquire();
+        ConnectionPool::Lease second = pool.acquire();
+        ASSERT_TRUE(first);
+        ASSERT_NE(first.get(), second.get());
+        ASSERT_EQ(pool.available(), 0u);
+        ASSERT_FALSE(pool.tryAcquire(std::chrono::milliseconds(10)));
+    }
+    ASSERT_EQ(pool.available(), 2u);
+}
+
+TEST(ConnectionPoolTest, WaitingAcquireIsWokenByRelease) {
+    ConnectionPool pool(offlineFactory(), 1);
+    ConnectionPool::Lease held = pool.acquire();
+    std::thread releaser([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        held = ConnectionPool::Lease();
+    });
+    ConnectionPool::Lease waited = pool.tryAcquire(std::chrono::seconds(5));
+    releaser.join();
+    ASSERT_TRUE(waited);
+}
+
+TEST(ConnectionPoolTest, FailingFactoryThrows) {
+    ASSERT_THROW(ConnectionPool([] { return std::unique_ptr<DBManager>(); }, 1), std::runtime_error);
+}
@@ -0,0 +1,134 @@
+#include "gtest/gtest.h"
+#include "DataGenerator.h"
+#include <map>
+#include <set>
+#include <sstream>
+
+namespace {
+DataGenConfig smallConfig() {
+    DataGenConfig config;
+    config.seed = 42;
+    config.rooms = 30;
+    config.guests = 200;
+    config.years = 1;
+    config.monthsAhead = 2;
+    config.today = "2024-03-15";
+    return config;
+}
+
+std::string dump(const DataGenerator& generator, DataTable table) {
+    std::string text;
+    generator.generate(table, [&](const std::string& chunk) { text += chunk; }, 512);
+    return text;
+}
+
+std::vector<std::vector<std::string>> rows(const std::string& text) {
+    std::vector<std::vector<std::string>> result;
+    std::stringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line)) {
+        std::vector<std::string> fields;
+        std::stringstream stream(line);
+        std::string field;
+        while (std::getline(stream, field, '\t')) {
+            fields.push_back(field);
+        }
+        result.push_back(fields);
+    }
+    return result;
+}
+}
+
+TEST(DataGeneratorTest, SameSeedGivesSameData) {
+    DataGenerator first(smallConfig());
+    DataGenerator second(smallConfig());
+    DataGenConfig other = smallConfig();
+    other.seed = 43;
+    DataGenerator third(other);
+
+    for (DataTable table : DataGenerator::loadOrder()) {
+        EXPECT_EQ(dump(first, table), dump(second, table)) << DataGenerator::tableName(table);
+    }
+    EXPECT_NE(dump(first, DataTable::BOOKINGS), dump(third, DataTable::BOOKINGS));
+    EXPECT_EQ(first.firstDay(), "2023-03-15");
+    EXPECT_EQ(first.lastDay(), "2024-05-15");
+    EXPECT_EQ(first.monthsSpanned(), 14);
+}
+
+TEST(DataGeneratorTest, BookingsOfRoomDoNotOverlapAndReferencesAreConsistent) {
+    DataGenConfig config = smallConfig();
+    config.properties = 3;
+    DataGenerator generator(config);
+
+    auto bookings = rows(dump(generator, DataTable::BOOKINGS));
+    ASSERT_GT(bookings.size(), 100u);
+    std::map<int, std::string> lastCheckout;
+    std::map<int, std::string> dateFromById;
+    std::map<int, int> propertyOfRoom;
+    for (const auto& room : rows(dump(generator, DataTable::ROOMS))) {
+        ASSERT_EQ(room.size(), 6u);
+        propertyOfRoom[std::stoi(room[0])] = std::stoi(room[5]);
+    }
+    EXPECT_EQ(propertyOfRoom.size(), 30u);
+    EXPECT_EQ(propertyOfRoom.at(30), 3);
+
+    for (const auto& booking : bookings) {
+        ASSERT_EQ(booking.size(), 8u);
+        int id = std::stoi(booking[0]);
+        int userId = std::stoi(booking[1]);
+        int roomId = std::stoi(booking[2]);
+        EXPECT_EQ(id, static_cast<int>(dateFromById.size()) + 1);
+        EXPECT_GE(userId, 3);
+        EXPECT_LE(userId, config.guests + 2);
+        EXPECT_EQ(std::stoi(booking[3]), propertyOfRoom.at(roomId));
+        EXPECT_LT(booking[4], booking[5]);
+        if (lastCheckout.count(roomId)) {
+            EXPECT_LE(lastCheckout[roomId], booking[4]) << "booking " << id << " overlaps the previous one";
+        }
+        lastCheckout[roomId] = booking[5];
+        dateFromById[id] = booking[4];
+        if (booking[5] <= config.today && booking[6] != "cancelled") {
+            EXPECT_EQ(booking[6], "completed");
+        }
+    }
+
+    std::set<std::pair<int, int>> lines;
+    for (const auto& line : rows(dump(generator, DataTable::BOOKING_SERVICES))) {
+        ASSERT_EQ(line.size(), 4u);
+        int bookingId = std::stoi(line[0]);
+        ASSERT_TRUE(dateFromById.count(bookingId));
+        EXPECT_EQ(line[3], dateFromById[bookingId]);
+        EXPECT_TRUE(lines.emplace(bookingId, std::stoi(line[1])).second);
+        EXPECT_GE(std::stoi(line[2]), 1);
+    }
+    EXPECT_FALSE(lines.empty());
+}
+
+TEST(DataGeneratorTest, SeasonalityAndCancellationRate) {
+    DataGenConfig config = smallConfig();
+    config.rooms = 200;
+    config.years = 3;
+    config.seasonality = 0.8;
+    config.cancellationRate = 0.2;
+    DataGenerator generator(config);
+
+    int summer = 0;
+    int winter = 0;
+    int cancelled = 0;
+    int total = 0;
+    generator.forEachBooking([&](const DataGenerator::GeneratedBooking& booking) {
+        std::string month = generator.date(booking.dateFrom).substr(5, 2);
+        summer += month == "07";
+        winter += month == "01";
+        cancelled += std::string(booking.status) == "cancelled";
+        ++total;
+    });
+    EXPECT_GT(summer, winter);
+    EXPECT_NEAR(static_cast<double>(cancelled) / total, 0.2, 0.03);
+
+    config.occupancy = 1.5;
+    EXPECT_THROW(DataGenerator{config}, std::invalid_argument);
+    config = smallConfig();
+    config.today = "2024-02-30";
+    EXPECT_THROW(DataGenerator{config}, std::invalid_argument);
+}
@@ -0,0 +1,57 @@
+#include "gtest/gtest.h"
+#include "DBManager.h"
+#include "Deadline.h"
+#include <chrono>
+#include <thread>
+
+TEST(DeadlineTest, DefaultDeadlineNeverExpires) {
+    Deadline deadline;
+    ASSERT_FALSE(deadline.isBounded());
+    ASSERT_FALSE(deadline.expired());
+    ASSERT_EQ(deadline.remaining(), std::chrono::milliseconds::max());
+}
+
+TEST(DeadlineTest, BoundedDeadlineExpires) {
+    Deadline deadline = Deadline::after(std::chrono::milliseconds(20));
+    ASSERT_TRUE(deadline.isBounded());
+    ASSERT_FALSE(deadline.expired());
+    ASSERT_LE(deadline.remaining().count(), 20);
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    ASSERT_TRUE(deadline.expired());
+    ASSERT_EQ(deadline.remaining().count(), 0);
+}
+
+TEST(DeadlineTest, EarliestPicksTighterDeadline) {
+    Deadline loose = Deadline::after(std::chrono::seconds(10));
+    Deadline tight = Deadline::after(std::chrono::milliseconds(10));
+    ASSERT_EQ(loose.earliest(tight).time(), tight.time());
+    ASSERT_EQ(tight.earliest(loose).time(), tight.time());
+    ASSERT_EQ(Deadline::never().earliest(tight).time(), tight.time());
+    ASSERT_FALSE(Deadline::never().earliest(Deadline::never()).isBounded());
+}
+
+TEST(DeadlineTest, ScopeNarrowsAndRestoresConnectionDeadline) {
+    DBManager dbManager("localhost", "user", "password", "database", 5432);
+    ASSERT_FALSE(dbManager.getDeadline().isBounded());
+    Deadline outer = Deadline::after(std::chrono::seconds(5));
+    {
+        DBManager::DeadlineScope scope(dbManager, outer);
+        ASSERT_EQ(dbManager.getDeadline().time(), outer.time());
+        {
+            DBManager::DeadlineScope looser(dbManager, Deadline::after(std::chrono::seconds(60)));
+            ASSERT_EQ(dbManager.getDeadline().time(), outer.time());
+        }
+        ASSERT_EQ(dbManager.getDeadline().time(), outer.time());
+    }
+    ASSERT_FALSE(dbManager.getDeadline().isBounded());
+}
+
+TEST(DeadlineTest, QueryTimeoutIsRuntimeError) {
+    try {
+        throw QueryTimeoutError("Query timed out after 5 ms");
+    } catch (const std::runtime_error& e) {
+        ASSERT_STREQ(e.what(), "Query timed out after 5 ms");
+        return;
+    }
+    FAIL();
+}
@@ -0,0 +1,31 @@
+#include "gtest/gtest.h"
+#include "DurableFile.h"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace {
+std::string readAll(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+}
+
+TEST(DurableFileTest, ReplaceOverwritesExistingTarget) {
+    std::string target = (std::filesystem::temp_directory_path() / "durable_file_test.bin").string();
+    std::string temporary = target + ".tmp";
+    writeDurably(target, "old");
+    writeDurably(temporary, std::string("new\0data", 8));
+    replaceDurably(temporary, target);
+    EXPECT_EQ(readAll(target), std::string("new\0data", 8));
+    EXPECT_FALSE(std::filesystem::exists(temporary));
+    std::filesystem::remove(target);
+}
+
+TEST(DurableFileTest, MissingSourceThrows) {
+    std::string target = (std::filesystem::temp_directory_path() / "durable_file_missing.bin").string();
+    EXPECT_THROW(replaceDurably(target + ".absent", target), std::runtime_error);
+    EXPECT_THROW(writeDurably((std::filesystem::temp_directory_path() / "no_such_dir" / "x.bin").string(), "x"),
+                 std::runtime_error);
+}
@@ -0,0 +1,41 @@
+#include "gtest/gtest.h"
+#include "FlatHashIndex.h"
+#include <string>
+
+TEST(FlatHashIndexTest, InsertAndFind) {
+    FlatHashIndex<int> index;
+    ASSERT_TRUE(index.insert("101", 1));
+    ASSERT_TRUE(index.insert("102", 2));
+
+    ASSERT_EQ(index.size(), 2u);
+    ASSERT_NE(index.find("101"), nullptr);
+    ASSERT_EQ(*index.find("101"), 1);
+    ASSERT_EQ(*index.find("102"), 2);
+    ASSERT_EQ(index.find("103"), nullptr);
+}
+
+TEST(FlatHashIndexTest, InsertExistingKeyUpdatesValue) {
+    FlatHashIndex<int> index;
+    ASSERT_TRUE(index.insert("admin", 1));
+    ASSERT_FALSE(index.insert("admin", 7));
+
+    ASSERT_EQ(index.size(), 1u);
+    ASSERT_EQ(*index.find("admin"), 7);
+}
+
+TEST(FlatHashIndexTest, GrowsBeyondInitialCapacity) {
+    FlatHashIndex<int> index(4);
+    for (int i = 0; i < 10000; ++i) {
+        index.insert("room-" + std::to_string(i), i);
+    }
+
+    ASSERT_EQ(index.size(), 10000u);
+    for (int i = 0; i < 10000; ++i) {
+        const int* value = index.find("room-" + std::to_string(i));
+        ASSERT_NE(value, nullptr);
+        ASSERT_EQ(*value, i);
+    }
+    index.clear();
+    ASSERT_TRUE(index.empty());
+    ASSERT_FALSE(index.contains("room-1"));
+}
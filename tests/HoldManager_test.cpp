@@ -0,0 +1,171 @@
+#include "gtest/gtest.h"
+#include "HoldManager.h"
+#include "Booking.h"
+#include "DBManager.h"
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono;
+
+namespace {
+
+std::string env(const char* name, const std::string& fallback) {
+    const char* value = std::getenv(name);
+    return value && *value ? std::string(value) : fallback;
+}
+
+std::unique_ptr<DBManager> makeDatabase() {
+    return std::make_unique<DBManager>(env("HOTEL_DB_HOST", "127.0.0.1"), env("HOTEL_DB_USER", "postgres"),
+                                       env("HOTEL_DB_PASSWORD", "dfvgbh04"), env("HOTEL_DB_NAME", "hotel_management"),
+                                       std::stoi(env("HOTEL_DB_PORT", "5432")));
+}
+
+} // namespace
+
+TEST(HoldManagerTest, HoldBlocksOverlappingDatesOfOtherUsers) {
+    HoldManager holds(seconds(60));
+    auto start = HoldManager::Clock::now();
+    auto hold = holds.place(5, 1, "2025-06-01", "2025-06-05", start);
+    ASSERT_TRUE(hold.has_value());
+    EXPECT_EQ(hold->roomId, 5);
+
+    EXPECT_FALSE(holds.place(5, 2, "2025-06-04", "2025-06-08", start).has_value());
+    EXPECT_TRUE(holds.place(5, 2, "2025-06-05", "2025-06-08", start).has_value());  // выезд в день заезда
+    EXPECT_TRUE(holds.place(6, 2, "2025-06-01", "2025-06-05", start).has_value());  // другой номер
+    EXPECT_TRUE(holds.place(5, 1, "2025-06-02", "2025-06-03", start).has_value());  // свое удержание не мешает
+
+    EXPECT_TRUE(holds.isHeld(5, "2025-06-03", "2025-06-04", 0, start));
+    EXPECT_TRUE(holds.isHeld(5, "2025-06-03", "2025-06-04", 2, start));
+    EXPECT_FALSE(holds.isHeld(5, "2025-05-01", "2025-06-01", 0, start));
+
+    EXPECT_FALSE(holds.release(hold->id, 2));  // чужое удержание
+    EXPECT_TRUE(holds.release(hold->id, 1));
+    EXPECT_FALSE(holds.find(hold->id, start).has_value());
+    EXPECT_EQ(holds.size(), 3u);
+}
+
+TEST(HoldManagerTest, HoldsExpireAfterTtlUnlessExtended) {
+    HoldManager holds(seconds(60), 16);
+    auto start = HoldManager::Clock::now();
+    auto idle = holds.place(1, 1, "2025-06-01", "2025-06-05", start);
+    auto extended = holds.place(2, 1, "2025-06-01", "2025-06-05", start);
+    ASSERT_TRUE(idle && extended);
+
+    EXPECT_TRUE(holds.extend(extended->id, 1, start + seconds(45)));
+    EXPECT_FALSE(holds.extend(extended->id, 2, start + seconds(45)));
+
+    // Истекшее удержание перестает действовать сразу, до освобождения колесом.
+    EXPECT_FALSE(holds.find(idle->id, start + seconds(61)).has_value());
+    EXPECT_TRUE(holds.place(1, 2, "2025-06-01", "2025-06-05", start + seconds(61)).has_value());
+
+    EXPECT_EQ(holds.expire(start + seconds(70)), 1u);
+    EXPECT_TRUE(holds.find(extended->id, start + seconds(70)).has_value());
+    EXPECT_EQ(holds.expire(start + seconds(200)), 2u);
+    EXPECT_EQ(holds.size(), 0u);
+}
+
+TEST(HoldManagerTest, ConcurrentHoldsGrantEachRangeOnce) {
+    HoldManager holds(seconds(60));
+    auto start = HoldManager::Clock::now();
+    std::vector<int> granted(8, 0);
+    std::vector<std::thread> threads;
+    for (int user = 1; user <= 8; ++user) {
+        threads.emplace_back([&, user] {
+            for (int room = 0; room < 500; ++room) {
+                if (holds.place(room, user, "2025-06-01", "2025-06-05", start)) {
+                    ++granted[user - 1];
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    int total = 0;
+    for (int count : granted) {
+        total += count;
+    }
+    EXPECT_EQ(total, 500);
+    EXPECT_EQ(holds.size(), 500u);
+    EXPECT_EQ(holds.expire(start + seconds(61)), 500u);
+}
+
+TEST(HoldManagerTest, FailedConfirmKeepsHoldForRetry) {
+    HoldManager holds(seconds(60));
+    auto start = HoldManager::Clock::now();
+    auto hold = holds.place(9, 1, "2025-06-01", "2025-06-05", start);
+    ASSERT_TRUE(hold.has_value());
+    EXPECT_EQ(holds.confirm(*makeDatabase(), hold->id, 2, start), nullptr);  // чужое удержание
+    EXPECT_EQ(holds.confirm(*makeDatabase(), hold->id, 1, start + seconds(61)), nullptr);  // истекло
+
+    DBManager offline("127.0.0.1", "postgres", "", "hotel_management");  // без connect
+    EXPECT_THROW(holds.confirm(offline, hold->id, 1, start), std::runtime_error);
+    auto kept = holds.find(hold->id, start);
+    ASSERT_TRUE(kept.has_value());
+    EXPECT_FALSE(kept->converting);
+    EXPECT_FALSE(holds.place(9, 2, "2025-06-02", "2025-06-03", start).has_value());
+    EXPECT_TRUE(holds.release(hold->id, 1));
+}
+
+TEST(HoldManagerTest, ConcurrentConfirmsBookRoomOnce) {
+    std::unique_ptr<DBManager> setup = makeDatabase();
+    if (!setup->connect()) {
+        GTEST_SKIP() << "PostgreSQL is not available";
+    }
+    PGResultWrapper ids = setup->executeQuery(
+        "SELECT (SELECT id FROM rooms ORDER BY id LIMIT 1), (SELECT id FROM users ORDER BY id LIMIT 1);");
+    if (PQgetisnull(ids.get(), 0, 0) || PQgetisnull(ids.get(), 0, 1)) {
+        GTEST_SKIP() << "No rooms or users in the database";
+    }
+    int roomId = std::stoi(PQgetvalue(ids.get(), 0, 0));
+    int userId = std::stoi(PQgetvalue(ids.get(), 0, 1));
+    const std::string cleanup = "DELETE FROM bookings WHERE room_id = " + std::to_string(roomId) +
+                                " AND date_from >= '2199-01-01' AND date_from < '2199-02-01';";
+    setup->executeUpdate(cleanup);
+
+    // Удержания одного пользователя друг другу не мешают, поэтому оба подтверждения доходят до базы данных;
+    // третий поток бронирует тот же номер напрямую.
+    HoldManager holds(seconds(60));
+    auto first = holds.place(roomId, userId, "2199-01-01", "2199-01-05");
+    auto second = holds.place(roomId, userId, "2199-01-03", "2199-01-07");
+    ASSERT_TRUE(first.has_value() && second.has_value());
+
+    std::atomic<int> created{0};
+    std::atomic<int> failed{0};
+    auto run = [&](auto action) {
+        return std::thread([&, action] {
+            std::unique_ptr<DBManager> db = makeDatabase();
+            try {
+                if (db->connect() && action(*db)) {
+                    created.fetch_add(1);
+                }
+            } catch (const std::exception&) {
+                failed.fetch_add(1);
+            }
+        });
+    };
+    std::vector<std::thread> threads;
+    threads.push_back(run([&](DBManager& db) { return holds.confirm(db, first->id, userId) != nullptr; }));
+    threads.push_back(run([&](DBManager& db) { return holds.confirm(db, second->id, userId) != nullptr; }));
+    threads.push_back(run([&](DBManager& db) {
+        return Booking::createBooking(db, userId, roomId, "2199-01-04", "2199-01-06") != nullptr;
+    }));
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    PGResultWrapper count = setup->executeQuery(
+        "SELECT COUNT(*) FROM bookings WHERE room_id = " + std::to_string(roomId) +
+        " AND date_from >= '2199-01-01' AND date_from < '2199-02-01';");
+    std::string stored = PQgetvalue(count.get(), 0, 0);
+    setup->executeUpdate(cleanup);
+    EXPECT_EQ(failed.load(), 0);
+    EXPECT_EQ(created.load(), 1);
+    EXPECT_EQ(stored, "1");
+    EXPECT_EQ(holds.size(), 0u);
+}
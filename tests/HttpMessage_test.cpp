@@ -0,0 +1,53 @@
+#include "gtest/gtest.h"
+#include "HttpMessage.h"
+
+TEST(HttpMessageTest, ParsesRequestWithBody) {
+    std::string raw = "POST /api/bookings?x=1 HTTP/1.1\r\nHost: localhost\r\nContent-Length: 9\r\n"
+                      "Authorization: Bearer abc\r\n\r\nroom_id=5GET";
+    HttpRequest request;
+    std::size_t consumed = 0;
+    ASSERT_EQ(parseHttpRequest(raw, request, consumed), ParseStatus::COMPLETE);
+    ASSERT_EQ(request.method, "POST");
+    ASSERT_EQ(request.path, "/api/bookings");
+    ASSERT_EQ(request.query, "x=1");
+    ASSERT_EQ(request.header("authorization"), "Bearer abc");
+    ASSERT_EQ(request.body, "room_id=5");
+    ASSERT_TRUE(request.keepAlive);
+    ASSERT_EQ(consumed, raw.size() - 3);
+}
+
+TEST(HttpMessageTest, ReportsIncompleteAndBadRequests) {
+    HttpRequest request;
+    std::size_t consumed = 0;
+    ASSERT_EQ(parseHttpRequest("GET / HTTP/1.1\r\nHost: x\r\n", request, consumed), ParseStatus::INCOMPLETE);
+    ASSERT_EQ(parseHttpRequest("POST / HTTP/1.1\r\nContent-Length: 10\r\n\r\nabc", request, consumed),
+              ParseStatus::INCOMPLETE);
+    ASSERT_EQ(parseHttpRequest("GARBAGE\r\n\r\n", request, consumed), ParseStatus::BAD);
+    ASSERT_EQ(parseHttpRequest("GET / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n", request, consumed),
+              ParseStatus::BAD);
+    ASSERT_EQ(parseHttpRequest("POST / HTTP/1.1\r\nContent-Length: 100\r\n\r\n", request, consumed, 64),
+              ParseStatus::BAD);
+}
+
+TEST(HttpMessageTest, ConnectionHeaderControlsKeepAlive) {
+    HttpRequest request;
+    std::size_t consumed = 0;
+    ASSERT_EQ(parseHttpRequest("GET / HTTP/1.1\r\nConnection: close\r\n\r\n", request, consumed), ParseStatus::COMPLETE);
+    ASSERT_FALSE(request.keepAlive);
+    ASSERT_EQ(parseHttpRequest("GET / HTTP/1.0\r\n\r\n", request, consumed), ParseStatus::COMPLETE);
+    ASSERT_FALSE(request.keepAlive);
+}
+
+TEST(HttpMessageTest, DecodesFormsAndEscapesJson) {
+    auto form = parseForm("login=john+doe&password=p%40ss&empty");
+    ASSERT_EQ(form["login"], "john doe");
+    ASSERT_EQ(form["password"], "p@ss");
+    ASSERT_EQ(form.count("empty"), 1u);
+    ASSERT_EQ(urlDecode("100%"), "100%");
+    ASSERT_EQ(jsonEscape("a\"b\\c\n\x01"), "a\\\"b\\\\c\\n\\u0001");
+
+    std::string serialized = HttpResponse::error(404, "Not here").serialize(false);
+    ASSERT_EQ(serialized.rfind("HTTP/1.1 404 Not Found\r\n", 0), 0u);
+    ASSERT_NE(serialized.find("Connection: close"), std::string::npos);
+    ASSERT_NE(serialized.find("{\"error\":\"Not here\"}"), std::string::npos);
+}
@@ -0,0 +1,42 @@
+#include "gtest/gtest.h"
+#include "LatencyHistogram.h"
+
+TEST(LatencyHistogramTest, PercentilesWithinRelativeError) {
+    LatencyHistogram histogram;
+    for (std::uint64_t value = 1; value <= 100000; ++value) {
+        histogram.record(value);
+    }
+    ASSERT_EQ(histogram.count(), 100000u);
+    ASSERT_EQ(histogram.min(), 1u);
+    ASSERT_EQ(histogram.max(), 100000u);
+    ASSERT_NEAR(histogram.mean(), 50000.5, 0.01);
+    ASSERT_NEAR(static_cast<double>(histogram.percentile(50)), 50000.0, 50000.0 * 0.04);
+    ASSERT_NEAR(static_cast<double>(histogram.percentile(99)), 99000.0, 99000.0 * 0.04);
+    ASSERT_EQ(histogram.percentile(100), 100000u);
+}
+
+TEST(LatencyHistogramTest, BucketsAreExactForSmallValuesAndMonotonic) {
+    for (std::uint64_t value = 0; value < 64; ++value) {
+        ASSERT_EQ(LatencyHistogram::bucketUpperBound(LatencyHistogram::bucketIndex(value)), value);
+    }
+    for (std::uint64_t value = 64; value < (1u << 20); value = value * 3 / 2) {
+        std::size_t index = LatencyHistogram::bucketIndex(value);
+        ASSERT_GE(LatencyHistogram::bucketUpperBound(index), value);
+        ASSERT_LT(LatencyHistogram::bucketUpperBound(index - 1), value);
+    }
+    ASSERT_LT(LatencyHistogram::bucketIndex(~std::uint64_t(0)), LatencyHistogram::BUCKET_COUNT);
+}
+
+TEST(LatencyHistogramTest, MergeCombinesCounts) {
+    LatencyHistogram a, b;
+    a.record(10);
+    b.record(1000);
+    b.record(2000);
+    a.merge(b);
+    ASSERT_EQ(a.count(), 3u);
+    ASSERT_EQ(a.min(), 10u);
+    ASSERT_EQ(a.max(), 2000u);
+    a.reset();
+    ASSERT_EQ(a.count(), 0u);
+    ASSERT_EQ(a.percentile(50), 0u);
+}
@@ -0,0 +1,33 @@
+#include "gtest/gtest.h"
+#include "LoadProfile.h"
+
+TEST(LoadProfileTest, ParsesMixAndPicksByShare) {
+    OperationMix mix = OperationMix::parse("search=50,book=25,cancel=25");
+    EXPECT_DOUBLE_EQ(mix.share(LoadOperation::SEARCH), 0.5);
+    EXPECT_DOUBLE_EQ(mix.share(LoadOperation::ADD_SERVICE), 0.0);
+    EXPECT_EQ(mix.pick(0.0), LoadOperation::SEARCH);
+    EXPECT_EQ(mix.pick(0.49), LoadOperation::SEARCH);
+    EXPECT_EQ(mix.pick(0.5), LoadOperation::BOOK);
+    EXPECT_EQ(mix.pick(0.8), LoadOperation::CANCEL);
+    EXPECT_EQ(mix.pick(0.999999), LoadOperation::CANCEL);
+
+    EXPECT_THROW(OperationMix::parse("search=1,checkout=2"), std::invalid_argument);
+    EXPECT_THROW(OperationMix::parse("search=abc"), std::invalid_argument);
+    EXPECT_THROW(OperationMix::parse("search=0"), std::invalid_argument);
+    EXPECT_THROW(OperationMix::parse("book=-1,search=2"), std::invalid_argument);
+}
+
+TEST(LoadProfileTest, ArrivalsFollowRateIndependentlyOfProgress) {
+    auto start = ArrivalSchedule::Clock::time_point{};
+    ArrivalSchedule schedule(1000.0, 7, start);
+    ArrivalSchedule::Clock::time_point last = start;
+    for (int i = 0; i < 20000; ++i) {
+        ArrivalSchedule::Clock::time_point next = schedule.next();
+        EXPECT_GE(next, last);
+        last = next;
+    }
+    // 20000 операций при 1000 в секунду - около 20 секунд расписания.
+    double seconds = std::chrono::duration<double>(last - start).count();
+    EXPECT_NEAR(seconds, 20.0, 0.6);
+    EXPECT_THROW(ArrivalSchedule(0.0, 1, start), std::invalid_argument);
+}
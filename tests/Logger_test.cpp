@@ -0,0 +1,113 @@
+#include "gtest/gtest.h"
+#include "Logger.h"
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Перенаправляет журнал в строку на время теста и восстанавливает настройки по умолчанию.
+ */
+class CapturedLog {
+private:
+    std::mutex mutex;
+    std::string text;
+
+public:
+    CapturedLog() {
+        Logger::flush();
+        Logger::setSink([this](std::string_view batch) {
+            std::lock_guard<std::mutex> lock(mutex);
+            text.append(batch);
+        });
+    }
+
+    ~CapturedLog() {
+        Logger::flush();
+        Logger::setSink(nullptr);
+        Logger::setLevel(LogLevel::INFO);
+        Logger::setRateLimit(Logger::DEFAULT_RATE_LIMIT);
+    }
+
+    std::string contents() {
+        Logger::flush();
+        std::lock_guard<std::mutex> lock(mutex);
+        return text;
+    }
+};
+
+std::size_t countOf(const std::string& text, const std::string& needle) {
+    std::size_t count = 0;
+    for (std::size_t at = text.find(needle); at != std::string::npos; at = text.find(needle, at + 1)) {
+        ++count;
+    }
+    return count;
+}
+
+} // namespace
+
+TEST(LoggerTest, FormatsDeferredArgumentsAndFiltersByLevel) {
+    CapturedLog log;
+    std::string temporary = "room 101";
+    Logger::severe("Failed to book {}: {} nights at {} ({})", temporary, 3, 89.5, "no rows\n");
+    temporary = "overwritten";
+    Logger::verbose("Hidden at INFO level");
+    Logger::setLevel(LogLevel::VERBOSE);
+    Logger::verbose("Shown after setLevel {}", 7u);
+
+    std::string text = log.contents();
+    EXPECT_NE(text.find(" SEVERE ["), std::string::npos);
+    EXPECT_NE(text.find("] Failed to book room 101: 3 nights at 89.5 (no rows\n)\n"), std::string::npos);
+    EXPECT_EQ(text.find("Hidden"), std::string::npos);
+    EXPECT_NE(text.find(" VERBOSE ["), std::string::npos);
+    EXPECT_NE(text.find("Shown after setLevel 7\n"), std::string::npos);
+
+    EXPECT_EQ(Logger::parseLevel("Warning"), LogLevel::WARNING);
+    EXPECT_THROW(Logger::parseLevel("debug"), std::invalid_argument);
+}
+
+TEST(LoggerTest, RateLimitSuppressesRepeatsOfOneFormat) {
+    CapturedLog log;
+    Logger::setRateLimit(5);
+    for (int i = 0; i < 20; ++i) {
+        Logger::warning("Replica {} failed", i);
+    }
+    Logger::warning("Other message");
+
+    std::string text = log.contents();
+    // Все 20 сообщений почти наверняка попадают в одну секунду; на границе секунды проходит больше.
+    std::size_t shown = countOf(text, "] Replica ");
+    EXPECT_GE(shown, 5u);
+    EXPECT_LE(shown, 10u);
+    EXPECT_NE(text.find("suppressed " + std::to_string(20 - shown) + " messages: Replica {} failed"), std::string::npos);
+    EXPECT_NE(text.find("Other message"), std::string::npos);
+}
+
+TEST(LoggerTest, ThreadsNeverBlockAndEveryRecordIsWrittenOrCounted) {
+    CapturedLog log;
+    Logger::setRateLimit(0);
+    std::uint64_t droppedBefore = Logger::dropped();
+    const int perThread = static_cast<int>(Logger::RING_RECORDS) * 2;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t, perThread] {
+            for (int i = 0; i < perThread; ++i) {
+                Logger::info("thread {} message {}", t, i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::string text = log.contents();
+    std::size_t written = countOf(text, "] thread ");
+    std::uint64_t dropped = Logger::dropped() - droppedBefore;
+    EXPECT_EQ(written + dropped, static_cast<std::size_t>(4 * perThread));
+    EXPECT_GE(written, Logger::RING_RECORDS);
+    if (dropped > 0) {
+        EXPECT_NE(text.find("records: thread buffer full"), std::string::npos);
+    }
+}
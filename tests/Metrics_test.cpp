@@ -0,0 +1,99 @@
+#include "gtest/gtest.h"
+#include "Metrics.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+TEST(MetricsTest, CountersAreSharedByNameAndLabelsAndSafeAcrossThreads) {
+    MetricsRegistry registry;
+    MetricCounter& ok = registry.counter("test_requests_total", "Requests.", "result=\"ok\"");
+    MetricCounter& failed = registry.counter("test_requests_total", "Requests.", "result=\"failed\"");
+    EXPECT_EQ(&ok, &registry.counter("test_requests_total", "Requests.", "result=\"ok\""));
+    EXPECT_NE(&ok, &failed);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&ok] {
+            for (int i = 0; i < 10000; ++i) {
+                ok.increment();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(ok.get(), 40000u);
+    EXPECT_EQ(failed.get(), 0u);
+
+    EXPECT_THROW(registry.gauge("test_requests_total", "Requests."), std::invalid_argument);
+}
+
+TEST(MetricsTest, HistogramBucketsAndPercentiles) {
+    MetricHistogram histogram;
+    EXPECT_EQ(histogram.percentile(50), 0u);
+    for (int i = 0; i < 90; ++i) {
+        histogram.observe(std::uint64_t{200'000});      // 0.2 мс -> корзина 0.25 мс
+    }
+    for (int i = 0; i < 10; ++i) {
+        histogram.observe(std::chrono::milliseconds(30)); // 30 мс -> корзина 50 мс
+    }
+    histogram.observe(std::chrono::seconds(20));          // больше всех границ -> +Inf
+    EXPECT_EQ(histogram.count(), 101u);
+    EXPECT_EQ(histogram.bucket(1), 90u);
+    EXPECT_EQ(histogram.bucket(8), 10u);
+    EXPECT_EQ(histogram.bucket(MetricHistogram::BOUND_COUNT), 1u);
+    EXPECT_EQ(histogram.percentile(50), 250'000u);
+    EXPECT_EQ(histogram.percentile(95), 50'000'000u);
+    EXPECT_EQ(histogram.percentile(100), MetricHistogram::BOUNDS_NS.back());
+}
+
+TEST(MetricsTest, PrometheusTextGroupsSeriesAndAccumulatesBuckets) {
+    MetricsRegistry registry;
+    registry.counter("test_logins_total", "Logins.", "result=\"success\"").increment(3);
+    registry.counter("test_logins_total", "Logins.", "result=\"failure\"").increment();
+    registry.gauge("test_connections", "Open connections.").set(2);
+    MetricHistogram& latency = registry.histogram("test_latency_seconds", "Latency.");
+    latency.observe(std::chrono::microseconds(50));
+    latency.observe(std::chrono::milliseconds(2));
+
+    std::string text = registry.prometheusText();
+    EXPECT_NE(text.find("# TYPE test_logins_total counter\n"
+                        "test_logins_total{result=\"success\"} 3\n"
+                        "test_logins_total{result=\"failure\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE test_connections gauge\ntest_connections 2\n"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE test_latency_seconds histogram\n"), std::string::npos);
+    EXPECT_NE(text.find("test_latency_seconds_bucket{le=\"0.0001\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("test_latency_seconds_bucket{le=\"0.001\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("test_latency_seconds_bucket{le=\"0.0025\"} 2\n"), std::string::npos);
+    EXPECT_NE(text.find("test_latency_seconds_bucket{le=\"+Inf\"} 2\n"), std::string::npos);
+    EXPECT_NE(text.find("test_latency_seconds_count 2\n"), std::string::npos);
+
+    std::vector<MetricSample> samples = registry.samples();
+    ASSERT_EQ(samples.size(), 4u);
+    EXPECT_EQ(samples[0].name, "test_connections");
+    EXPECT_EQ(samples[1].name, "test_latency_seconds");
+    EXPECT_DOUBLE_EQ(samples[1].value, 2.0);
+    EXPECT_DOUBLE_EQ(samples[1].p99Ms, 2.5);
+}
+
+TEST(MetricsTest, FileExporterReplacesFile) {
+    MetricsRegistry registry;
+    MetricCounter& counter = registry.counter("test_exported_total", "Exported.");
+    const std::string path = "metrics_test.prom";
+    MetricsFileExporter exporter(registry, path, std::chrono::milliseconds(10));
+
+    counter.increment(5);
+    ASSERT_TRUE(exporter.writeNow());
+    counter.increment();
+    exporter.start();
+    exporter.stop(); // последняя запись при остановке
+
+    std::ifstream in(path);
+    std::stringstream content;
+    content << in.rdbuf();
+    EXPECT_NE(content.str().find("test_exported_total 6\n"), std::string::npos);
+    in.close();
+    std::remove(path.c_str());
+}
@@ -0,0 +1,66 @@
+#include "gtest/gtest.h"
+#include "OptimisticLock.h"
+#include "Booking.h"
+#include <random>
+
+TEST(OptimisticLockTest, RetriesUntilSuccess) {
+    RetryPolicy policy;
+    policy.initialBackoff = std::chrono::milliseconds(0);
+    int calls = 0;
+    int attempts = 0;
+    UpdateResult result = retryOnConflict([&] {
+        return ++calls < 3 ? UpdateResult::CONFLICT : UpdateResult::OK;
+    }, policy, &attempts);
+
+    ASSERT_EQ(result, UpdateResult::OK);
+    ASSERT_EQ(attempts, 3);
+}
+
+TEST(OptimisticLockTest, GivesUpAfterMaxAttempts) {
+    RetryPolicy policy;
+    policy.maxAttempts = 4;
+    policy.initialBackoff = std::chrono::milliseconds(0);
+    int attempts = 0;
+    UpdateResult result = retryOnConflict([] { return UpdateResult::CONFLICT; }, policy, &attempts);
+
+    ASSERT_EQ(result, UpdateResult::CONFLICT);
+    ASSERT_EQ(attempts, 4);
+}
+
+TEST(OptimisticLockTest, NotFoundIsNotRetried) {
+    int attempts = 0;
+    UpdateResult result = retryOnConflict([] { return UpdateResult::NOT_FOUND; }, RetryPolicy(), &attempts);
+
+    ASSERT_EQ(result, UpdateResult::NOT_FOUND);
+    ASSERT_EQ(attempts, 1);
+}
+
+TEST(OptimisticLockTest, StoppedConflictIsNotRetried) {
+    RetryPolicy policy;
+    policy.initialBackoff = std::chrono::milliseconds(0);
+    int attempts = 0;
+    UpdateResult result = retryOnConflict([](RetryControl& control) {
+        control.stop();
+        return UpdateResult::CONFLICT;
+    }, policy, &attempts);
+
+    ASSERT_EQ(result, UpdateResult::CONFLICT);
+    ASSERT_EQ(attempts, 1);
+}
+
+TEST(OptimisticLockTest, BackoffIsCapped) {
+    RetryPolicy policy;
+    policy.initialBackoff = std::chrono::milliseconds(5);
+    policy.maxBackoff = std::chrono::milliseconds(40);
+    std::minstd_rand random(42);
+    for (int attempt = 1; attempt < 20; ++attempt) {
+        auto delay = computeBackoff(attempt, policy, random);
+        ASSERT_GE(delay.count(), 0);
+        ASSERT_LE(delay.count(), 40);
+    }
+}
+
+TEST(OptimisticLockTest, BookingKeepsVersion) {
+    Booking booking(1, 101, 201, "2023-01-01", "2023-01-05", BookingStatus::PENDING, 7);
+    ASSERT_EQ(booking.getVersion(), 7);
+}
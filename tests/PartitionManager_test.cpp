@@ -0,0 +1,62 @@
+#include "gtest/gtest.h"
+#include "PartitionManager.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+TEST(PartitionManagerTest, MonthArithmetic) {
+    EXPECT_EQ(PartitionManager::monthStart("2024-05-17"), "2024-05-01");
+    EXPECT_EQ(PartitionManager::addMonths("2024-11-01", 2), "2025-01-01");
+    EXPECT_EQ(PartitionManager::addMonths("2024-01-01", -1), "2023-12-01");
+    EXPECT_EQ(PartitionManager::addMonths("2024-03-01", -15), "2022-12-01");
+    EXPECT_THROW(PartitionManager::monthStart("2024/05/17"), std::invalid_argument);
+    EXPECT_THROW(PartitionManager::monthStart("2024-13-01"), std::invalid_argument);
+}
+
+TEST(PartitionManagerTest, PartitionNames) {
+    EXPECT_EQ(PartitionManager::partitionName("bookings", "2024-05-17"), "bookings_2024_05");
+    EXPECT_EQ(PartitionManager::monthOfPartition("bookings", "bookings_2024_05"), "2024-05-01");
+    EXPECT_EQ(PartitionManager::monthOfPartition("bookings", "bookings_default"), "");
+    EXPECT_EQ(PartitionManager::monthOfPartition("bookings", "booking_services_2024_05"), "");
+    EXPECT_EQ(PartitionManager::monthOfPartition("booking_services", "booking_services_2024_05"), "2024-05-01");
+    EXPECT_EQ(PartitionManager::createStatement("bookings", "2024-12-01"),
+              "CREATE TABLE IF NOT EXISTS bookings_2024_12 PARTITION OF bookings "
+              "FOR VALUES FROM ('2024-12-01') TO ('2025-01-01');");
+}
+
+TEST(PartitionManagerTest, ArchiveRoundTrip) {
+    PartitionArchive archive;
+    archive.month = "2023-02-01";
+    archive.bookings.push_back({7, 3, 12, "2023-02-03", "2023-02-10", "completed", 4});
+    archive.bookings.push_back({9, 5, 1, "2023-02-28", "2023-03-02", "cancelled", 0});
+    archive.services.push_back({7, 2, 3});
+
+    std::string path = (std::filesystem::temp_directory_path() / "partition_archive_test.archive").string();
+    archive.write(path);
+    EXPECT_EQ(std::filesystem::file_size(path), 18u + 2 * 25u + 12u);
+
+    PartitionArchive restored = PartitionArchive::read(path);
+    EXPECT_EQ(restored.month, "2023-02-01");
+    ASSERT_EQ(restored.bookings.size(), 2u);
+    EXPECT_EQ(restored.bookings[0].id, 7);
+    EXPECT_EQ(restored.bookings[0].dateTo, "2023-02-10");
+    EXPECT_EQ(restored.bookings[0].status, "completed");
+    EXPECT_EQ(restored.bookings[0].version, 4);
+    EXPECT_EQ(restored.bookings[1].dateFrom, "2023-02-28");
+    EXPECT_EQ(restored.bookings[1].status, "cancelled");
+    ASSERT_EQ(restored.services.size(), 1u);
+    EXPECT_EQ(restored.services[0].quantity, 3);
+
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    EXPECT_THROW(PartitionArchive::read(path), std::runtime_error);
+    archive.write(path);  // переименование поверх поврежденного архива
+    EXPECT_EQ(PartitionArchive::read(path).bookings.size(), 2u);
+    EXPECT_FALSE(std::filesystem::exists(path + ".tmp"));
+    std::remove(path.c_str());
+}
+
+TEST(PartitionManagerTest, EnsureThrowsWhenNotConnected) {
+    DBManager dbManager("localhost", "user", "password", "database", 5432);
+    PartitionManager partitions(dbManager);
+    EXPECT_THROW(partitions.ensurePartitions("2024-05-01"), std::runtime_error);
+}
@@ -0,0 +1,28 @@
+#include "gtest/gtest.h"
+#include "QueryArena.h"
+#include "Booking.h"
+#include <string>
+
+TEST(QueryArenaTest, CopyKeepsStrings) {
+    QueryArena arena;
+    std::string source = "2023-01-01";
+    std::string_view copy = arena.copy(source);
+    source.assign("overwritten");
+
+    ASSERT_EQ(copy, "2023-01-01");
+    ASSERT_EQ(arena.requested().allocations, 1u);
+    ASSERT_EQ(arena.requested().bytes, 10u);
+}
+
+TEST(QueryArenaTest, RowsAndStringsShareOneArena) {
+    QueryArena arena(64 * 1024);
+    std::pmr::vector<BookingRow> rows(arena.resource());
+    for (int i = 0; i < 1000; ++i) {
+        rows.push_back(BookingRow{i, 1, 2, arena.copy("2023-01-01"), arena.copy("2023-01-05"), BookingStatus::PENDING});
+    }
+
+    ASSERT_EQ(rows.size(), 1000u);
+    ASSERT_EQ(rows[999].dateTo, "2023-01-05");
+    ASSERT_GT(arena.requested().allocations, 2000u);
+    ASSERT_LT(arena.heap().allocations, 10u);
+}
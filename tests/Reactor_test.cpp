@@ -0,0 +1,76 @@
+#include "gtest/gtest.h"
+#include "AsyncDBManager.h"
+#include "Reactor.h"
+#include "Task.h"
+#include <stdexcept>
+#include <unistd.h>
+
+namespace {
+
+Task<int> answer() {
+    co_return 42;
+}
+
+Task<int> doubled() {
+    int value = co_await answer();
+    co_return value * 2;
+}
+
+Task<int> failing() {
+    throw std::runtime_error("boom");
+    co_return 0;
+}
+
+Task<char> readByte(Reactor& reactor, int fd) {
+    co_await reactor.readable(fd);
+    char byte = 0;
+    if (::read(fd, &byte, 1) != 1) {
+        throw std::runtime_error("read failed");
+    }
+    co_return byte;
+}
+
+Task<char> relay(Reactor& reactor, int in, int out) {
+    char byte = co_await readByte(reactor, in);
+    if (::write(out, &byte, 1) != 1) {
+        throw std::runtime_error("write failed");
+    }
+    co_return byte;
+}
+
+} // namespace
+
+TEST(TaskTest, AwaitsNestedTasksAndPropagatesExceptions) {
+    Reactor reactor;
+    ASSERT_EQ(reactor.run(doubled()), 84);
+    ASSERT_THROW(reactor.run(failing()), std::runtime_error);
+}
+
+TEST(ReactorTest, ResumesTasksWhenDescriptorsBecomeReady) {
+    int first[2], second[2];
+    ASSERT_EQ(::pipe(first), 0);
+    ASSERT_EQ(::pipe(second), 0);
+
+    Reactor reactor;
+    std::vector<Task<char>> tasks;
+    tasks.push_back(readByte(reactor, second[0]));       // ждет, пока relay не перешлет байт
+    tasks.push_back(relay(reactor, first[0], second[1]));
+    ASSERT_EQ(::write(first[1], "x", 1), 1);
+    reactor.runAll(tasks);
+
+    ASSERT_EQ(tasks[0].result(), 'x');
+    ASSERT_EQ(tasks[1].result(), 'x');
+    ASSERT_EQ(reactor.pending(), 0u);
+
+    reactor.forget(first[0]);
+    reactor.forget(second[0]);
+    for (int fd : {first[0], first[1], second[0], second[1]}) ::close(fd);
+}
+
+TEST(AsyncDBManagerTest, QueryWithoutConnectionThrows) {
+    Reactor reactor;
+    AsyncDBManager db(reactor, "127.0.0.1", "user", "pass", "db");
+    ASSERT_FALSE(db.isConnected());
+    ASSERT_THROW(reactor.run(db.query("SELECT 1")), std::runtime_error);
+    ASSERT_FALSE(db.isBusy());
+}
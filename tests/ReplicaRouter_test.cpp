@@ -0,0 +1,87 @@
+#include "gtest/gtest.h"
+#include "DBManager.h"
+#include "ReplicaRouter.h"
+#include <chrono>
+#include <memory>
+
+namespace {
+
+std::vector<ReplicaEndpoint> twoReplicas() {
+    return ReplicaRouter::parseEndpoints("replica-a:5433,replica-b", "postgres", "secret", "hotel_management");
+}
+
+} // namespace
+
+TEST(ReplicaRouterTest, ParsesEndpointList) {
+    auto endpoints = twoReplicas();
+    ASSERT_EQ(endpoints.size(), 2u);
+    ASSERT_EQ(endpoints[0].host, "replica-a");
+    ASSERT_EQ(endpoints[0].port, 5433);
+    ASSERT_EQ(endpoints[1].host, "replica-b");
+    ASSERT_EQ(endpoints[1].port, 5432);
+    ASSERT_EQ(endpoints[1].database, "hotel_management");
+    ASSERT_TRUE(ReplicaRouter::parseEndpoints("", "u", "p", "d").empty());
+}
+
+TEST(ReplicaRouterTest, PicksLeastOutstandingReplica) {
+    ReplicaRouter router(twoReplicas());
+    int first = router.acquire();
+    int second = router.acquire();
+    ASSERT_NE(first, second);
+    int third = router.acquire();
+    ASSERT_EQ(router.outstanding(third), 2);
+    int fourth = router.acquire();
+    ASSERT_NE(fourth, third);
+    ASSERT_EQ(router.outstanding(fourth), 2);
+    router.release(first);
+    router.release(second);
+    router.release(third);
+    router.release(fourth);
+    ASSERT_EQ(router.outstanding(0) + router.outstanding(1), 0);
+    ASSERT_EQ(router.served(0) + router.served(1), 4u);
+}
+
+TEST(ReplicaRouterTest, TiesAreRoundRobin) {
+    ReplicaRouter router(twoReplicas());
+    int a = router.acquire();
+    router.release(a);
+    int b = router.acquire();
+    router.release(b);
+    ASSERT_NE(a, b);
+}
+
+TEST(ReplicaRouterTest, SkipsReplicaMarkedDownUntilRetry) {
+    ReplicaRouter router(twoReplicas(), std::chrono::milliseconds(2000), std::chrono::milliseconds(100));
+    auto now = ReplicaRouter::Clock::now();
+    router.markDown(0, now);
+    for (int i = 0; i < 4; ++i) {
+        int index = router.acquire(now);
+        ASSERT_EQ(index, 1);
+        router.release(index);
+    }
+    router.markDown(1, now);
+    ASSERT_EQ(router.acquire(now), -1);
+    int recovered = router.acquire(now + std::chrono::milliseconds(200));
+    ASSERT_GE(recovered, 0);
+    router.release(recovered);
+}
+
+TEST(ReplicaRouterTest, ReadsPinnedToPrimaryAfterWrite) {
+    DBManager dbManager("localhost", "user", "password", "database", 5432);
+    ASSERT_TRUE(dbManager.readsOnPrimary());
+
+    dbManager.useReplicas(std::make_shared<ReplicaRouter>(twoReplicas(), std::chrono::milliseconds(500)));
+    auto now = ReplicaRouter::Clock::now();
+    ASSERT_FALSE(dbManager.readsOnPrimary(now));
+
+    dbManager.setLastWrite(now);
+    ASSERT_TRUE(dbManager.readsOnPrimary(now + std::chrono::milliseconds(100)));
+    ASSERT_FALSE(dbManager.readsOnPrimary(now + std::chrono::milliseconds(600)));
+
+    dbManager.clearLastWrite();
+    {
+        DBManager::PrimaryReads primary(dbManager);
+        ASSERT_TRUE(dbManager.readsOnPrimary(now));
+    }
+    ASSERT_FALSE(dbManager.readsOnPrimary(now));
+}
@@ -0,0 +1,28 @@
+#include "gtest/gtest.h"
+#include "RolloverJob.h"
+
+TEST(RolloverJobTest, NightlyRules) {
+    std::vector<StatusTransition> rules = RolloverJob::nightlyRules("2024-05-01");
+
+    ASSERT_EQ(rules.size(), 2u);
+    ASSERT_EQ(rules[0].from, BookingStatus::CONFIRMED);
+    ASSERT_EQ(rules[0].to, BookingStatus::COMPLETED);
+    ASSERT_EQ(rules[0].dateField, BookingDateField::DATE_TO);
+    ASSERT_EQ(rules[0].before, "2024-05-01");
+    ASSERT_EQ(rules[1].from, BookingStatus::PENDING);
+    ASSERT_EQ(rules[1].to, BookingStatus::CANCELLED);
+    ASSERT_EQ(rules[1].dateField, BookingDateField::DATE_FROM);
+}
+
+TEST(RolloverJobTest, TodayIsIsoDate) {
+    std::string today = RolloverJob::today();
+    ASSERT_EQ(today.size(), 10u);
+    ASSERT_EQ(today[4], '-');
+    ASSERT_EQ(today[7], '-');
+}
+
+TEST(RolloverJobTest, RunOnceThrowsWhenNotConnected) {
+    DBManager dbManager("localhost", "user", "password", "database", 5432);
+    RolloverJob job(dbManager);
+    EXPECT_THROW(job.runOnce("2024-05-01"), std::runtime_error);
+}
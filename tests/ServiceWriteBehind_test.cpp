@@ -0,0 +1,142 @@
+#include "gtest/gtest.h"
+#include "ServiceWriteBehind.h"
+#include "Booking.h"
+#include "DBManager.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+std::string journalPath(const std::string& name) {
+    std::string path = (std::filesystem::temp_directory_path() / name).string();
+    std::remove(path.c_str());
+    std::remove((path + ".flushing").c_str());
+    return path;
+}
+
+ServiceWriteBehindConfig offlineConfig(const std::string& path) {
+    ServiceWriteBehindConfig config;
+    config.journalPath = path;
+    config.maxDelay = 1h;  // фоновая запись только при остановке
+    config.syncJournal = false;
+    return config;
+}
+
+ServiceWriteBehind::Factory unavailable() {
+    return []() -> std::unique_ptr<DBManager> { return nullptr; };
+}
+
+} // namespace
+
+TEST(ServiceWriteBehindTest, CoalescesChangesAndOverlaysDatabaseRows) {
+    std::string path = journalPath("service_overlay_test.journal");
+    Booking booking(7, 1, 2, "2025-06-01", "2025-06-05", BookingStatus::CONFIRMED);
+    Booking other(8, 1, 3, "2025-06-01", "2025-06-05", BookingStatus::CONFIRMED);
+    {
+        ServiceWriteBehind writes(unavailable(), offlineConfig(path));
+        writes.addService(booking, 1, 2);
+        writes.addService(booking, 1, 3);      // объединяется с предыдущим: +5
+        writes.removeService(booking, 2);
+        writes.addService(booking, 2, 1);      // замена строки: ровно 1
+        writes.removeService(booking, 3);
+        writes.addService(other, 1, 4);
+        EXPECT_THROW(writes.addService(booking, 4, 0), std::invalid_argument);
+
+        std::map<int, int> services{{1, 10}, {2, 6}, {3, 1}, {5, 2}};
+        writes.overlay(booking.getId(), booking.getDateFrom(), services);
+        EXPECT_EQ(services, (std::map<int, int>{{1, 15}, {2, 1}, {5, 2}}));
+        EXPECT_EQ(writes.pendingCount(), 4u);
+
+        ServiceLineChange change{false, 2};
+        ServiceWriteBehind::coalesce(change, ServiceLineChange{true, 0});
+        ServiceWriteBehind::coalesce(change, ServiceLineChange{false, 3});
+        EXPECT_TRUE(change.replace);
+        EXPECT_EQ(change.quantity, 3);
+    }
+    std::remove(path.c_str());
+    std::remove((path + ".flushing").c_str());
+}
+
+TEST(ServiceWriteBehindTest, UnwrittenChangesSurviveRestartThroughJournal) {
+    std::string path = journalPath("service_restart_test.journal");
+    Booking booking(7, 1, 2, "2025-06-01", "2025-06-05", BookingStatus::CONFIRMED);
+    {
+        ServiceWriteBehind writes(unavailable(), offlineConfig(path));
+        writes.addService(booking, 1, 2);
+        EXPECT_FALSE(writes.flush());          // пачка переходит в .flushing и ждет базу данных
+        writes.addService(booking, 1, 3);
+        writes.removeService(booking, 2);
+        EXPECT_EQ(writes.pendingCount(), 3u);
+    }
+    EXPECT_TRUE(std::filesystem::exists(path + ".flushing"));
+    {
+        // Неполная последняя строка (аварийное завершение во время записи) пропускается.
+        std::ofstream torn(path, std::ios::app);
+        torn << "A 7 2025-06-01";
+    }
+    {
+        ServiceWriteBehind writes(unavailable(), offlineConfig(path));
+        EXPECT_EQ(writes.pendingCount(), 3u);  // услуга 1 - в пачке и в журнале
+        std::map<int, int> services{{2, 4}};
+        writes.overlay(booking.getId(), booking.getDateFrom(), services);
+        EXPECT_EQ(services, (std::map<int, int>{{1, 5}}));
+    }
+    std::remove(path.c_str());
+    std::remove((path + ".flushing").c_str());
+}
+
+TEST(ServiceWriteBehindTest, ConcurrentSyncedChangesShareJournalFlushes) {
+    std::string path = journalPath("service_group_sync_test.journal");
+    Booking booking(7, 1, 2, "2025-06-01", "2025-06-05", BookingStatus::CONFIRMED);
+    {
+        ServiceWriteBehindConfig config = offlineConfig(path);
+        config.syncJournal = true;
+        ServiceWriteBehind writes(unavailable(), config);
+        std::vector<std::thread> threads;
+        for (int service = 1; service <= 4; ++service) {
+            threads.emplace_back([&writes, &booking, service] {
+                for (int i = 0; i < 25; ++i) {
+                    writes.addService(booking, service, 1);
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        EXPECT_FALSE(writes.flush());          // журнал сброшен и переименован перед записью пачки
+        writes.addService(booking, 5, 2);
+    }
+    {
+        ServiceWriteBehind writes(unavailable(), offlineConfig(path));
+        std::map<int, int> services;
+        writes.overlay(booking.getId(), booking.getDateFrom(), services);
+        EXPECT_EQ(services, (std::map<int, int>{{1, 25}, {2, 25}, {3, 25}, {4, 25}, {5, 2}}));
+    }
+    std::remove(path.c_str());
+    std::remove((path + ".flushing").c_str());
+}
+
+TEST(ServiceWriteBehindTest, FlushDuringDatabaseReadRetriesBeforeOverlay) {
+    std::string path = journalPath("service_read_flush_test.journal");
+    Booking booking(7, 1, 2, "2025-06-01", "2025-06-05", BookingStatus::CONFIRMED);
+    {
+        ServiceWriteBehind writes(unavailable(), offlineConfig(path));
+        writes.addService(booking, 1, 2);
+        int reads = 0;
+        std::map<int, int> services = writes.getServices([&]() {
+            if (++reads == 1) {
+                EXPECT_FALSE(writes.flush());  // пачка уходит из pending в inFlight между чтением и наложением
+            }
+            return std::map<int, int>{{3, 1}};
+        }, booking.getId(), booking.getDateFrom());
+        EXPECT_EQ(reads, 2);
+        EXPECT_EQ(services, (std::map<int, int>{{1, 2}, {3, 1}}));
+    }
+    std::remove(path.c_str());
+    std::remove((path + ".flushing").c_str());
+}
@@ -0,0 +1,69 @@
+#include "gtest/gtest.h"
+#include "SessionManager.h"
+#include "TimingWheel.h"
+#include <vector>
+
+using namespace std::chrono;
+
+TEST(TimingWheelTest, ExpiresEntriesInOrderOfTicks) {
+    TimingWheel<int> wheel(8);
+    wheel.schedule(1, 3);
+    wheel.schedule(2, 10);
+    wheel.schedule(3, 20);
+
+    std::vector<int> expired;
+    wheel.advance(5, [&](int key) { expired.push_back(key); });
+    ASSERT_EQ(expired, std::vector<int>({1}));
+
+    wheel.advance(12, [&](int key) { expired.push_back(key); });
+    ASSERT_EQ(expired, std::vector<int>({1, 2}));
+    ASSERT_EQ(wheel.size(), 1u);
+
+    wheel.advance(1000, [&](int key) { expired.push_back(key); });
+    ASSERT_EQ(expired, std::vector<int>({1, 2, 3}));
+    ASSERT_EQ(wheel.size(), 0u);
+}
+
+TEST(SessionManagerTest, CreateFindDestroy) {
+    SessionManager sessions(seconds(60));
+    std::string token = sessions.createSession(std::make_unique<User>(1, "admin", "pass", UserRole::ADMIN));
+
+    ASSERT_EQ(token.size(), 32u);
+    auto session = sessions.find(token);
+    ASSERT_NE(session, nullptr);
+    ASSERT_EQ(session->user->getLogin(), "admin");
+    ASSERT_EQ(sessions.find("unknown"), nullptr);
+
+    ASSERT_TRUE(sessions.destroy(token));
+    ASSERT_EQ(sessions.find(token), nullptr);
+    ASSERT_EQ(sessions.size(), 0u);
+}
+
+TEST(SessionManagerTest, IdleSessionsExpire) {
+    SessionManager sessions(seconds(60));
+    auto start = SessionManager::Clock::now();
+    std::string idle = sessions.createSession(std::make_unique<User>(1, "idle", "pass", UserRole::USER), start);
+    std::string active = sessions.createSession(std::make_unique<User>(2, "active", "pass", UserRole::USER), start);
+
+    ASSERT_NE(sessions.find(active, start + seconds(45)), nullptr);
+    ASSERT_EQ(sessions.expireIdle(start + seconds(70)), 1u);
+    ASSERT_EQ(sessions.find(idle, start + seconds(70)), nullptr);
+    ASSERT_NE(sessions.find(active, start + seconds(70)), nullptr);
+
+    ASSERT_EQ(sessions.expireIdle(start + seconds(200)), 1u);
+    ASSERT_EQ(sessions.size(), 0u);
+}
+
+TEST(SessionManagerTest, ContextLoginLogout) {
+    SessionManager sessions;
+    SessionContext ctx(sessions);
+    ASSERT_EQ(ctx.session(), nullptr);
+
+    ctx.login(std::make_unique<User>(3, "user", "pass", UserRole::USER));
+    ASSERT_NE(ctx.session(), nullptr);
+    ASSERT_EQ(ctx.session()->user->getId(), 3);
+
+    ctx.logout();
+    ASSERT_EQ(ctx.session(), nullptr);
+    ASSERT_EQ(sessions.size(), 0u);
+}
@@ -0,0 +1,78 @@
+#include "gtest/gtest.h"
+#include "ShardRouter.h"
+#include <mutex>
+#include <set>
+
+namespace {
+std::unique_ptr<ConnectionPool> offlinePool() {
+    return std::make_unique<ConnectionPool>(
+        [] { return std::make_unique<DBManager>("127.0.0.1", "user", "pass", "db", 5432); }, 1);
+}
+}
+
+TEST(ShardRouterTest, RoutesPropertyToItsShard) {
+    TaskScheduler scheduler(2);
+    ShardRouter router(scheduler);
+    ASSERT_EQ(router.addShard(offlinePool(), {1, 2}), 0u);
+    ASSERT_EQ(router.addShard(offlinePool(), {3}), 1u);
+
+    EXPECT_EQ(router.shardOf(2), 0u);
+    EXPECT_EQ(router.shardOf(3), 1u);
+    EXPECT_THROW(router.shardOf(4), std::out_of_range);
+    EXPECT_THROW(router.addShard(offlinePool(), {5, 3}), std::invalid_argument);
+    EXPECT_EQ(router.shardCount(), 2u);
+    EXPECT_THROW(router.shardOf(5), std::out_of_range);
+
+    ConnectionPool::Lease lease = router.acquire(3);
+    EXPECT_TRUE(lease);
+    EXPECT_EQ(router.pool(1).available(), 0u);
+    EXPECT_EQ(router.pool(0).available(), 1u);
+}
+
+TEST(ShardRouterTest, GatherUsesEveryShardConnection) {
+    TaskScheduler scheduler(2);
+    ShardRouter router(scheduler);
+    router.addShard(offlinePool(), {1});
+    router.addShard(offlinePool(), {2});
+    router.addShard(offlinePool(), {3});
+
+    std::mutex mutex;
+    std::set<DBManager*> connections;
+    std::vector<int> rows = router.gather<int>([&](DBManager& db) {
+        std::lock_guard<std::mutex> lock(mutex);
+        connections.insert(&db);
+        return std::vector<int>{static_cast<int>(connections.size())};
+    });
+    EXPECT_EQ(connections.size(), 3u);
+    EXPECT_EQ(rows.size(), 3u);
+
+    std::vector<std::size_t> order(3);
+    router.forEachShard([&](std::size_t shard, DBManager&) { order[shard] = shard + 10; });
+    EXPECT_EQ(order, (std::vector<std::size_t>{10, 11, 12}));
+}
+
+TEST(ShardRouterTest, ForEachShardPropagatesErrors) {
+    TaskScheduler scheduler(2);
+    ShardRouter router(scheduler);
+    router.addShard(offlinePool(), {1});
+    router.addShard(offlinePool(), {2});
+    EXPECT_THROW(router.forEachShard([](std::size_t shard, DBManager&) {
+                     if (shard == 1) throw std::runtime_error("shard down");
+                 }),
+                 std::runtime_error);
+    EXPECT_EQ(router.pool(1).available(), 1u);
+}
+
+TEST(ShardRouterTest, ParseShards) {
+    auto shards = ShardRouter::parseShards("db1:5433/hotel_a=1,2;db2/hotel_b=3", "u", "p");
+    ASSERT_EQ(shards.size(), 2u);
+    EXPECT_EQ(shards[0].endpoint.host, "db1");
+    EXPECT_EQ(shards[0].endpoint.port, 5433);
+    EXPECT_EQ(shards[0].endpoint.database, "hotel_a");
+    EXPECT_EQ(shards[0].properties, (std::vector<int>{1, 2}));
+    EXPECT_EQ(shards[1].endpoint.port, 5432);
+    EXPECT_EQ(shards[1].endpoint.user, "u");
+    EXPECT_EQ(shards[1].properties, (std::vector<int>{3}));
+    EXPECT_THROW(ShardRouter::parseShards("db1/hotel_a", "u", "p"), std::invalid_argument);
+    EXPECT_THROW(ShardRouter::parseShards("db1/hotel_a=", "u", "p"), std::invalid_argument);
+}
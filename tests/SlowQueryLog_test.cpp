@@ -0,0 +1,88 @@
+#include "gtest/gtest.h"
+#include "SlowQueryLog.h"
+#include "DBManager.h"
+#include <chrono>
+
+using namespace std::chrono_literals;
+
+TEST(SlowQueryLogTest, NormalizesLiteralsSoFingerprintIgnoresValues) {
+    std::string first = SlowQueryLog::normalize(
+        "SELECT * FROM bookings WHERE room_id = 12 AND date_from >= '2025-01-01'::date AND note = 'O''Neil';");
+    std::string second = SlowQueryLog::normalize(
+        "SELECT *  FROM bookings\n WHERE room_id = 7 AND date_from >= '2026-03-15'::date AND note = 'x'");
+    EXPECT_EQ(first, "SELECT * FROM bookings WHERE room_id = ? AND date_from >= ?::date AND note = ?");
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(SlowQueryLog::fingerprint(first), SlowQueryLog::fingerprint(second));
+    EXPECT_EQ(SlowQueryLog::fingerprint(first).size(), 16u);
+
+    EXPECT_EQ(SlowQueryLog::normalize("SELECT * FROM rooms WHERE id IN (1, 2, 3) AND room2 = $1"),
+              "SELECT * FROM rooms WHERE id IN (?...) AND room2 = $1");
+    EXPECT_EQ(SlowQueryLog::normalize("SELECT * FROM rooms WHERE id IN (4,5)"),
+              SlowQueryLog::normalize("SELECT * FROM rooms WHERE id IN (4, 5, 6, 7)"));
+    EXPECT_NE(SlowQueryLog::fingerprint(SlowQueryLog::normalize("SELECT * FROM rooms")),
+              SlowQueryLog::fingerprint(SlowQueryLog::normalize("SELECT * FROM users")));
+}
+
+TEST(SlowQueryLogTest, RedactsStringLiteralsButKeepsPlanLayout) {
+    EXPECT_EQ(SlowQueryLog::redact("SELECT id FROM users WHERE email = 'a@b.c' AND password_hash = 'it''s secret';"),
+              "SELECT id FROM users WHERE email = '?' AND password_hash = '?';");
+    EXPECT_EQ(SlowQueryLog::redact("SELECT \"it's\" FROM t WHERE note = E'a\\'b' AND id = 42"),
+              "SELECT \"it's\" FROM t WHERE note = E'?' AND id = 42");
+    EXPECT_EQ(SlowQueryLog::redact("Seq Scan on users  (cost=0.00..1.05 rows=1 width=4)\n"
+                                   "  Filter: ((password_hash)::text = 'hunter2'::text)"),
+              "Seq Scan on users  (cost=0.00..1.05 rows=1 width=4)\n"
+              "  Filter: ((password_hash)::text = '?'::text)");
+}
+
+TEST(SlowQueryLogTest, OnlySingleDataStatementsAreExplainable) {
+    EXPECT_TRUE(SlowQueryLog::explainable("SELECT 1;"));
+    EXPECT_TRUE(SlowQueryLog::explainable("  update rooms SET status = 'a;b' WHERE id = 1"));
+    EXPECT_TRUE(SlowQueryLog::explainable("WITH x AS (SELECT 1) SELECT * FROM x"));
+    EXPECT_FALSE(SlowQueryLog::explainable("BEGIN;"));
+    EXPECT_FALSE(SlowQueryLog::explainable("COPY rooms FROM STDIN"));
+    EXPECT_FALSE(SlowQueryLog::explainable("SELECT 1; DROP TABLE rooms"));
+    EXPECT_FALSE(SlowQueryLog::explainable("SELECT pg_advisory_xact_lock(12);"));
+    EXPECT_FALSE(SlowQueryLog::explainable("SELECT setval('rooms_id_seq', 10)"));
+}
+
+TEST(SlowQueryLogTest, OnlyReadOnlySelectsAreAnalyzed) {
+    EXPECT_TRUE(SlowQueryLog::analyzable("SELECT COUNT(*) FROM bookings b WHERE NOT EXISTS (SELECT 1 FROM rooms r "
+                                         "WHERE r.id = b.room_id) AND (b.date_from, b.date_to) OVERLAPS ('2025-01-01', '2025-01-05')"));
+    EXPECT_TRUE(SlowQueryLog::analyzable("SELECT * FROM users WHERE login = 'nextval(x)'"));
+    EXPECT_FALSE(SlowQueryLog::analyzable("UPDATE bookings SET status = 'completed' WHERE date_to < now()"));
+    EXPECT_FALSE(SlowQueryLog::analyzable("INSERT INTO rooms (number) VALUES ('101')"));
+    EXPECT_FALSE(SlowQueryLog::analyzable("WITH d AS (DELETE FROM bills RETURNING id) SELECT * FROM d"));
+    EXPECT_FALSE(SlowQueryLog::analyzable("SELECT * FROM bookings WHERE id = 5 FOR UPDATE"));
+    EXPECT_FALSE(SlowQueryLog::analyzable("SELECT nextval('bookings_id_seq') FROM rooms"));
+    EXPECT_FALSE(SlowQueryLog::analyzable("SELECT pg_advisory_xact_lock(5)"));
+}
+
+TEST(SlowQueryLogTest, ReportsAreRateLimitedAndFailuresRecorded) {
+    SlowQueryConfig config;
+    config.threshold = 100ms;
+    config.maxPerMinute = 2;
+    int connects = 0;
+    SlowQueryLog log([&connects]() -> std::unique_ptr<DBManager> {
+        ++connects;
+        return nullptr;
+    }, config);
+
+    EXPECT_FALSE(log.report("SELECT * FROM rooms WHERE id = 1", 50ms));
+    EXPECT_FALSE(log.report("BEGIN", 200ms));
+    EXPECT_TRUE(log.report("SELECT * FROM rooms WHERE id = 1", 200ms));
+    EXPECT_FALSE(log.report("SELECT * FROM rooms WHERE id = 2", 300ms));  // тот же отпечаток
+    EXPECT_TRUE(log.report("SELECT * FROM users WHERE id = 1", 200ms));
+    EXPECT_FALSE(log.report("SELECT * FROM services WHERE id = 1", 200ms));  // maxPerMinute
+    log.stop();
+
+    EXPECT_EQ(log.captured(), 2u);
+    EXPECT_GE(connects, 1);
+    auto plans = log.recent();
+    ASSERT_EQ(plans.size(), 2u);
+    EXPECT_EQ(plans[0].normalized, "SELECT * FROM rooms WHERE id = ?");
+    EXPECT_EQ(plans[0].sample, "SELECT * FROM rooms WHERE id = 1");
+    EXPECT_DOUBLE_EQ(plans[0].durationMs, 200.0);
+    EXPECT_TRUE(plans[0].plan.empty());
+    EXPECT_EQ(plans[0].error, "side connection unavailable");
+    EXPECT_FALSE(log.report("SELECT * FROM bills WHERE id = 1", 200ms));  // после stop
+}
@@ -0,0 +1,89 @@
+#include "gtest/gtest.h"
+#include "SnapshotFile.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+std::string snapshotPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+void writeSample(const std::string& path) {
+    SnapshotWriter writer;
+    writer.addRoom(3, 1, "201", "Suite", 250.0, "Sea view");
+    writer.addRoom(1, 1, "101", "Standard", 90.0, "");
+    writer.addRoom(2, 2, "102", "Standard", 95.0, "Garden");
+    writer.addService(5, "Breakfast", 12.5);
+    writer.addUser(7, "alice", UserRole::MANAGER);
+    writer.addBooking(40, 7, 1, "2024-05-10", "2024-05-15", BookingStatus::CONFIRMED, 2);
+    writer.addBooking(41, 7, 3, "2024-05-01", "2024-05-03", BookingStatus::PENDING, 0);
+    writer.write(path, 1714000000);
+}
+}
+
+TEST(SnapshotFileTest, LookupsReadMappedRecords) {
+    std::string path = snapshotPath("snapshot_lookup_test.bin");
+    writeSample(path);
+    {
+        SnapshotFile snapshot(path);
+        EXPECT_EQ(snapshot.createdAt(), 1714000000);
+        ASSERT_EQ(snapshot.rooms().size(), 3u);
+        EXPECT_EQ(snapshot.rooms()[0].id, 1);
+
+        const SnapshotRoom* suite = snapshot.findRoom(3);
+        ASSERT_NE(suite, nullptr);
+        EXPECT_EQ(snapshot.text(suite->type), "Suite");
+        EXPECT_EQ(snapshot.text(suite->description), "Sea view");
+        EXPECT_EQ(snapshot.findRoom(4), nullptr);
+
+        const SnapshotRoom* byNumber = snapshot.findRoomByNumber("102");
+        ASSERT_NE(byNumber, nullptr);
+        EXPECT_EQ(byNumber->id, 2);
+        EXPECT_EQ(byNumber->propertyId, 2);
+        EXPECT_EQ(snapshot.findRoomByNumber("999"), nullptr);
+
+        ASSERT_NE(snapshot.findService(5), nullptr);
+        EXPECT_EQ(snapshot.text(snapshot.findService(5)->name), "Breakfast");
+        ASSERT_NE(snapshot.findUser(7), nullptr);
+        EXPECT_EQ(snapshot.findUser(7)->role, static_cast<int>(UserRole::MANAGER));
+        EXPECT_EQ(snapshot.text(snapshot.findUser(7)->login), "alice");
+    }
+    std::remove(path.c_str());
+}
+
+TEST(SnapshotFileTest, AvailabilityUsesSnapshotBookings) {
+    std::string path = snapshotPath("snapshot_availability_test.bin");
+    writeSample(path);
+    {
+        SnapshotFile snapshot(path);
+        std::vector<const SnapshotRoom*> rooms = snapshot.findAvailableRooms("2024-05-12", "2024-05-14");
+        ASSERT_EQ(rooms.size(), 2u);
+        EXPECT_EQ(rooms[0]->id, 2);
+        EXPECT_EQ(rooms[1]->id, 3);
+
+        EXPECT_EQ(snapshot.findAvailableRooms("2024-05-15", "2024-05-20").size(), 3u);
+        EXPECT_EQ(snapshot.findAvailableRooms("2024-04-28", "2024-05-11").size(), 1u);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(SnapshotFileTest, RejectsCorruptedOrForeignFiles) {
+    std::string path = snapshotPath("snapshot_corrupt_test.bin");
+    writeSample(path);
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(-3, std::ios::end);
+        file.put('#');
+    }
+    EXPECT_THROW(SnapshotFile snapshot(path), std::runtime_error);
+    EXPECT_NO_THROW(SnapshotFile snapshot(path, false));
+
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << std::string(200, 'x');
+    }
+    EXPECT_THROW(SnapshotFile snapshot(path), std::runtime_error);
+    std::remove(path.c_str());
+    EXPECT_THROW(SnapshotFile snapshot(path), std::runtime_error);
+}
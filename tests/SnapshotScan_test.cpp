@@ -0,0 +1,31 @@
+#include "gtest/gtest.h"
+#include "SnapshotScan.h"
+
+TEST(SnapshotScanTest, SplitRangeCoversKeysWithoutOverlap) {
+    auto ranges = SnapshotScan::splitRange(1, 100, 7);
+    ASSERT_EQ(ranges.size(), 7u);
+    ASSERT_EQ(ranges.front().lower, 1);
+    ASSERT_EQ(ranges.back().upper, 101);
+    for (std::size_t i = 1; i < ranges.size(); ++i) {
+        ASSERT_EQ(ranges[i].lower, ranges[i - 1].upper);
+        long long size = ranges[i].upper - ranges[i].lower;
+        ASSERT_TRUE(size == 14 || size == 15);
+    }
+}
+
+TEST(SnapshotScanTest, SplitRangeNeverProducesEmptyParts) {
+    auto ranges = SnapshotScan::splitRange(10, 12, 8);
+    ASSERT_EQ(ranges.size(), 3u);
+    for (const auto& range : ranges) {
+        ASSERT_EQ(range.upper - range.lower, 1);
+    }
+    auto single = SnapshotScan::splitRange(5, 5, 4);
+    ASSERT_EQ(single.size(), 1u);
+    ASSERT_EQ(single[0].lower, 5);
+    ASSERT_EQ(single[0].upper, 6);
+}
+
+TEST(SnapshotScanTest, SplitRangeHandlesEmptyInput) {
+    ASSERT_TRUE(SnapshotScan::splitRange(10, 9, 4).empty());
+    ASSERT_TRUE(SnapshotScan::splitRange(1, 10, 0).empty());
+}
@@ -0,0 +1,85 @@
+#include "gtest/gtest.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST(TaskSchedulerTest, RunsAllSubmittedTasks) {
+    std::atomic<int> counter{0};
+    {
+        TaskScheduler scheduler(4, 16);
+        for (int i = 0; i < 1000; ++i) {
+            scheduler.submit([&counter] { counter.fetch_add(1); });
+        }
+    }
+    ASSERT_EQ(counter.load(), 1000);
+}
+
+TEST(TaskSchedulerTest, GroupWaitsForNestedTasksAndRethrows) {
+    TaskScheduler scheduler(4);
+    std::atomic<int> counter{0};
+    TaskGroup outer(scheduler);
+    for (int i = 0; i < 8; ++i) {
+        outer.run([&scheduler, &counter] {
+            TaskGroup inner(scheduler);
+            for (int j = 0; j < 8; ++j) {
+                inner.run([&counter] { counter.fetch_add(1); });
+            }
+            inner.wait();
+        });
+    }
+    outer.wait();
+    ASSERT_EQ(counter.load(), 64);
+
+    TaskGroup failing(scheduler);
+    failing.run([] { throw std::runtime_error("boom"); });
+    failing.run([&counter] { counter.fetch_add(1); });
+    ASSERT_THROW(failing.wait(), std::runtime_error);
+    ASSERT_EQ(counter.load(), 65);
+    ASSERT_EQ(failing.pending(), 0u);
+}
+
+TEST(TaskSchedulerTest, ParallelForCoversRangeExactlyOnce) {
+    TaskScheduler scheduler(4);
+    std::vector<int> hits(10007, 0);
+    parallelFor(scheduler, 0, hits.size(), 100, [&hits](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) hits[i] += 1;
+    });
+    ASSERT_EQ(std::accumulate(hits.begin(), hits.end(), 0), 10007);
+    ASSERT_TRUE(std::all_of(hits.begin(), hits.end(), [](int h) { return h == 1; }));
+    parallelFor(scheduler, 5, 5, 0, [](std::size_t, std::size_t) { FAIL(); });
+}
+
+TEST(TaskSchedulerTest, TrySubmitRejectsWhenQueueIsFull) {
+    TaskScheduler scheduler(1, 2);
+    std::atomic<bool> release{false};
+    std::atomic<bool> started{false};
+    scheduler.submit([&] {
+        started = true;
+        while (!release.load()) std::this_thread::yield();
+    });
+    while (!started.load()) std::this_thread::yield();
+
+    ASSERT_TRUE(scheduler.trySubmit([] {}));
+    ASSERT_TRUE(scheduler.trySubmit([] {}));
+    ASSERT_FALSE(scheduler.trySubmit([] {}));
+    ASSERT_EQ(scheduler.stats().rejected, 1u);
+    ASSERT_EQ(scheduler.stats().queueDepth, 2u);
+    release = true;
+}
+
+TEST(TaskSchedulerTest, StatsCountExecutedTasks) {
+    TaskScheduler scheduler(2);
+    TaskGroup group(scheduler);
+    for (int i = 0; i < 100; ++i) {
+        group.run([] {});
+    }
+    group.wait();
+    SchedulerStats stats = scheduler.stats();
+    ASSERT_EQ(stats.submitted, 100u);
+    ASSERT_EQ(stats.executed, 100u);
+    ASSERT_EQ(stats.queueDepth, 0u);
+}
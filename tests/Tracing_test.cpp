@@ -0,0 +1,65 @@
+#include "gtest/gtest.h"
+#include "Tracing.h"
+#include <string>
+#include <thread>
+
+TEST(TracingTest, RecordsNothingWhileDisabled) {
+    Tracer::setEnabled(false);
+    Tracer::clear();
+    {
+        TraceSpan span("Test::disabled", "test");
+    }
+    EXPECT_EQ(Tracer::eventCount(), 0u);
+}
+
+TEST(TracingTest, WritesChromeTraceEventsPerThread) {
+    Tracer::clear();
+    Tracer::setEnabled(true);
+    {
+        TraceSpan outer("Test::outer", "test");
+        TraceSpan inner("Test::inner", "db", "SELECT \"quoted\" FROM rooms WHERE number = 'A-101' AND floor > 1");
+    }
+    std::thread worker([] {
+        Tracer::setThreadName("worker");
+        TraceSpan span("Test::worker", "test");
+    });
+    worker.join();
+    Tracer::setEnabled(false);
+
+    EXPECT_EQ(Tracer::eventCount(), 3u);
+    std::string json = Tracer::chromeJson();
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(json.find("\"name\":\"Test::outer\",\"cat\":\"test\",\"ph\":\"X\""), std::string::npos);
+    // Подробность обрезается до 47 байт и экранируется.
+    EXPECT_NE(json.find("\"args\":{\"detail\":\"SELECT \\\"quoted\\\" FROM rooms WHERE number = 'A-10\"}"),
+              std::string::npos);
+    EXPECT_NE(json.find("\"ph\":\"M\""), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{\"name\":\"worker\"}"), std::string::npos);
+    // Внутренняя область закрывается раньше внешней, поэтому записывается первой.
+    EXPECT_LT(json.find("Test::inner"), json.find("Test::outer"));
+
+    Tracer::clear();
+    EXPECT_EQ(Tracer::eventCount(), 0u);
+}
+
+TEST(TracingTest, RingBufferKeepsNewestEvents) {
+    Tracer::clear();
+    Tracer::setEnabled(true);
+    for (std::size_t i = 0; i < Tracer::BUFFER_EVENTS + 10; ++i) {
+        TraceSpan span("Test::loop", "test", i == 0 ? "first" : (i + 1 == Tracer::BUFFER_EVENTS + 10 ? "last" : ""));
+    }
+    // Многобайтовый символ на границе обрезки не разрезается.
+    std::string cyrillic(TraceEvent::DETAIL_SIZE - 2, 'x');
+    cyrillic += "\xD0\xAF";
+    {
+        TraceSpan span("Test::utf8", "test", cyrillic);
+    }
+    Tracer::setEnabled(false);
+
+    EXPECT_EQ(Tracer::eventCount(), Tracer::BUFFER_EVENTS);
+    std::string json = Tracer::chromeJson();
+    EXPECT_EQ(json.find("\"first\""), std::string::npos);
+    EXPECT_NE(json.find("\"last\""), std::string::npos);
+    EXPECT_NE(json.find("\"" + std::string(TraceEvent::DETAIL_SIZE - 2, 'x') + "\""), std::string::npos);
+    Tracer::clear();
+}
@@ -0,0 +1,24 @@
+#include "gtest/gtest.h"
+#include "UIManager.h"
+
+TEST(UIManagerTest, ValidDatesAreAccepted) {
+    EXPECT_TRUE(isValidDate("2025-01-31"));
+    EXPECT_TRUE(isValidDate("2024-02-29"));
+    EXPECT_TRUE(isValidDate("2025-12-01"));
+}
+
+TEST(UIManagerTest, ImpossibleCalendarDatesAreRejected) {
+    EXPECT_FALSE(isValidDate("2025-02-30"));
+    EXPECT_FALSE(isValidDate("2025-02-29"));
+    EXPECT_FALSE(isValidDate("2025-04-31"));
+    EXPECT_FALSE(isValidDate("2025-13-01"));
+    EXPECT_FALSE(isValidDate("2025-00-10"));
+    EXPECT_FALSE(isValidDate("2025-01-00"));
+}
+
+TEST(UIManagerTest, MalformedDatesAreRejected) {
+    EXPECT_FALSE(isValidDate(""));
+    EXPECT_FALSE(isValidDate("2025-1-01"));
+    EXPECT_FALSE(isValidDate("2025/01/01"));
+    EXPECT_FALSE(isValidDate("2025-01-01x"));
+}
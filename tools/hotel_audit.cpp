@@ -0,0 +1,190 @@
+/**
+ * @file hotel_audit.cpp
+ * @brief Точка входа чтения журнала аудита.
+ *
+ * Использование:
+ *   hotel_audit local [directory] [filters]   - записи локальных сегментов (еще не отправленные в audit_log)
+ *   hotel_audit query [filters]               - записи таблицы audit_log
+ * Фильтры: --actor <user_id> --target <id> --action <role_change|status_change|bill_calculated>
+ *          --from <YYYY-MM-DD> --limit <N>.
+ * Записи выводятся в CSV в порядке записи. Параметры базы данных берутся из переменных
+ * окружения HOTEL_DB_HOST, HOTEL_DB_PORT, HOTEL_DB_USER, HOTEL_DB_PASSWORD, HOTEL_DB_NAME.
+ */
+
+#include "AuditJournal.h"
+#include "DBManager.h"
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <optional>
+#include <string>
+
+namespace {
+
+/**
+ * @brief Возвращает значение переменной окружения или значение по умолчанию.
+ */
+std::string env(const char* name, const std::string& fallback) {
+    const char* value = std::getenv(name);
+    return value && *value ? std::string(value) : fallback;
+}
+
+/**
+ * @brief Выводит справку по использованию.
+ */
+int usage() {
+    std::cerr << "Usage: hotel_audit local [directory] [filters]\n"
+                 "       hotel_audit query [filters]\n"
+                 "Filters: --actor <user_id> --target <id> --action <role_change|status_change|bill_calculated>\n"
+                 "         --from <YYYY-MM-DD> --limit <N>" << std::endl;
+    return 2;
+}
+
+/**
+ * @brief Условия отбора записей.
+ */
+struct Filter {
+    std::optional<int> actor;
+    std::optional<int> target;
+    std::optional<AuditAction> action;
+    std::string from;     ///< Дата YYYY-MM-DD (пусто - без ограничения).
+    long limit = 0;       ///< 0 - без ограничения.
+};
+
+/**
+ * @brief Разбирает фильтры, начиная с аргумента first.
+ * @throw std::invalid_argument Если фильтр неизвестен или значение неверно.
+ */
+Filter parseFilter(int argc, char* argv[], int first) {
+    Filter filter;
+    for (int i = first; i < argc; i += 2) {
+        std::string name = argv[i];
+        if (i + 1 >= argc) {
+            throw std::invalid_argument("Missing value for " + name);
+        }
+        std::string value = argv[i + 1];
+        if (name == "--actor") {
+            filter.actor = std::stoi(value);
+        } else if (name == "--target") {
+            filter.target = std::stoi(value);
+        } else if (name == "--action") {
+            filter.action = AuditJournal::parseAction(value);
+        } else if (name == "--from") {
+            if (value.size() != 10 || value[4] != '-' || value[7] != '-') {
+                throw std::invalid_argument("Expected YYYY-MM-DD: " + value);
+            }
+            filter.from = value;
+        } else if (name == "--limit") {
+            filter.limit = std::stol(value);
+        } else {
+            throw std::invalid_argument("Unknown filter: " + name);
+        }
+    }
+    return filter;
+}
+
+/**
+ * @brief Заключает поле в кавычки CSV.
+ */
+std::string csvField(const std::string& text) {
+    std::string quoted = "\"";
+    for (char c : text) {
+        quoted += c;
+        if (c == '"') quoted += '"';
+    }
+    return quoted + "\"";
+}
+
+/**
+ * @brief Форматирует время записи (UTC) с миллисекундами.
+ */
+std::string formatTime(std::int64_t wallNs) {
+    std::time_t seconds = static_cast<std::time_t>(wallNs / 1000000000);
+    char text[32];
+    std::strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", std::gmtime(&seconds));
+    char millis[8];
+    std::snprintf(millis, sizeof(millis), ".%03d", static_cast<int>(wallNs % 1000000000 / 1000000));
+    return std::string(text) + millis;
+}
+
+/**
+ * @brief Выводит записи локальных сегментов каталога.
+ */
+void showLocal(const std::string& directory, const Filter& filter) {
+    std::cout << "sequence,recorded_at,actor_id,action,target_id,detail\n";
+    long shown = 0;
+    for (const AuditRecord& record : AuditJournal::readDirectory(directory)) {
+        std::string time = formatTime(record.wallNs);
+        if ((filter.actor && record.actorId != *filter.actor) || (filter.target && record.targetId != *filter.target) ||
+            (filter.action && record.action != *filter.action) || time < filter.from) {
+            continue;
+        }
+        std::cout << record.sequence << ',' << time << ',' << record.actorId << ','
+                  << AuditJournal::actionName(record.action) << ',' << record.targetId << ',' << csvField(record.detail) << '\n';
+        if (filter.limit > 0 && ++shown >= filter.limit) {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Выводит записи таблицы audit_log.
+ */
+void showDatabase(DBManager& db, const Filter& filter) {
+    std::string where;
+    auto add = [&where](const std::string& condition) { where += (where.empty() ? " WHERE " : " AND ") + condition; };
+    if (filter.actor) add("actor_id = " + std::to_string(*filter.actor));
+    if (filter.target) add("target_id = " + std::to_string(*filter.target));
+    if (filter.action) add(std::string("action = '") + AuditJournal::actionName(*filter.action) + "'");
+    if (!filter.from.empty()) add("recorded_at >= '" + filter.from + "'::date");
+    PGResultWrapper result = db.executeQuery(
+        "SELECT node, sequence, to_char(recorded_at AT TIME ZONE 'UTC', 'YYYY-MM-DD HH24:MI:SS.MS'), "
+        "COALESCE(actor_id, 0), action, target_id, detail FROM audit_log" + where + " ORDER BY recorded_at, node, sequence" +
+        (filter.limit > 0 ? " LIMIT " + std::to_string(filter.limit) : std::string()) + ";");
+    std::cout << "node,sequence,recorded_at,actor_id,action,target_id,detail\n";
+    for (int row = 0; row < PQntuples(result.get()); ++row) {
+        std::cout << csvField(PQgetvalue(result.get(), row, 0));
+        for (int column = 1; column < 6; ++column) {
+            std::cout << ',' << PQgetvalue(result.get(), row, column);
+        }
+        std::cout << ',' << csvField(PQgetvalue(result.get(), row, 6)) << '\n';
+    }
+}
+
+} // namespace
+
+/** @brief Точка входа. */
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        return usage();
+    }
+    std::string command = argv[1];
+
+    try {
+        if (command == "local") {
+            bool hasDirectory = argc > 2 && std::string(argv[2]).rfind("--", 0) != 0;
+            showLocal(hasDirectory ? argv[2] : "audit", parseFilter(argc, argv, hasDirectory ? 3 : 2));
+            return 0;
+        }
+        if (command != "query") {
+            return usage();
+        }
+        Filter filter = parseFilter(argc, argv, 2);
+        DBManager db(env("HOTEL_DB_HOST", "127.0.0.1"), env("HOTEL_DB_USER", "postgres"), env("HOTEL_DB_PASSWORD", "dfvgbh04"),
+                     env("HOTEL_DB_NAME", "hotel_management"), std::stoi(env("HOTEL_DB_PORT", "5432")));
+        if (!db.connect()) {
+            std::cerr << "FATAL: Failed to connect to database!" << std::endl;
+            return 1;
+        }
+        showDatabase(db, filter);
+        db.disconnect();
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << std::endl;
+        return usage();
+    } catch (const std::exception& e) {
+        std::cerr << "FATAL: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
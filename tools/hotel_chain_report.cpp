@@ -0,0 +1,90 @@
+/**
+ * @file hotel_chain_report.cpp
+ * @brief Точка входа отчета по сети отелей: сводка бронирований всех отелей за период,
+ *        собранная параллельно из всех баз данных-шардов.
+ *
+ * Использование: hotel_chain_report <date_from> <date_to> [property_id]
+ * Шарды задаются переменной HOTEL_SHARDS="host[:port]/database=1,2;host[:port]/database=3";
+ * пользователь и пароль - HOTEL_DB_USER, HOTEL_DB_PASSWORD. Если указан property_id, дополнительно
+ * выводятся свободные номера этого отеля (запрос только к его шарду).
+ */
+
+#include "Booking.h"
+#include "ConnectionPool.h"
+#include "Room.h"
+#include "ShardRouter.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace {
+
+/**
+ * @brief Возвращает значение переменной окружения или значение по умолчанию.
+ */
+std::string env(const char* name, const std::string& fallback) {
+    const char* value = std::getenv(name);
+    return value && *value ? std::string(value) : fallback;
+}
+
+} // namespace
+
+/** @brief Точка входа. */
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: hotel_chain_report <date_from> <date_to> [property_id]" << std::endl;
+        return 2;
+    }
+    std::string dateFrom = argv[1];
+    std::string dateTo = argv[2];
+
+    try {
+        std::vector<ShardConfig> configs = ShardRouter::parseShards(
+            env("HOTEL_SHARDS", "127.0.0.1:5432/hotel_management=1"), env("HOTEL_DB_USER", "postgres"),
+            env("HOTEL_DB_PASSWORD", "dfvgbh04"));
+        TaskScheduler scheduler(configs.size());
+        ShardRouter router(scheduler);
+        for (auto& config : configs) {
+            const ReplicaEndpoint& shard = config.endpoint;
+            router.addShard(std::make_unique<ConnectionPool>(
+                                ConnectionPool::postgres(shard.host, shard.user, shard.password, shard.database, shard.port), 2),
+                            std::move(config.properties));
+        }
+
+        std::vector<PropertyStats> stats = router.gather<PropertyStats>(
+            [&](DBManager& db) { return Booking::propertyStats(db, dateFrom, dateTo); });
+        std::sort(stats.begin(), stats.end(),
+                  [](const PropertyStats& a, const PropertyStats& b) { return a.propertyId < b.propertyId; });
+
+        PropertyStats total;
+        std::cout << std::left << std::setw(10) << "Property" << std::setw(10) << "Bookings" << std::setw(10) << "Nights"
+                  << "Revenue" << std::endl;
+        for (const auto& row : stats) {
+            std::cout << std::setw(10) << row.propertyId << std::setw(10) << row.bookings << std::setw(10) << row.nights
+                      << std::fixed << std::setprecision(2) << row.revenue << std::endl;
+            total.bookings += row.bookings;
+            total.nights += row.nights;
+            total.revenue += row.revenue;
+        }
+        std::cout << std::setw(10) << "Total" << std::setw(10) << total.bookings << std::setw(10) << total.nights
+                  << std::fixed << std::setprecision(2) << total.revenue << std::endl;
+
+        if (argc > 3) {
+            int propertyId = std::stoi(argv[3]);
+            ConnectionPool::Lease lease = router.acquire(propertyId);
+            std::vector<Room> rooms = Room::findAvailableRooms(*lease, propertyId, dateFrom, dateTo);
+            std::cout << "\nAvailable rooms of property " << propertyId << " (shard " << router.shardOf(propertyId)
+                      << "): " << rooms.size() << std::endl;
+            for (const auto& room : rooms) {
+                std::cout << "  " << room.getNumber() << " (" << room.getType() << ")" << std::endl;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "FATAL: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,214 @@
+/**
+ * @file hotel_datagen.cpp
+ * @brief Точка входа генератора синтетических данных для нагрузочных испытаний.
+ *
+ * Использование: hotel_datagen [параметры]
+ *   --seed N             зерно (по умолчанию 1)
+ *   --properties N       отелей сети (1)
+ *   --rooms N            номеров всего (100)
+ *   --guests N           гостей (5000)
+ *   --years N            лет истории (2)
+ *   --months-ahead N     месяцев будущих бронирований (3)
+ *   --today YYYY-MM-DD   текущая дата (по умолчанию сегодня; задайте явно для воспроизводимости)
+ *   --occupancy F        средняя загрузка 0..1 (0.7)
+ *   --seasonality F      амплитуда сезонности 0..1 (0.3)
+ *   --cancellations F    доля отмен 0..1 (0.08)
+ *   --services F         среднее число услуг на бронирование (1.2)
+ *   --out DIR            записать файлы DIR/<таблица>.tsv и DIR/load.sql вместо загрузки в базу данных
+ *   --truncate           очистить таблицы перед загрузкой (иначе они должны быть пустыми)
+ * Загрузка в базу данных выполняется командой COPY в одной транзакции. Параметры базы данных
+ * берутся из переменных окружения HOTEL_DB_HOST, HOTEL_DB_PORT, HOTEL_DB_USER, HOTEL_DB_PASSWORD,
+ * HOTEL_DB_NAME.
+ */
+
+#include "DataGenerator.h"
+#include "DBManager.h"
+#include "PartitionManager.h"
+#include "RolloverJob.h"
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace {
+
+/// Таблицы с последовательностями идентификаторов, которые нужно продвинуть после загрузки.
+const char* const kSequenceTables[] = {"users", "rooms", "services", "bookings"};
+
+/**
+ * @brief Возвращает значение переменной окружения или значение по умолчанию.
+ */
+std::string env(const char* name, const std::string& fallback) {
+    const char* value = std::getenv(name);
+    return value && *value ? std::string(value) : fallback;
+}
+
+/**
+ * @brief Выводит справку по использованию.
+ */
+int usage() {
+    std::cerr << "Usage: hotel_datagen [--seed N] [--properties N] [--rooms N] [--guests N] [--years N]\n"
+                 "                     [--months-ahead N] [--today YYYY-MM-DD] [--occupancy F] [--seasonality F]\n"
+                 "                     [--cancellations F] [--services F] [--out DIR] [--truncate]" << std::endl;
+    return 2;
+}
+
+/**
+ * @brief Выводит количество строк таблицы и скорость генерации.
+ */
+void report(DataTable table, long long rows, std::chrono::steady_clock::duration elapsed) {
+    double seconds = std::chrono::duration<double>(elapsed).count();
+    std::cerr << DataGenerator::tableName(table) << ": " << rows << " row(s) in " << seconds << " s";
+    if (seconds > 0) {
+        std::cerr << " (" << static_cast<long long>(rows * 60 / seconds) << " rows/min)";
+    }
+    std::cerr << std::endl;
+}
+
+/**
+ * @brief Записывает таблицы в файлы формата COPY и сценарий загрузки для psql.
+ * Сценарий создает секции всех месяцев истории, загружает файлы командой \\copy и продвигает
+ * последовательности идентификаторов.
+ */
+void writeFiles(const DataGenerator& generator, const std::string& directory) {
+    std::filesystem::create_directories(directory);
+    std::ofstream script(std::filesystem::path(directory) / "load.sql");
+    script << "-- Generated by hotel_datagen: psql -f load.sql from this directory (after sql/002 and sql/003).\nBEGIN;\n";
+    std::string firstMonth = PartitionManager::monthStart(generator.firstDay());
+    for (int offset = 0; offset <= generator.monthsSpanned(); ++offset) {
+        for (const auto& table : PartitionManager::tables()) {
+            script << PartitionManager::createStatement(table, PartitionManager::addMonths(firstMonth, offset)) << "\n";
+        }
+    }
+    for (DataTable table : DataGenerator::loadOrder()) {
+        std::string name = DataGenerator::tableName(table);
+        std::ofstream out(std::filesystem::path(directory) / (name + ".tsv"), std::ios::binary);
+        auto started = std::chrono::steady_clock::now();
+        long long rows = generator.generate(table, [&](const std::string& chunk) { out.write(chunk.data(), chunk.size()); });
+        if (!out) {
+            throw std::runtime_error("Failed to write " + name + ".tsv");
+        }
+        report(table, rows, std::chrono::steady_clock::now() - started);
+        if (table == DataTable::PROPERTIES) {
+            script << "CREATE TEMP TABLE datagen_properties (LIKE properties) ON COMMIT DROP;\n"
+                      "\\copy datagen_properties (" << DataGenerator::columns(table) << ") FROM 'properties.tsv'\n"
+                      "INSERT INTO properties SELECT * FROM datagen_properties ON CONFLICT (id) DO NOTHING;\n";
+        } else {
+            script << "\\copy " << name << " (" << DataGenerator::columns(table) << ") FROM '" << name << ".tsv'\n";
+        }
+    }
+    for (const char* table : kSequenceTables) {
+        script << "SELECT setval(pg_get_serial_sequence('" << table << "', 'id'), (SELECT COALESCE(max(id), 1) FROM "
+               << table << "));\n";
+    }
+    script << "COMMIT;\nANALYZE;\n";
+}
+
+/**
+ * @brief Загружает таблицы в базу данных командой COPY в одной транзакции.
+ * Секции bookings/booking_services создаются для всех месяцев истории заранее, чтобы строки
+ * не попали в секцию DEFAULT. Отели добавляются без перезаписи существующих.
+ */
+void load(const DataGenerator& generator, DBManager& db, bool truncate) {
+    if (!truncate) {
+        PGResultWrapper existing = db.executeQuery(
+            "SELECT EXISTS (SELECT 1 FROM users) OR EXISTS (SELECT 1 FROM rooms) OR EXISTS (SELECT 1 FROM bookings);");
+        if (std::string(PQgetvalue(existing.get(), 0, 0)) == "t") {
+            throw std::runtime_error("Target tables are not empty; rerun with --truncate to replace their contents");
+        }
+    }
+
+    db.beginTransaction();
+    try {
+        if (truncate) {
+            db.executeUpdate("TRUNCATE booking_services, bookings, services, rooms, users RESTART IDENTITY CASCADE;");
+        }
+        int created = PartitionManager(db).ensurePartitions(generator.firstDay(), generator.monthsSpanned());
+        if (created > 0) {
+            std::cerr << "Created " << created << " partition(s) from " << generator.firstDay() << std::endl;
+        }
+        for (DataTable table : DataGenerator::loadOrder()) {
+            std::string target = DataGenerator::tableName(table);
+            if (table == DataTable::PROPERTIES) {
+                db.executeUpdate("CREATE TEMP TABLE datagen_properties (LIKE properties) ON COMMIT DROP;");
+                target = "datagen_properties";
+            }
+            auto started = std::chrono::steady_clock::now();
+            long long rows = db.copyIn("COPY " + target + " (" + DataGenerator::columns(table) + ") FROM STDIN;",
+                                       [&](const auto& send) { generator.generate(table, send); });
+            report(table, rows, std::chrono::steady_clock::now() - started);
+            if (table == DataTable::PROPERTIES) {
+                db.executeUpdate("INSERT INTO properties SELECT * FROM datagen_properties ON CONFLICT (id) DO NOTHING;");
+            }
+        }
+        for (const char* table : kSequenceTables) {
+            db.executeQuery(std::string("SELECT setval(pg_get_serial_sequence('") + table +
+                            "', 'id'), (SELECT COALESCE(max(id), 1) FROM " + table + "));");
+        }
+        db.commit();
+    } catch (...) {
+        db.rollback();
+        throw;
+    }
+    db.executeUpdate("ANALYZE;");
+}
+
+} // namespace
+
+/** @brief Точка входа. */
+int main(int argc, char* argv[]) {
+    DataGenConfig config;
+    config.today = RolloverJob::today();
+    std::string outDirectory;
+    bool truncate = false;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string option = argv[i];
+            if (option == "--truncate") {
+                truncate = true;
+                continue;
+            }
+            if (i + 1 >= argc) {
+                return usage();
+            }
+            std::string value = argv[++i];
+            if (option == "--seed") config.seed = std::stoull(value);
+            else if (option == "--properties") config.properties = std::stoi(value);
+            else if (option == "--rooms") config.rooms = std::stoi(value);
+            else if (option == "--guests") config.guests = std::stoi(value);
+            else if (option == "--years") config.years = std::stoi(value);
+            else if (option == "--months-ahead") config.monthsAhead = std::stoi(value);
+            else if (option == "--today") config.today = value;
+            else if (option == "--occupancy") config.occupancy = std::stod(value);
+            else if (option == "--seasonality") config.seasonality = std::stod(value);
+            else if (option == "--cancellations") config.cancellationRate = std::stod(value);
+            else if (option == "--services") config.servicesPerBooking = std::stod(value);
+            else if (option == "--out") outDirectory = value;
+            else return usage();
+        }
+
+        DataGenerator generator(config);
+        std::cerr << "Generating " << generator.firstDay() << " .. " << generator.lastDay() << ", seed " << config.seed
+                  << ", today " << config.today << std::endl;
+
+        if (!outDirectory.empty()) {
+            writeFiles(generator, outDirectory);
+            return 0;
+        }
+
+        DBManager db(env("HOTEL_DB_HOST", "127.0.0.1"), env("HOTEL_DB_USER", "postgres"), env("HOTEL_DB_PASSWORD", "dfvgbh04"),
+                     env("HOTEL_DB_NAME", "hotel_management"), std::stoi(env("HOTEL_DB_PORT", "5432")));
+        if (!db.connect()) {
+            std::cerr << "FATAL: Failed to connect to database!" << std::endl;
+            return 1;
+        }
+        load(generator, db, truncate);
+    } catch (const std::exception& e) {
+        std::cerr << "FATAL: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
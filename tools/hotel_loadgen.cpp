@@ -0,0 +1,475 @@
+/**
+ * @file hotel_loadgen.cpp
+ * @brief Нагрузочный тест бронирования: N конкурентных сеансов гостей и администраторов выполняют
+ *        настоящие пути кода Booking/Room/Service/Bill против базы данных.
+ *
+ * Использование: hotel_loadgen [параметры]
+ *   --guests N          сеансов гостей (16)
+ *   --clerks N          сеансов администраторов (4)
+ *   --seconds N         длительность теста (30)
+ *   --rate R            открытая модель: операций в секунду на все сеансы; 0 - замкнутая модель (0)
+ *   --think-ms F        замкнутая модель: среднее время обдумывания между операциями, мс (100)
+ *   --guest-mix MIX     доли операций гостя (search=40,book=30,service=15,bill=10,cancel=5)
+ *   --clerk-mix MIX     доли операций администратора (search=20,book=10,service=30,bill=30,cancel=10)
+ *   --from YYYY-MM-DD   начало окна дат заезда (по умолчанию через неделю от сегодня)
+ *   --window-days N     ширина окна дат заезда (60)
+ *   --hot-rooms N       бронировать один из первых N найденных номеров (8; меньше - больше конфликтов)
+ *   --seed N            зерно (1)
+ *   --cleanup           удалить бронирования, созданные тестом
+ * Данные (гости, номера, услуги) должны быть загружены заранее, например hotel_datagen.
+ * Параметры базы данных берутся из переменных окружения HOTEL_DB_HOST, HOTEL_DB_PORT,
+ * HOTEL_DB_USER, HOTEL_DB_PASSWORD, HOTEL_DB_NAME.
+ *
+ * В открытой модели задержка считается от запланированного момента операции (поправка на
+ * координированное упущение), время обслуживания - от фактического начала. Конфликтом бронирования
+ * считается отказ createBooking после того, как поиск показал номер свободным; после теста
+ * дополнительно подсчитываются пересекающиеся бронирования, созданные тестом (двойные бронирования).
+ */
+
+#include "Bill.h"
+#include "Booking.h"
+#include "DBManager.h"
+#include "LatencyHistogram.h"
+#include "LoadProfile.h"
+#include "OptimisticLock.h"
+#include "RolloverJob.h"
+#include "Room.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Параметры теста.
+ */
+struct Options {
+    int guests = 16;
+    int clerks = 4;
+    int seconds = 30;
+    double rate = 0;
+    double thinkMs = 100;
+    std::string guestMix = "search=40,book=30,service=15,bill=10,cancel=5";
+    std::string clerkMix = "search=20,book=10,service=30,bill=30,cancel=10";
+    std::string from;
+    int windowDays = 60;
+    int hotRooms = 8;
+    std::uint64_t seed = 1;
+    bool cleanup = false;
+};
+
+/**
+ * @brief Результаты одного сеанса.
+ */
+struct SessionResult {
+    std::array<LatencyHistogram, LOAD_OPERATION_COUNT> response;    ///< От запланированного момента.
+    std::array<LatencyHistogram, LOAD_OPERATION_COUNT> service;     ///< От фактического начала.
+    std::array<std::uint64_t, LOAD_OPERATION_COUNT> errors{};
+    std::array<std::uint64_t, LOAD_OPERATION_COUNT> skipped{};      ///< Нет бронирования для операции.
+    std::uint64_t bookAttempts = 0;
+    std::uint64_t booked = 0;
+    std::uint64_t bookConflicts = 0;    ///< Номер заняли между поиском и бронированием.
+    std::uint64_t noRooms = 0;          ///< Поиск не нашел свободных номеров.
+    std::uint64_t versionConflicts = 0; ///< Повторы из-за конфликта версий бронирования.
+};
+
+/**
+ * @brief Данные, общие для сеансов.
+ */
+struct SharedState {
+    Options options;
+    std::vector<int> guestIds;
+    std::vector<int> serviceIds;
+    std::chrono::sys_days windowStart;
+    std::mutex bookingsMutex;
+    std::vector<int> bookings;          ///< Бронирования, созданные тестом (для администраторов).
+};
+
+/**
+ * @brief Возвращает значение переменной окружения или значение по умолчанию.
+ */
+std::string env(const char* name, const std::string& fallback) {
+    const char* value = std::getenv(name);
+    return value && *value ? std::string(value) : fallback;
+}
+
+/**
+ * @brief Создает соединение с базой данных из переменных окружения.
+ */
+std::unique_ptr<DBManager> connectDB() {
+    auto db = std::make_unique<DBManager>(env("HOTEL_DB_HOST", "127.0.0.1"), env("HOTEL_DB_USER", "postgres"),
+                                          env("HOTEL_DB_PASSWORD", "dfvgbh04"), env("HOTEL_DB_NAME", "hotel_management"),
+                                          std::stoi(env("HOTEL_DB_PORT", "5432")));
+    if (!db->connect()) {
+        throw std::runtime_error("Failed to connect to database");
+    }
+    return db;
+}
+
+/**
+ * @brief Форматирует дату в YYYY-MM-DD.
+ */
+std::string formatDate(std::chrono::sys_days day) {
+    std::chrono::year_month_day date(day);
+    char buffer[11];
+    std::snprintf(buffer, sizeof(buffer), "%04d-%02u-%02u", static_cast<int>(date.year()),
+                  static_cast<unsigned>(date.month()), static_cast<unsigned>(date.day()));
+    return buffer;
+}
+
+/**
+ * @brief Разбирает дату YYYY-MM-DD.
+ * @throws std::invalid_argument Если дата имеет неверный формат.
+ */
+std::chrono::sys_days parseDate(const std::string& text) {
+    int year = 0;
+    unsigned month = 0, day = 0;
+    std::chrono::year_month_day date;
+    if (std::sscanf(text.c_str(), "%d-%u-%u", &year, &month, &day) != 3 ||
+        !(date = std::chrono::year_month_day(std::chrono::year(year), std::chrono::month(month), std::chrono::day(day))).ok()) {
+        throw std::invalid_argument("Invalid date: '" + text + "'");
+    }
+    return std::chrono::sys_days(date);
+}
+
+/**
+ * @brief Сеанс гостя или администратора.
+ * Гость работает со своими бронированиями, администратор - с любыми бронированиями, созданными тестом.
+ */
+class Session {
+private:
+    SharedState& shared;
+    SessionResult& result;
+    const OperationMix& mix;
+    bool clerk;
+    int userId;
+    std::mt19937_64 random;
+    std::unique_ptr<DBManager> db;
+    std::vector<int> own;
+
+    double uniform() { return std::uniform_real_distribution<double>(0.0, 1.0)(random); }
+    int below(std::size_t bound) { return static_cast<int>(uniform() * static_cast<double>(bound)); }
+
+    /**
+     * @brief Выбирает случайные даты проживания в окне теста (1-4 ночи).
+     */
+    std::pair<std::string, std::string> pickStay() {
+        auto from = shared.windowStart + std::chrono::days(below(static_cast<std::size_t>(shared.options.windowDays)));
+        return {formatDate(from), formatDate(from + std::chrono::days(1 + below(4)))};
+    }
+
+    /**
+     * @brief Выбирает бронирование для операции: свое для гостя, любое созданное тестом для администратора.
+     * @return Идентификатор или 0, если бронирований нет.
+     */
+    int pickBooking() {
+        if (!clerk) {
+            return own.empty() ? 0 : own[below(own.size())];
+        }
+        std::lock_guard<std::mutex> lock(shared.bookingsMutex);
+        return shared.bookings.empty() ? 0 : shared.bookings[below(shared.bookings.size())];
+    }
+
+    /**
+     * @brief Забывает отмененное бронирование.
+     */
+    void forget(int bookingId) {
+        own.erase(std::remove(own.begin(), own.end(), bookingId), own.end());
+        std::lock_guard<std::mutex> lock(shared.bookingsMutex);
+        shared.bookings.erase(std::remove(shared.bookings.begin(), shared.bookings.end(), bookingId), shared.bookings.end());
+    }
+
+    /**
+     * @brief Изменяет бронирование с повторами при конфликте версий.
+     */
+    template <typename Change>
+    UpdateResult change(int bookingId, Change&& apply) {
+        int attempts = 0;
+        UpdateResult outcome = retryOnConflict([&] {
+            auto booking = Booking::findBookingById(*db, bookingId);
+            return booking ? apply(*booking) : UpdateResult::NOT_FOUND;
+        }, RetryPolicy(), &attempts);
+        result.versionConflicts += static_cast<std::uint64_t>(attempts > 0 ? attempts - 1 : 0);
+        return outcome;
+    }
+
+    /**
+     * @brief Выполняет операцию.
+     * @return False, если операцию не к чему применить (она не учитывается в задержках).
+     */
+    bool perform(LoadOperation operation) {
+        switch (operation) {
+            case LoadOperation::SEARCH: {
+                auto [from, to] = pickStay();
+                Room::findAvailableRooms(*db, from, to);
+                return true;
+            }
+            case LoadOperation::BOOK: {
+                auto [from, to] = pickStay();
+                std::vector<Room> rooms = Room::findAvailableRooms(*db, from, to);
+                if (rooms.empty()) {
+                    ++result.noRooms;
+                    return true;
+                }
+                const Room& room = rooms[below(std::min<std::size_t>(rooms.size(), static_cast<std::size_t>(shared.options.hotRooms)))];
+                ++result.bookAttempts;
+                auto booking = Booking::createBooking(*db, userId, room.getId(), from, to);
+                if (!booking) {
+                    ++result.bookConflicts;
+                    return true;
+                }
+                ++result.booked;
+                own.push_back(booking->getId());
+                std::lock_guard<std::mutex> lock(shared.bookingsMutex);
+                shared.bookings.push_back(booking->getId());
+                return true;
+            }
+            case LoadOperation::ADD_SERVICE: {
+                int bookingId = pickBooking();
+                if (bookingId == 0 || shared.serviceIds.empty()) {
+                    return false;
+                }
+                int serviceId = shared.serviceIds[below(shared.serviceIds.size())];
+                change(bookingId, [&](Booking& booking) { return booking.addService(*db, serviceId, 1 + below(3)); });
+                return true;
+            }
+            case LoadOperation::BILL: {
+                int bookingId = pickBooking();
+                if (bookingId == 0) {
+                    return false;
+                }
+                Bill::forBooking(*db, bookingId);
+                return true;
+            }
+            case LoadOperation::CANCEL: {
+                int bookingId = pickBooking();
+                if (bookingId == 0) {
+                    return false;
+                }
+                change(bookingId, [&](Booking& booking) { return booking.updateStatus(*db, BookingStatus::CANCELLED); });
+                forget(bookingId);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Выполняет операцию, запланированную на intended, и записывает задержки.
+     */
+    void runOne(Clock::time_point intended) {
+        LoadOperation operation = mix.pick(uniform());
+        std::size_t index = static_cast<std::size_t>(operation);
+        auto started = Clock::now();
+        bool counted = true;
+        try {
+            if (!db->isConnected() && !db->connect()) {
+                throw std::runtime_error("reconnect failed");
+            }
+            counted = perform(operation);
+        } catch (const std::exception&) {
+            ++result.errors[index];
+        }
+        auto finished = Clock::now();
+        if (!counted) {
+            ++result.skipped[index];
+            return;
+        }
+        result.response[index].record(static_cast<std::uint64_t>(std::chrono::nanoseconds(finished - intended).count()));
+        result.service[index].record(static_cast<std::uint64_t>(std::chrono::nanoseconds(finished - started).count()));
+    }
+
+public:
+    Session(SharedState& shared, SessionResult& result, const OperationMix& mix, bool clerk, int userId, std::uint64_t seed)
+        : shared(shared), result(result), mix(mix), clerk(clerk), userId(userId), random(seed), db(connectDB()) {}
+
+    /**
+     * @brief Открытая модель: операции по пуассоновскому расписанию с интенсивностью rate.
+     */
+    void runOpen(double rate, Clock::time_point start, Clock::time_point deadline) {
+        ArrivalSchedule schedule(rate, random(), start);
+        for (Clock::time_point intended = schedule.next(); intended < deadline; intended = schedule.next()) {
+            std::this_thread::sleep_until(intended);
+            runOne(intended);
+        }
+    }
+
+    /**
+     * @brief Замкнутая модель: операция, затем экспоненциальное время обдумывания.
+     */
+    void runClosed(double thinkMs, Clock::time_point deadline) {
+        std::exponential_distribution<double> think(thinkMs > 0 ? 1.0 / thinkMs : 1.0);
+        while (Clock::now() < deadline) {
+            if (thinkMs > 0) {
+                std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(think(random)));
+            }
+            runOne(Clock::now());
+        }
+    }
+};
+
+/**
+ * @brief Выводит справку по использованию.
+ */
+int usage() {
+    std::cerr << "Usage: hotel_loadgen [--guests N] [--clerks N] [--seconds N] [--rate R] [--think-ms F]\n"
+                 "                     [--guest-mix MIX] [--clerk-mix MIX] [--from YYYY-MM-DD] [--window-days N]\n"
+                 "                     [--hot-rooms N] [--seed N] [--cleanup]" << std::endl;
+    return 2;
+}
+
+/**
+ * @brief Возвращает идентификаторы из первого столбца запроса.
+ */
+std::vector<int> queryIds(DBManager& db, const std::string& query) {
+    PGResultWrapper result = db.executeQuery(query);
+    std::vector<int> ids;
+    for (int i = 0; i < PQntuples(result.get()); ++i) {
+        ids.push_back(std::stoi(PQgetvalue(result.get(), i, 0)));
+    }
+    return ids;
+}
+
+} // namespace
+
+/** @brief Точка входа. */
+int main(int argc, char* argv[]) {
+    SharedState shared;
+    Options& options = shared.options;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string option = argv[i];
+            if (option == "--cleanup") {
+                options.cleanup = true;
+                continue;
+            }
+            if (i + 1 >= argc) {
+                return usage();
+            }
+            std::string value = argv[++i];
+            if (option == "--guests") options.guests = std::stoi(value);
+            else if (option == "--clerks") options.clerks = std::stoi(value);
+            else if (option == "--seconds") options.seconds = std::stoi(value);
+            else if (option == "--rate") options.rate = std::stod(value);
+            else if (option == "--think-ms") options.thinkMs = std::stod(value);
+            else if (option == "--guest-mix") options.guestMix = value;
+            else if (option == "--clerk-mix") options.clerkMix = value;
+            else if (option == "--from") options.from = value;
+            else if (option == "--window-days") options.windowDays = std::stoi(value);
+            else if (option == "--hot-rooms") options.hotRooms = std::stoi(value);
+            else if (option == "--seed") options.seed = std::stoull(value);
+            else return usage();
+        }
+        if (options.guests < 0 || options.clerks < 0 || options.guests + options.clerks == 0 || options.seconds <= 0 ||
+            options.windowDays <= 0 || options.hotRooms <= 0) {
+            return usage();
+        }
+
+        OperationMix guestMix = OperationMix::parse(options.guestMix);
+        OperationMix clerkMix = OperationMix::parse(options.clerkMix);
+        shared.windowStart = options.from.empty() ? parseDate(RolloverJob::today()) + std::chrono::days(7) : parseDate(options.from);
+
+        auto setup = connectDB();
+        int sessions = options.guests + options.clerks;
+        shared.guestIds = queryIds(*setup, "SELECT id FROM users WHERE role = 'user' ORDER BY id LIMIT " + std::to_string(sessions) + ";");
+        shared.serviceIds = queryIds(*setup, "SELECT id FROM services ORDER BY id;");
+        if (shared.guestIds.empty()) {
+            throw std::runtime_error("No guest users found; load data with hotel_datagen first");
+        }
+        std::vector<int> lastId = queryIds(*setup, "SELECT COALESCE(max(id), 0) FROM bookings;");
+
+        std::vector<SessionResult> results(static_cast<std::size_t>(sessions));
+        std::vector<std::unique_ptr<Session>> workers;
+        for (int i = 0; i < sessions; ++i) {
+            bool clerk = i >= options.guests;
+            int userId = shared.guestIds[static_cast<std::size_t>(i) % shared.guestIds.size()];
+            workers.push_back(std::make_unique<Session>(shared, results[i], clerk ? clerkMix : guestMix, clerk, userId,
+                                                        options.seed * 1000003 + static_cast<std::uint64_t>(i)));
+        }
+
+        auto start = Clock::now();
+        auto deadline = start + std::chrono::seconds(options.seconds);
+        std::vector<std::thread> threads;
+        for (auto& worker : workers) {
+            Session* session = worker.get();
+            threads.emplace_back([&, session] {
+                if (options.rate > 0) {
+                    session->runOpen(options.rate / sessions, start, deadline);
+                } else {
+                    session->runClosed(options.thinkMs, deadline);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+        SessionResult total;
+        for (const auto& result : results) {
+            for (std::size_t op = 0; op < LOAD_OPERATION_COUNT; ++op) {
+                total.response[op].merge(result.response[op]);
+                total.service[op].merge(result.service[op]);
+                total.errors[op] += result.errors[op];
+                total.skipped[op] += result.skipped[op];
+            }
+            total.bookAttempts += result.bookAttempts;
+            total.booked += result.booked;
+            total.bookConflicts += result.bookConflicts;
+            total.noRooms += result.noRooms;
+            total.versionConflicts += result.versionConflicts;
+        }
+
+        std::string overlapQuery =
+            "SELECT count(*) FROM bookings a JOIN bookings b ON a.room_id = b.room_id AND a.id < b.id "
+            "AND a.date_from < b.date_to AND b.date_from < a.date_to "
+            "WHERE a.status <> 'cancelled' AND b.status <> 'cancelled' AND b.id > " + std::to_string(lastId.front()) +
+            " AND a.date_to > '" + formatDate(shared.windowStart) + "';";
+        long long doubleBookings = queryIds(*setup, overlapQuery).front();
+
+        auto ms = [](std::uint64_t ns) { return static_cast<double>(ns) / 1e6; };
+        std::printf("%d guest + %d clerk sessions, %.1f s, %s\n", options.guests, options.clerks, elapsed,
+                    options.rate > 0 ? ("open loop " + std::to_string(options.rate) + " ops/s").c_str()
+                                     : ("closed loop, think " + std::to_string(options.thinkMs) + " ms").c_str());
+        std::printf("%-8s %9s %7s %7s %9s %9s %9s %9s %9s %11s\n", "op", "count", "errors", "skipped", "p50 ms",
+                    "p90 ms", "p99 ms", "p99.9 ms", "max ms", "svc p99 ms");
+        std::uint64_t operations = 0;
+        for (std::size_t op = 0; op < LOAD_OPERATION_COUNT; ++op) {
+            const LatencyHistogram& latency = total.response[op];
+            operations += latency.count();
+            std::printf("%-8s %9llu %7llu %7llu %9.2f %9.2f %9.2f %9.2f %9.2f %11.2f\n",
+                        operationName(static_cast<LoadOperation>(op)), static_cast<unsigned long long>(latency.count()),
+                        static_cast<unsigned long long>(total.errors[op]), static_cast<unsigned long long>(total.skipped[op]),
+                        ms(latency.percentile(50)), ms(latency.percentile(90)), ms(latency.percentile(99)),
+                        ms(latency.percentile(99.9)), ms(latency.max()), ms(total.service[op].percentile(99)));
+        }
+        std::printf("throughput:       %.1f ops/s, %.1f bookings/s\n", operations / elapsed, total.booked / elapsed);
+        std::printf("booking attempts: %llu (%llu booked, %llu lost to a concurrent booking = %.2f%%, %llu searches found nothing)\n",
+                    static_cast<unsigned long long>(total.bookAttempts), static_cast<unsigned long long>(total.booked),
+                    static_cast<unsigned long long>(total.bookConflicts),
+                    total.bookAttempts ? 100.0 * total.bookConflicts / total.bookAttempts : 0.0,
+                    static_cast<unsigned long long>(total.noRooms));
+        std::printf("version retries:  %llu\n", static_cast<unsigned long long>(total.versionConflicts));
+        std::printf("double bookings:  %lld overlapping pair(s) created during the test\n", doubleBookings);
+
+        if (options.cleanup) {
+            int removed = setup->executeUpdate("DELETE FROM bookings WHERE id > " + std::to_string(lastId.front()) + ";");
+            std::printf("cleanup:          %d booking(s) removed\n", removed);
+        }
+        return doubleBookings > 0 ? 3 : 0;
+    } catch (const std::exception& e) {
+        std::cerr << "FATAL: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,104 @@
+/**
+ * @file hotel_partitions.cpp
+ * @brief Точка входа обслуживания месячных секций bookings/booking_services.
+ *
+ * Использование:
+ *   hotel_partitions ensure [months_ahead]                     - создать секции текущего и будущих месяцев
+ *   hotel_partitions archive <directory> [keep_months] [--keep-tables] - выгрузить и отсоединить старые секции
+ *   hotel_partitions show <file>                               - вывести содержимое файла архива в CSV
+ * Параметры базы данных берутся из переменных окружения HOTEL_DB_HOST, HOTEL_DB_PORT,
+ * HOTEL_DB_USER, HOTEL_DB_PASSWORD, HOTEL_DB_NAME.
+ */
+
+#include "DBManager.h"
+#include "PartitionManager.h"
+#include "RolloverJob.h"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace {
+
+/**
+ * @brief Возвращает значение переменной окружения или значение по умолчанию.
+ */
+std::string env(const char* name, const std::string& fallback) {
+    const char* value = std::getenv(name);
+    return value && *value ? std::string(value) : fallback;
+}
+
+/**
+ * @brief Выводит справку по использованию.
+ */
+int usage() {
+    std::cerr << "Usage: hotel_partitions ensure [months_ahead]\n"
+                 "       hotel_partitions archive <directory> [keep_months] [--keep-tables]\n"
+                 "       hotel_partitions show <file>" << std::endl;
+    return 2;
+}
+
+/**
+ * @brief Выводит содержимое файла архива в CSV.
+ */
+void show(const std::string& path) {
+    PartitionArchive archive = PartitionArchive::read(path);
+    std::cout << "id,user_id,room_id,date_from,date_to,status,version\n";
+    for (const auto& booking : archive.bookings) {
+        std::cout << booking.id << ',' << booking.userId << ',' << booking.roomId << ',' << booking.dateFrom << ','
+                  << booking.dateTo << ',' << booking.status << ',' << booking.version << '\n';
+    }
+    std::cout << "\nbooking_id,service_id,quantity\n";
+    for (const auto& service : archive.services) {
+        std::cout << service.bookingId << ',' << service.serviceId << ',' << service.quantity << '\n';
+    }
+    std::cerr << "Month " << archive.month << ": " << archive.bookings.size() << " bookings, "
+              << archive.services.size() << " service lines" << std::endl;
+}
+
+} // namespace
+
+/** @brief Точка входа. */
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        return usage();
+    }
+    std::string command = argv[1];
+
+    try {
+        if (command == "show") {
+            if (argc < 3) return usage();
+            show(argv[2]);
+            return 0;
+        }
+
+        DBManager db(env("HOTEL_DB_HOST", "127.0.0.1"), env("HOTEL_DB_USER", "postgres"), env("HOTEL_DB_PASSWORD", "dfvgbh04"),
+                     env("HOTEL_DB_NAME", "hotel_management"), std::stoi(env("HOTEL_DB_PORT", "5432")));
+        if (!db.connect()) {
+            std::cerr << "FATAL: Failed to connect to database!" << std::endl;
+            return 1;
+        }
+        PartitionManager partitions(db);
+        std::string today = RolloverJob::today();
+
+        if (command == "ensure") {
+            int ahead = argc > 2 ? std::atoi(argv[2]) : 3;
+            std::cout << "Created " << partitions.ensurePartitions(today, ahead) << " partition(s)" << std::endl;
+        } else if (command == "archive") {
+            if (argc < 3) return usage();
+            int keep = argc > 3 && std::string(argv[3]) != "--keep-tables" ? std::atoi(argv[3]) : 12;
+            bool dropDetached = std::string(argv[argc - 1]) != "--keep-tables";
+            PartitionReport report = partitions.archive(today, keep, argv[2], dropDetached);
+            for (const auto& file : report.files) {
+                std::cout << "Archived " << file << std::endl;
+            }
+            std::cout << report.archived << " month(s) archived, " << report.skipped << " skipped with active bookings, "
+                      << report.rowsArchived << " row(s) written" << std::endl;
+        } else {
+            return usage();
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "FATAL: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,167 @@
+/**
+ * @file hotel_server.cpp
+ * @brief Точка входа сетевого сервера: HTTP/JSON API поверх пула соединений с базой данных.
+ *
+ * Использование: hotel_server [port] [workers] [pool_size]
+ * Параметры базы данных берутся из переменных окружения HOTEL_DB_HOST, HOTEL_DB_PORT,
+ * HOTEL_DB_USER, HOTEL_DB_PASSWORD, HOTEL_DB_NAME (по умолчанию - как в main.cpp).
+ * HOTEL_REQUEST_TIMEOUT_MS задает крайний срок обработки запроса (по умолчанию 2000 мс).
+ * HOTEL_DB_REPLICAS - список реплик "host[:port],..." для запросов на чтение (по умолчанию реплик нет).
+ * HOTEL_SERVICE_JOURNAL - журнал отложенной записи услуг бронирований (по умолчанию услуги
+ * записываются сразу).
+ * HOTEL_SLOW_QUERY_MS - порог медленного запроса, для которого собирается план (по умолчанию не собирается).
+ * HOTEL_HOLD_TTL_SECONDS - время жизни удержания номера (по умолчанию 600 секунд).
+ * HOTEL_AUDIT_DIR - каталог журнала аудита, HOTEL_AUDIT_NODE - имя узла в audit_log (по умолчанию журнал
+ * аудита не ведется).
+ * Журнал настраивается переменными HOTEL_LOG_LEVEL, HOTEL_LOG_FILE и HOTEL_LOG_RATE_LIMIT.
+ */
+
+#include "AuditJournal.h"
+#include "ConnectionPool.h"
+#include "HoldManager.h"
+#include "HttpServer.h"
+#include "Logger.h"
+#include "ServerRoutes.h"
+#include "ServiceWriteBehind.h"
+#include "SessionManager.h"
+#include "SlowQueryLog.h"
+#include "TaskScheduler.h"
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace {
+
+HttpServer* activeServer = nullptr;
+
+/**
+ * @brief Возвращает значение переменной окружения или значение по умолчанию.
+ */
+std::string env(const char* name, const std::string& fallback) {
+    const char* value = std::getenv(name);
+    return value && *value ? std::string(value) : fallback;
+}
+
+/**
+ * @brief Обработчик SIGINT/SIGTERM: останавливает сервер.
+ */
+void onSignal(int) {
+    if (activeServer) {
+        activeServer->stop();
+    }
+}
+
+} // namespace
+
+/** @brief Точка входа. */
+int main(int argc, char* argv[]) {
+    Logger::configureFromEnvironment();
+    int port = argc > 1 ? std::atoi(argv[1]) : 8080;
+    std::size_t workers = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : std::thread::hardware_concurrency();
+    if (workers == 0) workers = 4;
+    std::size_t poolSize = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : workers;
+    if (poolSize == 0) poolSize = workers;
+
+    /**
+     * @brief Пул соединений открывается заранее; без базы данных сервер не запускается.
+     */
+    std::unique_ptr<ConnectionPool> pool;
+    std::shared_ptr<ServiceWriteBehind> serviceWrites;
+    std::unique_ptr<AuditJournal> audit;
+    try {
+        std::shared_ptr<ReplicaRouter> replicas;
+        auto endpoints = ReplicaRouter::parseEndpoints(env("HOTEL_DB_REPLICAS", ""), env("HOTEL_DB_USER", "postgres"),
+                                                       env("HOTEL_DB_PASSWORD", "dfvgbh04"), env("HOTEL_DB_NAME", "hotel_management"));
+        if (!endpoints.empty()) {
+            replicas = std::make_shared<ReplicaRouter>(std::move(endpoints));
+        }
+        std::shared_ptr<SlowQueryLog> slowQueries;
+        if (long thresholdMs = std::stol(env("HOTEL_SLOW_QUERY_MS", "0")); thresholdMs > 0) {
+            SlowQueryConfig config;
+            config.threshold = std::chrono::milliseconds(thresholdMs);
+            slowQueries = std::make_shared<SlowQueryLog>(
+                ConnectionPool::postgres(env("HOTEL_DB_HOST", "127.0.0.1"), env("HOTEL_DB_USER", "postgres"),
+                                         env("HOTEL_DB_PASSWORD", "dfvgbh04"), env("HOTEL_DB_NAME", "hotel_management"),
+                                         std::stoi(env("HOTEL_DB_PORT", "5432"))),
+                config);
+        }
+        pool = std::make_unique<ConnectionPool>(
+            ConnectionPool::postgres(env("HOTEL_DB_HOST", "127.0.0.1"), env("HOTEL_DB_USER", "postgres"),
+                                     env("HOTEL_DB_PASSWORD", "dfvgbh04"), env("HOTEL_DB_NAME", "hotel_management"),
+                                     std::stoi(env("HOTEL_DB_PORT", "5432")), replicas, slowQueries),
+            poolSize);
+        if (std::string journal = env("HOTEL_SERVICE_JOURNAL", ""); !journal.empty()) {
+            ServiceWriteBehindConfig config;
+            config.journalPath = journal;
+            serviceWrites = std::make_shared<ServiceWriteBehind>(
+                ConnectionPool::postgres(env("HOTEL_DB_HOST", "127.0.0.1"), env("HOTEL_DB_USER", "postgres"),
+                                         env("HOTEL_DB_PASSWORD", "dfvgbh04"), env("HOTEL_DB_NAME", "hotel_management"),
+                                         std::stoi(env("HOTEL_DB_PORT", "5432"))),
+                config);
+        }
+        if (std::string auditDir = env("HOTEL_AUDIT_DIR", ""); !auditDir.empty()) {
+            AuditJournalConfig config;
+            config.directory = auditDir;
+            config.node = env("HOTEL_AUDIT_NODE", "hotel_server");
+            audit = std::make_unique<AuditJournal>(
+                ConnectionPool::postgres(env("HOTEL_DB_HOST", "127.0.0.1"), env("HOTEL_DB_USER", "postgres"),
+                                         env("HOTEL_DB_PASSWORD", "dfvgbh04"), env("HOTEL_DB_NAME", "hotel_management"),
+                                         std::stoi(env("HOTEL_DB_PORT", "5432"))),
+                config);
+            AuditJournal::install(audit.get());
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "FATAL: " << e.what() << std::endl;
+        return 1;
+    }
+
+    SessionManager sessions;
+    auto holds = std::make_shared<HoldManager>(std::chrono::seconds(std::stol(env("HOTEL_HOLD_TTL_SECONDS", "600"))));
+    ServerRoutes routes(*pool, sessions, std::chrono::milliseconds(std::stol(env("HOTEL_REQUEST_TIMEOUT_MS", "2000"))),
+                        serviceWrites, holds);
+    TaskScheduler scheduler(workers, workers * 256);
+    HttpServer server([&routes](const HttpRequest& request) { return routes.handle(request); }, scheduler);
+    try {
+        server.listen(env("HOTEL_SERVER_ADDRESS", "127.0.0.1"), port);
+    } catch (const std::exception& e) {
+        std::cerr << "FATAL: " << e.what() << std::endl;
+        return 1;
+    }
+
+    /**
+     * @brief Фоновое удаление истекших сессий и удержаний раз в секунду.
+     */
+    std::mutex sweepMutex;
+    std::condition_variable sweepWake;
+    bool sweeping = true;
+    std::thread sweeper([&] {
+        std::unique_lock<std::mutex> lock(sweepMutex);
+        while (!sweepWake.wait_for(lock, std::chrono::seconds(1), [&] { return !sweeping; })) {
+            sessions.expireIdle();
+            holds->expire();
+        }
+    });
+
+    activeServer = &server;
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    std::cout << "hotel_server listening on port " << server.port() << " (" << workers << " workers, "
+              << poolSize << " DB connections)" << std::endl;
+    server.run();
+    activeServer = nullptr;
+
+    {
+        std::lock_guard<std::mutex> lock(sweepMutex);
+        sweeping = false;
+    }
+    sweepWake.notify_all();
+    sweeper.join();
+    AuditJournal::install(nullptr);
+    std::cout << "hotel_server stopped." << std::endl;
+    return 0;
+}
@@ -0,0 +1,174 @@
+/**
+ * @file server_loadtest.cpp
+ * @brief Локальный нагрузочный тест hotel_server: N соединений keep-alive в замкнутом цикле,
+ *        вывод пропускной способности (запросов в секунду) и перцентилей задержки.
+ *
+ * Использование: hotel_server_loadtest <port> [connections] [seconds] [path] [token]
+ * По умолчанию: 16 соединений, 10 секунд, путь /api/health.
+ * Для защищенных маршрутов передайте токен, полученный через POST /api/login.
+ */
+
+#include "LatencyHistogram.h"
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Результаты одного соединения.
+ */
+struct WorkerResult {
+    LatencyHistogram latency;
+    std::uint64_t errors = 0;
+    std::uint64_t non2xx = 0;
+};
+
+/**
+ * @brief Открывает TCP-соединение с локальным сервером.
+ * @return Дескриптор сокета или -1.
+ */
+int connectTo(int port) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        ::close(fd);
+        return -1;
+    }
+    int enable = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    return fd;
+}
+
+/**
+ * @brief Читает один HTTP-ответ целиком.
+ * @param fd Сокет.
+ * @param buffer Буфер соединения (остаток переносится между ответами).
+ * @return Код состояния или -1 при ошибке.
+ */
+int readResponse(int fd, std::string& buffer) {
+    char chunk[16384];
+    std::size_t headerEnd;
+    while ((headerEnd = buffer.find("\r\n\r\n")) == std::string::npos) {
+        ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0) return -1;
+        buffer.append(chunk, static_cast<std::size_t>(n));
+    }
+    int status = std::atoi(buffer.c_str() + 9);
+    std::size_t length = 0;
+    std::size_t lengthPos = buffer.find("Content-Length: ");
+    if (lengthPos != std::string::npos && lengthPos < headerEnd) {
+        length = std::strtoul(buffer.c_str() + lengthPos + 16, nullptr, 10);
+    }
+    std::size_t total = headerEnd + 4 + length;
+    while (buffer.size() < total) {
+        ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0) return -1;
+        buffer.append(chunk, static_cast<std::size_t>(n));
+    }
+    buffer.erase(0, total);
+    return status;
+}
+
+/**
+ * @brief Цикл одного соединения: запрос, ожидание ответа, запись задержки.
+ */
+void runConnection(int port, const std::string& request, std::chrono::steady_clock::time_point deadline,
+                   WorkerResult& result) {
+    using Clock = std::chrono::steady_clock;
+    int fd = connectTo(port);
+    std::string buffer;
+    while (Clock::now() < deadline) {
+        if (fd < 0) {
+            ++result.errors;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            fd = connectTo(port);
+            continue;
+        }
+        auto start = Clock::now();
+        int status = -1;
+        if (::send(fd, request.data(), request.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(request.size())) {
+            status = readResponse(fd, buffer);
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+        if (status < 0) {
+            ++result.errors;
+            ::close(fd);
+            buffer.clear();
+            fd = connectTo(port);
+            continue;
+        }
+        result.latency.record(static_cast<std::uint64_t>(elapsed));
+        if (status < 200 || status >= 300) {
+            ++result.non2xx;
+        }
+    }
+    if (fd >= 0) ::close(fd);
+}
+
+} // namespace
+
+/** @brief Точка входа. */
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <port> [connections] [seconds] [path] [token]" << std::endl;
+        return 1;
+    }
+    int port = std::atoi(argv[1]);
+    int connections = argc > 2 ? std::atoi(argv[2]) : 16;
+    int seconds = argc > 3 ? std::atoi(argv[3]) : 10;
+    std::string path = argc > 4 ? argv[4] : "/api/health";
+    std::string token = argc > 5 ? argv[5] : "";
+    if (connections <= 0) connections = 1;
+    if (seconds <= 0) seconds = 1;
+
+    std::string request = "GET " + path + " HTTP/1.1\r\nHost: 127.0.0.1\r\n";
+    if (!token.empty()) {
+        request += "Authorization: Bearer " + token + "\r\n";
+    }
+    request += "\r\n";
+
+    std::vector<WorkerResult> results(static_cast<std::size_t>(connections));
+    std::vector<std::thread> threads;
+    auto started = std::chrono::steady_clock::now();
+    auto deadline = started + std::chrono::seconds(seconds);
+    for (int i = 0; i < connections; ++i) {
+        threads.emplace_back(runConnection, port, std::cref(request), deadline, std::ref(results[i]));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    LatencyHistogram total;
+    std::uint64_t errors = 0, non2xx = 0;
+    for (const auto& result : results) {
+        total.merge(result.latency);
+        errors += result.errors;
+        non2xx += result.non2xx;
+    }
+
+    auto us = [](std::uint64_t ns) { return static_cast<double>(ns) / 1000.0; };
+    std::printf("GET %s, %d connections, %.1f s\n", path.c_str(), connections, elapsed);
+    std::printf("requests:   %llu (%llu non-2xx, %llu errors)\n", static_cast<unsigned long long>(total.count()),
+                static_cast<unsigned long long>(non2xx), static_cast<unsigned long long>(errors));
+    std::printf("throughput: %.0f req/s\n", static_cast<double>(total.count()) / elapsed);
+    std::printf("latency us: mean %.1f  p50 %.1f  p90 %.1f  p99 %.1f  p99.9 %.1f  max %.1f\n",
+                total.mean() / 1000.0, us(total.percentile(50)), us(total.percentile(90)), us(total.percentile(99)),
+                us(total.percentile(99.9)), us(total.max()));
+    return errors > 0 && total.count() == 0 ? 1 : 0;
+}